@@ -11,6 +11,9 @@ import { SCREENS, SERVER_URL, ENDPOINTS } from './constants'
 // Hooks
 import { useRoom, useGame } from './hooks'
 
+// Services
+import * as roomService from './services/roomService'
+
 // Components
 import { NameInput, Lobby, WaitingRoom, GameScreen, GameOver } from './components'
 
@@ -63,6 +66,17 @@ function App() {
             localStorage.setItem('sessionId', data.session_id)
           }
 
+          // Handle lobby change stream (thay cho việc poll /rooms)
+          if (data.action === 'lobby_update') {
+            roomRef.current.applyLobbyEvents(data.events || [])
+          }
+
+          // Handle quick-play match (room đã start hoặc phòng đang chờ)
+          if (data.action === 'match_found') {
+            roomRef.current.updateRoom(data.room)
+            setCurrentScreen(data.room.status === 'playing' ? SCREENS.PLAYING : SCREENS.WAITING_ROOM)
+          }
+
           // Handle room events
           if (data.action === 'player_joined' || data.action === 'player_left') {
             roomRef.current.updateRoom(data.room)
@@ -96,7 +110,9 @@ function App() {
           // Handle round results (khi TẤT CẢ đã trả lời)
           if (data.action === 'round_results') {
             game.updateGameData({
-              roundResults: data.results
+              roundResults: data.results,
+              leaderboard: data.leaderboard,
+              myRank: data.my_rank
             })
           }
 
@@ -122,6 +138,10 @@ function App() {
           // Handle game finished
           if (data.action === 'game_finished') {
             roomRef.current.updateRoom(data.room)
+            game.updateGameData({
+              leaderboard: data.leaderboard,
+              myRank: data.my_rank
+            })
             setCurrentScreen(SCREENS.GAME_OVER)
           }
         } catch {
@@ -146,7 +166,7 @@ function App() {
     }
   }, [])
 
-  // Fetch rooms only once when entering lobby
+  // Fetch rooms snapshot once when entering lobby - later changes arrive via lobby_update
   useEffect(() => {
     if (connected && currentScreen === SCREENS.LOBBY) {
       room.fetchRooms()
@@ -170,7 +190,7 @@ function App() {
   }
 
   // Create room
-  const handleCreateRoom = async ({ roomName, maxRounds }) => {
+  const handleCreateRoom = async ({ roomName, maxRounds, arena, difficulty }) => {
     if (!playerName.trim()) {
       alert('Vui lòng nhập tên trước!')
       return false
@@ -179,7 +199,9 @@ function App() {
     const result = await room.createRoom({
       roomName,
       playerName,
-      maxRounds
+      maxRounds,
+      arena,
+      difficulty
     })
 
     if (result) {
@@ -210,6 +232,20 @@ function App() {
     }
   }
 
+  // Quick play - vào hàng đợi, chờ match_found qua SSE
+  const handleQuickPlay = async (maxRounds) => {
+    if (!playerName.trim()) {
+      alert('Vui lòng nhập tên trước!')
+      return
+    }
+
+    try {
+      await roomService.joinMatchmaking({ playerName, maxRounds })
+    } catch (error) {
+      alert(error.response?.data?.error || 'Không thể vào hàng đợi')
+    }
+  }
+
   // Leave room
   const handleLeaveRoom = async () => {
     const success = await room.leaveRoom()
@@ -261,6 +297,7 @@ function App() {
           rooms={room.rooms}
           onCreateRoom={handleCreateRoom}
           onJoinRoom={handleJoinRoom}
+          onQuickPlay={handleQuickPlay}
           onRefresh={room.fetchRooms}
           loading={room.loading}
           connected={connected}
@@ -294,6 +331,8 @@ function App() {
         <GameOver
           room={room.currentRoom}
           sessionId={sessionId}
+          leaderboard={game.leaderboard}
+          myRank={game.myRank}
           onReturnToLobby={handleReturnToLobby}
         />
       )
@@ -305,6 +344,7 @@ function App() {
           rooms={room.rooms}
           onCreateRoom={handleCreateRoom}
           onJoinRoom={handleJoinRoom}
+          onQuickPlay={handleQuickPlay}
           onRefresh={room.fetchRooms}
           loading={room.loading}
           connected={connected}
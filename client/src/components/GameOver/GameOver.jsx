@@ -4,8 +4,9 @@
 
 import PropTypes from 'prop-types'
 
-function GameOver({ room, sessionId, onReturnToLobby }) {
-  const sortedPlayers = room?.players
+function GameOver({ room, sessionId, leaderboard, myRank, onReturnToLobby }) {
+  // Server đã xếp hạng sẵn; chỉ tự sắp xếp khi thiếu leaderboard
+  const sortedPlayers = leaderboard || room?.players
     ?.slice()
     .sort((a, b) => b.score - a.score) || []
   const winner = sortedPlayers[0]
@@ -42,6 +43,9 @@ function GameOver({ room, sessionId, onReturnToLobby }) {
 
       <div className="final-leaderboard">
         <h2>📊 Bảng Xếp Hạng</h2>
+        {myRank && (
+          <p>Hạng của bạn: <strong>#{myRank}</strong></p>
+        )}
         {sortedPlayers.map((player, index) => (
           <div 
             key={player.session_id} 
@@ -73,6 +77,13 @@ GameOver.propTypes = {
     }))
   }),
   sessionId: PropTypes.number,
+  leaderboard: PropTypes.arrayOf(PropTypes.shape({
+    rank: PropTypes.number.isRequired,
+    session_id: PropTypes.number.isRequired,
+    name: PropTypes.string.isRequired,
+    score: PropTypes.number.isRequired
+  })),
+  myRank: PropTypes.number,
   onReturnToLobby: PropTypes.func.isRequired
 }
 
@@ -9,6 +9,10 @@ function CreateRoomForm({
   setRoomName, 
   maxRounds,
   setMaxRounds,
+  arena,
+  setArena,
+  difficulty,
+  setDifficulty,
   onCreate, 
   loading, 
   disabled 
@@ -32,6 +36,21 @@ function CreateRoomForm({
           <option value={15}>15 câu hỏi</option>
           <option value={20}>20 câu hỏi</option>
         </select>
+        <select
+          value={difficulty}
+          onChange={(e) => setDifficulty(e.target.value)}
+        >
+          <option value="random">Ngẫu nhiên</option>
+          <option value="ramp">Khó dần</option>
+        </select>
+        <label>
+          <input
+            type="checkbox"
+            checked={arena}
+            onChange={(e) => setArena(e.target.checked)}
+          />
+          Arena
+        </label>
         <button onClick={onCreate} disabled={loading || disabled}>
           {loading ? 'Đang tạo...' : '➕ Tạo Phòng'}
         </button>
@@ -45,12 +64,18 @@ CreateRoomForm.propTypes = {
   setRoomName: PropTypes.func.isRequired,
   maxRounds: PropTypes.number.isRequired,
   setMaxRounds: PropTypes.func.isRequired,
+  arena: PropTypes.bool,
+  setArena: PropTypes.func.isRequired,
+  difficulty: PropTypes.oneOf(['random', 'ramp']),
+  setDifficulty: PropTypes.func.isRequired,
   onCreate: PropTypes.func.isRequired,
   loading: PropTypes.bool,
   disabled: PropTypes.bool
 }
 
 CreateRoomForm.defaultProps = {
+  arena: false,
+  difficulty: 'random',
   loading: false,
   disabled: false
 }
@@ -12,17 +12,22 @@ function Lobby({
   rooms, 
   onCreateRoom, 
   onJoinRoom, 
+  onQuickPlay,
   onRefresh, 
   loading, 
   connected 
 }) {
   const [roomName, setRoomName] = useState('')
   const [maxRounds, setMaxRounds] = useState(10)
+  const [arena, setArena] = useState(false)
+  const [difficulty, setDifficulty] = useState('random')
 
   const handleCreateRoom = async () => {
     const success = await onCreateRoom({ 
       roomName: roomName || `Phòng của ${playerName}`, 
-      maxRounds
+      maxRounds,
+      arena,
+      difficulty
     })
     if (success) {
       setRoomName('')
@@ -41,11 +46,23 @@ function Lobby({
         setRoomName={setRoomName}
         maxRounds={maxRounds}
         setMaxRounds={setMaxRounds}
+        arena={arena}
+        setArena={setArena}
+        difficulty={difficulty}
+        setDifficulty={setDifficulty}
         onCreate={handleCreateRoom}
         loading={loading}
         disabled={!connected}
       />
 
+      <button
+        className="refresh-btn"
+        onClick={() => onQuickPlay(maxRounds)}
+        disabled={loading || !connected}
+      >
+        ⚡ Chơi nhanh
+      </button>
+
       <div className="rooms-list-section">
         <h2>Danh Sách Phòng ({rooms.length})</h2>
         <button className="refresh-btn" onClick={onRefresh}>
@@ -76,6 +93,7 @@ Lobby.propTypes = {
   rooms: PropTypes.array.isRequired,
   onCreateRoom: PropTypes.func.isRequired,
   onJoinRoom: PropTypes.func.isRequired,
+  onQuickPlay: PropTypes.func.isRequired,
   onRefresh: PropTypes.func.isRequired,
   loading: PropTypes.bool,
   connected: PropTypes.bool
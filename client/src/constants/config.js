@@ -18,10 +18,17 @@ export const ENDPOINTS = {
   ROOMS_START: '/rooms/start',
   ROOMS_CHOICE: '/rooms/choice',
   ROOMS_INFO: '/rooms/info',
+
+  // Quick-play matchmaking
+  MATCHMAKING_JOIN: '/matchmaking/join',
+  MATCHMAKING_LEAVE: '/matchmaking/leave',
   
   // Game (legacy single player)
   GAME: '/game',
   GAME_CHOICE: '/game/choice'
 }
 
+// GET /rooms page size (server caps ?limit= at ROOM_LIST_MAX_LIMIT = 50)
+export const ROOM_LIST_PAGE_SIZE = 50
+
 
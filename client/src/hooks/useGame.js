@@ -21,7 +21,9 @@ const initialGameState = {
   round: 0,
   waitingFor: 0,
   loading: false,
-  roundResults: null  // Kết quả của tất cả players sau khi round kết thúc
+  roundResults: null,  // Kết quả của tất cả players sau khi round kết thúc
+  leaderboard: null,   // Top K do server xếp hạng
+  myRank: null         // Hạng của mình (server gửi kèm round_results/game_finished)
 }
 
 /**
@@ -44,7 +44,7 @@ export const useRoom = (sessionId) => {
   }, [])
 
   // Create room
-  const createRoom = useCallback(async ({ roomName, playerName, maxRounds }) => {
+  const createRoom = useCallback(async ({ roomName, playerName, maxRounds, arena, difficulty }) => {
     if (!sessionId) {
       setError('Chưa kết nối đến server')
       return null
@@ -52,7 +52,7 @@ export const useRoom = (sessionId) => {
 
     setLoading(true)
     try {
-      const data = await roomService.createRoom({ roomName, playerName, maxRounds })
+      const data = await roomService.createRoom({ roomName, playerName, maxRounds, arena, difficulty })
       setState(prev => ({
         ...prev,
         currentRoom: data.room,
@@ -136,6 +136,30 @@ export const useRoom = (sessionId) => {
     }))
   }, [])
 
+  // Apply incremental lobby events from SSE (room_added / room_updated / room_removed)
+  // room_updated only carries the id plus the fields that changed, so merge it into
+  // a room we already have; only room_added (full room) may insert a new entry
+  const applyLobbyEvents = useCallback((events) => {
+    setState(prev => {
+      let rooms = prev.rooms
+      for (const event of events) {
+        if (event.type === 'room_removed') {
+          rooms = rooms.filter(r => r.id !== event.room_id)
+        } else if (event.type === 'room_added' || event.type === 'room_updated') {
+          const exists = rooms.some(r => r.id === event.room.id)
+          if (exists) {
+            rooms = rooms.map(r => (r.id === event.room.id ? { ...r, ...event.room } : r))
+          } else if (event.type === 'room_added') {
+            rooms = [...rooms, event.room]
+          }
+          // Unknown id on room_updated: the snapshot raced the delta, the next
+          // fetchRooms() picks the room up with all its fields
+        }
+      }
+      return { ...prev, rooms }
+    })
+  }, [])
+
   return {
     // State
     rooms: state.rooms,
@@ -149,7 +173,8 @@ export const useRoom = (sessionId) => {
     joinRoom,
     leaveRoom,
     startGame,
-    updateRoom
+    updateRoom,
+    applyLobbyEvents
   }
 }
 
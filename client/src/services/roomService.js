@@ -3,15 +3,25 @@
  */
 
 import api from './api'
-import { ENDPOINTS } from '../constants'
+import { ENDPOINTS, ROOM_LIST_PAGE_SIZE } from '../constants'
 
 /**
  * Get list of all rooms
+ * GET /rooms is paginated: follow next_cursor until the last page so the
+ * lobby snapshot is not truncated to the first page
  * @returns {Promise<Array>} List of rooms
  */
 export const getRooms = async () => {
-  const response = await api.get(ENDPOINTS.ROOMS)
-  return response.data.rooms || []
+  const rooms = []
+  let cursor = null
+  do {
+    const params = { limit: ROOM_LIST_PAGE_SIZE }
+    if (cursor) params.cursor = cursor
+    const response = await api.get(ENDPOINTS.ROOMS, { params })
+    rooms.push(...(response.data.rooms || []))
+    cursor = response.data.next_cursor || null
+  } while (cursor)
+  return rooms
 }
 
 /**
@@ -20,13 +30,17 @@ export const getRooms = async () => {
  * @param {string} params.roomName - Room name
  * @param {string} params.playerName - Player name
  * @param {number} params.maxRounds - Max rounds (5-50)
+ * @param {boolean} params.arena - Arena room (large, top-K broadcasts)
+ * @param {string} params.difficulty - 'random' or 'ramp' (pairs get closer in price each round)
  * @returns {Promise<Object>} Created room data
  */
-export const createRoom = async ({ roomName, playerName, maxRounds }) => {
+export const createRoom = async ({ roomName, playerName, maxRounds, arena, difficulty }) => {
   const response = await api.post(ENDPOINTS.ROOMS_CREATE, {
     room_name: roomName,
     player_name: playerName,
-    max_rounds: maxRounds || 10
+    max_rounds: maxRounds || 10,
+    arena: arena ? 1 : 0,
+    difficulty: difficulty || 'random'
   })
   return response.data
 }
@@ -73,11 +87,37 @@ export const getRoomInfo = async () => {
   return response.data
 }
 
+/**
+ * Join quick-play queue - server sends match_found via SSE when matched
+ * @param {Object} params
+ * @param {string} params.playerName - Player name
+ * @param {number} params.maxRounds - Preferred max rounds (5-50)
+ * @returns {Promise<Object>} Queue status
+ */
+export const joinMatchmaking = async ({ playerName, maxRounds }) => {
+  const response = await api.post(ENDPOINTS.MATCHMAKING_JOIN, {
+    player_name: playerName,
+    max_rounds: maxRounds || 10
+  })
+  return response.data
+}
+
+/**
+ * Leave quick-play queue
+ * @returns {Promise<Object>} Response data
+ */
+export const leaveMatchmaking = async () => {
+  const response = await api.post(ENDPOINTS.MATCHMAKING_LEAVE, {})
+  return response.data
+}
+
 export default {
   getRooms,
   createRoom,
   joinRoom,
   leaveRoom,
   startGame,
-  getRoomInfo
+  getRoomInfo,
+  joinMatchmaking,
+  leaveMatchmaking
 }
@@ -0,0 +1,76 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - GAME TOKEN BENCHMARK
+ * ============================================================================
+ * File: game_token_bench.c
+ * Description: Chi phí kiểm tra + ký lại token chơi đơn, và throughput khi
+ *              tăng số worker thread (không state chung => tăng tuyến tính
+ *              đến số core)
+ *
+ * Chạy: make bench-token
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/config.h"
+#include "../include/game_token.h"
+
+#define OPS_PER_THREAD 500000
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Một "request" /game/choice: decode + verify, đổi state, ký lại
+ */
+static void *worker(void *arg) {
+    char text[GAME_TOKEN_LEN];
+    GameToken token = { .catalog_id = 42, .index_a = 1, .index_b = 2, .seed = (uintptr_t)arg };
+    game_token_encode(&token, text, sizeof(text));
+
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        if (game_token_decode(text, &token) != GAME_TOKEN_OK) {
+            fprintf(stderr, "❌ Token rejected at op %d\n", i);
+            exit(1);
+        }
+        token.round++;
+        token.score += 10;
+        game_token_encode(&token, text, sizeof(text));
+    }
+    return NULL;
+}
+
+int main(void) {
+    uint8_t key[16];
+    for (int i = 0; i < 16; i++) key[i] = (uint8_t)(i * 17);
+    game_token_set_key(key);
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("Token verify + re-sign, %d ops/thread, %ld core(s)\n\n", OPS_PER_THREAD, cores);
+    printf("%8s %12s %14s %10s\n", "threads", "ns/op", "ops/s", "scaling");
+
+    double base = 0;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        pthread_t tids[8];
+        double t0 = now_ns();
+        for (int t = 0; t < threads; t++) {
+            pthread_create(&tids[t], NULL, worker, (void *)(uintptr_t)(t + 1));
+        }
+        for (int t = 0; t < threads; t++) pthread_join(tids[t], NULL);
+        double elapsed = now_ns() - t0;
+
+        double ops = (double)OPS_PER_THREAD * threads;
+        double rate = ops / (elapsed / 1e9);
+        if (threads == 1) base = rate;
+        printf("%8d %12.1f %14.0f %9.2fx\n", threads, elapsed * threads / ops, rate, rate / base);
+    }
+    return 0;
+}
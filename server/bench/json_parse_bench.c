@@ -0,0 +1,150 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - REQUEST PARSER BENCHMARK
+ * ============================================================================
+ * File: json_parse_bench.c
+ * Description: So sánh parse_json_string/parse_json_int cũ (strstr mỗi key)
+ *              với parse_request_body (một lượt, SSE2) trên các body thật
+ *
+ * Chạy: make bench-parse
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/json_parse.h"
+
+/* ============================================================================
+ *                           LEGACY PARSER
+ * ============================================================================ */
+
+/**
+ * parse_json_string cũ (room_helpers.c trước khi có json_parse)
+ */
+static void legacy_parse_json_string(const char *json, const char *key, char *out, size_t out_size) {
+    char search_key[64];
+    snprintf(search_key, sizeof(search_key), "\"%s\"", key);
+
+    char *ptr = strstr(json, search_key);
+    if (!ptr) return;
+
+    char *value_start = strchr(ptr, ':');
+    if (!value_start) return;
+
+    value_start++;
+    while (*value_start == ' ' || *value_start == '"') value_start++;
+
+    char *value_end = strchr(value_start, '"');
+    if (!value_end) return;
+
+    int len = value_end - value_start;
+    if (len > 0 && len < (int)out_size) {
+        strncpy(out, value_start, len);
+        out[len] = '\0';
+    }
+}
+
+static int legacy_parse_json_int(const char *json, const char *key) {
+    char search_key[64];
+    snprintf(search_key, sizeof(search_key), "\"%s\"", key);
+
+    char *ptr = strstr(json, search_key);
+    if (!ptr) return 0;
+
+    char *value_start = strchr(ptr, ':');
+    if (!value_start) return 0;
+
+    return atoi(value_start + 1);
+}
+
+/* ============================================================================
+ *                           CASES
+ * ============================================================================ */
+
+typedef struct {
+    const char *label;
+    const char *body;
+} BenchCase;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Lấy cùng các key mà handle_create_room cần, theo cả hai cách
+ */
+static void legacy_create(const char *body, RequestBody *out) {
+    memset(out, 0, sizeof(*out));
+    legacy_parse_json_string(body, "room_name", out->room_name, sizeof(out->room_name));
+    legacy_parse_json_string(body, "player_name", out->player_name, sizeof(out->player_name));
+    out->max_rounds = legacy_parse_json_int(body, "max_rounds");
+    out->arena = legacy_parse_json_int(body, "arena");
+    out->room_id = legacy_parse_json_int(body, "room_id");
+    out->choice = legacy_parse_json_int(body, "choice");
+    out->response_time = legacy_parse_json_int(body, "response_time");
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+int main(void) {
+    static char long_body[4096];
+    char padding[3000];
+    memset(padding, 'x', sizeof(padding) - 1);
+    padding[sizeof(padding) - 1] = '\0';
+    snprintf(long_body, sizeof(long_body),
+             "{\"client\":{\"ua\":\"%s\",\"tags\":[1,2,3]},\"room_name\":\"Long\","
+             "\"player_name\":\"Ann\",\"max_rounds\":20}", padding);
+
+    const BenchCase cases[] = {
+        { "choice",  "{\"choice\":1,\"response_time\":1234}" },
+        { "create",  "{\"room_name\":\"Friday night trivia\",\"player_name\":\"Ann\",\"max_rounds\":20,\"arena\":0}" },
+        { "join",    "{\"room_id\":42,\"player_name\":\"Bob the builder\"}" },
+        { "escaped", "{\"room_name\":\"Say \\\"hi\\\" \\u00e9\",\"player_name\":\"C\\\\D\",\"max_rounds\":10}" },
+        { "long",    long_body },
+    };
+    const int iters = 200000;
+
+    printf("%-8s %6s %12s %12s %10s\n", "body", "bytes", "strstr_ns", "onepass_ns", "speedup");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const char *body = cases[c].body;
+        size_t len = strlen(body);
+        RequestBody a, b;
+        volatile int sink = 0;
+
+        double t0 = now_ns();
+        for (int i = 0; i < iters; i++) {
+            legacy_create(body, &a);
+            sink += a.max_rounds;
+        }
+        double legacy_ns = (now_ns() - t0) / iters;
+
+        t0 = now_ns();
+        for (int i = 0; i < iters; i++) {
+            if (parse_request_body(body, len, &b) != 0) {
+                fprintf(stderr, "❌ Parse failed: %s\n", cases[c].label);
+                return 1;
+            }
+            sink += b.max_rounds;
+        }
+        double onepass_ns = (now_ns() - t0) / iters;
+        (void)sink;
+
+        printf("%-8s %6zu %12.1f %12.1f %9.1fx\n",
+               cases[c].label, len, legacy_ns, onepass_ns, legacy_ns / onepass_ns);
+        if (strcmp(a.room_name, b.room_name) != 0) {
+            printf("         room_name: strstr=\"%s\" onepass=\"%s\"\n", a.room_name, b.room_name);
+        }
+        if (strcmp(a.player_name, b.player_name) != 0) {
+            printf("         player_name: strstr=\"%s\" onepass=\"%s\"\n", a.player_name, b.player_name);
+        }
+    }
+
+    return 0;
+}
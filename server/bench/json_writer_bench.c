@@ -0,0 +1,134 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - JSON WRITER BENCHMARK
+ * ============================================================================
+ * File: json_writer_bench.c
+ * Description: So sánh cách build danh sách players cũ (snprintf + strlen +
+ *              strcat, O(n^2)) với JsonWriter (O(n)) ở phòng 50/500/5000 người
+ *
+ * Chạy: make bench-json
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/types.h"
+#include "../include/json_writer.h"
+
+/* ============================================================================
+ *                           HELPERS
+ * ============================================================================ */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void make_players(RoomPlayer *players, int n) {
+    for (int i = 0; i < n; i++) {
+        memset(&players[i], 0, sizeof(RoomPlayer));
+        players[i].session_id = i + 1;
+        snprintf(players[i].name, PLAYER_NAME_LEN, "Player_%d", i + 1);
+        players[i].score = (i * 37) % 500;
+        players[i].streak = i % 7;
+        players[i].is_ready = 1;
+        players[i].has_answered = i & 1;
+    }
+}
+
+/* ============================================================================
+ *                           BUILDERS
+ * ============================================================================ */
+
+/**
+ * Cách cũ của build_players_json (trước JsonWriter)
+ */
+static void legacy_players_json(RoomPlayer *players, int n, int host, char *json, size_t json_size) {
+    strcpy(json, "[");
+    for (int i = 0; i < n; i++) {
+        RoomPlayer *p = &players[i];
+        char entry[512];
+        snprintf(entry, sizeof(entry),
+            "%s{\"session_id\":%d,\"name\":\"%s\",\"score\":%d,\"streak\":%d,"
+            "\"is_ready\":%d,\"game_over\":%d,\"has_answered\":%d,\"is_host\":%s}",
+            i > 0 ? "," : "",
+            p->session_id, p->name, p->score, p->streak,
+            p->is_ready, p->game_over, p->has_answered,
+            p->session_id == host ? "true" : "false");
+        if (strlen(json) + strlen(entry) < json_size - 2) {
+            strcat(json, entry);
+        }
+    }
+    strcat(json, "]");
+}
+
+static void writer_players_json(JsonWriter *w, RoomPlayer *players, int n, int host) {
+    jw_array_begin(w);
+    for (int i = 0; i < n; i++) {
+        RoomPlayer *p = &players[i];
+        jw_object_begin(w);
+        jw_kv_int(w, "session_id", p->session_id);
+        jw_kv_str(w, "name", p->name);
+        jw_kv_int(w, "score", p->score);
+        jw_kv_int(w, "streak", p->streak);
+        jw_kv_int(w, "is_ready", p->is_ready);
+        jw_kv_int(w, "game_over", p->game_over);
+        jw_kv_int(w, "has_answered", p->has_answered);
+        jw_kv_bool(w, "is_host", p->session_id == host);
+        jw_object_end(w);
+    }
+    jw_array_end(w);
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+int main(void) {
+    static const int sizes[] = { 50, 500, 5000 };
+
+    printf("%-8s %-10s %12s %12s %10s\n", "players", "bytes", "strcat_us", "writer_us", "speedup");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int n = sizes[s];
+        int iters = n >= 5000 ? 20 : (n >= 500 ? 200 : 2000);
+
+        RoomPlayer *players = malloc(sizeof(RoomPlayer) * n);
+        size_t legacy_size = (size_t)n * 256 + 16;
+        char *legacy = malloc(legacy_size);
+        if (!players || !legacy) return 1;
+        make_players(players, n);
+
+        double t0 = now_ns();
+        for (int i = 0; i < iters; i++) {
+            legacy_players_json(players, n, 1, legacy, legacy_size);
+        }
+        double legacy_us = (now_ns() - t0) / iters / 1e3;
+
+        JsonWriter w;
+        jw_init(&w);
+        t0 = now_ns();
+        for (int i = 0; i < iters; i++) {
+            jw_reset(&w);
+            writer_players_json(&w, players, n, 1);
+        }
+        double writer_us = (now_ns() - t0) / iters / 1e3;
+
+        if (strcmp(legacy, jw_str(&w)) != 0) {
+            fprintf(stderr, "❌ Output mismatch at %d players\n", n);
+            return 1;
+        }
+
+        printf("%-8d %-10zu %12.1f %12.1f %9.1fx\n",
+               n, jw_len(&w), legacy_us, writer_us, legacy_us / writer_us);
+
+        jw_free(&w);
+        free(legacy);
+        free(players);
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - LOGGER BENCHMARK
+ * ============================================================================
+ * File: logger_bench.c
+ * Description: Thời gian thread gọi log phải trả: printf trực tiếp (stdout
+ *              lock + write) so với LOG_* vào ring, và LOG_DEBUG khi tắt
+ *
+ * Output log ghi vào /dev/null (GAME_LOG_FILE) để chỉ đo phía gọi.
+ * Chạy: make bench-log
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/config.h"
+#include "../include/logger.h"
+
+#define OPS_PER_THREAD  200000
+#define BURST           256     // Dòng mỗi đợt (vừa một ring), giữa hai đợt ring được drain
+
+typedef void (*LogFn)(int i);
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static FILE *devnull;
+
+static void log_printf(int i) {
+    fprintf(devnull, "[SSE] 📡 Update sent to session %d\n", i);
+    fflush(devnull);        // Như stdout line-buffered của server cũ: mỗi dòng một write()
+}
+
+static void log_ring(int i) {
+    LOG_INFO("SSE", "📡 Update sent to session %d", i);
+}
+
+static void log_disabled(int i) {
+    LOG_DEBUG("SSE", "📡 Update sent to session %d", i);
+}
+
+typedef struct {
+    LogFn fn;
+    double ns;                      // Chỉ tính thời gian trong các lời gọi log
+} Worker;
+
+/**
+ * Log theo đợt như server (vài dòng mỗi request); drain giữa các đợt không
+ * tính giờ, để đo đường ghi vào ring chứ không đo nhánh ring đầy
+ */
+static void *worker(void *arg) {
+    Worker *w = arg;
+    for (int i = 0; i < OPS_PER_THREAD; i += BURST) {
+        double t0 = now_ns();
+        for (int j = i; j < i + BURST; j++) w->fn(j);
+        w->ns += now_ns() - t0;
+        log_flush();
+    }
+    return NULL;
+}
+
+static void run(const char *label, LogFn fn, int threads) {
+    pthread_t tids[8];
+    Worker workers[8];
+    LogStats before, after;
+    log_stats(&before);
+    for (int t = 0; t < threads; t++) {
+        workers[t].fn = fn;
+        workers[t].ns = 0;
+        pthread_create(&tids[t], NULL, worker, &workers[t]);
+    }
+    double ns = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        ns += workers[t].ns;
+    }
+    log_stats(&after);
+
+    printf("%-14s %8d %12.1f %12llu\n", label, threads, ns / ((double)OPS_PER_THREAD * threads),
+           after.dropped - before.dropped);
+}
+
+int main(void) {
+    devnull = fopen("/dev/null", "w");
+    setenv(LOG_FILE_ENV, "/dev/null", 1);
+    setenv(LOG_LEVEL_ENV, "info", 1);
+    log_init();
+
+    printf("%d calls/thread, %ld core(s), ring %d x %d slots\n\n", OPS_PER_THREAD,
+           sysconf(_SC_NPROCESSORS_ONLN), LOG_RINGS, LOG_RING_SIZE);
+    printf("%-14s %8s %12s %12s\n", "logger", "threads", "ns/call", "dropped");
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        run("printf", log_printf, threads);
+        run("LOG_INFO ring", log_ring, threads);
+        run("LOG_DEBUG off", log_disabled, threads);
+    }
+    return 0;
+}
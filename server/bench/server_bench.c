@@ -0,0 +1,495 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - SERVER MICROBENCHMARKS
+ * ============================================================================
+ * File: server_bench.c
+ * Description: Microbenchmark các hàm nóng của server, link với chính các
+ *              module của server (trừ main.c)
+ *
+ * - Request parsing: parse_http_request (sscanf + strstr của handle_client),
+ *   get_session_from_request, metrics_match_route
+ * - Body: parse_request_body (thay cho parse_json_string / parse_json_int cũ)
+ * - JSON builders: build_room_json, build_players_json,
+ *   build_round_results_json ở phòng 5/20/50 người
+ * - find_room_with_player (10000 session), get_random_index_except
+ * - broadcast_sse_to_room tới 1/10/50 client qua socketpair
+ *
+ * Mỗi case: tự chọn số vòng cho ~BENCH_SAMPLE_MS, chạy BENCH_SAMPLES lần,
+ * lấy median ns/op. stdout là JSON lines (một dòng mỗi case) để lưu và so
+ * sánh trước/sau một thay đổi; bảng dễ đọc in ra stderr.
+ *
+ * Chạy:
+ *   make bench                                     (hoặc bin/server_bench)
+ *   bin/server_bench > before.jsonl
+ *   bin/server_bench --baseline before.jsonl > after.jsonl
+ *   bin/server_bench --filter build_room
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "../include/game.h"
+#include "../include/room_helpers.h"
+#include "../include/room_directory.h"
+#include "../include/json_parse.h"
+#include "../include/json_writer.h"
+
+#define BENCH_SAMPLES       7
+#define BENCH_SAMPLE_MS     40
+#define BENCH_MAX_BASELINE  256
+#define LOOKUP_ROOMS        500
+#define LOOKUP_PLAYERS      20
+#define BROADCAST_BUDGET    65536       // Byte mỗi client giữa hai lần drain (dưới SSE_QUEUE_MAX_BYTES)
+
+// Globals của main.c (bench không link main.c)
+SSE_Client sse_clients[MAX_CLIENTS];
+ProfiledMutex clients_mutex = PROFILED_MUTEX_INITIALIZER("clients_mutex");
+int next_session_id = 1;
+
+/* ============================================================================
+ *                           HARNESS
+ * ============================================================================ */
+
+/**
+ * Chạy iters lần, trả về ns đo được (hàm tự bấm giờ để loại phần setup)
+ */
+typedef uint64_t (*BenchFn)(void *ctx, long iters);
+
+typedef struct {
+    char key[128];                      // "name|case"
+    double ns_per_op;
+} BaselineEntry;
+
+static const char *filter = NULL;
+static BaselineEntry baseline[BENCH_MAX_BASELINE];
+static int baseline_count = 0;
+static volatile uint64_t sink;          // Chặn compiler bỏ vòng lặp
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static const BaselineEntry *find_baseline(const char *key) {
+    for (int i = 0; i < baseline_count; i++) {
+        if (strcmp(baseline[i].key, key) == 0) return &baseline[i];
+    }
+    return NULL;
+}
+
+/**
+ * Đọc file JSON lines của lần chạy trước: chỉ cần name, case, ns_per_op
+ */
+static int load_baseline(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), file) && baseline_count < BENCH_MAX_BASELINE) {
+        char name[64], bench_case[64];
+        const char *n = strstr(line, "\"name\":\"");
+        const char *c = strstr(line, "\"case\":\"");
+        const char *v = strstr(line, "\"ns_per_op\":");
+        if (!n || !c || !v) continue;
+        if (sscanf(n + 8, "%63[^\"]", name) != 1 || sscanf(c + 8, "%63[^\"]", bench_case) != 1) continue;
+        BaselineEntry *e = &baseline[baseline_count++];
+        snprintf(e->key, sizeof(e->key), "%s|%s", name, bench_case);
+        e->ns_per_op = atof(v + 12);
+    }
+    fclose(file);
+    return 0;
+}
+
+static void bench_run(const char *name, const char *bench_case, BenchFn fn, void *ctx) {
+    if (filter && !strstr(name, filter)) return;
+
+    // Tăng gấp đôi số vòng tới khi một lần chạy đủ 1/4 thời gian mẫu
+    long iters = 1;
+    uint64_t elapsed = fn(ctx, iters);
+    while (elapsed < BENCH_SAMPLE_MS * 250000ULL && iters < (1L << 30)) {
+        iters *= 2;
+        elapsed = fn(ctx, iters);
+    }
+    iters = (long)((double)iters * (BENCH_SAMPLE_MS * 1e6) / (double)(elapsed ? elapsed : 1));
+    if (iters < 1) iters = 1;
+
+    double samples[BENCH_SAMPLES];
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        samples[s] = (double)fn(ctx, iters) / (double)iters;
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(double), cmp_double);
+    double median = samples[BENCH_SAMPLES / 2];
+
+    char key[128];
+    snprintf(key, sizeof(key), "%s|%s", name, bench_case);
+    const BaselineEntry *base = find_baseline(key);
+
+    printf("{\"name\":\"%s\",\"case\":\"%s\",\"iterations\":%ld,\"samples\":%d,"
+           "\"ns_per_op\":%.2f,\"min_ns_per_op\":%.2f,\"max_ns_per_op\":%.2f",
+           name, bench_case, iters, BENCH_SAMPLES, median, samples[0], samples[BENCH_SAMPLES - 1]);
+    if (base) {
+        printf(",\"baseline_ns_per_op\":%.2f,\"change_pct\":%.1f",
+               base->ns_per_op, (median - base->ns_per_op) * 100.0 / base->ns_per_op);
+    }
+    printf("}\n");
+    fflush(stdout);
+
+    fprintf(stderr, "%-26s %-22s %12.1f %12.1f %12.1f", name, bench_case, median,
+            samples[0], samples[BENCH_SAMPLES - 1]);
+    if (base) {
+        fprintf(stderr, "   %+7.1f%% vs %.1f", (median - base->ns_per_op) * 100.0 / base->ns_per_op,
+                base->ns_per_op);
+    }
+    fprintf(stderr, "\n");
+}
+
+/* ============================================================================
+ *                           REQUEST PARSING
+ * ============================================================================ */
+
+static const char choice_request[] =
+    "POST /rooms/choice HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0\r\n"
+    "Accept: */*\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Content-Type: application/json\r\n"
+    "Origin: http://localhost:3000\r\n"
+    "Referer: http://localhost:3000/\r\n"
+    "X-Session-ID: 12345\r\n"
+    "Content-Length: 35\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "{\"choice\":1,\"response_time\":1234}";
+
+static const char list_request[] =
+    "GET /rooms?status=waiting&limit=20 HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "Accept: application/json\r\n"
+    "\r\n";
+
+static uint64_t run_parse_http_request(void *ctx, long iters) {
+    const char *request = ctx;
+    size_t len = strlen(request);
+    char buffer[BUFFER_SIZE];
+    HttpRequest req;
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        memcpy(buffer, request, len + 1);       // Router sửa path tại chỗ ('?' -> '\0')
+        parse_http_request(buffer, &req);
+        sink += (uint64_t)req.session_id + (uint64_t)metrics_match_route(req.method, req.path);
+    }
+    return metrics_now_ns() - start;
+}
+
+static uint64_t run_get_session(void *ctx, long iters) {
+    (void)ctx;
+    char buffer[sizeof(choice_request)];
+    memcpy(buffer, choice_request, sizeof(choice_request));
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        sink += (uint64_t)get_session_from_request(buffer);
+    }
+    return metrics_now_ns() - start;
+}
+
+static uint64_t run_parse_body(void *ctx, long iters) {
+    const char *body = ctx;
+    size_t len = strlen(body);
+    RequestBody out;
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        sink += (uint64_t)parse_request_body(body, len, &out) + (uint64_t)out.choice;
+    }
+    return metrics_now_ns() - start;
+}
+
+/* ============================================================================
+ *                           JSON BUILDERS
+ * ============================================================================ */
+
+typedef enum { ROOM_CACHED, ROOM_ONE_CHANGED, ROOM_ALL_CHANGED } RoomChange;
+
+typedef struct {
+    GameRoom *room;
+    RoomChange change;
+} RoomCtx;
+
+/**
+ * Phòng đang chơi với n người, điểm khác nhau (leaderboard có thứ tự thật)
+ */
+static GameRoom *make_room(int n, int first_session) {
+    MUTEX_LOCK(&rooms_mutex);
+    int room_idx = create_room(first_session, "Bench Room", "Player_1", 10, 0, DIFFICULTY_RANDOM, NULL, NULL);
+    GameRoom *room = &rooms[room_idx];
+    for (int i = 1; i < n; i++) {
+        char name[PLAYER_NAME_LEN];
+        snprintf(name, sizeof(name), "Player_%d", i + 1);
+        add_player_to_room(room, first_session + i, name, 0);
+    }
+    start_room_game(room_idx);
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < n; i++) {
+            apply_player_answer(room, &room->players[i], (i + round) % 3 != 0, 500 + (i * 37) % 2000);
+        }
+        reset_round_state(room);
+    }
+    MUTEX_UNLOCK(&rooms_mutex);
+    return room;
+}
+
+static void apply_change(RoomCtx *c, long i) {
+    GameRoom *room = c->room;
+    if (c->change == ROOM_ONE_CHANGED) {
+        touch_player(room, &room->players[i % room->player_count]);
+    } else if (c->change == ROOM_ALL_CHANGED) {
+        for (int p = 0; p < room->player_count; p++) touch_player(room, &room->players[p]);
+    }
+}
+
+static uint64_t run_build_room(void *ctx, long iters) {
+    RoomCtx *c = ctx;
+    JsonWriter w;
+    jw_init(&w);
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        apply_change(c, i);
+        jw_reset(&w);
+        build_room_json(&w, c->room);
+        sink += jw_len(&w);
+    }
+    uint64_t elapsed = metrics_now_ns() - start;
+    jw_free(&w);
+    return elapsed;
+}
+
+static uint64_t run_build_players(void *ctx, long iters) {
+    RoomCtx *c = ctx;
+    JsonWriter w;
+    jw_init(&w);
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        apply_change(c, i);
+        jw_reset(&w);
+        build_players_json(&w, c->room);
+        sink += jw_len(&w);
+    }
+    uint64_t elapsed = metrics_now_ns() - start;
+    jw_free(&w);
+    return elapsed;
+}
+
+static uint64_t run_build_round_results(void *ctx, long iters) {
+    RoomCtx *c = ctx;
+    JsonWriter w;
+    jw_init(&w);
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        jw_reset(&w);
+        build_round_results_json(&w, c->room, 3, 1395, "Herman Miller Aeron Chair");
+        sink += jw_len(&w);
+    }
+    uint64_t elapsed = metrics_now_ns() - start;
+    jw_free(&w);
+    return elapsed;
+}
+
+/* ============================================================================
+ *                           LOOKUPS
+ * ============================================================================ */
+
+typedef struct {
+    int *sessions;
+    int count;
+} LookupCtx;
+
+static uint64_t run_find_room(void *ctx, long iters) {
+    LookupCtx *c = ctx;
+    int player_idx = 0;
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        sink += (uint64_t)find_room_with_player(c->sessions[i % c->count], &player_idx) + (uint64_t)player_idx;
+    }
+    return metrics_now_ns() - start;
+}
+
+static uint64_t run_random_index(void *ctx, long iters) {
+    ItemCatalog *catalog = ctx;
+    int count = item_catalog_count(catalog);
+    uint64_t start = metrics_now_ns();
+    for (long i = 0; i < iters; i++) {
+        sink += (uint64_t)get_random_index_except(catalog, (int)(i % count));
+    }
+    return metrics_now_ns() - start;
+}
+
+/* ============================================================================
+ *                           SSE BROADCAST
+ * ============================================================================ */
+
+typedef struct {
+    int room_id;
+    int clients;
+    int peers[MAX_PLAYERS_PER_ROOM];    // Đầu đọc của socketpair
+    int sessions[MAX_PLAYERS_PER_ROOM];
+    const char *json;
+} BroadcastCtx;
+
+static void drain(BroadcastCtx *c) {
+    char buf[65536];
+    for (int i = 0; i < c->clients; i++) {
+        while (recv(c->peers[i], buf, sizeof(buf), MSG_DONTWAIT) > 0) {}
+    }
+}
+
+static uint64_t run_broadcast(void *ctx, long iters) {
+    BroadcastCtx *c = ctx;
+    // Drain trước khi buffer socketpair + queue đầy (client chậm bị ngắt)
+    long per_drain = BROADCAST_BUDGET / (long)(strlen(c->json) + 8);
+    if (per_drain < 1) per_drain = 1;
+    uint64_t elapsed = 0;
+    for (long done = 0; done < iters; ) {
+        long chunk = iters - done < per_drain ? iters - done : per_drain;
+        uint64_t start = metrics_now_ns();
+        for (long i = 0; i < chunk; i++) broadcast_sse_to_room(c->room_id, c->json);
+        elapsed += metrics_now_ns() - start;
+        drain(c);                           // Không tính: client thật đọc ở process khác
+        done += chunk;
+    }
+    return elapsed;
+}
+
+/**
+ * Gắn n SSE client (socketpair) vào room_id như một lần subscribe + join
+ */
+static int setup_broadcast(BroadcastCtx *c, int room_id, int n, const char *json) {
+    c->room_id = room_id;
+    c->clients = n;
+    c->json = json;
+    for (int i = 0; i < n; i++) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) return -1;
+        c->sessions[i] = sse_register_client(pair[0]);
+        update_sse_client_room(c->sessions[i], room_id, NULL);
+        c->peers[i] = pair[1];
+    }
+    drain(c);                               // Message connected
+    return 0;
+}
+
+static void teardown_broadcast(BroadcastCtx *c) {
+    for (int i = 0; i < c->clients; i++) {
+        sse_close_session(c->sessions[i]);
+        close(c->peers[i]);
+    }
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            if (load_baseline(argv[++i]) != 0) return 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--filter NAME] [--baseline FILE.jsonl]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    log_level = LOG_LEVEL_ERROR;            // Log INFO của setup không lẫn vào kết quả
+    init_game_database();
+    init_rooms();
+    init_room_directory();
+    init_sse();
+
+    fprintf(stderr, "%d samples x ~%d ms per case, median / min / max ns per op\n\n",
+            BENCH_SAMPLES, BENCH_SAMPLE_MS);
+    fprintf(stderr, "%-26s %-22s %12s %12s %12s\n", "name", "case", "ns/op", "min", "max");
+
+    /* ----- Request parsing ----- */
+    bench_run("parse_http_request", "POST /rooms/choice", run_parse_http_request, (void *)choice_request);
+    bench_run("parse_http_request", "GET /rooms?query", run_parse_http_request, (void *)list_request);
+    bench_run("get_session_from_request", "browser headers", run_get_session, NULL);
+    bench_run("parse_request_body", "choice", run_parse_body,
+              (void *)"{\"choice\":1,\"response_time\":1234}");
+    bench_run("parse_request_body", "create", run_parse_body,
+              (void *)"{\"room_name\":\"Friday \\\"quiz\\\" night\",\"player_name\":\"Ann\",\"max_rounds\":10,"
+                      "\"difficulty\":\"ramp\",\"catalogs\":\"tech,cars\"}");
+
+    /* ----- JSON builders ----- */
+    static const int sizes[] = { 5, 20, 50 };
+    static const char *change_names[] = { "cached", "one_changed", "all_changed" };
+    int next_session = 1000;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        GameRoom *room = make_room(sizes[s], next_session);
+        next_session += sizes[s];
+        for (int change = ROOM_CACHED; change <= ROOM_ALL_CHANGED; change++) {
+            RoomCtx ctx = { room, (RoomChange)change };
+            char bench_case[64];
+            snprintf(bench_case, sizeof(bench_case), "players=%d %s", sizes[s], change_names[change]);
+            bench_run("build_room_json", bench_case, run_build_room, &ctx);
+            bench_run("build_players_json", bench_case, run_build_players, &ctx);
+        }
+        RoomCtx ctx = { room, ROOM_CACHED };
+        char bench_case[64];
+        snprintf(bench_case, sizeof(bench_case), "players=%d", sizes[s]);
+        bench_run("build_round_results_json", bench_case, run_build_round_results, &ctx);
+    }
+
+    /* ----- Lookups ----- */
+    LookupCtx lookup = { malloc(sizeof(int) * LOOKUP_ROOMS * LOOKUP_PLAYERS), 0 };
+    for (int r = 0; r < LOOKUP_ROOMS; r++) {
+        make_room(LOOKUP_PLAYERS, next_session);
+        for (int i = 0; i < LOOKUP_PLAYERS; i++) lookup.sessions[lookup.count++] = next_session + i;
+        next_session += LOOKUP_PLAYERS;
+    }
+    // Thứ tự tra cứu ngẫu nhiên (không đi tuần tự qua bảng băm)
+    for (int i = lookup.count - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = lookup.sessions[i];
+        lookup.sessions[i] = lookup.sessions[j];
+        lookup.sessions[j] = tmp;
+    }
+    char lookup_case[64];
+    snprintf(lookup_case, sizeof(lookup_case), "sessions=%d hit", lookup.count);
+    bench_run("find_room_with_player", lookup_case, run_find_room, &lookup);
+    for (int i = 0; i < lookup.count; i++) lookup.sessions[i] += 10000000;
+    snprintf(lookup_case, sizeof(lookup_case), "sessions=%d miss", lookup.count);
+    bench_run("find_room_with_player", lookup_case, run_find_room, &lookup);
+    free(lookup.sessions);
+
+    ItemCatalog *catalog = item_catalog_acquire();
+    char catalog_case[64];
+    snprintf(catalog_case, sizeof(catalog_case), "items=%d", item_catalog_count(catalog));
+    bench_run("get_random_index_except", catalog_case, run_random_index, catalog);
+    item_catalog_release(catalog);
+
+    /* ----- SSE broadcast ----- */
+    GameRoom *room = make_room(MAX_PLAYERS_PER_ROOM, next_session);
+    JsonWriter message;
+    jw_init(&message);
+    build_new_round_json(&message, room);
+    static const int fanouts[] = { 1, 10, 50 };
+    for (size_t f = 0; f < sizeof(fanouts) / sizeof(fanouts[0]); f++) {
+        BroadcastCtx ctx;
+        if (setup_broadcast(&ctx, room->id, fanouts[f], jw_str(&message)) != 0) {
+            perror("socketpair");
+            return 1;
+        }
+        char bench_case[64];
+        snprintf(bench_case, sizeof(bench_case), "clients=%d bytes=%zu", fanouts[f], jw_len(&message));
+        bench_run("broadcast_sse_to_room", bench_case, run_broadcast, &ctx);
+        teardown_broadcast(&ctx);
+    }
+    jw_free(&message);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - SESSION TABLE BENCHMARK
+ * ============================================================================
+ * File: session_table_bench.c
+ * Description: Chi phí session_table_advance() với hàng triệu game chơi đơn:
+ *              thêm game mới, trả lời game đang có (hit), bảng đầy (mỗi game
+ *              mới đẩy một game LRU ra), và throughput theo số thread
+ *
+ * Chạy: make bench-session
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/config.h"
+#include "../include/prng.h"
+#include "../include/session_table.h"
+
+#define BENCH_SESSIONS  (1 << 21)   // Game đang chơi (bảng chứa một nửa capacity)
+#define OPS_PER_THREAD  1000000
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// game_id của game thứ i (seed ngẫu nhiên như token thật)
+static uint64_t game_id(uint64_t i) {
+    return i * 0x9E3779B97F4A7C15ULL + 1;
+}
+
+static uint32_t rounds[BENCH_SESSIONS];
+static uint32_t issued;                 // issued_at của mọi token (unix time lúc chạy)
+
+/**
+ * Trả lời game ngẫu nhiên trong BENCH_SESSIONS game (mỗi thread một dải
+ * riêng để round luôn tăng, không bị tính là replay)
+ */
+static void *worker(void *arg) {
+    uintptr_t t = (uintptr_t)arg;
+    uint32_t per_thread = BENCH_SESSIONS / 8;
+    Prng rng;
+    prng_seed(&rng, t);
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        uint32_t g = (uint32_t)(t * per_thread + prng_below(&rng, per_thread));
+        if (session_table_advance(game_id(g), rounds[g]++, issued) != SESSION_OK) {
+            fprintf(stderr, "❌ Unexpected replay at op %d\n", i);
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+// ns/op tính theo mỗi thread, ops/s là tổng
+static void report(const char *label, double elapsed, double ops, int threads) {
+    printf("%-28s %10.1f ns/op %14.0f ops/s\n", label, elapsed * threads / ops, ops / (elapsed / 1e9));
+}
+
+int main(void) {
+    if (session_table_init(BENCH_SESSIONS * 2) != 0) return 1;
+    issued = (uint32_t)time(NULL);
+
+    printf("\n%d sessions, %d shards, %ld core(s)\n\n",
+           BENCH_SESSIONS, SESSION_TABLE_SHARDS, sysconf(_SC_NPROCESSORS_ONLN));
+
+    // Game mới: mỗi game một lần thêm vào bảng
+    double t0 = now_ns();
+    for (uint32_t g = 0; g < BENCH_SESSIONS; g++) {
+        session_table_advance(game_id(g), rounds[g]++, issued);
+    }
+    report("insert", now_ns() - t0, BENCH_SESSIONS, 1);
+
+    // Gửi lại token cũ: phải bị từ chối
+    int rejected = 0;
+    for (uint32_t g = 0; g < 1000; g++) {
+        rejected += session_table_advance(game_id(g), 0, issued) == SESSION_REPLAY;
+    }
+    printf("%-28s %10d / 1000\n", "replays rejected", rejected);
+
+    // Trả lời game đang có, 1..8 thread
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        pthread_t tids[8];
+        t0 = now_ns();
+        for (int t = 0; t < threads; t++) {
+            pthread_create(&tids[t], NULL, worker, (void *)(uintptr_t)t);
+        }
+        for (int t = 0; t < threads; t++) pthread_join(tids[t], NULL);
+        char label[32];
+        snprintf(label, sizeof(label), "hit, %d thread(s)", threads);
+        report(label, now_ns() - t0, (double)OPS_PER_THREAD * threads, threads);
+    }
+
+    // Bảng đầy: mỗi game mới đẩy game LRU ra
+    t0 = now_ns();
+    for (uint64_t g = BENCH_SESSIONS; g < BENCH_SESSIONS * 4ULL; g++) {
+        session_table_advance(game_id(g), 0, issued);
+    }
+    report("insert + LRU evict", now_ns() - t0, BENCH_SESSIONS * 3.0, 1);
+
+    // Game đã bị đẩy ra: token cũ không được nhận lại như game mới
+    int forgotten = 0;
+    for (uint32_t g = 0; g < 1000; g++) {
+        forgotten += session_table_advance(game_id(g), rounds[g], issued) == SESSION_FORGOTTEN;
+    }
+    printf("%-28s %10d / 1000\n", "evicted tokens rejected", forgotten);
+
+    SessionTableStats stats;
+    session_table_stats(&stats);
+    printf("\ncount %llu / %llu, evicted %llu, replays %llu, forgotten %llu\n",
+           stats.count, stats.capacity, stats.evicted, stats.replays, stats.forgotten);
+    return 0;
+}
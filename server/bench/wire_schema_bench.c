@@ -0,0 +1,164 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - WIRE SCHEMA BENCHMARK
+ * ============================================================================
+ * File: wire_schema_bench.c
+ * Description: So sánh jw_kv_* viết tay với encoder sinh từ bảng schema,
+ *              kích thước JSON / binary / delta, và kiểm tra decode binary
+ *
+ * Chạy: make bench-wire
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../include/wire_schema.h"
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * choice_result viết tay như game_handlers.c trước khi có schema
+ */
+static void handwritten_choice(JsonWriter *w, const WireChoiceResult *m) {
+    jw_object_begin(w);
+    jw_kv_str(w, "action", "choice_result");
+    jw_kv_bool(w, "correct", m->correct);
+    jw_kv_int(w, "score", m->score);
+    jw_kv_int(w, "streak", m->streak);
+    jw_kv_str(w, "message", m->message);
+    jw_kv_int(w, "valueB", m->valueB);
+    jw_kv_int(w, "waiting_for", m->waiting_for);
+    jw_kv_int(w, "response_time", m->response_time);
+    jw_object_end(w);
+}
+
+static void handwritten_player(JsonWriter *w, const WirePlayer *p) {
+    jw_object_begin(w);
+    jw_kv_int(w, "session_id", p->session_id);
+    jw_kv_str(w, "name", p->name);
+    jw_kv_int(w, "score", p->score);
+    jw_kv_int(w, "streak", p->streak);
+    jw_kv_int(w, "is_ready", p->is_ready);
+    jw_kv_int(w, "game_over", p->game_over);
+    jw_kv_int(w, "has_answered", p->has_answered);
+    jw_kv_bool(w, "is_host", p->is_host);
+    jw_object_end(w);
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+int main(void) {
+    const int iters = 1000000;
+    JsonWriter w;
+    jw_init(&w);
+    volatile size_t sink = 0;
+
+    WireChoiceResult choice = {
+        .correct = 1, .score = 1250, .streak = 7, .message = "Eiffel Tower: $1500 - Correct!",
+        .valueB = 1500, .waiting_for = 3, .response_time = 1834,
+    };
+    WirePlayer player = {
+        .session_id = 123456, .name = "Player \"one\"", .score = 900, .streak = 4,
+        .is_ready = 1, .game_over = 0, .has_answered = 1, .is_host = 0,
+    };
+
+    /* ----- JSON: viết tay vs bảng ----- */
+    printf("%-14s %12s %12s\n", "message", "handwrit_ns", "schema_ns");
+
+    double t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        jw_reset(&w);
+        handwritten_choice(&w, &choice);
+        sink += jw_len(&w);
+    }
+    double hand_ns = (now_ns() - t0) / iters;
+    char hand_out[512];
+    snprintf(hand_out, sizeof(hand_out), "%s", jw_str(&w));
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        jw_reset(&w);
+        wire_json_object(&w, WIRE_SCHEMA(CHOICE_RESULT), &choice);
+        sink += jw_len(&w);
+    }
+    double schema_ns = (now_ns() - t0) / iters;
+    printf("%-14s %12.1f %12.1f\n", "choice_result", hand_ns, schema_ns);
+    if (strcmp(hand_out, jw_str(&w)) != 0) {
+        fprintf(stderr, "❌ Output mismatch:\n  %s\n  %s\n", hand_out, jw_str(&w));
+        return 1;
+    }
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        jw_reset(&w);
+        handwritten_player(&w, &player);
+        sink += jw_len(&w);
+    }
+    hand_ns = (now_ns() - t0) / iters;
+    snprintf(hand_out, sizeof(hand_out), "%s", jw_str(&w));
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        jw_reset(&w);
+        wire_json_object(&w, WIRE_SCHEMA(PLAYER), &player);
+        sink += jw_len(&w);
+    }
+    schema_ns = (now_ns() - t0) / iters;
+    printf("%-14s %12.1f %12.1f\n", "player", hand_ns, schema_ns);
+    if (strcmp(hand_out, jw_str(&w)) != 0) {
+        fprintf(stderr, "❌ Output mismatch:\n  %s\n  %s\n", hand_out, jw_str(&w));
+        return 1;
+    }
+
+    /* ----- Kích thước + decode binary ----- */
+    size_t json_bytes = jw_len(&w);
+    unsigned char bin[256];
+    size_t bin_bytes = wire_binary_encode(WIRE_SCHEMA(PLAYER), &player, bin, sizeof(bin));
+
+    WirePlayer decoded;
+    char strings[128];
+    if (wire_binary_decode(WIRE_SCHEMA(PLAYER), bin, bin_bytes, 0, &decoded, strings, sizeof(strings)) != 0 ||
+        wire_delta_count(WIRE_SCHEMA(PLAYER), &player, &decoded) != 0) {
+        fprintf(stderr, "❌ Binary round trip failed\n");
+        return 1;
+    }
+
+    // Delta điển hình sau một câu trả lời: score, streak, has_answered đổi
+    WirePlayer after = player;
+    after.score += 100;
+    after.streak++;
+    after.has_answered = 0;
+    unsigned char delta[256];
+    size_t delta_bytes = wire_binary_delta(WIRE_SCHEMA(PLAYER), &player, &after, delta, sizeof(delta));
+
+    jw_reset(&w);
+    wire_json_delta(&w, WIRE_SCHEMA(PLAYER), &player, &after);
+    size_t json_delta_bytes = jw_len(&w);
+
+    if (wire_binary_decode(WIRE_SCHEMA(PLAYER), delta, delta_bytes, 1, &decoded, strings, sizeof(strings)) != 0 ||
+        wire_delta_count(WIRE_SCHEMA(PLAYER), &after, &decoded) != 0) {
+        fprintf(stderr, "❌ Delta round trip failed\n");
+        return 1;
+    }
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        sink += wire_binary_encode(WIRE_SCHEMA(PLAYER), &player, bin, sizeof(bin));
+    }
+    double bin_ns = (now_ns() - t0) / iters;
+    (void)sink;
+
+    printf("\nplayer bytes: json=%zu binary=%zu json_delta=%zu binary_delta=%zu\n",
+           json_bytes, bin_bytes, json_delta_bytes, delta_bytes);
+    printf("player binary encode: %.1f ns\n", bin_ns);
+
+    jw_free(&w);
+    return 0;
+}
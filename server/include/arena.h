@@ -0,0 +1,45 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ARENA MODE
+ * ============================================================================
+ * File: arena.h
+ * Description: Arena rooms (hàng chục nghìn người chơi): broadcast thống kê
+ *              tổng hợp + top K thay vì toàn bộ danh sách players
+ * ============================================================================
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "types.h"
+#include "json_writer.h"
+
+/* ============================================================================
+ *                           JSON BUILDERS
+ * ============================================================================ */
+
+/**
+ * Build phần đầu message round_results của arena (object để mở, KHÔNG có dấu } cuối)
+ * 
+ * Gồm thống kê tổng hợp, top ARENA_TOP_K và leaderboard;
+ * broadcast_sse_to_room_ranked() nối thêm my_rank/my_score cho từng người nhận.
+ */
+void build_arena_round_results_prefix(JsonWriter *w, GameRoom *room, int round, int valueB,
+                                      const char *labelB);
+
+/**
+ * Build chi tiết một player trong phòng (GET /rooms/player)
+ */
+void build_arena_player_json(JsonWriter *w, GameRoom *room, int player_idx);
+
+/* ============================================================================
+ *                           ROUND DEADLINE
+ * ============================================================================ */
+
+/**
+ * Chạy thread đóng round arena quá ARENA_ROUND_DEADLINE_MS
+ * (một người chơi bỏ đi không làm cả phòng đứng im)
+ */
+void init_arena_timer(void);
+
+#endif // ARENA_H
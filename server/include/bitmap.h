@@ -0,0 +1,132 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - COMPRESSED BITMAP
+ * ============================================================================
+ * File: bitmap.h
+ * Description: Bitmap nén kiểu roaring cho tập index item
+ *
+ * Không gian 32-bit được chia thành chunk 65536 giá trị theo 16 bit cao.
+ * Mỗi chunk là một trong hai dạng:
+ *   - ARRAY: mảng uint16 đã sắp, khi chunk có <= BITMAP_ARRAY_MAX phần tử
+ *   - BITS:  1024 word 64-bit (8 KB), khi chunk dày hơn
+ *
+ * Tag hiếm tốn 2 byte mỗi item, tag phổ biến / khoảng catalog tốn tối đa
+ * 1 bit mỗi item. AND/OR đi theo từng cặp chunk cùng key, không giải nén.
+ *
+ * Bitmap được build bằng append tăng dần (bitmap_add, bitmap_add_range)
+ * hoặc là kết quả của AND/OR. bitmap_select / bitmap_rank dùng rank cộng
+ * dồn của từng chunk: O(log số chunk) + quét trong chunk.
+ * ============================================================================
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BITMAP_ARRAY_MAX    4096    // ARRAY lớn hơn mức này tốn hơn BITS
+#define BITMAP_WORDS        1024    // 65536 bit / 64
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef enum {
+    BITMAP_ARRAY = 0,
+    BITMAP_BITS
+} BitmapChunkKind;
+
+/**
+ * BitmapChunk - 65536 giá trị có cùng 16 bit cao
+ */
+typedef struct {
+    uint16_t key;                   // 16 bit cao
+    uint16_t kind;                  // BitmapChunkKind
+    uint32_t cardinality;
+    uint32_t cap;                   // Sức chứa của array (ARRAY)
+    uint64_t rank;                  // Số phần tử ở các chunk trước
+    union {
+        uint16_t *array;
+        uint64_t *bits;
+    } data;
+} BitmapChunk;
+
+typedef struct {
+    BitmapChunk *chunks;            // Sắp theo key
+    int count;
+    int cap;
+    uint64_t cardinality;
+    uint32_t max;                   // Phần tử lớn nhất (khi cardinality > 0)
+} Bitmap;
+
+/* ============================================================================
+ *                           BUILD
+ * ============================================================================ */
+
+void bitmap_init(Bitmap *b);
+void bitmap_free(Bitmap *b);
+
+/**
+ * Thêm value lớn hơn mọi phần tử hiện có (append tăng dần)
+ *
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ hoặc value không tăng
+ */
+int bitmap_add(Bitmap *b, uint32_t value);
+
+/**
+ * Thêm khoảng [first, last) nằm sau mọi phần tử hiện có
+ *
+ * Chunk phủ kín được điền thẳng dạng BITS, không thêm từng phần tử.
+ */
+int bitmap_add_range(Bitmap *b, uint32_t first, uint32_t last);
+
+/**
+ * Thêm mọi phần tử của src cộng offset (offset + min(src) phải lớn hơn
+ * mọi phần tử hiện có của dst)
+ */
+int bitmap_append_shifted(Bitmap *dst, const Bitmap *src, uint32_t offset);
+
+/* ============================================================================
+ *                           SET OPERATIONS
+ * ============================================================================ */
+
+/**
+ * out = a AND b / a OR b (out phải khác a và b, được init lại)
+ *
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ (out rỗng)
+ */
+int bitmap_and(Bitmap *out, const Bitmap *a, const Bitmap *b);
+int bitmap_or(Bitmap *out, const Bitmap *a, const Bitmap *b);
+
+/**
+ * Copy độc lập (out được init lại)
+ */
+int bitmap_copy(Bitmap *out, const Bitmap *src);
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+static inline uint64_t bitmap_cardinality(const Bitmap *b) {
+    return b->cardinality;
+}
+
+int bitmap_contains(const Bitmap *b, uint32_t value);
+
+/**
+ * Phần tử thứ rank (đếm từ 0) theo thứ tự tăng dần, rank < cardinality
+ */
+uint32_t bitmap_select(const Bitmap *b, uint64_t rank);
+
+/**
+ * Số phần tử nhỏ hơn value
+ */
+uint64_t bitmap_rank(const Bitmap *b, uint32_t value);
+
+/**
+ * Số byte đã cấp phát (để log / thống kê)
+ */
+size_t bitmap_memory(const Bitmap *b);
+
+#endif // BITMAP_H
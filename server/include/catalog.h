@@ -0,0 +1,180 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - BINARY ITEM CATALOG
+ * ============================================================================
+ * File: catalog.h
+ * Description: Định dạng file catalog nhị phân + builder + mmap loader
+ *
+ * items.txt (name|value|image_url|tags) được biên dịch sẵn thành data/items.bin
+ * bằng tools/catalog_compile (make catalog). Server mmap file này lúc khởi
+ * động, không parse text và không chép item: file giữ map suốt đời phiên
+ * bản catalog (ItemStore trong item_store.h chỉ là view), page được chia
+ * sẻ giữa các process map cùng file.
+ *
+ * Layout (little-endian, theo byte order của máy build):
+ *
+ *   CatalogHeader                      56 byte
+ *   int32 values[item_count]           mảng value hot liền mạch
+ *   CatalogRecord[item_count]          16 byte mỗi item (offset table)
+ *   string heap                        name/image_url/tags kết thúc bằng '\0'
+ *
+ * Byte đầu của heap luôn là '\0': offset 0 là chuỗi rỗng (item không tag).
+ * Chuỗi trùng (tên, URL ảnh, danh sách tag) chỉ lưu một lần trong heap.
+ *
+ * Không có items.bin (hoặc cũ hơn items.txt) thì server build cùng layout
+ * này trong bộ nhớ từ items.txt, nên mọi chỗ đọc item chỉ có một đường.
+ * ============================================================================
+ */
+
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+/* ============================================================================
+ *                           FILE FORMAT
+ * ============================================================================ */
+
+#define CATALOG_MAGIC       "HLCATLG"       // 7 ký tự + '\0' = 8 byte
+#define CATALOG_VERSION     3               // 2: thêm tags_offset, 3: values + fingerprint
+
+/**
+ * CatalogHeader - Đầu file
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t item_count;
+    uint64_t records_offset;        // Từ đầu file
+    uint64_t strings_offset;        // Từ đầu file
+    uint64_t strings_size;          // Byte cuối của heap luôn là '\0'
+    uint64_t values_offset;         // Từ đầu file, căn 4 byte
+    uint32_t fingerprint;           // catalog_fingerprint() của values
+    uint32_t reserved;
+} CatalogHeader;
+
+/**
+ * CatalogRecord - Một item; offset tính từ đầu string heap
+ */
+typedef struct {
+    uint32_t name_offset;
+    uint32_t image_offset;
+    int32_t value;
+    uint32_t tags_offset;           // "tag1,tag2", 0 = không có tag
+} CatalogRecord;
+
+/* ============================================================================
+ *                           CATALOG (READ SIDE)
+ * ============================================================================ */
+
+/**
+ * Catalog - Vùng nhớ chứa file catalog (mmap hoặc malloc)
+ */
+typedef struct {
+    void *base;
+    size_t size;
+    int mapped;                     // 1 = mmap (munmap khi đóng), 0 = malloc
+    const int32_t *values;          // Hot: chấm điểm / chọn cặp chỉ đọc mảng này
+    const CatalogRecord *records;
+    const char *strings;
+    uint64_t strings_size;
+    uint32_t count;
+    uint32_t fingerprint;
+} Catalog;
+
+/**
+ * mmap file catalog (read-only, MAP_SHARED) và kiểm tra header
+ *
+ * @return 0 nếu thành công, -1 nếu không mở được / sai magic, version, kích thước
+ */
+int catalog_open(Catalog *c, const char *path);
+
+/**
+ * Dùng buffer đã build trong bộ nhớ (nhận quyền sở hữu buffer, free khi đóng)
+ *
+ * @return 0 nếu hợp lệ, -1 nếu không (buffer vẫn được free)
+ */
+int catalog_from_buffer(Catalog *c, void *buf, size_t size);
+
+void catalog_close(Catalog *c);
+
+/**
+ * Hash FNV-1a của count + values theo thứ tự (ghi sẵn trong header)
+ */
+uint32_t catalog_fingerprint(const int32_t *values, uint32_t count);
+
+/**
+ * View của item thứ index (con trỏ trỏ thẳng vào catalog, không copy)
+ *
+ * Offset hỏng trong file cho ra chuỗi rỗng thay vì đọc ra ngoài vùng map.
+ */
+static inline GameItem catalog_item(const Catalog *c, uint32_t index) {
+    const CatalogRecord *r = &c->records[index];
+    GameItem item;
+    item.name = r->name_offset < c->strings_size ? c->strings + r->name_offset : "";
+    item.value = c->values[index];
+    item.image_url = r->image_offset < c->strings_size ? c->strings + r->image_offset : "";
+    return item;
+}
+
+/**
+ * Chuỗi tag "tag1,tag2" của item ("" nếu không có)
+ */
+static inline const char *catalog_item_tags(const Catalog *c, uint32_t index) {
+    uint32_t offset = c->records[index].tags_offset;
+    return offset < c->strings_size ? c->strings + offset : "";
+}
+
+/* ============================================================================
+ *                           BUILDER (WRITE SIDE)
+ * ============================================================================ */
+
+/**
+ * CatalogBuilder - Gom item rồi xuất ra đúng layout file
+ *
+ * interned là bảng băm mở (offset + 1, 0 = trống) trên string heap: chuỗi
+ * đã có trong heap được dùng lại offset thay vì chép thêm.
+ */
+typedef struct {
+    CatalogRecord *records;
+    size_t count;
+    size_t cap;
+    char *strings;
+    size_t strings_len;
+    size_t strings_cap;
+    uint32_t *interned;
+    size_t interned_count;
+    size_t interned_cap;            // Luỹ thừa của 2
+} CatalogBuilder;
+
+void catalog_builder_init(CatalogBuilder *b);
+void catalog_builder_free(CatalogBuilder *b);
+
+/**
+ * Thêm một item
+ *
+ * @param tags "tag1,tag2" hoặc NULL / "" nếu không có
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ hoặc heap vượt 4GB
+ */
+int catalog_builder_add(CatalogBuilder *b, const char *name, int value, const char *image_url,
+                        const char *tags);
+
+/**
+ * Đọc file text name|value|image_url[|tags] (bỏ qua dòng trống và dòng #)
+ *
+ * @param skipped Số dòng sai định dạng bị bỏ qua (có thể NULL)
+ * @return Số item đã thêm, -1 nếu lỗi bộ nhớ
+ */
+long catalog_builder_add_text(CatalogBuilder *b, FILE *file, long *skipped);
+
+/**
+ * Xuất header + values + offset table + heap thành một buffer malloc
+ *
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ
+ */
+int catalog_builder_finish(CatalogBuilder *b, void **out, size_t *out_size);
+
+#endif // CATALOG_H
@@ -15,30 +15,153 @@
  * ============================================================================ */
 #define SERVER_PORT         8080
 #define PORT                SERVER_PORT     // Alias for backward compatibility
-#define MAX_CLIENTS         100
+#define MAX_CLIENTS         32768       // Max SSE connections (arena cần hàng chục nghìn)
 #define BUFFER_SIZE         8192
 #define RESPONSE_SIZE       16384       // Larger buffer for JSON responses
-#define BACKLOG             10          // Max pending connections
+#define BACKLOG             1024        // Max pending connections
+
+/* ============================================================================
+ *                           SSE CONFIG
+ * ============================================================================ */
+#define SSE_QUEUE_MAX_BYTES     65536   // Byte chờ gửi tối đa mỗi client, vượt thì ngắt client chậm
+#define SSE_SESSION_BUCKETS     65536   // Bảng băm session -> slot, lũy thừa của 2
+#define SSE_ROOM_BUCKETS        8192    // Danh sách người nhận theo room id, lũy thừa của 2
 
 /* ============================================================================
  *                           ROOM CONFIG
  * ============================================================================ */
-#define MAX_ROOMS           20
+#define MAX_ROOMS           4096
 #define MAX_PLAYERS_PER_ROOM 50
+#define MAX_ROUNDS_PER_GAME 50          // max_rounds bị giới hạn trong [5, 50]
 #define ROOM_NAME_LEN       64
 #define PLAYER_NAME_LEN     32
 
+/* ============================================================================
+ *                           LOGGER CONFIG
+ * ============================================================================ */
+#define LOG_LEVEL_ENV           "GAME_LOG_LEVEL"  // debug | info | warn | error | off (mặc định info)
+#define LOG_FILE_ENV            "GAME_LOG_FILE"   // Append vào file này thay cho stdout
+#define LOG_RINGS               8       // Số ring, mỗi thread ghi vào một ring cố định
+#define LOG_RING_SIZE           1024    // Dòng chờ mỗi ring (lũy thừa của 2), đầy thì bỏ
+#define LOG_TAG_LEN             16
+#define LOG_MSG_LEN             220     // Message dài hơn bị cắt (slot = 256 byte)
+#define LOG_DRAIN_INTERVAL_MS   10      // Drainer ngủ bấy lâu khi mọi ring rỗng
+
+/* ============================================================================
+ *                           METRICS CONFIG
+ * ============================================================================ */
+#define METRIC_SHARDS           16      // Counter/histogram chia shard, mỗi thread ghi một shard
+
+/* ============================================================================
+ *                           ADMIN ENDPOINT CONFIG
+ * ============================================================================ */
+#define ADMIN_TOKEN_ENV         "GAME_ADMIN_TOKEN"  // "Authorization: Bearer <token>" cho /metrics, /locks, /trace (không đặt = chỉ loopback)
+#define ADMIN_TOKEN_MAX         128     // Token dài hơn bị bỏ qua (vẫn chỉ loopback)
+
+/* ============================================================================
+ *                           TRACE CONFIG
+ * ============================================================================ */
+#define TRACE_SAMPLE_ENV        "GAME_TRACE_SAMPLE"  // Trace 1 trên N request (0 = tắt, mặc định)
+#define TRACE_FILE_ENV          "GAME_TRACE_FILE"    // File dump khi nhận SIGUSR2
+#define TRACE_FILE_DEFAULT      "trace.json"
+#define TRACE_BUFFERS           16      // Số ring span, mỗi thread ghi vào một ring cố định
+#define TRACE_BUFFER_SPANS      4096    // Span mỗi ring (lũy thừa của 2), đầy thì ghi đè span cũ nhất
+
+/* ============================================================================
+ *                           LOCK PROFILING CONFIG
+ * ============================================================================ */
+#define LOCK_SITES              256     // Call site lock theo dõi (lũy thừa của 2), thừa thì bỏ qua
+#define LOCK_REGISTRY           16      // Số ProfiledMutex tối đa trên /metrics, /locks
+#define LOCK_TOP_N              10      // Mặc định của GET /locks?limit=N
+
+/* ============================================================================
+ *                           TRAFFIC RECORDER CONFIG
+ * ============================================================================ */
+#define RECORD_FILE_ENV         "GAME_RECORD_FILE"  // Ghi mọi request vào file này (không đặt = tắt)
+#define RECORD_FLUSH_MS         100     // Buffer stdio được flush sau tối đa bấy lâu
+
+/* ============================================================================
+ *                           LOBBY STREAM CONFIG
+ * ============================================================================ */
+#define LOBBY_FLUSH_INTERVAL_MS 100     // Chu kỳ gộp & broadcast lobby events
+
+/* ============================================================================
+ *                           ROOM DIRECTORY CONFIG
+ * ============================================================================ */
+#define ROOM_LIST_DEFAULT_LIMIT 20      // Số phòng mỗi trang GET /rooms mặc định
+#define ROOM_LIST_MAX_LIMIT     50      // Giới hạn trên của ?limit=
+
+/* ============================================================================
+ *                           ARENA CONFIG
+ * ============================================================================ */
+#define ARENA_MAX_PLAYERS       30000   // Số người chơi tối đa của phòng arena
+#define ARENA_TOP_K             10      // Số người đứng đầu gửi kèm mỗi broadcast
+#define SESSION_INDEX_SIZE      262144  // Bảng băm session -> (room, player), lũy thừa của 2
+#define ARENA_ROUND_DEADLINE_MS 20000   // Round arena đóng sau bấy lâu dù còn người chưa trả lời
+#define ARENA_TICK_MS           100     // Chu kỳ kiểm tra hạn round arena
+
+/* ============================================================================
+ *                           MATCHMAKING CONFIG
+ * ============================================================================ */
+#define MATCH_TARGET_PLAYERS    8       // Đủ số này là tạo phòng ngay
+#define MATCH_MIN_PLAYERS       2       // Tối thiểu để tạo phòng khi hết hạn chờ
+#define MATCH_MAX_WAIT_MS       5000    // Hạn chờ trước khi ghép với ít người hơn
+#define MATCH_TICK_MS           100     // Chu kỳ chạy matcher
+#define MATCH_STATS_SAMPLES     1024    // Số mẫu time-to-match giữ lại
+
+/* ============================================================================
+ *                           LEADERBOARD CONFIG
+ * ============================================================================ */
+#define LEADERBOARD_FILE        "data/leaderboard.log"  // Append-only log kết quả game
+#define LEADERBOARD_QUEUE_SIZE  65536   // Record chờ ghi tối đa (đầy thì bỏ, không chặn game)
+#define LEADERBOARD_DEFAULT_LIMIT 10    // Top N mặc định của GET /leaderboard
+#define LEADERBOARD_MAX_LIMIT   50      // Giới hạn trên của ?limit=
+
+/* ============================================================================
+ *                           JSON WRITER CONFIG
+ * ============================================================================ */
+#define JW_INITIAL_CAP          4096    // Dung lượng đầu của buffer JSON
+#define JW_POOL_SIZE            64      // Số buffer giữ lại để tái sử dụng
+#define JW_POOL_MAX_CAP         (1 << 20)  // Buffer lớn hơn mức này được free, không giữ
+
 /* ============================================================================
  *                           GAME CONFIG
  * ============================================================================ */
-#define MAX_ITEMS           100         // Max number of items in database
 #define SCORE_PER_CORRECT   10          // Points for correct answer
+#define MAX_RESPONSE_TIME_MS 60000      // Response time tối đa tính vào xếp hạng
+#define LEADERBOARD_TOP_K   10          // Số người trong "leaderboard" của round_results/game_finished
 #define ITEMS_FILE          "data/items.txt"  // Path to items data file
+#define ITEMS_CATALOG_FILE  "data/items.bin"  // Catalog nhị phân (make catalog), ưu tiên hơn items.txt
+#define CATALOGS_DIR        "data/catalogs"   // <name>.bin|.txt: nhiều catalog có tên, thay cho items.*
+#define CATALOG_NAME_LEN    32          // Tên catalog (tên file bỏ đuôi)
+#define CATALOG_LOAD_THREADS 16         // Số thread load catalog song song tối đa
+#define TAG_NAME_LEN        32          // Tag dài hơn bị bỏ qua
+#define ROOM_FILTER_LEN     256         // "catalogs" / "tags" của phòng (danh sách cách nhau bởi dấu phẩy)
+#define CATALOG_RELOAD_DEBOUNCE_MS 200  // Chờ file ngừng đổi bấy lâu rồi mới reload
+#define ROOM_DECK_MAX       1024        // Số lá tối đa mỗi bộ item của phòng (hết thì rút bộ mới)
+#define DECK_FULL_SHUFFLE_LIMIT 65536   // Catalog nhỏ hơn: xáo cả mảng; lớn hơn: lấy mẫu Floyd
+
+/* ============================================================================
+ *                           SINGLE PLAYER CONFIG
+ * ============================================================================ */
+// State của game chơi đơn nằm trong token ký MAC; server chỉ nhớ round mới nhất mỗi game
+#define GAME_TOKEN_KEY_ENV      "GAME_TOKEN_KEY"  // 32 ký tự hex, giống nhau trên mọi process
+#define GAME_TOKEN_LEN          96      // Token base64url (hiện dùng 60 ký tự)
+#define GAME_TOKEN_TTL_SEC      3600    // Token không dùng quá lâu thì hết hạn
+#define SESSION_TABLE_CAPACITY  (1 << 22)  // Số game nhớ round để chặn token cũ (~32 byte / game)
+#define SESSION_TABLE_SHARDS    64      // Mỗi shard một mutex, lũy thừa của 2
+#define SESSION_IDLE_SEC        (GAME_TOKEN_TTL_SEC + 60)  // Bỏ game idle chỉ khi mọi token của nó đã hết hạn
 
 /* ============================================================================
- *                           STRING LIMITS
+ *                           DIFFICULTY CONFIG
  * ============================================================================ */
-#define ITEM_NAME_LEN       64
-#define IMAGE_URL_LEN       256
+// Phòng "ramp": khoảng tỉ lệ max(vA, vB) / min(vA, vB) đi từ EASY (round 1)
+// đến HARD (round cuối) tuyến tính theo current_round
+#define DIFFICULTY_NAME_LEN     16
+#define DIFFICULTY_EASY_MIN_RATIO 4.0   // Round đầu: một item đắt gấp 4..50 lần item kia
+#define DIFFICULTY_EASY_MAX_RATIO 50.0
+#define DIFFICULTY_HARD_MIN_RATIO 1.05  // Round cuối: chỉ chênh 5%..25%
+#define DIFFICULTY_HARD_MAX_RATIO 1.25
+#define DIFFICULTY_RAMP_ROUNDS  20      // Game không giới hạn round: khó nhất từ round này
 
 #endif // CONFIG_H
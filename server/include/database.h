@@ -10,16 +10,31 @@
 #ifndef DATABASE_H
 #define DATABASE_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "types.h"
+#include "bitmap.h"
 
 /* ============================================================================
- *                           GLOBAL VARIABLES
+ *                           STRUCTURES
  * ============================================================================ */
 
-// Database lưu trữ tất cả game items
-extern GameItem game_database[MAX_ITEMS];
+/**
+ * ItemCatalogStats - Thống kê hot reload
+ */
+typedef struct {
+    unsigned int generation;            // Phiên bản đang publish (1 = lúc khởi động)
+    int item_count;
+    unsigned long reloads;              // Số lần reload thành công
+    unsigned long failures;             // Số lần reload lỗi (giữ bản cũ)
+    double last_reload_ms;              // Thời gian build + publish lần gần nhất
+} ItemCatalogStats;
 
-// Số lượng items trong database
+/* ============================================================================
+ *                           GLOBAL VARIABLES
+ * ============================================================================ */
+
+// Số lượng items của catalog đang publish (chỉ để hiển thị)
 extern int item_count;
 
 /* ============================================================================
@@ -29,16 +44,89 @@ extern int item_count;
 /**
  * Khởi tạo game database
  * 
- * Load hoặc tạo danh sách items cho game
+ * mmap data/items.bin, hoặc build catalog từ data/items.txt nếu không có
  */
 void init_game_database(void);
 
+/**
+ * Chạy watcher thread: file catalog trong data/ đổi thì build bản mới và
+ * publish bằng cách đổi con trỏ (không chặn request đang xử lý)
+ */
+void init_catalog_watcher(void);
+
+/**
+ * Lấy reference đến catalog đang publish (phải item_catalog_release sau khi dùng)
+ * 
+ * Phòng giữ reference suốt game để index A/B luôn trỏ đúng catalog.
+ */
+ItemCatalog *item_catalog_acquire(void);
+
+/**
+ * Trả reference; reference cuối cùng unmap/free catalog (NULL được bỏ qua)
+ */
+void item_catalog_release(ItemCatalog *catalog);
+
+/**
+ * Số item trong catalog (0 nếu NULL)
+ */
+int item_catalog_count(const ItemCatalog *catalog);
+
+/**
+ * View item theo index, hợp lệ khi còn giữ reference (index sai => item rỗng)
+ */
+GameItem item_catalog_get(const ItemCatalog *catalog, int index);
+
+/**
+ * Fingerprint của catalog (value + thứ tự item): index chỉ còn đúng khi
+ * fingerprint không đổi, kể cả giữa các process (token chơi đơn)
+ */
+uint32_t item_catalog_fingerprint(const ItemCatalog *catalog);
+
+/**
+ * Chỉ value của item (mảng hot, không chạm chuỗi) - dùng khi chấm điểm
+ * (index sai => 0)
+ */
+int item_catalog_value(const ItemCatalog *catalog, int index);
+
+/**
+ * Chọn item B có max(vA, vB) / min(vA, vB) trong [lo, hi], O(log n)
+ * 
+ * @param rng PRNG của phòng (giữ game replay được theo seed)
+ * @param filter Tập item của phòng (NULL = mọi item)
+ * @return Index khác index_a, -1 nếu không có ứng viên (caller tự fallback)
+ */
+int item_catalog_pick_ratio(const ItemCatalog *catalog, Prng *rng, const Bitmap *filter,
+                            int index_a, double lo, double hi);
+
+/**
+ * Tập item ứng viên: OR các catalog được chọn, AND các tag
+ * 
+ * @param catalogs Tên catalog "tech,cars" ("" = mọi catalog)
+ * @param tags Tên tag "apple,phone" ("" = không lọc theo tag)
+ * @param out Bitmap index chung (được init, caller bitmap_free)
+ * @param error Thông báo lỗi khi trả về khác 0
+ * @return 0 nếu thành công, -1 nếu tên catalog/tag không có, -2 nếu hết bộ nhớ
+ */
+int item_catalog_filter(const ItemCatalog *catalog, const char *catalogs, const char *tags,
+                        Bitmap *out, char *error, size_t error_len);
+
+/**
+ * Đọc thống kê reload
+ */
+void item_catalog_stats(ItemCatalogStats *out);
+
+/**
+ * GET /catalogs - Tên catalog, số item, tag và số item mỗi tag
+ */
+void handle_get_catalogs(int sock);
+
 /**
  * Lấy random index khác với exclude_index
  * 
+ * @param catalog Catalog chứa index
  * @param exclude_index Index không muốn chọn
  * @return Random index khác exclude_index
  */
-int get_random_index_except(int exclude_index);
+int get_random_index_except(const ItemCatalog *catalog, int exclude_index);
 
 #endif // DATABASE_H
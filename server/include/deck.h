@@ -0,0 +1,58 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ITEM DECK
+ * ============================================================================
+ * File: deck.h
+ * Description: Bộ bài item đã xáo sẵn cho một game
+ *
+ * Lúc bắt đầu game, phòng rút một bộ gồm các index khác nhau (đủ cho mọi
+ * round, tối đa ROOM_DECK_MAX lá) rồi mỗi round chỉ pop một lá: O(1),
+ * không lặp item trong bộ. Hết bộ (game không giới hạn round, hoặc catalog
+ * nhỏ hơn số round) thì rút bộ mới từ cùng PRNG.
+ *
+ * Toàn bộ dãy lá chỉ phụ thuộc (seed, số item, số lá cần) => ghi lại seed
+ * là replay lại được đúng game đó.
+ * ============================================================================
+ */
+
+#ifndef DECK_H
+#define DECK_H
+
+#include <stdint.h>
+#include "prng.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    Prng rng;
+    uint64_t seed;                  // Seed của game (log để replay)
+    int *cards;                     // Index item đã xáo
+    int size;                       // Số lá mỗi bộ
+    int pos;                        // Lá tiếp theo
+    int item_count;                 // Số item của catalog rút từ đó
+} ItemDeck;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Khởi tạo PRNG từ seed và rút bộ đầu tiên
+ *
+ * @param needed Số lá muốn có (bị chặn bởi item_count và ROOM_DECK_MAX)
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ hoặc item_count < 1
+ */
+int deck_init(ItemDeck *deck, uint64_t seed, int item_count, int needed);
+
+/**
+ * Pop lá tiếp theo; hết bộ thì rút bộ mới (lá đầu bộ mới khác avoid)
+ *
+ * @param avoid Index không muốn nhận ngay (item đang hiển thị), -1 nếu không
+ */
+int deck_next(ItemDeck *deck, int avoid);
+
+void deck_free(ItemDeck *deck);
+
+#endif // DECK_H
@@ -18,6 +18,9 @@
 // Cấu hình và constants
 #include "config.h"
 
+// Logging (ring buffer + drainer thread)
+#include "logger.h"
+
 // Data types và structures
 #include "types.h"
 
@@ -36,4 +39,16 @@
 // Room/Lobby system
 #include "room.h"
 
+// Single player (stateless, token)
+#include "game_single.h"
+
+// Lobby change stream
+#include "lobby.h"
+
+// Quick-play matchmaking
+#include "matchmaking.h"
+
+// Global leaderboard
+#include "leaderboard.h"
+
 #endif // GAME_H
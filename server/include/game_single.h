@@ -0,0 +1,29 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - SINGLE PLAYER
+ * ============================================================================
+ * File: game_single.h
+ * Description: Single player handlers (state trong token, xem game_token.h)
+ * ============================================================================
+ */
+
+#ifndef GAME_SINGLE_H
+#define GAME_SINGLE_H
+
+/* ============================================================================
+ *                           HANDLERS
+ * ============================================================================ */
+
+/**
+ * POST /game - Game mới: cặp item đầu tiên + token
+ */
+void handle_game_init(int sock);
+
+/**
+ * POST /game/choice - Body: { "token": "...", "choice": 1|2 }
+ * 
+ * Chấm điểm từ state trong token, trả state mới trong token mới.
+ */
+void handle_player_choice(int sock, char *json_body);
+
+#endif // GAME_SINGLE_H
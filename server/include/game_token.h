@@ -0,0 +1,87 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - GAME TOKEN
+ * ============================================================================
+ * File: game_token.h
+ * Description: State của game chơi đơn trong token ký MAC
+ *
+ * Server không giữ state người chơi đơn: mỗi response trả token mới chứa
+ * index A/B, score, streak, round và seed PRNG; request sau gửi lại token.
+ * Process nào có cùng key (GAME_TOKEN_KEY) và cùng catalog cũng phục vụ
+ * được, không cần lock hay bảng chung.
+ *
+ * Token = base64url(payload 37 byte || tag 8 byte), tag = SipHash-2-4
+ * (key 128 bit) của payload. SipHash là PRF cho input ngắn: ký + kiểm tra
+ * một token tốn vài trăm ns, so sánh tag thời gian hằng.
+ *
+ * Token tự nó không chống gửi lại (replay): session_table.h chặn trong
+ * phạm vi một process, điểm chơi đơn vẫn không vào leaderboard.
+ * ============================================================================
+ */
+
+#ifndef GAME_TOKEN_H
+#define GAME_TOKEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GAME_TOKEN_VERSION  1
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * GameToken - State một game chơi đơn
+ */
+typedef struct {
+    uint32_t catalog_id;            // Fingerprint catalog: index chỉ đúng với catalog này
+    int32_t index_a;
+    int32_t index_b;
+    int32_t score;
+    int32_t streak;
+    uint32_t round;                 // Số lần đã trả lời
+    uint64_t seed;                  // PRNG của round r = prng_seed(seed + r)
+    uint32_t issued_at;             // Unix time lúc ký
+} GameToken;
+
+typedef enum {
+    GAME_TOKEN_OK = 0,
+    GAME_TOKEN_MALFORMED = -1,
+    GAME_TOKEN_BAD_MAC = -2,
+    GAME_TOKEN_EXPIRED = -3
+} GameTokenStatus;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Key từ biến môi trường GAME_TOKEN_KEY (32 ký tự hex); không có thì sinh
+ * ngẫu nhiên (token chỉ dùng được với process này)
+ */
+void game_token_init_key(void);
+
+/**
+ * Đặt key trực tiếp (benchmark / tool)
+ */
+void game_token_set_key(const uint8_t key[16]);
+
+/**
+ * Ký và mã hóa token (issued_at được ghi đè bằng thời điểm hiện tại)
+ *
+ * @return Độ dài chuỗi, -1 nếu out quá nhỏ
+ */
+int game_token_encode(GameToken *token, char *out, size_t out_len);
+
+/**
+ * Giải mã + kiểm tra MAC và hạn dùng
+ */
+GameTokenStatus game_token_decode(const char *text, GameToken *out);
+
+/**
+ * SipHash-2-4 của data với key 128 bit
+ */
+uint64_t siphash24(const uint8_t key[16], const void *data, size_t len);
+
+#endif // GAME_TOKEN_H
@@ -10,6 +10,8 @@
 #ifndef HTTP_H
 #define HTTP_H
 
+#include <stddef.h>
+
 /* ============================================================================
  *                           HTTP RESPONSE FUNCTIONS
  * ============================================================================ */
@@ -41,6 +43,11 @@ void send_cors_headers(int sock);
  * @param sock Socket để gửi
  * @param body JSON string để gửi
  */
-void send_json_response(int sock, char *body);
+void send_json_response(int sock, const char *body);
+
+/**
+ * Gửi response 200 với Content-Type tùy ý (body không cần kết thúc '\0')
+ */
+void send_response(int sock, const char *content_type, const char *body, size_t body_len);
 
 #endif // HTTP_H
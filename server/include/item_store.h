@@ -0,0 +1,82 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ITEM STORE
+ * ============================================================================
+ * File: item_store.h
+ * Description: View item theo index chung trên các catalog đang map
+ *
+ *   values     mảng int32 hot của từng catalog, nằm ngay trong file
+ *              (16 item / cache line): chấm điểm và chọn cặp chỉ đọc đây
+ *   records    offset table + string heap đã dedup lúc biên dịch catalog;
+ *              chỉ đọc khi build JSON gửi client
+ *
+ * Build chỉ O(số catalog): không chép, không intern item. Catalog giữ map
+ * tới khi phiên bản catalog cuối cùng được trả (item_store_free), nên RSS
+ * riêng của process không tăng theo số item.
+ * ============================================================================
+ */
+
+#ifndef ITEM_STORE_H
+#define ITEM_STORE_H
+
+#include <stdint.h>
+#include "catalog.h"
+#include "types.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    Catalog *parts;                 // Sở hữu: đóng (munmap / free) khi free store
+    uint32_t *bases;                // Index chung của item đầu tiên mỗi part
+    int part_count;
+    uint32_t count;
+    uint32_t fingerprint;           // Ghép fingerprint của các catalog theo thứ tự
+} ItemStore;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Nhận quyền sở hữu các catalog (kể cả khi lỗi), nối tiếp theo thứ tự:
+ * catalog thứ hai bắt đầu từ parts[0]->count. *parts[i] được reset.
+ *
+ * fingerprint giống nhau giữa các process load cùng các file catalog.
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ / quá nhiều item (store rỗng)
+ */
+int item_store_build(ItemStore *store, Catalog *const *parts, int part_count);
+
+void item_store_free(ItemStore *store);
+
+/**
+ * Part chứa item index (một catalog: không cần tìm)
+ */
+static inline int item_store_part(const ItemStore *store, uint32_t index) {
+    int lo = 0, hi = store->part_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (store->bases[mid] <= index) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+static inline int32_t item_store_value(const ItemStore *store, uint32_t index) {
+    int p = item_store_part(store, index);
+    return store->parts[p].values[index - store->bases[p]];
+}
+
+/**
+ * View item (chuỗi trỏ vào heap của catalog, hợp lệ khi store còn sống)
+ */
+static inline GameItem item_store_get(const ItemStore *store, uint32_t index) {
+    int p = item_store_part(store, index);
+    return catalog_item(&store->parts[p], index - store->bases[p]);
+}
+
+#endif // ITEM_STORE_H
@@ -0,0 +1,70 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - JSON FRAGMENT CACHE
+ * ============================================================================
+ * File: json_cache.h
+ * Description: Cache JSON đã serialize của room/player theo version
+ *
+ * Mỗi GameRoom và RoomPlayer có một số version, tăng mỗi khi field hiển
+ * thị trong JSON thay đổi (touch_room / touch_player trong room_helpers).
+ * Fragment giữ bytes đã build cùng version lúc build; còn khớp version thì
+ * builder chèn thẳng bytes cũ thay vì serialize lại.
+ *
+ * Mọi thao tác trên fragment diễn ra khi giữ rooms_mutex; chỉ bộ đếm
+ * hit/miss được đọc không cần lock.
+ * ============================================================================
+ */
+
+#ifndef JSON_CACHE_H
+#define JSON_CACHE_H
+
+#include <stddef.h>
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * JsonFragment - Bytes JSON đã build cho một version của object
+ */
+typedef struct {
+    char *data;                 // NULL = chưa có
+    size_t len;
+    size_t cap;
+    unsigned int version;       // Version của object lúc build
+} JsonFragment;
+
+/**
+ * JsonCacheStats - Bộ đếm toàn server
+ */
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+} JsonCacheStats;
+
+/* ============================================================================
+ *                           FRAGMENT FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Kiểm tra fragment còn dùng được cho version hiện tại (đếm hit/miss)
+ * @return 1 nếu hit, 0 nếu phải build lại
+ */
+int json_fragment_lookup(const JsonFragment *f, unsigned int version);
+
+/**
+ * Lưu bytes vừa build cho version (tái sử dụng buffer cũ nếu đủ chỗ)
+ */
+void json_fragment_store(JsonFragment *f, unsigned int version, const char *data, size_t len);
+
+/**
+ * Giải phóng buffer, fragment trở về trạng thái rỗng
+ */
+void json_fragment_free(JsonFragment *f);
+
+/**
+ * Đọc bộ đếm hit/miss
+ */
+void json_cache_stats(JsonCacheStats *out);
+
+#endif // JSON_CACHE_H
@@ -0,0 +1,91 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - REQUEST BODY PARSER
+ * ============================================================================
+ * File: json_parse.h
+ * Description: Tokenizer một lượt cho JSON body của các POST request
+ *
+ * - Quét body đúng một lần, lấy mọi key đã biết vào struct RequestBody
+ * - Chỉ khớp key ở tầng ngoài cùng (không khớp nhầm chữ trong string value)
+ * - Decode escape (\" \\ \n \uXXXX ...) trong string value
+ * - Tìm dấu " và \ bằng SSE2 (16 byte mỗi lần), fallback scalar
+ *
+ * Thêm key mới: thêm một dòng vào REQUEST_FIELDS, field trong struct và
+ * cờ REQ_xxx được sinh tự động.
+ * ============================================================================
+ */
+
+#ifndef JSON_PARSE_H
+#define JSON_PARSE_H
+
+#include <stddef.h>
+#include "config.h"
+
+/* ============================================================================
+ *                           KEY TABLE
+ * ============================================================================ */
+
+/**
+ * X(ID, "key", kiểu, field, kích thước string)
+ *
+ * INT:    số nguyên (true/false được hiểu là 1/0), bị chặn trong phạm vi int
+ * STRING: chuỗi đã decode escape, cắt bớt nếu dài hơn kích thước field
+ */
+#define REQUEST_FIELDS(X) \
+    X(ROOM_NAME,     "room_name",     STRING, room_name,     ROOM_NAME_LEN) \
+    X(PLAYER_NAME,   "player_name",   STRING, player_name,   PLAYER_NAME_LEN) \
+    X(MAX_ROUNDS,    "max_rounds",    INT,    max_rounds,    0) \
+    X(ARENA,         "arena",         INT,    arena,         0) \
+    X(DIFFICULTY,    "difficulty",    STRING, difficulty,    DIFFICULTY_NAME_LEN) \
+    X(CATALOGS,      "catalogs",      STRING, catalogs,      ROOM_FILTER_LEN) \
+    X(TAGS,          "tags",          STRING, tags,          ROOM_FILTER_LEN) \
+    X(ROOM_ID,       "room_id",       INT,    room_id,       0) \
+    X(CHOICE,        "choice",        INT,    choice,        0) \
+    X(RESPONSE_TIME, "response_time", INT,    response_time, 0) \
+    X(TOKEN,         "token",         STRING, token,         GAME_TOKEN_LEN)
+
+/**
+ * Thứ tự field trong bảng, dùng làm bit của RequestBody.present
+ */
+typedef enum {
+#define REQ_FIELD_ENUM(id, key, type, field, size) REQ_FIELD_##id,
+    REQUEST_FIELDS(REQ_FIELD_ENUM)
+#undef REQ_FIELD_ENUM
+    REQ_FIELD_COUNT
+} RequestFieldId;
+
+#define REQ_HAS(body, id)   (((body)->present >> REQ_FIELD_##id) & 1u)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+#define REQ_DECLARE_INT(field, size)    int field;
+#define REQ_DECLARE_STRING(field, size) char field[size];
+#define REQ_FIELD_DECL(id, key, type, field, size) REQ_DECLARE_##type(field, size)
+
+/**
+ * RequestBody - Kết quả parse: key thiếu thì int = 0, string = ""
+ */
+typedef struct {
+    unsigned int present;               // Bit REQ_FIELD_xxx: key có trong body
+    REQUEST_FIELDS(REQ_FIELD_DECL)
+} RequestBody;
+
+#undef REQ_FIELD_DECL
+
+/* ============================================================================
+ *                           PARSER FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Parse JSON object body vào RequestBody
+ *
+ * Body rỗng (hoặc chỉ có khoảng trắng) được coi là object rỗng.
+ * Key không có trong bảng được bỏ qua (kể cả object/array lồng nhau).
+ *
+ * @return 0 nếu hợp lệ, -1 nếu body không phải JSON object hợp lệ
+ */
+int parse_request_body(const char *json, size_t len, RequestBody *out);
+
+#endif // JSON_PARSE_H
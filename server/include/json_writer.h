@@ -0,0 +1,126 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - JSON WRITER
+ * ============================================================================
+ * File: json_writer.h
+ * Description: Streaming JSON writer dùng chung cho mọi JSON builder
+ *
+ * - Giữ con trỏ cuối buffer nên mỗi lần ghi là O(độ dài phần ghi thêm)
+ *   (không strlen/strcat lại từ đầu)
+ * - Buffer tự lớn lên, lấy từ pool để tái sử dụng giữa các request
+ * - Escape chuỗi đúng chuẩn JSON, số nguyên format bằng bảng 2 chữ số
+ * - Tự chèn dấu phẩy giữa các phần tử/field
+ *
+ * Ví dụ:
+ *   JsonWriter w;
+ *   jw_init(&w);
+ *   jw_object_begin(&w);
+ *   jw_kv_str(&w, "action", "room_joined");
+ *   jw_key(&w, "room");
+ *   build_room_json(&w, room);
+ *   jw_object_end(&w);
+ *   send_json_response(sock, jw_str(&w));
+ *   jw_free(&w);
+ * ============================================================================
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+
+/* ============================================================================
+ *                           CONSTANTS
+ * ============================================================================ */
+
+#define JW_MAX_DEPTH        32              // Độ sâu lồng object/array tối đa
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * JsonWriter - Buffer đang ghi + trạng thái dấu phẩy theo từng tầng
+ */
+typedef struct {
+    char *buf;                              // Dữ liệu (luôn kết thúc bằng '\0')
+    size_t len;                             // Số byte đã ghi
+    size_t cap;                             // Dung lượng buffer
+    int depth;                              // Tầng hiện tại (0 = ngoài cùng)
+    unsigned char has_items[JW_MAX_DEPTH];  // Tầng đã có phần tử chưa (cần dấu phẩy)
+    int after_key;                          // Vừa ghi key, value kế tiếp không cần dấu phẩy
+    int failed;                             // Hết bộ nhớ: mọi lần ghi sau bị bỏ qua
+} JsonWriter;
+
+/* ============================================================================
+ *                           LIFECYCLE
+ * ============================================================================ */
+
+/**
+ * Khởi tạo writer với buffer lấy từ pool
+ */
+void jw_init(JsonWriter *w);
+
+/**
+ * Trả buffer về pool
+ */
+void jw_free(JsonWriter *w);
+
+/**
+ * Xóa nội dung và trạng thái lỗi, giữ buffer để ghi message khác
+ */
+void jw_reset(JsonWriter *w);
+
+/**
+ * Chuỗi JSON hiện tại (NUL-terminated, hợp lệ đến lần ghi kế tiếp)
+ */
+static inline const char *jw_str(const JsonWriter *w) { return w->buf ? w->buf : ""; }
+static inline size_t jw_len(const JsonWriter *w) { return w->len; }
+
+/**
+ * 1 nếu đã hết bộ nhớ từ lần init / reset gần nhất (nội dung bị thiếu)
+ */
+static inline int jw_failed(const JsonWriter *w) { return w->failed; }
+
+/* ============================================================================
+ *                           STRUCTURE
+ * ============================================================================ */
+
+void jw_object_begin(JsonWriter *w);
+void jw_object_end(JsonWriter *w);
+void jw_array_begin(JsonWriter *w);
+void jw_array_end(JsonWriter *w);
+
+/**
+ * Ghi key của field trong object (key là literal, không escape)
+ */
+void jw_key(JsonWriter *w, const char *key);
+
+/**
+ * Như jw_key nhưng độ dài đã biết trước (bảng field của wire_schema)
+ */
+void jw_key_n(JsonWriter *w, const char *key, size_t n);
+
+/* ============================================================================
+ *                           VALUES
+ * ============================================================================ */
+
+void jw_string(JsonWriter *w, const char *s);
+void jw_int(JsonWriter *w, long long v);
+void jw_bool(JsonWriter *w, int v);
+void jw_null(JsonWriter *w);
+
+/**
+ * Chèn nguyên văn một JSON value đã build sẵn
+ */
+void jw_raw(JsonWriter *w, const char *json, size_t len);
+
+/* ============================================================================
+ *                           KEY-VALUE SHORTCUTS
+ * ============================================================================ */
+
+void jw_kv_str(JsonWriter *w, const char *key, const char *s);
+void jw_kv_int(JsonWriter *w, const char *key, long long v);
+void jw_kv_bool(JsonWriter *w, const char *key, int v);
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,93 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - GLOBAL LEADERBOARD
+ * ============================================================================
+ * File: leaderboard.h
+ * Description: Bảng xếp hạng toàn server (all-time / daily / weekly)
+ *
+ * - Kết quả game kết thúc được ghi vào append-only log (LEADERBOARD_FILE)
+ *   bởi writer thread, game path chỉ đẩy record vào hàng đợi
+ * - Khi khởi động, log được replay để dựng lại index trong bộ nhớ
+ * - Mỗi window là một skip list: mỗi tên giữ kết quả tốt nhất trong window
+ * ============================================================================
+ */
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stdint.h>
+#include "types.h"
+
+/* ============================================================================
+ *                           CONSTANTS
+ * ============================================================================ */
+
+#define LEADERBOARD_MAGIC   0x3152424Cu     // "LBR1" - đánh dấu record hợp lệ
+
+/**
+ * Các window thời gian (UTC)
+ */
+typedef enum {
+    LB_WINDOW_ALL = 0,      // Toàn thời gian
+    LB_WINDOW_DAILY,        // Từ 00:00 hôm nay
+    LB_WINDOW_WEEKLY,       // Từ 00:00 thứ Hai tuần này
+    LB_WINDOW_COUNT
+} LeaderboardWindow;
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * LeaderboardRecord - Một dòng trong log (kích thước cố định 64 bytes)
+ */
+typedef struct {
+    uint32_t magic;                     // LEADERBOARD_MAGIC
+    int32_t score;                      // Điểm cuối game
+    int32_t streak;                     // Streak cuối game
+    int32_t total_response_ms;          // Tổng thời gian trả lời
+    int64_t finished_at;                // Unix time (giây) lúc game kết thúc
+    int32_t room_id;                    // Phòng đã chơi
+    int32_t rounds;                     // max_rounds của game
+    char name[PLAYER_NAME_LEN];         // Tên người chơi
+} LeaderboardRecord;
+
+/**
+ * LeaderboardStats - Trạng thái hàng đợi ghi
+ */
+typedef struct {
+    int pending;                        // Record chờ writer thread
+    unsigned long long dropped;         // Record bị bỏ vì hàng đợi đầy
+    unsigned long long unwritten;       // Record không ghi được vào log (chỉ có trong bộ nhớ)
+} LeaderboardStats;
+
+/* ============================================================================
+ *                           LEADERBOARD FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Replay log vào bộ nhớ và khởi động writer thread
+ *
+ * Record hỏng/cắt dở ở cuối file (crash khi đang ghi) bị cắt bỏ để các
+ * lần append sau vẫn thẳng hàng.
+ */
+void init_leaderboard(void);
+
+/**
+ * Đẩy kết quả cuối game của cả phòng vào hàng đợi ghi
+ *
+ * Chỉ copy record vào hàng đợi, không I/O, không chờ writer. Hàng đợi
+ * đầy thì record bị bỏ (đếm trong dropped). Caller giữ rooms_mutex.
+ */
+void leaderboard_submit_room(GameRoom *room);
+
+void leaderboard_stats(LeaderboardStats *out);
+
+/**
+ * GET /leaderboard?window=all|daily|weekly&limit=N&name=X
+ *
+ * Response: top N của window + rank của tên X (nếu có)
+ */
+void handle_get_leaderboard(int sock, const char *query);
+
+#endif // LEADERBOARD_H
@@ -0,0 +1,36 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - LOBBY STREAM
+ * ============================================================================
+ * File: lobby.h
+ * Description: Lobby change stream qua SSE (room_added/updated/removed)
+ * ============================================================================
+ */
+
+#ifndef LOBBY_H
+#define LOBBY_H
+
+/* ============================================================================
+ *                           LOBBY STREAM FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Khởi tạo lobby stream
+ * 
+ * - Reset trạng thái đã publish của tất cả room slots
+ * - Tạo flusher thread gom các thay đổi và broadcast theo chu kỳ
+ *   LOBBY_FLUSH_INTERVAL_MS
+ */
+void init_lobby_stream(void);
+
+/**
+ * Đánh dấu room slot đã thay đổi (tạo, join, leave, start, finish, xóa)
+ * 
+ * Nhiều thay đổi của cùng một slot trong một chu kỳ flush được gộp thành
+ * một event duy nhất. Caller PHẢI đang giữ rooms_mutex.
+ * 
+ * @param room_idx Index của room trong mảng rooms
+ */
+void lobby_mark_dirty(int room_idx);
+
+#endif // LOBBY_H
@@ -0,0 +1,93 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - LOGGER
+ * ============================================================================
+ * File: logger.h
+ * Description: Log có level, ghi bất đồng bộ qua ring buffer lock-free
+ *
+ * Thread gọi LOG_* chỉ format vào một slot của ring (không lock, không
+ * syscall, không chạm stdout); thread drainer gom các ring và ghi ra
+ * stdout hoặc file (GAME_LOG_FILE) theo lô.
+ *
+ *   - Level tắt: macro kiểm tra level TRƯỚC khi tính tham số => một phép
+ *     so sánh; dưới LOG_COMPILE_LEVEL thì call site bị loại lúc biên dịch
+ *   - LOG_RINGS ring, mỗi thread gắn cố định vào một ring (round-robin lúc
+ *     log lần đầu); slot có sequence riêng (ring bounded MPSC kiểu Vyukov)
+ *   - Ring đầy: bỏ dòng log và đếm dropped, không bao giờ chặn game
+ *   - Chưa log_init() (tool, benchmark): ghi thẳng ra stdout
+ *
+ * Dòng log: "HH:MM:SS.mmm LEVEL [TAG] message", thứ tự theo thời điểm gọi
+ * giữa các ring (drainer trộn theo timestamp).
+ * ============================================================================
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/* ============================================================================
+ *                           LEVELS
+ * ============================================================================ */
+
+#define LOG_LEVEL_DEBUG     0
+#define LOG_LEVEL_INFO      1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_ERROR     3
+#define LOG_LEVEL_OFF       4
+
+// Build với -DLOG_COMPILE_LEVEL=LOG_LEVEL_INFO để bỏ hẳn log debug
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL   LOG_LEVEL_DEBUG
+#endif
+
+// Level tối thiểu lúc chạy (GAME_LOG_LEVEL), đọc không lock
+extern int log_level;
+
+/* ============================================================================
+ *                           MACROS
+ * ============================================================================ */
+
+#define LOG_AT(level, tag, ...) do {                                        \
+        if ((level) >= LOG_COMPILE_LEVEL &&                                 \
+            (level) >= __atomic_load_n(&log_level, __ATOMIC_RELAXED)) {     \
+            log_write((level), (tag), __VA_ARGS__);                         \
+        }                                                                   \
+    } while (0)
+
+#define LOG_DEBUG(tag, ...) LOG_AT(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define LOG_INFO(tag, ...)  LOG_AT(LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define LOG_WARN(tag, ...)  LOG_AT(LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define LOG_ERROR(tag, ...) LOG_AT(LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    unsigned long long written;     // Dòng đã ghi ra output
+    unsigned long long dropped;     // Dòng bỏ vì ring đầy
+} LogStats;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Đọc GAME_LOG_LEVEL / GAME_LOG_FILE, cấp phát ring, chạy drainer thread
+ * (gọi đầu tiên trong main; log trước đó được ghi thẳng)
+ */
+void log_init(void);
+
+/**
+ * Format message vào ring của thread hiện tại (tag: "ROOM", "SSE", ...)
+ */
+void log_write(int level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * Ghi hết các dòng đang chờ (đăng ký atexit: exit() không mất log)
+ */
+void log_flush(void);
+
+void log_stats(LogStats *out);
+
+#endif // LOGGER_H
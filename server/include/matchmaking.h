@@ -0,0 +1,58 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - MATCHMAKING
+ * ============================================================================
+ * File: matchmaking.h
+ * Description: Quick-play queue tự ghép người chơi vào phòng
+ * ============================================================================
+ */
+
+#ifndef MATCHMAKING_H
+#define MATCHMAKING_H
+
+/* ============================================================================
+ *                           INITIALIZATION
+ * ============================================================================ */
+
+/**
+ * Khởi tạo hàng đợi và chạy matcher thread (tick mỗi MATCH_TICK_MS)
+ */
+void init_matchmaking(void);
+
+/**
+ * Bỏ vé của session khỏi hàng đợi (người chơi tự tạo / vào phòng)
+ * 
+ * Không gọi khi đang giữ rooms_mutex (lock order, xem matchmaking.c).
+ * @return 1 nếu có vé bị bỏ, 0 nếu session không trong hàng đợi
+ */
+int matchmaking_cancel(int session_id);
+
+/* ============================================================================
+ *                           HTTP HANDLERS
+ * ============================================================================ */
+
+/**
+ * POST /matchmaking/join - Vào hàng đợi quick-play
+ * 
+ * Request body: { "player_name": "...", "max_rounds": N }
+ * Response: { "action": "matchmaking_queued", "queue_size": N }
+ * SSE khi ghép xong: { "action": "match_found", "room": {...} }
+ */
+void handle_matchmaking_join(int sock, int session_id, char *json_body);
+
+/**
+ * POST /matchmaking/leave - Rời hàng đợi
+ * 
+ * Response: { "action": "matchmaking_left" }
+ */
+void handle_matchmaking_leave(int sock, int session_id);
+
+/**
+ * GET /matchmaking/stats - Thống kê hàng đợi và time-to-match percentiles
+ * 
+ * Response: { "action": "matchmaking_stats", "queued": N, "matched": N,
+ *             "time_to_match_ms": { "p50": .., "p90": .., "p99": .., "max": .. } }
+ */
+void handle_matchmaking_stats(int sock);
+
+#endif // MATCHMAKING_H
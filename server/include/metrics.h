@@ -0,0 +1,167 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - METRICS
+ * ============================================================================
+ * File: metrics.h
+ * Description: Counter + histogram latency cho GET /metrics (Prometheus)
+ *
+ * - Histogram kiểu HDR: bucket log-linear (2 bucket mỗi lũy thừa 2, từ 4µs
+ *   đến ~67s, cận trên <= 1.5 lần cận dưới), tìm bucket bằng một lệnh clz
+ * - Ghi vào METRIC_SHARDS shard, mỗi thread gắn vào một shard (round-robin);
+ *   mỗi lần ghi là vài phép cộng atomic relaxed, không lock
+ * - GET /metrics cộng các shard lúc scrape, gauge (phòng, SSE client,
+ *   catalog, ...) được đọc tại thời điểm đó
+ * ============================================================================
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <time.h>
+
+/* ============================================================================
+ *                           HISTOGRAM BUCKETS
+ * ============================================================================ */
+
+// Bucket j >= 1: [2^e, 1.5 * 2^e) hoặc [1.5 * 2^e, 2^(e+1)) µs, e từ
+// METRIC_MIN_EXP đến METRIC_MAX_EXP; bucket 0: < 2^METRIC_MIN_EXP µs
+#define METRIC_MIN_EXP      2
+#define METRIC_MAX_EXP      25
+#define METRIC_BUCKETS      (2 + 2 * (METRIC_MAX_EXP - METRIC_MIN_EXP + 1))   // + overflow
+
+static inline int metrics_bucket_of(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    if (us < (1u << METRIC_MIN_EXP)) return 0;
+    int e = 63 - __builtin_clzll(us);
+    if (e > METRIC_MAX_EXP) return METRIC_BUCKETS - 1;
+    int half = (int)((us >> (e - 1)) & 1);          // Bit ngay sau bit cao nhất
+    return 1 + 2 * (e - METRIC_MIN_EXP) + half;
+}
+
+// Cận trên (µs) của bucket j < METRIC_BUCKETS - 1
+static inline uint64_t metrics_bucket_bound_us(int j) {
+    if (j == 0) return 1u << METRIC_MIN_EXP;
+    int e = METRIC_MIN_EXP + (j - 1) / 2;
+    return (j - 1) % 2 ? (uint64_t)2 << e : (uint64_t)3 << (e - 1);
+}
+
+/* ============================================================================
+ *                           ROUTES
+ * ============================================================================ */
+
+/**
+ * Mọi route của router: id, method, path (label của histogram)
+ *
+ * Router khớp method + path theo bảng này rồi switch theo id.
+ */
+#define METRIC_ROUTES(X)                                            \
+    X(SUBSCRIBE,          "GET",  "/subscribe")                     \
+    X(ROOMS,              "GET",  "/rooms")                         \
+    X(ROOMS_CREATE,       "POST", "/rooms/create")                  \
+    X(ROOMS_JOIN,         "POST", "/rooms/join")                    \
+    X(ROOMS_LEAVE,        "POST", "/rooms/leave")                   \
+    X(ROOMS_START,        "POST", "/rooms/start")                   \
+    X(ROOMS_CHOICE,       "POST", "/rooms/choice")                  \
+    X(ROOMS_INFO,         "GET",  "/rooms/info")                    \
+    X(ROOMS_PLAYER,       "GET",  "/rooms/player")                  \
+    X(ROOMS_CACHE,        "GET",  "/rooms/cache")                   \
+    X(MATCHMAKING_JOIN,   "POST", "/matchmaking/join")              \
+    X(MATCHMAKING_LEAVE,  "POST", "/matchmaking/leave")             \
+    X(MATCHMAKING_STATS,  "GET",  "/matchmaking/stats")             \
+    X(CATALOGS,           "GET",  "/catalogs")                      \
+    X(GAME,               "POST", "/game")                          \
+    X(GAME_CHOICE,        "POST", "/game/choice")                   \
+    X(LEADERBOARD,        "GET",  "/leaderboard")                   \
+    X(METRICS,            "GET",  "/metrics")                       \
+    X(TRACE,              "GET",  "/trace")                         \
+    X(LOCKS,              "GET",  "/locks")                         \
+    X(OPTIONS,            "OPTIONS", "*")                           \
+    X(NOT_FOUND,          "",     "")
+
+typedef enum {
+#define X(id, method, path) ROUTE_##id,
+    METRIC_ROUTES(X)
+#undef X
+    ROUTE_COUNT
+} MetricRoute;
+
+/**
+ * Loại SSE broadcast (fan-out)
+ */
+#define METRIC_BROADCASTS(X)    \
+    X(SESSION, "session")       \
+    X(ROOM,    "room")          \
+    X(LOBBY,   "lobby")         \
+    X(RANKED,  "room_ranked")
+
+typedef enum {
+#define X(id, name) BROADCAST_##id,
+    METRIC_BROADCASTS(X)
+#undef X
+    BROADCAST_COUNT
+} MetricBroadcast;
+
+/**
+ * Counter đơn
+ */
+typedef enum {
+    METRIC_CONNECTIONS = 0,     // Kết nối TCP đã accept
+    METRIC_BYTES_IN,            // Byte request đã đọc
+    METRIC_BYTES_OUT,           // Byte response HTTP đã gửi
+    METRIC_SSE_BYTES_OUT,       // Byte SSE event đã gửi / xếp vào queue
+    METRIC_SSE_MESSAGES,        // SSE event gửi thành công (mỗi client một)
+    METRIC_READ_ERRORS,         // read() request lỗi / rỗng
+    METRIC_WRITE_ERRORS,        // Gửi response lỗi
+    METRIC_SSE_DISCONNECTS,     // Client SSE bị bỏ vì gửi lỗi / đã đóng
+    METRIC_SSE_SLOW_DROPS,      // Trong số đó: bị ngắt vì queue gửi đầy (đọc chậm)
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Thời điểm hiện tại (ns, monotonic) để đo latency
+ */
+static inline uint64_t metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Route của request (NOT_FOUND nếu không khớp)
+ */
+MetricRoute metrics_match_route(const char *method, const char *path);
+
+/**
+ * "METHOD /path" của route (chuỗi hằng, dùng làm tên span)
+ */
+const char *metrics_route_name(MetricRoute route);
+
+void metrics_add(MetricCounter counter, uint64_t n);
+
+/**
+ * Latency của một request, đo quanh dispatch trong handle_client
+ */
+void metrics_observe_route(MetricRoute route, uint64_t ns);
+
+/**
+ * Thời gian gửi một SSE event đến mọi client đích (tính cả chờ clients_mutex)
+ */
+void metrics_observe_broadcast(MetricBroadcast kind, uint64_t ns, int recipients);
+
+/**
+ * GET /metrics - Prometheus text format (version 0.0.4)
+ */
+void handle_metrics(int sock);
+
+/**
+ * GET /locks?limit=N - Mỗi ProfiledMutex + top-N call site theo thời gian
+ * chờ, thời gian giữ và thời gian bắt thread khác chờ
+ */
+void handle_locks(int sock, const char *query);
+
+#endif // METRICS_H
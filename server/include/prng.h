@@ -0,0 +1,80 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - PRNG
+ * ============================================================================
+ * File: prng.h
+ * Description: xoshiro256** có seed, mỗi phòng một state riêng
+ *
+ * - Seed 64-bit được mở rộng bằng splitmix64 => cùng seed cho cùng dãy số
+ *   (dùng để replay một game)
+ * - prng_below() không bias (Lemire: nhân 128-bit + reject hiếm khi xảy ra)
+ * - Không dùng state chung: không cần lock, không đụng rand()
+ * ============================================================================
+ */
+
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <stdint.h>
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    uint64_t s[4];
+} Prng;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Khởi tạo state từ seed (splitmix64)
+ */
+void prng_seed(Prng *rng, uint64_t seed);
+
+/**
+ * Seed ngẫu nhiên từ kernel (getrandom), fallback thời gian + địa chỉ stack
+ */
+uint64_t prng_entropy_seed(void);
+
+static inline uint64_t prng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * 64 bit ngẫu nhiên tiếp theo
+ */
+static inline uint64_t prng_next(Prng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = prng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = prng_rotl(s[3], 45);
+
+    return result;
+}
+
+/**
+ * Số nguyên đều trong [0, bound), bound > 0
+ */
+static inline uint64_t prng_below(Prng *rng, uint64_t bound) {
+    __uint128_t m = (__uint128_t)prng_next(rng) * bound;
+    uint64_t low = (uint64_t)m;
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (__uint128_t)prng_next(rng) * bound;
+            low = (uint64_t)m;
+        }
+    }
+    return (uint64_t)(m >> 64);
+}
+
+#endif // PRNG_H
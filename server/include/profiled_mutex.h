@@ -0,0 +1,121 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - PROFILED MUTEX
+ * ============================================================================
+ * File: profiled_mutex.h
+ * Description: pthread mutex đo thời gian chờ / giữ theo lock và call site
+ *
+ * - MUTEX_LOCK / MUTEX_UNLOCK / MUTEX_COND_WAIT thay cho pthread_mutex_*,
+ *   call site ("file.c:123" + hàm) được ghi lúc lock
+ * - Không tranh chấp: trylock thành công => wait = 0, một clock_gettime
+ *   lúc lock và một lúc unlock; mọi thống kê được cập nhật khi đang giữ lock
+ *   nên không tranh cache line với thread khác
+ * - Tranh chấp: thread chờ đọc call site đang giữ lock, thời gian chờ
+ *   được tính cho site đó ("blocked others") => tìm ra ai gây nghẽn
+ * - Histogram wait/hold trên GET /metrics, top-N call site trên GET /locks
+ *   (metrics.c đọc qua profiled_mutex_list / profiled_mutex_sites)
+ *
+ * Build với -DLOCK_PROFILE=0: macro gọi thẳng pthread, không đo gì.
+ * ============================================================================
+ */
+
+#ifndef PROFILED_MUTEX_H
+#define PROFILED_MUTEX_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "metrics.h"
+
+#ifndef LOCK_PROFILE
+#define LOCK_PROFILE        1
+#endif
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * ProfiledMutex - pthread mutex + thống kê của lock
+ *
+ * Các field thống kê chỉ được ghi khi đang giữ mutex; GET /metrics và
+ * GET /locks đọc không lock (atomic relaxed).
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    const char *name;                   // "rooms_mutex" (label trên /metrics)
+    int registered;                     // Đã vào danh sách cho /metrics, /locks
+    uint64_t acquired_ns;               // Lúc thread đang giữ lấy được lock
+    const char *holder_site;            // Call site đang giữ (NULL nếu tự do)
+    const char *holder_func;
+    void *holder_entry;                 // Thống kê call site đang giữ (nội bộ)
+    uint64_t acquisitions;
+    uint64_t contended;                 // Lần lock phải chờ (trylock thất bại)
+    uint64_t wait_ns;
+    uint64_t hold_ns;
+    uint64_t wait_buckets[METRIC_BUCKETS];
+    uint64_t hold_buckets[METRIC_BUCKETS];
+} ProfiledMutex;
+
+#define PROFILED_MUTEX_INITIALIZER(lock_name) { .mutex = PTHREAD_MUTEX_INITIALIZER, .name = (lock_name) }
+
+/**
+ * LockSiteStats - Snapshot thống kê của một call site
+ */
+typedef struct {
+    const char *lock;                   // Tên lock
+    const char *site;                   // "src/sse.c:123"
+    const char *func;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+    uint64_t wait_max_ns;
+    uint64_t hold_ns;
+    uint64_t hold_max_ns;
+    uint64_t blocked_ns;                // Thời gian thread khác chờ khi site này đang giữ
+    uint64_t blocked_count;
+} LockSiteStats;
+
+/* ============================================================================
+ *                           MACROS
+ * ============================================================================ */
+
+#define LOCK_STR_(x)        #x
+#define LOCK_STR(x)         LOCK_STR_(x)
+#define LOCK_SITE           __FILE__ ":" LOCK_STR(__LINE__)
+
+#if LOCK_PROFILE
+#define MUTEX_LOCK(m)               profiled_mutex_lock((m), LOCK_SITE, __func__)
+#define MUTEX_UNLOCK(m)             profiled_mutex_unlock(m)
+#define MUTEX_COND_WAIT(cond, m)    profiled_mutex_cond_wait((cond), (m), LOCK_SITE, __func__)
+#else
+#define MUTEX_LOCK(m)               pthread_mutex_lock(&(m)->mutex)
+#define MUTEX_UNLOCK(m)             pthread_mutex_unlock(&(m)->mutex)
+#define MUTEX_COND_WAIT(cond, m)    pthread_cond_wait((cond), &(m)->mutex)
+#endif
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+void profiled_mutex_lock(ProfiledMutex *m, const char *site, const char *func);
+void profiled_mutex_unlock(ProfiledMutex *m);
+
+/**
+ * pthread_cond_wait: phần giữ lock trước khi ngủ được tính là một lần hold,
+ * lúc thức dậy là một lần lock mới (thời gian ngủ không tính là chờ lock)
+ */
+void profiled_mutex_cond_wait(pthread_cond_t *cond, ProfiledMutex *m, const char *site, const char *func);
+
+/**
+ * Các lock đã từng được lock (cho /metrics)
+ * @return Số lock ghi vào out
+ */
+int profiled_mutex_list(ProfiledMutex **out, int max);
+
+/**
+ * Snapshot mọi call site đã ghi nhận
+ * @return Số site ghi vào out
+ */
+int profiled_mutex_sites(LockSiteStats *out, int max);
+
+#endif // PROFILED_MUTEX_H
@@ -0,0 +1,118 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TRAFFIC RECORDER
+ * ============================================================================
+ * File: recorder.h
+ * Description: Ghi mọi request (thời điểm, session, body) vào log nhị phân
+ *              để tools/replay.c phát lại
+ *
+ * - Bật bằng GAME_RECORD_FILE=traffic.rec (không đặt = tắt, chỉ tốn một
+ *   lần đọc biến mỗi request)
+ * - Router ghi record sau khi handler xong: /subscribe và /rooms/create kèm
+ *   id server vừa cấp (session / room) để replay ánh xạ id cũ -> id mới
+ * - File: header 16 byte + record liên tiếp, số nguyên dạng varint (LEB128)
+ *
+ *   header:  "HLREC" 0x01 0x00 0x00 | uint64 LE unix ms lúc bắt đầu ghi
+ *   record:  varint t_us         (từ lúc bắt đầu ghi, lúc request tới)
+ *            varint session_id   (X-Session-ID, 0 nếu không có)
+ *            varint assigned_id  (session / room id được cấp, 0 nếu không)
+ *            byte   method       (RECORD_METHOD_*)
+ *            varint target_len, target  (path + "?query")
+ *            varint body_len, body
+ *
+ * Format và varint dùng chung với tools/replay.c (hàm inline bên dưới).
+ * ============================================================================
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "server.h"
+
+#define RECORD_MAGIC        "HLREC\x01\x00\x00"
+#define RECORD_MAGIC_LEN    8
+#define RECORD_HEADER_LEN   16
+
+typedef enum {
+    RECORD_METHOD_GET = 0,
+    RECORD_METHOD_POST,
+    RECORD_METHOD_OPTIONS,
+    RECORD_METHOD_OTHER
+} RecordMethod;
+
+/* ============================================================================
+ *                           RECORDING
+ * ============================================================================ */
+
+// File record đang mở (0 = tắt)
+extern int recorder_enabled;
+
+// Id server cấp trong request hiện tại (handler đặt, router ghi vào record)
+extern __thread int recorder_assigned_id;
+
+/**
+ * Mở GAME_RECORD_FILE (nếu đặt), ghi header, chạy thread flush định kỳ
+ */
+void recorder_init(void);
+
+/**
+ * Ghi một request (gọi sau handler, cả với /subscribe)
+ * @param arrival_ns metrics_now_ns() lúc request tới
+ */
+void recorder_write(const HttpRequest *req, uint64_t arrival_ns);
+
+/* ============================================================================
+ *                           FORMAT HELPERS
+ * ============================================================================ */
+
+static inline RecordMethod record_method_of(const char *method) {
+    if (strcmp(method, "GET") == 0) return RECORD_METHOD_GET;
+    if (strcmp(method, "POST") == 0) return RECORD_METHOD_POST;
+    if (strcmp(method, "OPTIONS") == 0) return RECORD_METHOD_OPTIONS;
+    return RECORD_METHOD_OTHER;
+}
+
+static inline const char *record_method_name(RecordMethod method) {
+    switch (method) {
+        case RECORD_METHOD_GET:     return "GET";
+        case RECORD_METHOD_POST:    return "POST";
+        case RECORD_METHOD_OPTIONS: return "OPTIONS";
+        default:                    return "OTHER";
+    }
+}
+
+/**
+ * Ghi varint vào out (tối đa 10 byte)
+ * @return Số byte đã ghi
+ */
+static inline size_t record_put_varint(uint8_t *out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * Đọc varint từ [*p, end)
+ * @return 0 nếu thành công, -1 nếu hết dữ liệu / quá 10 byte
+ */
+static inline int record_get_varint(const uint8_t **p, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 70 && *p < end; shift += 7) {
+        uint8_t byte = *(*p)++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#endif // RECORDER_H
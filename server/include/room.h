@@ -11,6 +11,9 @@
 #define ROOM_H
 
 #include "types.h"
+#include "json_writer.h"
+#include "profiled_mutex.h"
+#include "room_rank.h"
 #include <pthread.h>
 
 /* ============================================================================
@@ -20,8 +23,8 @@
 // Danh sách tất cả phòng
 extern GameRoom rooms[MAX_ROOMS];
 
-// Mutex để bảo vệ danh sách phòng
-extern pthread_mutex_t rooms_mutex;
+// Mutex để bảo vệ danh sách phòng (MUTEX_LOCK / MUTEX_UNLOCK)
+extern ProfiledMutex rooms_mutex;
 
 // ID phòng tiếp theo
 extern int next_room_id;
@@ -37,16 +40,53 @@ extern int next_room_id;
  */
 void init_rooms(void);
 
+/* ============================================================================
+ *                           ROUND CLOSE
+ * ============================================================================ */
+
+/**
+ * RoundClose - Message của một round vừa đóng, build trong lock, gửi sau
+ */
+typedef struct {
+    int room_id;
+    int round;                                  // Round vừa đóng
+    int is_arena;
+    int finished;                               // 1 = game_finished, 0 = new_round
+    int players;                                // Số người lúc đóng
+    RoomRankKey *rank_keys;                     // Snapshot xếp hạng (my_rank / my_score)
+    int rank_count;
+    JsonWriter results_json;                    // round_results (arena: object để mở)
+    JsonWriter next_json;                       // new_round hoặc game_finished
+} RoundClose;
+
+/**
+ * Đóng round hiện tại (caller giữ rooms_mutex)
+ * 
+ * Build round_results + new_round / game_finished và chuyển phòng sang round
+ * kế tiếp (hoặc ROOM_FINISHED). Dùng khi người cuối cùng trả lời, khi người
+ * chưa trả lời rời phòng, và khi round arena hết hạn.
+ */
+void close_round_locked(int room_idx, RoundClose *rc);
+
+/**
+ * Gửi message của round đã đóng (sau khi unlock) và giải phóng rc
+ */
+void publish_round_close(RoundClose *rc);
+
 /* ============================================================================
  *                           HTTP HANDLERS
  * ============================================================================ */
 
 /**
- * GET /rooms - Lấy danh sách phòng
+ * GET /rooms - Lấy danh sách phòng (có filter và phân trang)
+ * 
+ * Query: ?status=waiting,playing&prefix=abc&players_min=1&players_max=49
+ *        &rounds_min=5&rounds_max=20&open=1&limit=20&cursor=...
+ * Response: { "action": "room_list", "rooms": [...], "next_cursor": "..." | null }
  * 
- * Response: { "action": "room_list", "rooms": [...] }
+ * @param query Query string (phần sau '?'), có thể rỗng
  */
-void handle_list_rooms(int sock);
+void handle_list_rooms(int sock, const char *query);
 
 /**
  * POST /rooms/create - Tạo phòng mới
@@ -93,4 +133,19 @@ void handle_room_choice(int sock, int session_id, char *json_body);
  */
 void handle_get_room_info(int sock, int session_id);
 
+/**
+ * GET /rooms/player?session_id=N - Chi tiết một người chơi trong phòng
+ * 
+ * Dùng cho arena (broadcast chỉ có top K). Bỏ session_id = chính mình.
+ * Response: { "action": "player_info", "room_id": ..., "player": { ..., "rank": ... } }
+ */
+void handle_get_room_player(int sock, int session_id, const char *query);
+
+/**
+ * GET /rooms/cache - Bộ đếm hit/miss của cache JSON room/player
+ * 
+ * Response: { "action": "cache_stats", "hits": ..., "misses": ... }
+ */
+void handle_room_cache_stats(int sock);
+
 #endif // ROOM_H
@@ -0,0 +1,83 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ROOM DIRECTORY
+ * ============================================================================
+ * File: room_directory.h
+ * Description: Secondary indexes cho danh sách phòng (filter + phân trang)
+ * ============================================================================
+ */
+
+#ifndef ROOM_DIRECTORY_H
+#define ROOM_DIRECTORY_H
+
+#include <stddef.h>
+#include "config.h"
+
+/* ============================================================================
+ *                           CONSTANTS
+ * ============================================================================ */
+
+// Key = [status][attr...][room_id big-endian], attr dài nhất là tên phòng
+#define ROOM_DIR_KEY_LEN        (1 + ROOM_NAME_LEN + 4)
+
+// Cursor = hex của [index tag][key]
+#define ROOM_DIR_CURSOR_LEN     (2 * (1 + ROOM_DIR_KEY_LEN) + 1)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * RoomQuery - Điều kiện lọc cho GET /rooms
+ * 
+ * Giá trị -1 nghĩa là không lọc theo trường đó
+ */
+typedef struct {
+    int status_mask;                        // Bit (1 << RoomStatus) được chấp nhận
+    char name_prefix[ROOM_NAME_LEN];        // Tiền tố tên phòng (không phân biệt hoa thường)
+    int players_min;                        // Số người chơi tối thiểu
+    int players_max;                        // Số người chơi tối đa
+    int rounds_min;                         // max_rounds tối thiểu
+    int rounds_max;                         // max_rounds tối đa
+    int only_open;                          // 1 = chỉ phòng còn chỗ (player_count < max_players)
+    int arena;                              // 0 = phòng thường, 1 = arena, -1 = cả hai
+    int limit;                              // Số phòng mỗi trang
+    char cursor[ROOM_DIR_CURSOR_LEN];       // Cursor trang trước ("" = trang đầu)
+} RoomQuery;
+
+/* ============================================================================
+ *                           DIRECTORY FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Khởi tạo các index rỗng
+ */
+void init_room_directory(void);
+
+/**
+ * Cập nhật index cho một room slot sau khi room thay đổi
+ * 
+ * Xóa key cũ của slot (nếu có) và thêm key mới nếu room chưa bị xóa.
+ * Caller PHẢI đang giữ rooms_mutex.
+ * 
+ * @param room_idx Index của room trong mảng rooms
+ */
+void room_dir_update(int room_idx);
+
+/**
+ * Tìm phòng theo điều kiện, O(log n + page)
+ * 
+ * Chọn index hẹp nhất theo filter (name > fill > rounds > status), các
+ * filter còn lại được kiểm tra trên từng phòng khi duyệt.
+ * Caller PHẢI đang giữ rooms_mutex.
+ * 
+ * @param query Điều kiện lọc
+ * @param out_slots Output: index các room trong mảng rooms
+ * @param max_out Kích thước out_slots (>= query->limit)
+ * @param next_cursor Output: cursor trang kế ("" nếu hết)
+ * @return Số phòng tìm được, hoặc -1 nếu cursor không hợp lệ
+ */
+int room_dir_query(const RoomQuery *query, int *out_slots, int max_out,
+                   char *next_cursor, size_t cursor_size);
+
+#endif // ROOM_DIRECTORY_H
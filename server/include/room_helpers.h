@@ -11,6 +11,9 @@
 #define ROOM_HELPERS_H
 
 #include "types.h"
+#include "json_writer.h"
+#include "json_parse.h"
+#include "wire_schema.h"
 
 /* ============================================================================
  *                           ROOM FINDER FUNCTIONS
@@ -41,6 +44,22 @@ int find_room_with_player(int session_id, int *player_idx);
  */
 int find_empty_room_slot(void);
 
+/**
+ * Kiểm tra room có hiển thị trong lobby không (waiting hoặc playing)
+ * @return 1 nếu có, 0 nếu không
+ */
+int room_is_listed(GameRoom *room);
+
+/**
+ * Item theo index trong catalog của game hiện tại (phòng chưa start => item rỗng)
+ */
+GameItem room_item(GameRoom *room, int index);
+
+/**
+ * Chỉ value của item (mảng hot) - dùng khi chấm điểm
+ */
+int room_item_value(GameRoom *room, int index);
+
 /**
  * Kiểm tra player đã ở trong phòng nào chưa
  * @return 1 nếu đã ở trong phòng, 0 nếu chưa
@@ -52,9 +71,86 @@ int is_player_in_any_room(int session_id);
  * ============================================================================ */
 
 /**
- * Cập nhật room_id và player_name cho SSE client
+ * Báo room slot đã thay đổi: cập nhật room directory và lobby stream
+ * 
+ * Gọi sau mỗi thay đổi status, player_count, tên... Caller giữ rooms_mutex.
+ */
+void notify_room_changed(int room_idx);
+
+/**
+ * Đánh dấu JSON của room đã cũ (field của room thay đổi)
+ * 
+ * Gọi sau mọi thay đổi field có trong build_room_json(). Caller giữ rooms_mutex.
+ */
+void touch_room(GameRoom *room);
+
+/**
+ * Đánh dấu JSON của player (và room chứa nó) đã cũ
+ */
+void touch_player(GameRoom *room, RoomPlayer *player);
+
+/**
+ * Tạo phòng mới ở slot trống với host là player đầu tiên
+ * 
+ * Caller giữ rooms_mutex và đã kiểm tra host chưa ở phòng nào.
+ * @param is_arena 1 = phòng arena (ARENA_MAX_PLAYERS, broadcast top K)
+ * @param difficulty Cách chọn cặp item mỗi round
+ * @param catalogs, tags Bộ lọc item (NULL / "" = không lọc), đã kiểm tra bằng item_catalog_filter
+ * @return Index của room, hoặc -1 nếu hết slot / hết bộ nhớ
+ */
+int create_room(int host_session_id, const char *room_name, const char *host_name,
+                int max_rounds, int is_arena, RoomDifficulty difficulty,
+                const char *catalogs, const char *tags);
+
+/**
+ * Xóa phòng: giải phóng players, đưa slot về ROOM_EMPTY
+ * 
+ * Caller giữ rooms_mutex.
+ */
+void destroy_room(int room_idx);
+
+/**
+ * Thêm player vào cuối danh sách và gắn SSE client vào phòng
+ * 
+ * Caller giữ rooms_mutex và đã kiểm tra phòng còn chỗ.
+ */
+void add_player_to_room(GameRoom *room, int session_id, const char *player_name, int is_host);
+
+/**
+ * Xóa player khỏi phòng, cập nhật session index và các aggregate
+ * 
+ * Phòng thường giữ thứ tự (shift), arena dùng swap-remove O(1).
+ * Caller giữ rooms_mutex; KHÔNG xóa phòng khi hết người.
+ */
+void remove_player_from_room(GameRoom *room, int player_idx);
+
+/**
+ * Ghi nhận câu trả lời của player, cập nhật score/streak và aggregate của room
+ */
+void apply_player_answer(GameRoom *room, RoomPlayer *player, int correct, int response_time_ms);
+
+/**
+ * Bắt đầu game: chuyển sang ROOM_PLAYING, reset players, rút bộ item với
+ * seed ngẫu nhiên và chọn cặp item đầu
+ * 
+ * Caller giữ rooms_mutex.
+ */
+void start_room_game(int room_idx);
+
+/**
+ * Như start_room_game nhưng với seed cho trước (cùng seed + cùng catalog
+ * => cùng dãy item, dùng để replay một game đã log)
  */
-void update_sse_client_room(int session_id, int room_id, const char *player_name);
+void start_room_game_seeded(int room_idx, uint64_t seed);
+
+/**
+ * Item B của round hiện tại (khác item A)
+ * 
+ * DIFFICULTY_RANDOM: pop từ bộ của phòng. DIFFICULTY_RAMP: chọn theo khoảng
+ * tỉ lệ giá của current_round qua value index, không có ứng viên thì pop bộ.
+ * Phòng có bộ lọc chỉ nhận item trong room->pool.
+ */
+int room_next_item(GameRoom *room);
 
 /**
  * Khởi tạo RoomPlayer với giá trị mặc định
@@ -67,43 +163,87 @@ void init_room_player(RoomPlayer *player, int session_id, const char *name, int
 int count_answered_players(GameRoom *room);
 
 /**
- * Reset trạng thái round cho tất cả players
+ * Reset trạng thái round cho tất cả players (và đặt lại hạn round arena)
  */
 void reset_round_state(GameRoom *room);
 
+/**
+ * Đặt hạn của round vừa bắt đầu: arena = bây giờ + ARENA_ROUND_DEADLINE_MS,
+ * phòng thường không có hạn
+ */
+void arm_round_deadline(GameRoom *room);
+
 /* ============================================================================
- *                           JSON PARSE HELPERS
- * ============================================================================ */
+ *                           JSON BUILDERS
+ * ============================================================================
+ * Mọi builder ghi tiếp vào JsonWriter (xem json_writer.h), nên có thể lồng
+ * vào nhau hoặc dùng làm value của một key mà không cần buffer trung gian.
+ */
 
 /**
- * Parse chuỗi JSON để lấy giá trị string theo key
+ * Build JSON array các players trong room
+ * 
+ * Entry của player chưa đổi version được chèn từ cache.
  */
-void parse_json_string(const char *json, const char *key, char *out, size_t out_size);
+void build_players_json(JsonWriter *w, GameRoom *room);
 
 /**
- * Parse chuỗi JSON để lấy giá trị int theo key
- * @return Giá trị int, hoặc 0 nếu không tìm thấy
+ * Build JSON object cho room info
+ * 
+ * Dùng lại bytes đã cache khi room->version chưa đổi (xem json_cache.h);
+ * players chưa đổi version cũng được chèn từ cache.
  */
-int parse_json_int(const char *json, const char *key);
+void build_room_json(JsonWriter *w, GameRoom *room);
 
-/* ============================================================================
- *                           JSON BUILDERS
- * ============================================================================ */
+/**
+ * Build room JSON không qua cache room (dùng khi cache miss và trong benchmark)
+ */
+void build_room_json_uncached(JsonWriter *w, GameRoom *room);
 
 /**
- * Build JSON array các players trong room
+ * Điền các field tóm tắt room cho lobby (schema ROOM_SUMMARY)
  */
-void build_players_json(GameRoom *room, char *json, size_t json_size);
+void fill_room_summary(WireRoomSummary *out, GameRoom *room);
 
 /**
- * Build JSON object cho room info
+ * Build JSON object tóm tắt room cho lobby (id, name, player_count, max_players, status)
+ */
+void build_room_summary_json(JsonWriter *w, GameRoom *room);
+
+/**
+ * Build message game_started (room, round, labelA, valueA, labelB)
+ */
+void build_game_started_json(JsonWriter *w, GameRoom *room);
+
+/**
+ * Build message new_round (cùng dạng game_started)
+ */
+void build_new_round_json(JsonWriter *w, GameRoom *room);
+
+/**
+ * Build mảng top LEADERBOARD_TOP_K theo bảng xếp hạng của room
+ * 
+ * [{"rank","session_id","name","score","streak","total_response_time"}, ...]
+ */
+void build_leaderboard_json(JsonWriter *w, GameRoom *room);
+
+/**
+ * Build mảng results[] (schema ROUND_RESULT) theo thứ tự ordered, rank từ 1
+ */
+void build_round_result_entries(JsonWriter *w, RoomPlayer **ordered, int count);
+
+/**
+ * Build phần đầu message round_results (object để mở, KHÔNG có dấu } cuối)
+ * 
+ * results theo thứ hạng (có field rank) + leaderboard; dùng với
+ * broadcast_sse_to_room_ranked() để mỗi người nhận thêm my_rank/my_score.
  */
-void build_room_json(GameRoom *room, char *json, size_t json_size);
+void build_round_results_json(JsonWriter *w, GameRoom *room, int round, int valueB,
+                              const char *labelB);
 
 /**
- * Build JSON object cho kết quả round
+ * Build phần đầu message game_finished (object để mở): room + leaderboard
  */
-void build_round_results_json(GameRoom *room, int round, int valueB, const char *labelB, 
-                               char *json, size_t json_size);
+void build_game_finished_json(JsonWriter *w, GameRoom *room);
 
 #endif // ROOM_HELPERS_H
@@ -0,0 +1,111 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ROOM RANKING
+ * ============================================================================
+ * File: room_rank.h
+ * Description: Bảng xếp hạng incremental của từng phòng (indexed skip list)
+ * 
+ * Thứ tự: score giảm dần, streak giảm dần, tổng thời gian trả lời tăng dần,
+ * session_id tăng dần (để key luôn duy nhất). Mọi hàm yêu cầu caller giữ
+ * rooms_mutex.
+ * ============================================================================
+ */
+
+#ifndef ROOM_RANK_H
+#define ROOM_RANK_H
+
+#include "types.h"
+
+/* ============================================================================
+ *                           CONSTANTS
+ * ============================================================================ */
+
+// Key = [~score][~streak][total_response_ms][session_id], big-endian u32
+#define ROOM_RANK_KEY_LEN   16
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * RoomRankKey - Bản sao key xếp hạng của một player (snapshot)
+ */
+typedef struct {
+    unsigned char key[ROOM_RANK_KEY_LEN];
+} RoomRankKey;
+
+/* ============================================================================
+ *                           LIFECYCLE
+ * ============================================================================ */
+
+/**
+ * Khởi tạo bảng xếp hạng rỗng cho room
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ
+ */
+int room_rank_init(GameRoom *room);
+
+/**
+ * Giải phóng bảng xếp hạng
+ */
+void room_rank_free(GameRoom *room);
+
+/**
+ * Xây lại từ đầu theo trạng thái hiện tại của players (khi start game)
+ */
+void room_rank_rebuild(GameRoom *room);
+
+/* ============================================================================
+ *                           UPDATES - O(log n)
+ * ============================================================================ */
+
+/**
+ * Thêm player theo score/streak/response hiện tại
+ */
+void room_rank_insert(GameRoom *room, RoomPlayer *player);
+
+/**
+ * Xóa player, PHẢI gọi trước khi thay đổi score/streak/total_response_ms
+ */
+void room_rank_remove(GameRoom *room, RoomPlayer *player);
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+/**
+ * Hạng của player (1 = đứng đầu), O(log n)
+ * @return Hạng, hoặc 0 nếu player không có trong bảng
+ */
+int room_rank_of(GameRoom *room, RoomPlayer *player);
+
+/**
+ * Top K players theo thứ hạng, O(K)
+ * 
+ * @param out Output: con trỏ players, out[0] là hạng 1
+ * @return Số players (<= k)
+ */
+int room_rank_top(GameRoom *room, RoomPlayer **out, int k);
+
+/**
+ * Chụp key xếp hạng của tất cả players, O(n) duyệt tuần tự mảng players
+ * 
+ * Rẻ hơn nhiều so với duyệt skip list (cache miss mỗi node) nên dùng khi
+ * cần rank của mọi người lúc đóng round; phần sắp xếp làm ngoài lock
+ * bằng room_rank_resolve().
+ * 
+ * @param out Mảng tối thiểu room->player_count phần tử
+ * @return Số keys
+ */
+int room_rank_snapshot(GameRoom *room, RoomRankKey *out);
+
+/**
+ * Sắp xếp snapshot và tính rank/score cho từng session, O(n log n)
+ * 
+ * KHÔNG cần rooms_mutex. Thứ tự giống hệt bảng xếp hạng của room.
+ * 
+ * @param keys Snapshot (bị sắp xếp lại)
+ * @param out Mảng tối thiểu n phần tử
+ */
+void room_rank_resolve(RoomRankKey *keys, int n, SSE_RankEntry *out);
+
+#endif // ROOM_RANK_H
@@ -10,6 +10,23 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <stddef.h>
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * HttpRequest - Phần request line + header mà router cần
+ */
+typedef struct {
+    char method[16];
+    char path[256];             // Đã bỏ query string
+    char *query;                // Phần sau '?' ("" nếu không có), nằm trong path
+    char *body;                 // Sau "\r\n\r\n" trong buffer, NULL nếu thiếu
+    int session_id;             // X-Session-ID, 0 nếu không có
+} HttpRequest;
+
 /* ============================================================================
  *                           SERVER FUNCTIONS
  * ============================================================================ */
@@ -25,6 +42,18 @@
  */
 void* handle_client(void* arg);
 
+/**
+ * Đọc GAME_ADMIN_TOKEN (gọi một lần lúc khởi động, trước khi nhận kết nối)
+ */
+void init_admin_access(void);
+
+/**
+ * Parse request line, X-Session-ID và vị trí body (buffer kết thúc bằng '\0')
+ * 
+ * req->query và req->body trỏ vào req->path / buffer, không copy.
+ */
+void parse_http_request(char *buffer, HttpRequest *req);
+
 /**
  * Lấy session ID từ HTTP request header
  * 
@@ -35,6 +64,17 @@ void* handle_client(void* arg);
  */
 int get_session_from_request(char *request);
 
+/**
+ * Lấy giá trị query parameter đã URL-decode
+ * 
+ * @param query Query string (phần sau '?')
+ * @param name Tên parameter
+ * @param out Buffer output
+ * @param out_size Kích thước buffer
+ * @return 1 nếu tìm thấy, 0 nếu không
+ */
+int get_query_param(const char *query, const char *name, char *out, size_t out_size);
+
 /**
  * Cleanup khi player disconnect
  * 
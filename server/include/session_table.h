@@ -0,0 +1,77 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - SESSION TABLE
+ * ============================================================================
+ * File: session_table.h
+ * Description: Bảng game chơi đơn đang chạy (chống gửi lại token cũ)
+ *
+ * State game vẫn nằm trong token (game_token.h); bảng chỉ nhớ round tiếp
+ * theo của mỗi game (key = seed của token). Token có round nhỏ hơn round
+ * đã ghi là token cũ bị gửi lại => từ chối.
+ *
+ *   - SESSION_TABLE_SHARDS shard, mỗi shard một mutex: request của các
+ *     game khác nhau hầu như không tranh lock
+ *   - Mỗi shard: pool entry cố định + bảng băm open addressing (index vào
+ *     pool, xóa bằng backward-shift) => tra / thêm / xóa O(1)
+ *   - LRU: danh sách liên kết đôi trong pool; đầy thì bỏ game lâu nhất
+ *     không chơi, game idle quá SESSION_IDLE_SEC được dọn dần mỗi thao tác
+ *
+ * Game bị bỏ không được nhận lại như game mới: idle dài hơn TTL của token
+ * nên game hết hạn không còn token hợp lệ, và mỗi shard nhớ lần dùng cuối
+ * (wall clock) của game gần nhất bị bỏ. Token round > 0 của game không có
+ * trong bảng mà ký trước mốc đó có thể là của game đã bị bỏ => từ chối.
+ * Token ký bởi process khác sau mốc đó vẫn được nhận: bảng chặn replay
+ * trong phạm vi một process, không phải tuyệt đối.
+ * ============================================================================
+ */
+
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include <stdint.h>
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef enum {
+    SESSION_OK = 0,
+    SESSION_REPLAY = -1,            // Token cũ hơn round đã ghi
+    SESSION_FORGOTTEN = -2          // Game có thể đã bị bỏ khỏi bảng (không kiểm tra được round)
+} SessionStatus;
+
+/**
+ * SessionTableStats - Tổng của mọi shard
+ */
+typedef struct {
+    unsigned long long count;       // Game đang nhớ
+    unsigned long long capacity;
+    unsigned long long evicted;     // Bỏ vì đầy (LRU)
+    unsigned long long expired;     // Bỏ vì idle
+    unsigned long long replays;     // Token cũ bị từ chối
+    unsigned long long forgotten;   // Token của game đã bị bỏ bị từ chối
+} SessionTableStats;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Cấp phát bảng cho tối đa capacity game (chia đều các shard)
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ
+ */
+int session_table_init(uint32_t capacity);
+
+/**
+ * Ghi nhận token của game sắp được trả lời
+ *
+ * round là round trong token client gửi; thành công thì round tiếp theo
+ * được ghi là round + 1. Game chưa có trong bảng được thêm vào, trừ khi
+ * round > 0 và issued_at (unix time lúc ký token) không mới hơn game gần
+ * nhất bị bỏ khỏi shard (SESSION_FORGOTTEN).
+ */
+SessionStatus session_table_advance(uint64_t game_id, uint32_t round, uint32_t issued_at);
+
+void session_table_stats(SessionTableStats *out);
+
+#endif // SESSION_TABLE_H
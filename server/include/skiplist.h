@@ -0,0 +1,117 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - INDEXED SKIP LIST
+ * ============================================================================
+ * File: skiplist.h
+ * Description: Skip list có thứ tự với rank (order-statistic)
+ * 
+ * - Key là chuỗi byte độ dài cố định, so sánh bằng memcmp
+ *   => encode số big-endian để thứ tự byte trùng thứ tự số
+ * - Mỗi link lưu "span" (số node đi qua) nên rank/select là O(log n)
+ * - KHÔNG thread-safe: caller tự giữ lock
+ * ============================================================================
+ */
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================================
+ *                           CONSTANTS
+ * ============================================================================ */
+
+#define SKIPLIST_MAX_LEVEL  24          // Đủ cho ~16 triệu phần tử (p = 1/2)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * SkipNode - Một phần tử trong skip list
+ * 
+ * Key được lưu ngay sau mảng links (cùng một lần malloc)
+ */
+typedef struct SkipNode {
+    int value;                          // Payload (room slot, session ID, ...)
+    int level;                          // Số tầng của node
+    unsigned char *key;                 // Trỏ vào vùng nhớ cuối node
+    struct {
+        struct SkipNode *next;          // Node kế tiếp ở tầng này
+        size_t span;                    // Số node level-0 nhảy qua
+    } links[];
+} SkipNode;
+
+/**
+ * SkipList - Danh sách có thứ tự theo key
+ */
+typedef struct {
+    SkipNode *head;                     // Node đầu (không chứa dữ liệu)
+    size_t key_len;                     // Độ dài key (byte)
+    size_t length;                      // Số phần tử
+    int level;                          // Tầng cao nhất đang dùng
+    uint32_t rng_state;                 // PRNG riêng để chọn level
+} SkipList;
+
+/* ============================================================================
+ *                           LIFECYCLE
+ * ============================================================================ */
+
+/**
+ * Khởi tạo skip list rỗng
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ
+ */
+int skiplist_init(SkipList *sl, size_t key_len);
+
+/**
+ * Giải phóng toàn bộ node
+ */
+void skiplist_free(SkipList *sl);
+
+/* ============================================================================
+ *                           MODIFICATION
+ * ============================================================================ */
+
+/**
+ * Thêm phần tử (key phải chưa tồn tại)
+ * @return 0 nếu thành công, -1 nếu key đã có hoặc hết bộ nhớ
+ */
+int skiplist_insert(SkipList *sl, const void *key, int value);
+
+/**
+ * Xóa phần tử theo key
+ * @return 0 nếu đã xóa, -1 nếu không tìm thấy
+ */
+int skiplist_remove(SkipList *sl, const void *key);
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+/**
+ * Tìm node đầu tiên có key >= key
+ * @param rank Output: số phần tử có key < key (có thể NULL)
+ * @return Node, hoặc NULL nếu không có
+ */
+SkipNode *skiplist_lower_bound(SkipList *sl, const void *key, size_t *rank);
+
+/**
+ * Tìm node đầu tiên có key > key
+ * @param rank Output: số phần tử có key <= key (có thể NULL)
+ */
+SkipNode *skiplist_upper_bound(SkipList *sl, const void *key, size_t *rank);
+
+/**
+ * Lấy node ở vị trí rank (0-based)
+ * @return Node, hoặc NULL nếu rank >= length
+ */
+SkipNode *skiplist_at(SkipList *sl, size_t rank);
+
+/**
+ * Node đầu tiên / node kế tiếp (duyệt theo thứ tự tăng dần)
+ */
+SkipNode *skiplist_first(SkipList *sl);
+SkipNode *skiplist_next(SkipNode *node);
+
+#endif // SKIPLIST_H
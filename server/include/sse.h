@@ -11,6 +11,7 @@
 #define SSE_H
 
 #include "types.h"
+#include "profiled_mutex.h"
 #include <pthread.h>
 
 /* ============================================================================
@@ -20,16 +21,55 @@
 // Danh sách tất cả SSE clients
 extern SSE_Client sse_clients[MAX_CLIENTS];
 
-// Mutex để bảo vệ danh sách SSE clients
-extern pthread_mutex_t clients_mutex;
+// Mutex để bảo vệ danh sách SSE clients (MUTEX_LOCK / MUTEX_UNLOCK)
+extern ProfiledMutex clients_mutex;
 
 // ID phiên tiếp theo
 extern int next_session_id;
 
+/**
+ * SSE_Stats - Snapshot cho GET /metrics
+ */
+typedef struct {
+    int clients;                        // Client đang mở
+    size_t queued_bytes;                // Byte đang chờ trong queue của mọi client
+} SSE_Stats;
+
 /* ============================================================================
  *                           SSE CONNECTION FUNCTIONS
  * ============================================================================ */
 
+/**
+ * Khởi tạo bảng client, index theo session / room và thread flush
+ * (epoll: gửi tiếp queue khi socket ghi được, bỏ client đã đóng kết nối)
+ */
+void init_sse(void);
+
+/**
+ * Thêm socket (đã gửi HTTP headers) vào danh sách SSE
+ * 
+ * Socket chuyển sang non-blocking; message connected kèm session_id là
+ * event đầu tiên client nhận được.
+ * 
+ * @return Session ID mới, -1 nếu đã đủ MAX_CLIENTS (socket bị đóng)
+ */
+int sse_register_client(int client_sock);
+
+/**
+ * Đóng stream của một session (nếu còn mở)
+ */
+void sse_close_session(int session_id);
+
+/**
+ * Cập nhật room_id và player_name cho SSE client (chuyển danh sách người nhận)
+ */
+void update_sse_client_room(int session_id, int room_id, const char *player_name);
+
+/**
+ * Số client và byte đang chờ gửi
+ */
+void sse_stats(SSE_Stats *out);
+
 /**
  * Xử lý request subscribe SSE
  * 
@@ -46,13 +86,19 @@ void handle_sse_subscribe(int client_sock);
  *                           BROADCAST FUNCTIONS
  * ============================================================================ */
 
+/*
+ * Mọi broadcast chỉ duyệt client đích (bảng băm session, danh sách theo
+ * room / lobby) và không bao giờ chặn: socket đầy thì phần còn lại vào queue
+ * của client, queue vượt SSE_QUEUE_MAX_BYTES thì client bị ngắt.
+ */
+
 /**
  * Gửi SSE message đến một session cụ thể
  * 
  * @param session_id Session ID cần gửi
  * @param json_data JSON data để gửi
  */
-void broadcast_sse_to_session(int session_id, char *json_data);
+void broadcast_sse_to_session(int session_id, const char *json_data);
 
 /**
  * Gửi SSE message đến tất cả người chơi trong một phòng
@@ -60,6 +106,25 @@ void broadcast_sse_to_session(int session_id, char *json_data);
  * @param room_id Room ID cần gửi
  * @param json_data JSON data để gửi
  */
-void broadcast_sse_to_room(int room_id, char *json_data);
+void broadcast_sse_to_room(int room_id, const char *json_data);
+
+/**
+ * Gửi SSE message đến tất cả clients đang ở lobby (chưa vào phòng nào)
+ * 
+ * @param json_data JSON data để gửi
+ */
+void broadcast_sse_to_lobby(const char *json_data);
+
+/**
+ * Gửi SSE message kèm rank riêng của từng người chơi (arena)
+ * 
+ * Mỗi client nhận json_prefix + ,"my_rank":R,"my_score":S}
+ * 
+ * @param room_id Room ID cần gửi
+ * @param json_prefix JSON object chưa có dấu } đóng
+ * @param ranks Rank của các session (bị sắp xếp lại theo session_id)
+ * @param rank_count Số entries trong ranks
+ */
+void broadcast_sse_to_room_ranked(int room_id, const char *json_prefix, SSE_RankEntry *ranks, int rank_count);
 
 #endif // SSE_H
@@ -0,0 +1,67 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TAG INDEX
+ * ============================================================================
+ * File: tag_index.h
+ * Description: Tag -> bitmap các item mang tag đó
+ *
+ * Tag của item là chuỗi "tag1,tag2" trong catalog (cột thứ 4 của
+ * items.txt). Mỗi catalog được index riêng trên thread load của nó (index
+ * cục bộ từ 0), sau đó tag_index_merge() ghép vào index chung với offset
+ * là index đầu của catalog trong tập catalog.
+ * ============================================================================
+ */
+
+#ifndef TAG_INDEX_H
+#define TAG_INDEX_H
+
+#include <stdint.h>
+#include "bitmap.h"
+#include "catalog.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    char *name;
+    Bitmap items;
+} TagEntry;
+
+/**
+ * TagIndex - Bảng băm mở tên tag -> TagEntry
+ */
+typedef struct {
+    TagEntry *entries;              // Theo thứ tự gặp lần đầu
+    int count;
+    int cap;
+    int *slots;                     // Index vào entries + 1, 0 = trống
+    int slot_count;                 // Lũy thừa của 2
+} TagIndex;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+void tag_index_init(TagIndex *index);
+void tag_index_free(TagIndex *index);
+
+/**
+ * Index tag của mọi item trong catalog với index item = base + i
+ *
+ * Gọi theo thứ tự base tăng dần (bitmap chỉ append).
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ
+ */
+int tag_index_add_catalog(TagIndex *index, const Catalog *catalog, uint32_t base);
+
+/**
+ * Ghép src vào dst, mọi index item cộng thêm offset
+ */
+int tag_index_merge(TagIndex *dst, const TagIndex *src, uint32_t offset);
+
+/**
+ * Bitmap của tag, NULL nếu không có item nào mang tag
+ */
+const Bitmap *tag_index_find(const TagIndex *index, const char *name);
+
+#endif // TAG_INDEX_H
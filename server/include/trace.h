@@ -0,0 +1,89 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TRACING
+ * ============================================================================
+ * File: trace.h
+ * Description: Span theo request / round, xuất ra Chrome trace-event JSON
+ *
+ * - Sampling: GAME_TRACE_SAMPLE=N trace 1 trên N request (0 = tắt, mặc định);
+ *   round kết thúc luôn được trace khi tracing bật (request đó được nâng lên)
+ * - Span ghi vào TRACE_BUFFERS ring, mỗi thread gắn vào một ring
+ *   (round-robin); ring đầy thì ghi đè span cũ nhất (flight recorder)
+ * - Request không được sample: trace_start() chỉ đọc một biến thread-local
+ * - Dump: GET /trace (mở bằng chrome://tracing hoặc Perfetto), hoặc
+ *   kill -USR2 <pid> ghi ra GAME_TRACE_FILE
+ * ============================================================================
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "metrics.h"
+
+/* ============================================================================
+ *                           SAMPLING STATE
+ * ============================================================================ */
+
+// Request hiện tại của thread có được trace không
+extern __thread int trace_sampled;
+
+// 1/N request được sample (0 = tắt), chỉ đặt lúc khởi động (GAME_TRACE_SAMPLE)
+extern int trace_sample_every;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Đọc GAME_TRACE_SAMPLE, cài handler SIGUSR2 + thread ghi file dump
+ */
+void trace_init(void);
+
+/**
+ * Quyết định sample cho request mới của thread này (gọi trong handle_client)
+ */
+void trace_request_begin(void);
+
+static inline void trace_request_end(void) {
+    trace_sampled = 0;
+}
+
+/**
+ * Trace nốt request hiện tại nếu tracing đang bật (round kết thúc)
+ */
+static inline void trace_promote(void) {
+    if (__atomic_load_n(&trace_sample_every, __ATOMIC_RELAXED) > 0) trace_sampled = 1;
+}
+
+/**
+ * Mốc bắt đầu span; 0 nếu request không được sample
+ */
+static inline uint64_t trace_start(void) {
+    return trace_sampled ? metrics_now_ns() : 0;
+}
+
+/**
+ * Mốc thời gian khi tracing bật (dù request chưa được sample): dùng trước
+ * các đoạn có thể dẫn tới trace_promote(), như chờ rooms_mutex
+ */
+static inline uint64_t trace_clock(void) {
+    return __atomic_load_n(&trace_sample_every, __ATOMIC_RELAXED) > 0 ? metrics_now_ns() : 0;
+}
+
+/**
+ * Ghi span [start, end] (name phải là chuỗi hằng; arg: room / session id)
+ * Bỏ qua nếu request không được sample hoặc start == 0.
+ */
+void trace_span(const char *name, uint64_t start, uint64_t end, int64_t arg);
+
+static inline void trace_end(const char *name, uint64_t start, int64_t arg) {
+    if (start) trace_span(name, start, metrics_now_ns(), arg);
+}
+
+/**
+ * GET /trace - Span đang có trong ring (Chrome trace-event JSON)
+ */
+void handle_trace(int sock);
+
+#endif // TRACE_H
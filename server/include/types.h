@@ -11,6 +11,10 @@
 #define TYPES_H
 
 #include "config.h"
+#include "skiplist.h"
+#include "json_cache.h"
+#include "deck.h"
+#include "bitmap.h"
 
 /* ============================================================================
  *                           ENUMERATIONS
@@ -26,19 +30,32 @@ typedef enum {
     ROOM_FINISHED       // Game đã kết thúc
 } RoomStatus;
 
+/**
+ * Room Difficulty - Cách chọn item B mỗi round
+ */
+typedef enum {
+    DIFFICULTY_RANDOM = 0,  // Rút ngẫu nhiên từ bộ của phòng (mặc định)
+    DIFFICULTY_RAMP         // Tỉ lệ giá A/B hẹp dần theo current_round
+} RoomDifficulty;
+
 /* ============================================================================
  *                           GAME STRUCTURES
  * ============================================================================ */
 
+// Catalog item có refcount (database.c), phòng giữ reference suốt game
+typedef struct ItemCatalog ItemCatalog;
+
 /**
  * GameItem - Một item trong game (coin, stock, etc.)
  * 
  * Ví dụ: Bitcoin với giá $50000
+ * View trỏ vào string heap của catalog (item_catalog_get), không copy
+ * chuỗi; value và chuỗi đọc thẳng từ catalog đang map (item_store.h).
  */
 typedef struct {
-    char name[ITEM_NAME_LEN];           // Tên item: "Bitcoin"
+    const char *name;                   // Tên item: "Bitcoin"
     int value;                          // Giá trị: 50000
-    char image_url[IMAGE_URL_LEN];      // URL hình ảnh
+    const char *image_url;              // URL hình ảnh
 } GameItem;
 
 /* ============================================================================
@@ -64,20 +81,13 @@ typedef struct {
     int has_answered;                   // Đã trả lời câu hiện tại chưa
     int last_answer_correct;            // Câu trả lời cuối có đúng không
     int response_time_ms;               // Thời gian trả lời (milliseconds)
+    int total_response_ms;              // Tổng thời gian trả lời cả game (tie-break xếp hạng)
+    
+    // Serialization cache (xem json_cache.h)
+    unsigned int version;               // Tăng mỗi khi field trong JSON thay đổi
+    JsonFragment json;                  // Entry trong "players" đã build
 } RoomPlayer;
 
-/**
- * PlayerGameState - Game state cho chế độ chơi đơn (legacy)
- */
-typedef struct {
-    int active;                         // Có đang hoạt động không
-    int session_id;                     // ID session
-    int score;                          // Điểm
-    int streak;                         // Chuỗi đúng
-    int current_index_A;                // Index item A
-    int current_index_B;                // Index item B
-} PlayerGameState;
-
 /* ============================================================================
  *                           ROOM STRUCTURES
  * ============================================================================ */
@@ -93,20 +103,37 @@ typedef struct {
     int host_session_id;                        // Session ID của chủ phòng
     
     // Players
-    RoomPlayer players[MAX_PLAYERS_PER_ROOM];   // Danh sách người chơi
+    RoomPlayer *players;                        // Danh sách người chơi (cấp phát max_players)
     int player_count;                           // Số người chơi hiện tại
     int max_players;                            // Số người chơi tối đa
+    int is_arena;                               // Phòng arena: broadcast top K thay vì tất cả
     
     // Game settings
     int max_rounds;                             // Số câu hỏi tối đa (0 = unlimited)
+    RoomDifficulty difficulty;                  // Đường cong độ khó của cặp item
+    char catalogs[ROOM_FILTER_LEN];             // Catalog được chọn "tech,cars" ("" = tất cả)
+    char tags[ROOM_FILTER_LEN];                 // Tag bắt buộc "apple,phone" ("" = không lọc)
     
     // Current question (shared by all players)
+    ItemCatalog *items;                         // Catalog của game (giữ reference, NULL trước khi start)
+    ItemDeck deck;                              // Bộ item đã xáo + PRNG của game (deck.seed để replay)
+    Bitmap pool;                                // Item thỏa catalogs/tags (rỗng = mọi item); lá của bộ là thứ hạng trong pool
     int current_index_A;                        // Index của item A
     int current_index_B;                        // Index của item B
     int current_round;                          // Vòng hiện tại
+    uint64_t round_deadline_ns;                 // Arena: round tự đóng lúc này (metrics_now_ns, 0 = không hạn)
+    
+    // Aggregates (cập nhật incremental, không cần duyệt players)
+    int answered_count;                         // Số người đã trả lời round hiện tại
+    int correct_count;                          // Số người trả lời đúng round hiện tại
+    SkipList ranking;                           // Bảng xếp hạng (xem room_rank.h)
     
     // Status
     RoomStatus status;                          // Trạng thái phòng
+    
+    // Serialization cache (xem json_cache.h)
+    unsigned int version;                       // Tăng khi room hoặc player bất kỳ thay đổi
+    JsonFragment json;                          // build_room_json() đã build
 } GameRoom;
 
 /* ============================================================================
@@ -116,7 +143,9 @@ typedef struct {
 /**
  * SSE_Client - Thông tin client kết nối SSE
  * 
- * Mỗi client có một SSE connection để nhận real-time updates
+ * Mỗi client có một SSE connection để nhận real-time updates.
+ * Socket non-blocking: phần chưa gửi được nằm trong out (tối đa
+ * SSE_QUEUE_MAX_BYTES), thread flush của sse.c gửi tiếp khi socket ghi được.
  */
 typedef struct {
     int socket;                         // Socket descriptor
@@ -124,6 +153,19 @@ typedef struct {
     int session_id;                     // ID session
     char player_name[PLAYER_NAME_LEN];  // Tên người chơi
     int room_id;                        // ID phòng đang ở (-1 nếu không ở phòng nào)
+    int room_prev, room_next;           // Danh sách client cùng bucket room (-1 = hết)
+    int session_next;                   // Chuỗi bảng băm session (-1 = hết)
+    char *out;                          // Byte chờ gửi (NULL khi chưa cần)
+    size_t out_off, out_len, out_cap;   // Đã gửi / đang có / dung lượng
 } SSE_Client;
 
+/**
+ * SSE_RankEntry - Rank riêng của một người nhận trong broadcast arena
+ */
+typedef struct {
+    int session_id;                     // Session nhận message
+    int rank;                           // Hạng hiện tại
+    int score;                          // Điểm hiện tại
+} SSE_RankEntry;
+
 #endif // TYPES_H
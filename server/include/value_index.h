@@ -0,0 +1,66 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - VALUE INDEX
+ * ============================================================================
+ * File: value_index.h
+ * Description: Index item của catalog sắp theo value
+ *
+ * Trả lời "chọn B sao cho max(vA, vB) / min(vA, vB) nằm trong [lo, hi]"
+ * bằng hai lần binary search trên mảng value liền mạch: O(log n), không
+ * duyệt catalog. Build một lần cho mỗi phiên bản catalog bằng radix sort
+ * (O(n), vài chục ms với catalog hàng triệu item).
+ * ============================================================================
+ */
+
+#ifndef VALUE_INDEX_H
+#define VALUE_INDEX_H
+
+#include <stdint.h>
+#include "bitmap.h"
+#include "item_store.h"
+#include "prng.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * ValueIndex - values[i] là value của item items[i], values tăng dần
+ */
+typedef struct {
+    int32_t *values;
+    uint32_t *items;
+    int count;
+} ValueIndex;
+
+/* ============================================================================
+ *                           FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Sắp mọi item của store theo value (đọc mảng value của từng catalog)
+ *
+ * @return 0 nếu thành công, -1 nếu hết bộ nhớ (index rỗng)
+ */
+int value_index_build(ValueIndex *index, const ItemStore *items);
+
+void value_index_free(ValueIndex *index);
+
+/**
+ * Vị trí đầu tiên có values[pos] >= value (count nếu không có)
+ */
+int value_index_lower_bound(const ValueIndex *index, int64_t value);
+
+/**
+ * Chọn ngẫu nhiên (đều) một item khác except có tỉ lệ value với value_a
+ * trong [lo, hi] (lo >= 1)
+ *
+ * @param filter Chỉ nhận item trong bitmap này (NULL = mọi item); ứng viên
+ *               ngoài filter được rút lại vài lần rồi bỏ cuộc
+ * @return Index item, -1 nếu không có ứng viên
+ *         (value_a <= 0, hoặc khoảng quá hẹp với catalog / filter này)
+ */
+int value_index_pick_ratio(const ValueIndex *index, Prng *rng, const Bitmap *filter,
+                           int except, int value_a, double lo, double hi);
+
+#endif // VALUE_INDEX_H
@@ -0,0 +1,309 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - WIRE MESSAGE SCHEMAS
+ * ============================================================================
+ * File: wire_schema.h
+ * Description: Khai báo schema message một lần, encoder sinh từ bảng
+ *
+ * Mỗi message (hoặc phần phẳng của message) là một danh sách field X-macro.
+ * Từ danh sách đó sinh ra:
+ *   - struct C chứa giá trị (WirePlayer, WireChoiceResult, ...)
+ *   - bảng WireField hằng (key, kiểu, offset) trong wire_schema.c
+ *
+ * Encoder JSON, binary và delta chỉ là vòng lặp trên bảng, nên thêm field
+ * chỉ cần sửa một dòng, thêm transport mới chỉ cần viết một encoder.
+ *
+ * Phần lồng nhau (room.players, results[], ...) vẫn do builder trong
+ * room_helpers/arena ghép: builder gọi wire_json_fields() vào object đang
+ * mở rồi tự ghi các key lồng nhau.
+ * ============================================================================
+ */
+
+#ifndef WIRE_SCHEMA_H
+#define WIRE_SCHEMA_H
+
+#include <stddef.h>
+#include "json_writer.h"
+
+/* ============================================================================
+ *                           FIELD TYPES
+ * ============================================================================ */
+
+/**
+ * INT:    int, JSON số / binary zigzag varint
+ * BOOL:   int, JSON true/false / binary 1 byte
+ * STRING: const char * (không copy; NULL = ""), binary varint độ dài + bytes
+ * ENUM:   int, JSON tên trong WireEnum / binary varint
+ */
+typedef enum {
+    WF_INT = 0,
+    WF_BOOL,
+    WF_STRING,
+    WF_ENUM
+} WireFieldType;
+
+/**
+ * WireEnum - Bảng tên cho field ENUM
+ */
+typedef struct {
+    const char *const *names;
+    int count;
+} WireEnum;
+
+/**
+ * WireField - Mô tả một field
+ */
+typedef struct {
+    const char *key;
+    unsigned char key_len;
+    unsigned char type;             // WireFieldType
+    unsigned short offset;          // offsetof trong struct message
+    const WireEnum *names;          // Chỉ dùng cho ENUM
+} WireField;
+
+/**
+ * WireSchema - Bảng field của một message
+ *
+ * Field đầu tiên là khóa định danh: delta luôn mang theo nó.
+ */
+typedef struct {
+    const char *name;
+    const char *action;             // "action" ghi đầu object (NULL = không có)
+    unsigned short id;              // Tag binary (WIRE_SCHEMA_xxx)
+    unsigned short field_count;
+    const WireField *fields;
+} WireSchema;
+
+extern const WireEnum wire_room_status_enum;     // empty/waiting/playing/finished
+extern const WireEnum wire_room_difficulty_enum; // random/ramp
+
+/**
+ * Giá trị của tên trong bảng enum, -1 nếu không có
+ */
+int wire_enum_value(const WireEnum *e, const char *name);
+
+/* ============================================================================
+ *                           FIELD LISTS
+ * ============================================================================ */
+
+/* X(T, field, "key", kiểu, bảng enum hoặc 0) - T là struct message (cho offsetof) */
+
+#define WIRE_PLAYER_FIELDS(X, T) \
+    X(T, session_id,    "session_id",    INT,    0) \
+    X(T, name,          "name",          STRING, 0) \
+    X(T, score,         "score",         INT,    0) \
+    X(T, streak,        "streak",        INT,    0) \
+    X(T, is_ready,      "is_ready",      INT,    0) \
+    X(T, game_over,     "game_over",     INT,    0) \
+    X(T, has_answered,  "has_answered",  INT,    0) \
+    X(T, is_host,       "is_host",       BOOL,   0)
+
+#define WIRE_ROOM_FIELDS(X, T) \
+    X(T, id,              "id",              INT,    0) \
+    X(T, name,            "name",            STRING, 0) \
+    X(T, host_session_id, "host_session_id", INT,    0) \
+    X(T, player_count,    "player_count",    INT,    0) \
+    X(T, max_players,     "max_players",     INT,    0) \
+    X(T, max_rounds,      "max_rounds",      INT,    0) \
+    X(T, status,          "status",          ENUM,   &wire_room_status_enum) \
+    X(T, current_round,   "current_round",   INT,    0) \
+    X(T, arena,           "arena",           BOOL,   0) \
+    X(T, difficulty,      "difficulty",      ENUM,   &wire_room_difficulty_enum) \
+    X(T, catalogs,        "catalogs",        STRING, 0) \
+    X(T, tags,            "tags",            STRING, 0)
+
+#define WIRE_ROOM_SUMMARY_FIELDS(X, T) \
+    X(T, id,            "id",            INT,    0) \
+    X(T, name,          "name",          STRING, 0) \
+    X(T, player_count,  "player_count",  INT,    0) \
+    X(T, max_players,   "max_players",   INT,    0) \
+    X(T, status,        "status",        ENUM,   &wire_room_status_enum) \
+    X(T, arena,         "arena",         BOOL,   0)
+
+#define WIRE_LEADERBOARD_ENTRY_FIELDS(X, T) \
+    X(T, rank,                "rank",                INT,    0) \
+    X(T, session_id,          "session_id",          INT,    0) \
+    X(T, name,                "name",                STRING, 0) \
+    X(T, score,               "score",               INT,    0) \
+    X(T, streak,              "streak",              INT,    0) \
+    X(T, total_response_time, "total_response_time", INT,    0)
+
+#define WIRE_ROUND_RESULT_FIELDS(X, T) \
+    X(T, rank,           "rank",           INT,    0) \
+    X(T, session_id,     "session_id",     INT,    0) \
+    X(T, name,           "name",           STRING, 0) \
+    X(T, correct,        "correct",        BOOL,   0) \
+    X(T, score,          "score",          INT,    0) \
+    X(T, streak,         "streak",         INT,    0) \
+    X(T, response_time,  "response_time",  INT,    0)
+
+#define WIRE_ROUND_RESULTS_FIELDS(X, T) \
+    X(T, round,   "round",   INT,    0) \
+    X(T, valueB,  "valueB",  INT,    0) \
+    X(T, labelB,  "labelB",  STRING, 0)
+
+#define WIRE_ARENA_STATS_FIELDS(X, T) \
+    X(T, players,   "players",   INT, 0) \
+    X(T, answered,  "answered",  INT, 0) \
+    X(T, correct,   "correct",   INT, 0)
+
+#define WIRE_ROUND_START_FIELDS(X, T) \
+    X(T, round,   "round",   INT,    0) \
+    X(T, labelA,  "labelA",  STRING, 0) \
+    X(T, valueA,  "valueA",  INT,    0) \
+    X(T, labelB,  "labelB",  STRING, 0)
+
+#define WIRE_CHOICE_RESULT_FIELDS(X, T) \
+    X(T, correct,        "correct",        BOOL,   0) \
+    X(T, score,          "score",          INT,    0) \
+    X(T, streak,         "streak",         INT,    0) \
+    X(T, message,        "message",        STRING, 0) \
+    X(T, valueB,         "valueB",         INT,    0) \
+    X(T, waiting_for,    "waiting_for",    INT,    0) \
+    X(T, response_time,  "response_time",  INT,    0)
+
+#define WIRE_ROOM_INFO_FIELDS(X, T) \
+    X(T, in_room,       "in_room",       BOOL,   0) \
+    X(T, is_host,       "is_host",       BOOL,   0) \
+    X(T, round,         "round",         INT,    0) \
+    X(T, my_score,      "my_score",      INT,    0) \
+    X(T, my_streak,     "my_streak",     INT,    0) \
+    X(T, my_rank,       "my_rank",       INT,    0) \
+    X(T, my_game_over,  "my_game_over",  BOOL,   0) \
+    X(T, has_answered,  "has_answered",  BOOL,   0) \
+    X(T, labelA,        "labelA",        STRING, 0) \
+    X(T, valueA,        "valueA",        INT,    0) \
+    X(T, labelB,        "labelB",        STRING, 0)
+
+#define WIRE_PLAYER_INFO_FIELDS(X, T) \
+    X(T, session_id,           "session_id",           INT,    0) \
+    X(T, name,                 "name",                 STRING, 0) \
+    X(T, score,                "score",                INT,    0) \
+    X(T, streak,               "streak",               INT,    0) \
+    X(T, rank,                 "rank",                 INT,    0) \
+    X(T, has_answered,         "has_answered",         BOOL,   0) \
+    X(T, game_over,            "game_over",            BOOL,   0) \
+    X(T, response_time,        "response_time",        INT,    0) \
+    X(T, total_response_time,  "total_response_time",  INT,    0)
+
+#define WIRE_UPDATE_GAME_FIELDS(X, T) \
+    X(T, score,    "score",    INT,    0) \
+    X(T, streak,   "streak",   INT,    0) \
+    X(T, labelA,   "labelA",   STRING, 0) \
+    X(T, valueA,   "valueA",   INT,    0) \
+    X(T, imageA,   "imageA",   STRING, 0) \
+    X(T, labelB,   "labelB",   STRING, 0) \
+    X(T, valueB,   "valueB",   INT,    0) \
+    X(T, imageB,   "imageB",   STRING, 0) \
+    X(T, message,  "message",  STRING, 0) \
+    X(T, round,    "round",    INT,    0) \
+    X(T, token,    "token",    STRING, 0)
+
+/* ============================================================================
+ *                           SCHEMA LIST
+ * ============================================================================ */
+
+/* S(ID, kiểu struct, action, danh sách field) - thứ tự = tag binary */
+#define WIRE_SCHEMAS(S) \
+    S(PLAYER,            WirePlayer,            NULL,            WIRE_PLAYER_FIELDS) \
+    S(ROOM,              WireRoom,              NULL,            WIRE_ROOM_FIELDS) \
+    S(ROOM_SUMMARY,      WireRoomSummary,       NULL,            WIRE_ROOM_SUMMARY_FIELDS) \
+    S(LEADERBOARD_ENTRY, WireLeaderboardEntry,  NULL,            WIRE_LEADERBOARD_ENTRY_FIELDS) \
+    S(ROUND_RESULT,      WireRoundResult,       NULL,            WIRE_ROUND_RESULT_FIELDS) \
+    S(ROUND_RESULTS,     WireRoundResults,      "round_results", WIRE_ROUND_RESULTS_FIELDS) \
+    S(ARENA_STATS,       WireArenaStats,        NULL,            WIRE_ARENA_STATS_FIELDS) \
+    S(ROUND_START,       WireRoundStart,        NULL,            WIRE_ROUND_START_FIELDS) \
+    S(CHOICE_RESULT,     WireChoiceResult,      "choice_result", WIRE_CHOICE_RESULT_FIELDS) \
+    S(ROOM_INFO,         WireRoomInfo,          "room_info",     WIRE_ROOM_INFO_FIELDS) \
+    S(PLAYER_INFO,       WirePlayerInfo,        NULL,            WIRE_PLAYER_INFO_FIELDS) \
+    S(UPDATE_GAME,       WireUpdateGame,        "update_game",   WIRE_UPDATE_GAME_FIELDS)
+
+typedef enum {
+#define WIRE_SCHEMA_ENUM(id, type, action, fields) WIRE_SCHEMA_##id,
+    WIRE_SCHEMAS(WIRE_SCHEMA_ENUM)
+#undef WIRE_SCHEMA_ENUM
+    WIRE_SCHEMA_COUNT
+} WireSchemaId;
+
+/* ============================================================================
+ *                           MESSAGE STRUCTS
+ * ============================================================================ */
+
+#define WIRE_DECLARE_INT(field)     int field;
+#define WIRE_DECLARE_BOOL(field)    int field;
+#define WIRE_DECLARE_ENUM(field)    int field;
+#define WIRE_DECLARE_STRING(field)  const char *field;
+#define WIRE_FIELD_DECL(stype, field, key, type, names) WIRE_DECLARE_##type(field)
+#define WIRE_STRUCT_DECL(id, type, action, fields) \
+    typedef struct { fields(WIRE_FIELD_DECL, type) } type;
+
+WIRE_SCHEMAS(WIRE_STRUCT_DECL)
+
+#undef WIRE_STRUCT_DECL
+#undef WIRE_FIELD_DECL
+
+extern const WireSchema wire_schemas[WIRE_SCHEMA_COUNT];
+
+#define WIRE_SCHEMA(id)     (&wire_schemas[WIRE_SCHEMA_##id])
+
+/* Số field tối đa mỗi schema (bitmask delta binary dùng unsigned int) */
+#define WIRE_MAX_FIELDS     32
+
+/* ============================================================================
+ *                           JSON ENCODERS
+ * ============================================================================ */
+
+/**
+ * Ghi "action" (nếu schema có) và mọi field vào object đang mở
+ */
+void wire_json_fields(JsonWriter *w, const WireSchema *schema, const void *msg);
+
+/**
+ * Ghi message thành một object hoàn chỉnh
+ */
+void wire_json_object(JsonWriter *w, const WireSchema *schema, const void *msg);
+
+/**
+ * Đếm số field (không tính khóa) khác nhau giữa old và cur
+ */
+int wire_delta_count(const WireSchema *schema, const void *old, const void *cur);
+
+/**
+ * Ghi object chỉ gồm field khóa và các field khác nhau giữa old và cur
+ *
+ * @return Số field đã đổi (không tính field khóa)
+ */
+int wire_json_delta(JsonWriter *w, const WireSchema *schema, const void *old, const void *cur);
+
+/* ============================================================================
+ *                           BINARY ENCODERS
+ * ============================================================================ */
+
+/**
+ * Binary: varint tag schema, rồi các field theo thứ tự bảng
+ *
+ * @return Số byte đã ghi, 0 nếu out không đủ chỗ
+ */
+size_t wire_binary_encode(const WireSchema *schema, const void *msg, unsigned char *out, size_t cap);
+
+/**
+ * Binary delta: varint tag, varint bitmask field có mặt (luôn gồm khóa),
+ * rồi giá trị các field đó
+ *
+ * @return Số byte đã ghi, 0 nếu out không đủ chỗ
+ */
+size_t wire_binary_delta(const WireSchema *schema, const void *old, const void *cur,
+                         unsigned char *out, size_t cap);
+
+/**
+ * Decode binary (đầy đủ hoặc delta) vào msg
+ *
+ * Field STRING trỏ vào strings (mỗi chuỗi kết thúc bằng '\0'). Với delta,
+ * field không có mặt giữ nguyên giá trị cũ trong msg.
+ *
+ * @return 0 nếu thành công, -1 nếu dữ liệu sai tag / hỏng / strings không đủ chỗ
+ */
+int wire_binary_decode(const WireSchema *schema, const unsigned char *in, size_t len,
+                       int is_delta, void *msg, char *strings, size_t strings_cap);
+
+#endif // WIRE_SCHEMA_H
@@ -0,0 +1,122 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ARENA MODE
+ * ============================================================================
+ * File: arena.c
+ * Description: JSON builders + hạn round cho arena rooms
+ * 
+ * Arena có thể có ARENA_MAX_PLAYERS người, nên mọi broadcast chỉ chứa
+ * thống kê tổng hợp + top K (lấy từ bảng xếp hạng của room, O(K)); rank
+ * riêng của từng người được nối vào message khi gửi
+ * (xem broadcast_sse_to_room_ranked).
+ *
+ * Round arena không chờ người cuối cùng: sau ARENA_ROUND_DEADLINE_MS thread
+ * hẹn giờ đóng round (người chưa trả lời không được điểm), nên một người
+ * đóng tab không làm phòng hàng chục nghìn người đứng im.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/game.h"
+#include "../include/arena.h"
+#include "../include/room_helpers.h"
+#include "../include/room_rank.h"
+#include "../include/metrics.h"
+
+/* ============================================================================
+ *                           JSON BUILDERS
+ * ============================================================================ */
+
+void build_arena_round_results_prefix(JsonWriter *w, GameRoom *room, int round, int valueB,
+                                      const char *labelB) {
+    RoomPlayer *top[ARENA_TOP_K];
+    int n = room_rank_top(room, top, ARENA_TOP_K);
+    
+    WireRoundResults header = { .round = round, .valueB = valueB, .labelB = labelB };
+    WireArenaStats stats = {
+        .players = room->player_count,
+        .answered = room->answered_count,
+        .correct = room->correct_count,
+    };
+    
+    jw_object_begin(w);
+    wire_json_fields(w, WIRE_SCHEMA(ROUND_RESULTS), &header);
+    jw_kv_bool(w, "arena", 1);
+    
+    jw_key(w, "stats");
+    wire_json_object(w, WIRE_SCHEMA(ARENA_STATS), &stats);
+    
+    jw_key(w, "results");
+    build_round_result_entries(w, top, n);
+    
+    jw_key(w, "leaderboard");
+    build_leaderboard_json(w, room);
+}
+
+void build_arena_player_json(JsonWriter *w, GameRoom *room, int player_idx) {
+    RoomPlayer *p = &room->players[player_idx];
+    WirePlayerInfo msg = {
+        .session_id = p->session_id,
+        .name = p->name,
+        .score = p->score,
+        .streak = p->streak,
+        .rank = room_rank_of(room, p),
+        .has_answered = p->has_answered,
+        .game_over = p->game_over,
+        .response_time = p->response_time_ms,
+        .total_response_time = p->total_response_ms,
+    };
+    
+    jw_object_begin(w);
+    jw_kv_str(w, "action", "player_info");
+    jw_kv_int(w, "room_id", room->id);
+    jw_key(w, "player");
+    wire_json_object(w, WIRE_SCHEMA(PLAYER_INFO), &msg);
+    jw_object_end(w);
+}
+
+/* ============================================================================
+ *                           ROUND DEADLINE
+ * ============================================================================ */
+
+/**
+ * Mỗi ARENA_TICK_MS: đóng mọi round arena đã quá hạn
+ * 
+ * Message build trong rooms_mutex (close_round_locked), gửi sau khi unlock.
+ */
+static void *arena_timer(void *arg) {
+    (void)arg;
+    RoundClose *closes = malloc(sizeof(RoundClose) * MAX_ROOMS);
+    if (!closes) return NULL;
+    
+    while (1) {
+        usleep(ARENA_TICK_MS * 1000);
+        
+        int count = 0;
+        uint64_t now = metrics_now_ns();
+        MUTEX_LOCK(&rooms_mutex);
+        for (int i = 0; i < MAX_ROOMS; i++) {
+            GameRoom *room = &rooms[i];
+            if (room->status != ROOM_PLAYING || !room->is_arena) continue;
+            if (room->round_deadline_ns == 0 || now < room->round_deadline_ns) continue;
+            
+            LOG_INFO("ARENA", "⏰ Round %d of room %d timed out (%d/%d answered)", room->current_round,
+                     room->id, room->answered_count, room->player_count);
+            close_round_locked(i, &closes[count++]);
+        }
+        MUTEX_UNLOCK(&rooms_mutex);
+        
+        for (int i = 0; i < count; i++) publish_round_close(&closes[i]);
+    }
+    return NULL;
+}
+
+void init_arena_timer(void) {
+    pthread_t thread_id;
+    pthread_create(&thread_id, NULL, arena_timer, NULL);
+    pthread_detach(thread_id);
+}
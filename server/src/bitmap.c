@@ -0,0 +1,518 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - COMPRESSED BITMAP
+ * ============================================================================
+ * File: bitmap.c
+ * Description: Chunk ARRAY/BITS, append tăng dần, AND/OR, select/rank
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/bitmap.h"
+
+/* ============================================================================
+ *                           CHUNKS
+ * ============================================================================ */
+
+static void chunk_free(BitmapChunk *c) {
+    if (c->kind == BITMAP_BITS) {
+        free(c->data.bits);
+    } else {
+        free(c->data.array);
+    }
+    c->data.array = NULL;
+}
+
+/**
+ * Thêm chunk rỗng vào cuối (key lớn hơn mọi chunk hiện có)
+ */
+static BitmapChunk *push_chunk(Bitmap *b, uint16_t key, BitmapChunkKind kind) {
+    if (b->count == b->cap) {
+        int new_cap = b->cap ? b->cap * 2 : 4;
+        BitmapChunk *grown = realloc(b->chunks, sizeof(BitmapChunk) * new_cap);
+        if (!grown) return NULL;
+        b->chunks = grown;
+        b->cap = new_cap;
+    }
+
+    BitmapChunk *c = &b->chunks[b->count];
+    memset(c, 0, sizeof(*c));
+    c->key = key;
+    c->kind = kind;
+    c->rank = b->cardinality;
+    if (kind == BITMAP_BITS) {
+        c->data.bits = calloc(BITMAP_WORDS, sizeof(uint64_t));
+        if (!c->data.bits) return NULL;
+    }
+    b->count++;
+    return c;
+}
+
+static int array_reserve(BitmapChunk *c, uint32_t need) {
+    if (need <= c->cap) return 0;
+    uint32_t new_cap = c->cap ? c->cap * 2 : 8;
+    while (new_cap < need) new_cap *= 2;
+    if (new_cap > BITMAP_ARRAY_MAX) new_cap = BITMAP_ARRAY_MAX;
+    uint16_t *grown = realloc(c->data.array, sizeof(uint16_t) * new_cap);
+    if (!grown) return -1;
+    c->data.array = grown;
+    c->cap = new_cap;
+    return 0;
+}
+
+static int array_to_bits(BitmapChunk *c) {
+    uint64_t *bits = calloc(BITMAP_WORDS, sizeof(uint64_t));
+    if (!bits) return -1;
+    for (uint32_t i = 0; i < c->cardinality; i++) {
+        uint16_t v = c->data.array[i];
+        bits[v >> 6] |= 1ULL << (v & 63);
+    }
+    free(c->data.array);
+    c->data.bits = bits;
+    c->kind = BITMAP_BITS;
+    c->cap = 0;
+    return 0;
+}
+
+/**
+ * Đặt bit [lo, hi) trong một chunk BITS
+ */
+static void bits_set_range(uint64_t *bits, uint32_t lo, uint32_t hi) {
+    while (lo < hi && (lo & 63) != 0) {
+        bits[lo >> 6] |= 1ULL << (lo & 63);
+        lo++;
+    }
+    while (lo + 64 <= hi) {
+        bits[lo >> 6] = ~0ULL;
+        lo += 64;
+    }
+    while (lo < hi) {
+        bits[lo >> 6] |= 1ULL << (lo & 63);
+        lo++;
+    }
+}
+
+static uint32_t bits_count(const uint64_t *bits) {
+    uint32_t n = 0;
+    for (int i = 0; i < BITMAP_WORDS; i++) n += (uint32_t)__builtin_popcountll(bits[i]);
+    return n;
+}
+
+/**
+ * Chunk BITS thưa (<= BITMAP_ARRAY_MAX) thì đổi về ARRAY
+ */
+static int bits_maybe_to_array(BitmapChunk *c) {
+    if (c->kind != BITMAP_BITS || c->cardinality > BITMAP_ARRAY_MAX) return 0;
+
+    uint16_t *array = malloc(sizeof(uint16_t) * (c->cardinality ? c->cardinality : 1));
+    if (!array) return -1;
+    uint32_t n = 0;
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        uint64_t w = c->data.bits[i];
+        while (w) {
+            array[n++] = (uint16_t)(i * 64 + __builtin_ctzll(w));
+            w &= w - 1;
+        }
+    }
+    free(c->data.bits);
+    c->data.array = array;
+    c->kind = BITMAP_ARRAY;
+    c->cap = c->cardinality ? c->cardinality : 1;
+    return 0;
+}
+
+static uint32_t chunk_max_low(const BitmapChunk *c) {
+    if (c->kind == BITMAP_ARRAY) return c->data.array[c->cardinality - 1];
+    for (int i = BITMAP_WORDS - 1; i >= 0; i--) {
+        if (c->data.bits[i]) return (uint32_t)(i * 64 + 63 - __builtin_clzll(c->data.bits[i]));
+    }
+    return 0;
+}
+
+/**
+ * Chunk cuối vừa xong (kết quả AND/OR): bỏ nếu rỗng, cập nhật tổng
+ */
+static void seal_last_chunk(Bitmap *b) {
+    BitmapChunk *c = &b->chunks[b->count - 1];
+    if (c->cardinality == 0) {
+        chunk_free(c);
+        b->count--;
+        return;
+    }
+    b->cardinality += c->cardinality;
+    b->max = ((uint32_t)c->key << 16) | chunk_max_low(c);
+}
+
+/* ============================================================================
+ *                           BUILD
+ * ============================================================================ */
+
+void bitmap_init(Bitmap *b) {
+    memset(b, 0, sizeof(*b));
+}
+
+void bitmap_free(Bitmap *b) {
+    for (int i = 0; i < b->count; i++) chunk_free(&b->chunks[i]);
+    free(b->chunks);
+    memset(b, 0, sizeof(*b));
+}
+
+/**
+ * Chunk cuối có key đã cho, tạo mới nếu chưa có
+ */
+static BitmapChunk *tail_chunk(Bitmap *b, uint16_t key, BitmapChunkKind kind) {
+    if (b->count > 0 && b->chunks[b->count - 1].key == key) return &b->chunks[b->count - 1];
+    return push_chunk(b, key, kind);
+}
+
+int bitmap_add(Bitmap *b, uint32_t value) {
+    if (b->cardinality > 0 && value <= b->max) return -1;
+
+    BitmapChunk *c = tail_chunk(b, (uint16_t)(value >> 16), BITMAP_ARRAY);
+    if (!c) return -1;
+    uint16_t low = (uint16_t)value;
+
+    if (c->kind == BITMAP_ARRAY && c->cardinality == BITMAP_ARRAY_MAX && array_to_bits(c) != 0) {
+        return -1;
+    }
+    if (c->kind == BITMAP_BITS) {
+        c->data.bits[low >> 6] |= 1ULL << (low & 63);
+    } else {
+        if (array_reserve(c, c->cardinality + 1) != 0) return -1;
+        c->data.array[c->cardinality] = low;
+    }
+
+    c->cardinality++;
+    b->cardinality++;
+    b->max = value;
+    return 0;
+}
+
+int bitmap_add_range(Bitmap *b, uint32_t first, uint32_t last) {
+    if (first >= last) return 0;
+    if (b->cardinality > 0 && first <= b->max) return -1;
+
+    while (first < last) {
+        uint16_t key = (uint16_t)(first >> 16);
+        uint64_t chunk_end = ((uint64_t)key + 1) << 16;
+        uint32_t end = chunk_end < last ? (uint32_t)chunk_end : last;
+        uint32_t n = end - first;
+
+        BitmapChunk *c = tail_chunk(b, key, n > BITMAP_ARRAY_MAX ? BITMAP_BITS : BITMAP_ARRAY);
+        if (!c) return -1;
+        if (c->kind == BITMAP_ARRAY && c->cardinality + n > BITMAP_ARRAY_MAX && array_to_bits(c) != 0) {
+            return -1;
+        }
+
+        if (c->kind == BITMAP_BITS) {
+            bits_set_range(c->data.bits, first & 0xFFFF, (first & 0xFFFF) + n);
+        } else {
+            if (array_reserve(c, c->cardinality + n) != 0) return -1;
+            for (uint32_t i = 0; i < n; i++) {
+                c->data.array[c->cardinality + i] = (uint16_t)(first + i);
+            }
+        }
+
+        c->cardinality += n;
+        b->cardinality += n;
+        b->max = end - 1;
+        first = end;
+    }
+    return 0;
+}
+
+/**
+ * Copy nguyên chunk sang dst với key mới (offset chia hết cho 65536)
+ */
+static int clone_chunk(Bitmap *dst, const BitmapChunk *src, uint16_t key) {
+    BitmapChunk *c = push_chunk(dst, key, (BitmapChunkKind)src->kind);
+    if (!c) return -1;
+    if (src->kind == BITMAP_BITS) {
+        memcpy(c->data.bits, src->data.bits, sizeof(uint64_t) * BITMAP_WORDS);
+    } else {
+        if (array_reserve(c, src->cardinality) != 0) return -1;
+        memcpy(c->data.array, src->data.array, sizeof(uint16_t) * src->cardinality);
+    }
+    c->cardinality = src->cardinality;
+    seal_last_chunk(dst);
+    return 0;
+}
+
+int bitmap_append_shifted(Bitmap *dst, const Bitmap *src, uint32_t offset) {
+    for (int i = 0; i < src->count; i++) {
+        const BitmapChunk *s = &src->chunks[i];
+        uint32_t base = ((uint32_t)s->key << 16) + offset;
+
+        // Offset thẳng hàng chunk và chunk đích còn trống: copy cả khối
+        if ((offset & 0xFFFF) == 0 &&
+            (dst->count == 0 || dst->chunks[dst->count - 1].key < (uint16_t)(base >> 16))) {
+            if (clone_chunk(dst, s, (uint16_t)(base >> 16)) != 0) return -1;
+            continue;
+        }
+
+        if (s->kind == BITMAP_ARRAY) {
+            for (uint32_t j = 0; j < s->cardinality; j++) {
+                if (bitmap_add(dst, base + s->data.array[j]) != 0) return -1;
+            }
+        } else {
+            for (int w = 0; w < BITMAP_WORDS; w++) {
+                uint64_t word = s->data.bits[w];
+                while (word) {
+                    if (bitmap_add(dst, base + (uint32_t)(w * 64 + __builtin_ctzll(word))) != 0) return -1;
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/* ============================================================================
+ *                           SET OPERATIONS
+ * ============================================================================ */
+
+static int bits_test(const uint64_t *bits, uint16_t v) {
+    return (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+static int and_chunks(Bitmap *out, const BitmapChunk *a, const BitmapChunk *b) {
+    // ARRAY luôn ở bên a nếu có
+    if (a->kind == BITMAP_BITS && b->kind == BITMAP_ARRAY) {
+        const BitmapChunk *t = a; a = b; b = t;
+    }
+
+    if (a->kind == BITMAP_BITS) {
+        BitmapChunk *c = push_chunk(out, a->key, BITMAP_BITS);
+        if (!c) return -1;
+        for (int i = 0; i < BITMAP_WORDS; i++) c->data.bits[i] = a->data.bits[i] & b->data.bits[i];
+        c->cardinality = bits_count(c->data.bits);
+        if (bits_maybe_to_array(c) != 0) return -1;
+        seal_last_chunk(out);
+        return 0;
+    }
+
+    BitmapChunk *c = push_chunk(out, a->key, BITMAP_ARRAY);
+    if (!c || array_reserve(c, a->cardinality) != 0) return -1;
+    uint32_t n = 0;
+    if (b->kind == BITMAP_BITS) {
+        for (uint32_t i = 0; i < a->cardinality; i++) {
+            if (bits_test(b->data.bits, a->data.array[i])) c->data.array[n++] = a->data.array[i];
+        }
+    } else {
+        uint32_t i = 0, j = 0;
+        while (i < a->cardinality && j < b->cardinality) {
+            uint16_t x = a->data.array[i], y = b->data.array[j];
+            if (x < y) {
+                i++;
+            } else if (y < x) {
+                j++;
+            } else {
+                c->data.array[n++] = x;
+                i++;
+                j++;
+            }
+        }
+    }
+    c->cardinality = n;
+    seal_last_chunk(out);
+    return 0;
+}
+
+static int or_chunks(Bitmap *out, const BitmapChunk *a, const BitmapChunk *b) {
+    if (a->kind == BITMAP_ARRAY && b->kind == BITMAP_ARRAY &&
+        a->cardinality + b->cardinality <= BITMAP_ARRAY_MAX) {
+        BitmapChunk *c = push_chunk(out, a->key, BITMAP_ARRAY);
+        if (!c || array_reserve(c, a->cardinality + b->cardinality) != 0) return -1;
+        uint32_t i = 0, j = 0, n = 0;
+        while (i < a->cardinality || j < b->cardinality) {
+            if (j >= b->cardinality || (i < a->cardinality && a->data.array[i] < b->data.array[j])) {
+                c->data.array[n++] = a->data.array[i++];
+            } else if (i >= a->cardinality || b->data.array[j] < a->data.array[i]) {
+                c->data.array[n++] = b->data.array[j++];
+            } else {
+                c->data.array[n++] = a->data.array[i++];
+                j++;
+            }
+        }
+        c->cardinality = n;
+        seal_last_chunk(out);
+        return 0;
+    }
+
+    BitmapChunk *c = push_chunk(out, a->key, BITMAP_BITS);
+    if (!c) return -1;
+    const BitmapChunk *sides[2] = { a, b };
+    for (int s = 0; s < 2; s++) {
+        const BitmapChunk *x = sides[s];
+        if (x->kind == BITMAP_BITS) {
+            for (int i = 0; i < BITMAP_WORDS; i++) c->data.bits[i] |= x->data.bits[i];
+        } else {
+            for (uint32_t i = 0; i < x->cardinality; i++) {
+                c->data.bits[x->data.array[i] >> 6] |= 1ULL << (x->data.array[i] & 63);
+            }
+        }
+    }
+    c->cardinality = bits_count(c->data.bits);
+    if (bits_maybe_to_array(c) != 0) return -1;
+    seal_last_chunk(out);
+    return 0;
+}
+
+int bitmap_and(Bitmap *out, const Bitmap *a, const Bitmap *b) {
+    bitmap_init(out);
+    int i = 0, j = 0;
+    while (i < a->count && j < b->count) {
+        uint16_t ka = a->chunks[i].key, kb = b->chunks[j].key;
+        if (ka < kb) {
+            i++;
+        } else if (kb < ka) {
+            j++;
+        } else {
+            if (and_chunks(out, &a->chunks[i], &b->chunks[j]) != 0) {
+                bitmap_free(out);
+                return -1;
+            }
+            i++;
+            j++;
+        }
+    }
+    return 0;
+}
+
+int bitmap_or(Bitmap *out, const Bitmap *a, const Bitmap *b) {
+    bitmap_init(out);
+    int i = 0, j = 0;
+    while (i < a->count || j < b->count) {
+        int rc;
+        if (j >= b->count || (i < a->count && a->chunks[i].key < b->chunks[j].key)) {
+            rc = clone_chunk(out, &a->chunks[i], a->chunks[i].key);
+            i++;
+        } else if (i >= a->count || b->chunks[j].key < a->chunks[i].key) {
+            rc = clone_chunk(out, &b->chunks[j], b->chunks[j].key);
+            j++;
+        } else {
+            rc = or_chunks(out, &a->chunks[i], &b->chunks[j]);
+            i++;
+            j++;
+        }
+        if (rc != 0) {
+            bitmap_free(out);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int bitmap_copy(Bitmap *out, const Bitmap *src) {
+    bitmap_init(out);
+    if (bitmap_append_shifted(out, src, 0) != 0) {
+        bitmap_free(out);
+        return -1;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+/**
+ * Chunk đầu tiên có key >= key (count nếu không có)
+ */
+static int find_chunk(const Bitmap *b, uint16_t key) {
+    int lo = 0, hi = b->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (b->chunks[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Số phần tử < low trong mảng đã sắp
+ */
+static uint32_t array_lower_bound(const uint16_t *array, uint32_t n, uint16_t low) {
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (array[mid] < low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int bitmap_contains(const Bitmap *b, uint32_t value) {
+    int i = find_chunk(b, (uint16_t)(value >> 16));
+    if (i >= b->count || b->chunks[i].key != (uint16_t)(value >> 16)) return 0;
+
+    const BitmapChunk *c = &b->chunks[i];
+    uint16_t low = (uint16_t)value;
+    if (c->kind == BITMAP_BITS) return bits_test(c->data.bits, low);
+    uint32_t pos = array_lower_bound(c->data.array, c->cardinality, low);
+    return pos < c->cardinality && c->data.array[pos] == low;
+}
+
+uint32_t bitmap_select(const Bitmap *b, uint64_t rank) {
+    if (rank >= b->cardinality) return 0;
+
+    // Chunk cuối có rank <= rank cần tìm
+    int lo = 0, hi = b->count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (b->chunks[mid].rank <= rank) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    const BitmapChunk *c = &b->chunks[lo];
+    uint32_t local = (uint32_t)(rank - c->rank);
+    uint32_t base = (uint32_t)c->key << 16;
+    if (c->kind == BITMAP_ARRAY) return base | c->data.array[local];
+
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        uint64_t w = c->data.bits[i];
+        uint32_t n = (uint32_t)__builtin_popcountll(w);
+        if (local < n) {
+            while (local--) w &= w - 1;
+            return base | (uint32_t)(i * 64 + __builtin_ctzll(w));
+        }
+        local -= n;
+    }
+    return 0;
+}
+
+uint64_t bitmap_rank(const Bitmap *b, uint32_t value) {
+    uint16_t key = (uint16_t)(value >> 16);
+    int i = find_chunk(b, key);
+    if (i >= b->count) return b->cardinality;
+
+    const BitmapChunk *c = &b->chunks[i];
+    if (c->key != key) return c->rank;
+
+    uint16_t low = (uint16_t)value;
+    if (c->kind == BITMAP_ARRAY) return c->rank + array_lower_bound(c->data.array, c->cardinality, low);
+
+    uint64_t n = c->rank;
+    for (int w = 0; w < (low >> 6); w++) n += (uint64_t)__builtin_popcountll(c->data.bits[w]);
+    uint64_t partial = c->data.bits[low >> 6] & ((1ULL << (low & 63)) - 1);
+    return n + (uint64_t)__builtin_popcountll(partial);
+}
+
+size_t bitmap_memory(const Bitmap *b) {
+    size_t total = sizeof(BitmapChunk) * (size_t)b->cap;
+    for (int i = 0; i < b->count; i++) {
+        const BitmapChunk *c = &b->chunks[i];
+        total += c->kind == BITMAP_BITS ? sizeof(uint64_t) * BITMAP_WORDS : sizeof(uint16_t) * c->cap;
+    }
+    return total;
+}
@@ -0,0 +1,317 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - BINARY ITEM CATALOG
+ * ============================================================================
+ * File: catalog.c
+ * Description: mmap/kiểm tra file catalog và builder từ items.txt
+ *
+ * Dùng chung cho server (load) và tools/catalog_compile (ghi file).
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/catalog.h"
+#include "../include/logger.h"
+
+_Static_assert(sizeof(CatalogHeader) == 56, "CatalogHeader layout changed");
+_Static_assert(sizeof(CatalogRecord) == 16, "CatalogRecord layout changed");
+
+/* ============================================================================
+ *                           VALIDATION
+ * ============================================================================ */
+
+/**
+ * Kiểm tra header và gán con trỏ values/records/strings (chỉ O(1), không
+ * duyệt item)
+ */
+static int attach(Catalog *c, const char *label) {
+    if (c->size < sizeof(CatalogHeader)) {
+        LOG_ERROR("CATALOG", "❌ %s: file too small", label);
+        return -1;
+    }
+
+    const CatalogHeader *h = c->base;
+    if (memcmp(h->magic, CATALOG_MAGIC, sizeof(h->magic)) != 0) {
+        LOG_ERROR("CATALOG", "❌ %s: bad magic", label);
+        return -1;
+    }
+    if (h->version != CATALOG_VERSION) {
+        LOG_ERROR("CATALOG", "❌ %s: version %u, expected %u", label, h->version, CATALOG_VERSION);
+        return -1;
+    }
+
+    uint64_t records_end = h->records_offset + (uint64_t)h->item_count * sizeof(CatalogRecord);
+    uint64_t values_end = h->values_offset + (uint64_t)h->item_count * sizeof(int32_t);
+    if (h->values_offset % sizeof(int32_t) != 0 || h->values_offset < sizeof(CatalogHeader) ||
+        values_end > c->size ||
+        h->records_offset % sizeof(uint32_t) != 0 || records_end > c->size ||
+        h->strings_offset < records_end || h->strings_size == 0 ||
+        h->strings_offset + h->strings_size > c->size ||
+        ((const char *)c->base)[h->strings_offset + h->strings_size - 1] != '\0') {
+        LOG_ERROR("CATALOG", "❌ %s: corrupt offsets", label);
+        return -1;
+    }
+
+    c->values = (const int32_t *)((const char *)c->base + h->values_offset);
+    c->records = (const CatalogRecord *)((const char *)c->base + h->records_offset);
+    c->strings = (const char *)c->base + h->strings_offset;
+    c->strings_size = h->strings_size;
+    c->count = h->item_count;
+    c->fingerprint = h->fingerprint;
+    return 0;
+}
+
+/* ============================================================================
+ *                           OPEN / CLOSE
+ * ============================================================================ */
+
+int catalog_open(Catalog *c, const char *path) {
+    memset(c, 0, sizeof(*c));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("[CATALOG] mmap failed");
+        return -1;
+    }
+
+    // Truy cập item là ngẫu nhiên, đọc trước cả vùng chỉ tốn RSS
+    madvise(base, (size_t)st.st_size, MADV_RANDOM);
+
+    c->base = base;
+    c->size = (size_t)st.st_size;
+    c->mapped = 1;
+    if (attach(c, path) != 0) {
+        catalog_close(c);
+        return -1;
+    }
+    return 0;
+}
+
+int catalog_from_buffer(Catalog *c, void *buf, size_t size) {
+    memset(c, 0, sizeof(*c));
+    c->base = buf;
+    c->size = size;
+    if (attach(c, "memory") != 0) {
+        catalog_close(c);
+        return -1;
+    }
+    return 0;
+}
+
+void catalog_close(Catalog *c) {
+    if (c->base) {
+        if (c->mapped) {
+            munmap(c->base, c->size);
+        } else {
+            free(c->base);
+        }
+    }
+    memset(c, 0, sizeof(*c));
+}
+
+uint32_t catalog_fingerprint(const int32_t *values, uint32_t count) {
+    uint64_t h = 14695981039346656037ULL ^ count;   // FNV-1a 64 bit theo từng value
+    for (uint32_t i = 0; i < count; i++) {
+        h = (h ^ (uint32_t)values[i]) * 1099511628211ULL;
+    }
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+/* ============================================================================
+ *                           BUILDER
+ * ============================================================================ */
+
+void catalog_builder_init(CatalogBuilder *b) {
+    memset(b, 0, sizeof(*b));
+}
+
+void catalog_builder_free(CatalogBuilder *b) {
+    free(b->records);
+    free(b->strings);
+    free(b->interned);
+    memset(b, 0, sizeof(*b));
+}
+
+static uint64_t hash_string(const char *s, size_t n) {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < n; i++) h = (h ^ (unsigned char)s[i]) * 1099511628211ULL;
+    return h;
+}
+
+/**
+ * Nhân đôi bảng intern (băm lại các offset đã có)
+ */
+static int intern_grow(CatalogBuilder *b) {
+    size_t new_cap = b->interned_cap ? b->interned_cap * 2 : 4096;
+    uint32_t *table = calloc(new_cap, sizeof(uint32_t));
+    if (!table) return -1;
+
+    for (size_t i = 0; i < b->interned_cap; i++) {
+        uint32_t slot = b->interned[i];
+        if (!slot) continue;
+        const char *s = b->strings + slot - 1;
+        size_t pos = hash_string(s, strlen(s)) & (new_cap - 1);
+        while (table[pos]) pos = (pos + 1) & (new_cap - 1);
+        table[pos] = slot;
+    }
+    free(b->interned);
+    b->interned = table;
+    b->interned_cap = new_cap;
+    return 0;
+}
+
+/**
+ * Offset của chuỗi trong heap, chép vào nếu chưa có (UINT32_MAX nếu lỗi)
+ */
+static uint32_t heap_add(CatalogBuilder *b, const char *s) {
+    size_t n = strlen(s) + 1;
+
+    // Giữ load factor <= 1/2
+    if ((b->interned_count + 1) * 2 > b->interned_cap && intern_grow(b) != 0) return UINT32_MAX;
+    size_t mask = b->interned_cap - 1;
+    size_t pos = hash_string(s, n - 1) & mask;
+    while (b->interned[pos]) {
+        uint32_t offset = b->interned[pos] - 1;
+        if (memcmp(b->strings + offset, s, n) == 0) return offset;
+        pos = (pos + 1) & mask;
+    }
+
+    if (b->strings_len + n > UINT32_MAX) return UINT32_MAX;
+
+    if (b->strings_len + n > b->strings_cap) {
+        size_t new_cap = b->strings_cap ? b->strings_cap : 4096;
+        while (new_cap < b->strings_len + n) new_cap *= 2;
+        char *grown = realloc(b->strings, new_cap);
+        if (!grown) return UINT32_MAX;
+        b->strings = grown;
+        b->strings_cap = new_cap;
+    }
+
+    uint32_t offset = (uint32_t)b->strings_len;
+    memcpy(b->strings + b->strings_len, s, n);
+    b->strings_len += n;
+    b->interned[pos] = offset + 1;
+    b->interned_count++;
+    return offset;
+}
+
+int catalog_builder_add(CatalogBuilder *b, const char *name, int value, const char *image_url,
+                        const char *tags) {
+    if (b->count >= UINT32_MAX) return -1;
+
+    // Offset 0 dành cho chuỗi rỗng
+    if (b->strings_len == 0 && heap_add(b, "") == UINT32_MAX) return -1;
+
+    if (b->count == b->cap) {
+        size_t new_cap = b->cap ? b->cap * 2 : 256;
+        CatalogRecord *grown = realloc(b->records, new_cap * sizeof(CatalogRecord));
+        if (!grown) return -1;
+        b->records = grown;
+        b->cap = new_cap;
+    }
+
+    CatalogRecord *r = &b->records[b->count];
+    r->name_offset = heap_add(b, name);
+    r->image_offset = heap_add(b, image_url);
+    if (r->name_offset == UINT32_MAX || r->image_offset == UINT32_MAX) return -1;
+    r->value = value;
+    r->tags_offset = (tags && tags[0]) ? heap_add(b, tags) : 0;
+    if (r->tags_offset == UINT32_MAX) return -1;
+
+    b->count++;
+    return 0;
+}
+
+long catalog_builder_add_text(CatalogBuilder *b, FILE *file, long *skipped) {
+    char *line = NULL;
+    size_t line_cap = 0;
+    long added = 0;
+    long bad = 0;
+
+    while (getline(&line, &line_cap, file) != -1) {
+        // Skip empty lines and comments
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || line[0] == '\0') {
+            continue;
+        }
+        line[strcspn(line, "\n\r")] = '\0';
+
+        // Parse: name|value|image_url[|tags]
+        char *sep1 = strchr(line, '|');
+        char *sep2 = sep1 ? strchr(sep1 + 1, '|') : NULL;
+        if (!sep1 || !sep2 || sep1 == line) {
+            bad++;
+            continue;
+        }
+        *sep1 = '\0';
+        *sep2 = '\0';
+        char *sep3 = strchr(sep2 + 1, '|');
+        if (sep3) *sep3 = '\0';
+
+        char *end;
+        long value = strtol(sep1 + 1, &end, 10);
+        if (end == sep1 + 1) {
+            bad++;
+            continue;
+        }
+
+        if (catalog_builder_add(b, line, (int)value, sep2 + 1, sep3 ? sep3 + 1 : NULL) != 0) {
+            free(line);
+            return -1;
+        }
+        added++;
+    }
+
+    free(line);
+    if (skipped) *skipped = bad;
+    return added;
+}
+
+int catalog_builder_finish(CatalogBuilder *b, void **out, size_t *out_size) {
+    // Heap rỗng vẫn cần một byte '\0' để header hợp lệ
+    if (b->strings_len == 0 && heap_add(b, "") == UINT32_MAX) return -1;
+
+    size_t values_size = b->count * sizeof(int32_t);
+    size_t records_size = b->count * sizeof(CatalogRecord);
+    size_t total = sizeof(CatalogHeader) + values_size + records_size + b->strings_len;
+
+    char *buf = malloc(total);
+    if (!buf) return -1;
+
+    int32_t *values = (int32_t *)(buf + sizeof(CatalogHeader));
+    for (size_t i = 0; i < b->count; i++) values[i] = b->records[i].value;
+
+    CatalogHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CATALOG_MAGIC, sizeof(h.magic));
+    h.version = CATALOG_VERSION;
+    h.item_count = (uint32_t)b->count;
+    h.values_offset = sizeof(CatalogHeader);
+    h.records_offset = sizeof(CatalogHeader) + values_size;
+    h.strings_offset = h.records_offset + records_size;
+    h.strings_size = b->strings_len;
+    h.fingerprint = catalog_fingerprint(values, h.item_count);
+
+    memcpy(buf, &h, sizeof(h));
+    if (records_size) memcpy(buf + h.records_offset, b->records, records_size);
+    memcpy(buf + h.strings_offset, b->strings, b->strings_len);
+
+    *out = buf;
+    *out_size = total;
+    return 0;
+}
@@ -6,123 +6,846 @@
  * Description: Game database loading và management
  * 
  * Chức năng:
- *   1. Load items từ file data/items.txt
- *   2. Random item selection utilities
+ *   1. Load mọi catalog trong data/catalogs/ song song (hoặc chỉ
+ *      data/items.bin / data/items.txt), ghép thành một không gian index
+ *   2. Item tách hot/cold (mảng value + arena chuỗi interned), tag index
+ *      (bitmap nén) + value index cho việc chọn item của phòng
+ *   3. Hot reload khi file trong data/ đổi (inotify), không restart
+ *   4. Random item selection utilities
+ * 
+ * Reload kiểu RCU: catalog mới được build trên watcher thread, sau đó chỉ
+ * đổi con trỏ current_catalog. Catalog cũ được giữ bằng refcount: phòng
+ * đang chơi vẫn dùng catalog lúc bắt đầu game (index A/B thuộc catalog đó)
+ * và catalog cũ chỉ bị unmap khi reference cuối cùng được trả.
  * ============================================================================
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
 #include "../include/game.h"
+#include "../include/catalog.h"
+#include "../include/item_store.h"
+#include "../include/tag_index.h"
+#include "../include/value_index.h"
+#include "../include/json_writer.h"
 
 /* ============================================================================
  *                           GLOBAL VARIABLES
  * ============================================================================ */
 
-// Database chứa tất cả items trong game
-GameItem game_database[MAX_ITEMS];
+/**
+ * CatalogPart - Một catalog có tên; item của nó có index chung
+ * [base, base + count)
+ */
+typedef struct {
+    char name[CATALOG_NAME_LEN];
+    int base;
+    int count;
+} CatalogPart;
+
+/**
+ * ItemCatalog - Một phiên bản tập catalog + refcount
+ * 
+ * current_catalog giữ một reference; mỗi phòng đang chơi giữ một reference.
+ */
+struct ItemCatalog {
+    CatalogPart *parts;             // Sắp theo tên
+    int part_count;
+    ItemStore items;                // Các catalog đang map, theo index chung
+    TagIndex tags;                  // Tag -> bitmap index chung
+    ValueIndex by_value;            // Item sắp theo value (chọn cặp theo độ khó)
+    int count;
+    unsigned int generation;
+    int refs;                       // Atomic
+};
+
+// Catalog đang publish; publish_mutex chỉ bao đoạn đọc con trỏ + tăng ref
+static ItemCatalog *current_catalog = NULL;
+static pthread_mutex_t publish_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int next_generation = 1;
 
-// Số lượng items thực tế đã load
+// Số lượng items của catalog đang publish (chỉ để hiển thị)
 int item_count = 0;
 
+// Thống kê reload (đọc qua item_catalog_stats)
+static ItemCatalogStats reload_stats;
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* ============================================================================
- *                           DATABASE INITIALIZATION
+ *                           CATALOG LOADING
  * ============================================================================ */
 
 /**
- * Load items từ file vào game_database
+ * Items mặc định khi không đọc được file nào
+ */
+static const char *const default_items[][3] = {
+    { "iPhone 15 Pro",   "1199",  "https://images.unsplash.com/photo-1695048133142-1a20484d2569?w=400" },
+    { "MacBook Pro",     "2499",  "https://images.unsplash.com/photo-1517336714731-489689fd1ca8?w=400" },
+    { "PlayStation 5",   "499",   "https://images.unsplash.com/photo-1606813907291-d86efa9b94db?w=400" },
+    { "Nike Air Jordan", "170",   "https://images.unsplash.com/photo-1542291026-7eec264c27ff?w=400" },
+    { "Tesla Model 3",   "42990", "https://images.unsplash.com/photo-1560958089-b8a1929cea89?w=400" },
+};
+
+static double elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * items.bin dùng được khi tồn tại và không cũ hơn items.txt
+ */
+static int catalog_file_is_fresh(void) {
+    struct stat bin_st, txt_st;
+    if (stat(ITEMS_CATALOG_FILE, &bin_st) != 0) return 0;
+    if (stat(ITEMS_FILE, &txt_st) == 0 && txt_st.st_mtime > bin_st.st_mtime) {
+        LOG_WARN("DB", "⚠️  %s is older than %s, parsing text (run 'make catalog')",
+                 ITEMS_CATALOG_FILE, ITEMS_FILE);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Build catalog trong bộ nhớ từ file text
  * 
- * File format (data/items.txt):
- *   name|value|image_url
- *   # Comment lines start with #
+ * @param with_defaults 1 = thiếu file / quá ít item thì dùng items mặc định
+ */
+static int load_text_catalog(Catalog *catalog, const char *path, int with_defaults) {
+    CatalogBuilder builder;
+    catalog_builder_init(&builder);
+    
+    const char *source = path;
+    FILE *file = fopen(path, "r");
+    if (file) {
+        long skipped = 0;
+        catalog_builder_add_text(&builder, file, &skipped);
+        fclose(file);
+        if (skipped > 0) {
+            LOG_WARN("DB", "⚠️  Skipped %ld malformed lines in %s", skipped, path);
+        }
+    } else {
+        LOG_WARN("DB", "⚠️  Could not open %s%s", path, with_defaults ? ", using default items" : "");
+    }
+    
+    if (builder.count < 2 && with_defaults) {
+        if (file) LOG_WARN("DB", "⚠️  Not enough items loaded, adding defaults");
+        catalog_builder_free(&builder);
+        catalog_builder_init(&builder);
+        for (size_t i = 0; i < sizeof(default_items) / sizeof(default_items[0]); i++) {
+            catalog_builder_add(&builder, default_items[i][0], atoi(default_items[i][1]),
+                                default_items[i][2], NULL);
+        }
+        source = "defaults";
+    }
+    if (builder.count == 0) {
+        catalog_builder_free(&builder);
+        return -1;
+    }
+    
+    void *buf;
+    size_t size;
+    int rc = catalog_builder_finish(&builder, &buf, &size);
+    catalog_builder_free(&builder);
+    if (rc != 0 || catalog_from_buffer(catalog, buf, size) != 0) {
+        return -1;
+    }
+    
+    LOG_INFO("DB", "📦 Game database loaded %u items from %s", catalog->count, source);
+    return 0;
+}
+
+/* ============================================================================
+ *                           PARALLEL LOADING
+ * ============================================================================ */
+
+/**
+ * LoadJob - Một file catalog cần load (chạy trên thread load)
+ */
+typedef struct {
+    char name[CATALOG_NAME_LEN];
+    char path[512];
+    int legacy;                     // 1 = data/items.bin|items.txt (không có data/catalogs/)
+    int is_text;
+    off_t size;
+    Catalog data;                   // Chuyển vào ItemStore (vẫn map) khi ghép
+    TagIndex tags;                  // Index cục bộ (item từ 0)
+    int ok;
+} LoadJob;
+
+typedef struct {
+    LoadJob *jobs;
+    int *order;                     // Job lớn trước: thread rảnh lấy job nhỏ còn lại
+    int count;
+    int next;                       // Atomic
+} LoadBatch;
+
+static void run_load_job(LoadJob *job) {
+    tag_index_init(&job->tags);
+    
+    int rc;
+    if (job->legacy) {
+        if (catalog_file_is_fresh() && catalog_open(&job->data, ITEMS_CATALOG_FILE) == 0) {
+            LOG_INFO("DB", "📦 Game database mapped %u items from %s (%.1f MB)",
+                     job->data.count, ITEMS_CATALOG_FILE, job->data.size / (1024.0 * 1024.0));
+            rc = 0;
+        } else {
+            rc = load_text_catalog(&job->data, ITEMS_FILE, 1);
+        }
+    } else if (job->is_text) {
+        rc = load_text_catalog(&job->data, job->path, 0);
+    } else {
+        rc = catalog_open(&job->data, job->path);
+        if (rc == 0) {
+            LOG_INFO("DB", "📦 Catalog \"%s\" mapped %u items (%.1f MB)",
+                     job->name, job->data.count, job->data.size / (1024.0 * 1024.0));
+        }
+    }
+    if (rc != 0) {
+        LOG_WARN("CATALOG", "⚠️  Skipping catalog \"%s\" (%s)", job->name, job->path);
+        return;
+    }
+    
+    if (tag_index_add_catalog(&job->tags, &job->data, 0) != 0) {
+        LOG_WARN("CATALOG", "⚠️  Out of memory indexing tags of \"%s\"", job->name);
+        tag_index_free(&job->tags);
+        catalog_close(&job->data);
+        return;
+    }
+    job->ok = 1;
+}
+
+static void *load_worker(void *arg) {
+    LoadBatch *batch = arg;
+    int i;
+    while ((i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED)) < batch->count) {
+        run_load_job(&batch->jobs[batch->order[i]]);
+    }
+    return NULL;
+}
+
+static int compare_job_name(const void *a, const void *b) {
+    return strcmp(((const LoadJob *)a)->name, ((const LoadJob *)b)->name);
+}
+
+typedef struct {
+    off_t size;
+    int index;
+} JobOrder;
+
+static int compare_job_size_desc(const void *a, const void *b) {
+    off_t x = ((const JobOrder *)a)->size;
+    off_t y = ((const JobOrder *)b)->size;
+    return (y > x) - (y < x);
+}
+
+/**
+ * Liệt kê data/catalogs/<name>.bin|.txt; cùng tên thì dùng .bin trừ khi
+ * .txt mới hơn (giống items.bin / items.txt)
  * 
- * Ví dụ:
- *   iPhone 15|1199|https://example.com/iphone.jpg
+ * @return Số job (jobs sắp theo tên), 0 nếu thư mục không có / rỗng
  */
-void init_game_database() {
-    FILE *file = fopen(ITEMS_FILE, "r");
-    if (!file) {
-        printf("⚠️  Warning: Could not open %s, using default items\n", ITEMS_FILE);
-        
-        // Fallback to default items
-        strcpy(game_database[0].name, "iPhone 15 Pro");
-        game_database[0].value = 1199;
-        strcpy(game_database[0].image_url, "https://images.unsplash.com/photo-1695048133142-1a20484d2569?w=400");
-        
-        strcpy(game_database[1].name, "MacBook Pro");
-        game_database[1].value = 2499;
-        strcpy(game_database[1].image_url, "https://images.unsplash.com/photo-1517336714731-489689fd1ca8?w=400");
-        
-        strcpy(game_database[2].name, "PlayStation 5");
-        game_database[2].value = 499;
-        strcpy(game_database[2].image_url, "https://images.unsplash.com/photo-1606813907291-d86efa9b94db?w=400");
+static int scan_catalog_dir(LoadJob **out) {
+    *out = NULL;
+    DIR *dir = opendir(CATALOGS_DIR);
+    if (!dir) return 0;
+    
+    LoadJob *jobs = NULL;
+    int count = 0, cap = 0;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        const char *dot = strrchr(ent->d_name, '.');
+        if (ent->d_name[0] == '.' || !dot) continue;
+        int is_text = strcmp(dot, ".txt") == 0;
+        if (!is_text && strcmp(dot, ".bin") != 0) continue;
         
-        strcpy(game_database[3].name, "Nike Air Jordan");
-        game_database[3].value = 170;
-        strcpy(game_database[3].image_url, "https://images.unsplash.com/photo-1542291026-7eec264c27ff?w=400");
+        size_t name_len = (size_t)(dot - ent->d_name);
+        if (name_len >= CATALOG_NAME_LEN || memchr(ent->d_name, ',', name_len)) {
+            LOG_WARN("CATALOG", "⚠️  Ignoring %s/%s (bad catalog name)", CATALOGS_DIR, ent->d_name);
+            continue;
+        }
         
-        strcpy(game_database[4].name, "Tesla Model 3");
-        game_database[4].value = 42990;
-        strcpy(game_database[4].image_url, "https://images.unsplash.com/photo-1560958089-b8a1929cea89?w=400");
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", CATALOGS_DIR, ent->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) continue;
         
-        item_count = 5;
-        printf("📦 Game database initialized with %d default items\n", item_count);
+        // Đã có file cùng tên (đuôi kia)?
+        LoadJob *job = NULL;
+        for (int i = 0; i < count; i++) {
+            if (strlen(jobs[i].name) == name_len && strncmp(jobs[i].name, ent->d_name, name_len) == 0) {
+                job = &jobs[i];
+                break;
+            }
+        }
+        if (job) {
+            struct stat other;
+            int other_mtime_ok = stat(job->path, &other) == 0;
+            time_t bin_mtime = is_text ? (other_mtime_ok ? other.st_mtime : 0) : st.st_mtime;
+            time_t txt_mtime = is_text ? st.st_mtime : (other_mtime_ok ? other.st_mtime : 0);
+            int use_text = txt_mtime > bin_mtime;
+            if (use_text != is_text) continue;
+        } else {
+            if (count == cap) {
+                int new_cap = cap ? cap * 2 : 16;
+                LoadJob *grown = realloc(jobs, new_cap * sizeof(LoadJob));
+                if (!grown) break;
+                jobs = grown;
+                cap = new_cap;
+            }
+            job = &jobs[count++];
+            memset(job, 0, sizeof(*job));
+            memcpy(job->name, ent->d_name, name_len);
+            job->name[name_len] = '\0';
+        }
+        snprintf(job->path, sizeof(job->path), "%s", path);
+        job->is_text = is_text;
+        job->size = st.st_size;
+    }
+    closedir(dir);
+    
+    // Thứ tự theo tên: index item không phụ thuộc thứ tự readdir
+    if (count > 1) qsort(jobs, count, sizeof(LoadJob), compare_job_name);
+    *out = jobs;
+    return count;
+}
+
+/**
+ * Load mọi job song song, tối đa CATALOG_LOAD_THREADS thread
+ * 
+ * Job được phát theo kích thước giảm dần nên tổng thời gian ~ thời gian
+ * của catalog lớn nhất khi đủ core.
+ */
+static void load_jobs_parallel(LoadJob *jobs, int count) {
+    int *order = malloc(sizeof(int) * count);
+    JobOrder *by_size = malloc(sizeof(JobOrder) * count);
+    if (!order || !by_size) {
+        free(order);
+        free(by_size);
+        for (int i = 0; i < count; i++) run_load_job(&jobs[i]);
         return;
     }
+    for (int i = 0; i < count; i++) {
+        by_size[i].size = jobs[i].size;
+        by_size[i].index = i;
+    }
+    qsort(by_size, count, sizeof(JobOrder), compare_job_size_desc);
+    for (int i = 0; i < count; i++) order[i] = by_size[i].index;
+    free(by_size);
     
-    char line[512];
-    item_count = 0;
+    LoadBatch batch = { jobs, order, count, 0 };
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = count;
+    if (threads > CATALOG_LOAD_THREADS) threads = CATALOG_LOAD_THREADS;
+    if (cores > 0 && threads > cores) threads = (int)cores;
     
-    while (fgets(line, sizeof(line), file) && item_count < MAX_ITEMS) {
-        // Skip empty lines and comments
-        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+    pthread_t tids[CATALOG_LOAD_THREADS];
+    int started = 0;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&tids[started], NULL, load_worker, &batch) == 0) started++;
+    }
+    load_worker(&batch);
+    for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+    free(order);
+}
+
+/**
+ * Ghép các job đã load thành một phiên bản catalog: index chung nối tiếp
+ * theo tên catalog, item store chung, tag index chung, value index chung
+ * 
+ * Catalog của mọi job được chuyển vào item store (vẫn map), hoặc đóng ở
+ * đây nếu lỗi.
+ */
+static ItemCatalog *assemble_catalog(LoadJob *jobs, int count) {
+    ItemCatalog *c = calloc(1, sizeof(ItemCatalog));
+    Catalog **datas = malloc(sizeof(Catalog *) * count);
+    if (c) c->parts = calloc(count, sizeof(CatalogPart));
+    if (!c || !c->parts || !datas) {
+        for (int i = 0; i < count; i++) {
+            if (!jobs[i].ok) continue;
+            tag_index_free(&jobs[i].tags);
+            catalog_close(&jobs[i].data);
+        }
+        if (c) free(c->parts);
+        free(c);
+        free(datas);
+        return NULL;
+    }
+    tag_index_init(&c->tags);
+    
+    for (int i = 0; i < count; i++) {
+        LoadJob *job = &jobs[i];
+        if (!job->ok) continue;
+        
+        // Index phòng/round là int: catalog vượt INT32_MAX tổng bị bỏ
+        if ((int64_t)c->count + job->data.count > INT32_MAX ||
+            tag_index_merge(&c->tags, &job->tags, (uint32_t)c->count) != 0) {
+            LOG_WARN("CATALOG", "⚠️  Dropping catalog \"%s\" (too many items / out of memory)", job->name);
+            tag_index_free(&job->tags);
+            catalog_close(&job->data);
+            job->ok = 0;
             continue;
         }
+        tag_index_free(&job->tags);
         
-        // Remove newline
-        line[strcspn(line, "\n\r")] = 0;
+        CatalogPart *part = &c->parts[c->part_count];
+        snprintf(part->name, sizeof(part->name), "%s", job->name);
+        part->base = c->count;
+        part->count = (int)job->data.count;
+        c->count += part->count;
+        datas[c->part_count++] = &job->data;
+    }
+    
+    // Chỉ nhận các vùng map: item được đọc thẳng từ file, không chép
+    int rc = item_store_build(&c->items, datas, c->part_count);
+    for (int i = 0; i < count; i++) jobs[i].ok = 0;
+    free(datas);
+    if (rc != 0) {
+        LOG_WARN("CATALOG", "⚠️  Out of memory building item store");
+        free(c->parts);
+        tag_index_free(&c->tags);
+        free(c);
+        return NULL;
+    }
+    
+    // Index theo value chỉ là tối ưu: thiếu bộ nhớ thì phòng rút item ngẫu nhiên
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (value_index_build(&c->by_value, &c->items) != 0) {
+        LOG_WARN("DB", "⚠️  Could not build value index, difficulty curves disabled");
+    } else if (c->count >= 100000) {
+        LOG_INFO("DB", "📦 Value index built in %.1f ms", elapsed_ms(&start));
+    }
+    
+    c->refs = 1;
+    return c;
+}
+
+static void free_catalog(ItemCatalog *c) {
+    item_store_free(&c->items);
+    free(c->parts);
+    tag_index_free(&c->tags);
+    value_index_free(&c->by_value);
+    free(c);
+}
+
+/**
+ * Build một phiên bản catalog mới (refs = 1, dành cho lần publish)
+ * 
+ * Chạy ngoài mọi lock: có thể mất hàng trăm ms với catalog text lớn.
+ * Có data/catalogs/ thì load mọi catalog trong đó song song, không thì
+ * dùng data/items.bin|items.txt làm catalog duy nhất tên "default".
+ */
+static ItemCatalog *load_catalog(void) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    LoadJob *jobs;
+    int count = scan_catalog_dir(&jobs);
+    if (count > 0) load_jobs_parallel(jobs, count);
+    
+    int loaded = 0;
+    for (int i = 0; i < count; i++) loaded += jobs[i].ok;
+    if (loaded == 0) {
+        if (count > 0) LOG_WARN("CATALOG", "⚠️  No usable catalog in %s/, using %s", CATALOGS_DIR, ITEMS_FILE);
+        free(jobs);
+        jobs = calloc(1, sizeof(LoadJob));
+        if (!jobs) return NULL;
+        count = 1;
+        snprintf(jobs[0].name, sizeof(jobs[0].name), "default");
+        jobs[0].legacy = 1;
+        run_load_job(&jobs[0]);
+        if (!jobs[0].ok) {
+            free(jobs);
+            return NULL;
+        }
+    }
+    
+    ItemCatalog *c = assemble_catalog(jobs, count);
+    free(jobs);
+    if (c && c->part_count > 1) {
+        LOG_INFO("DB", "📦 Loaded %d catalogs (%d items, %d tags) in %.1f ms",
+                 c->part_count, c->count, c->tags.count, elapsed_ms(&start));
+    }
+    return c;
+}
+
+/**
+ * Đổi con trỏ sang catalog mới, trả reference của bản cũ
+ */
+static void publish_catalog(ItemCatalog *c) {
+    pthread_mutex_lock(&publish_mutex);
+    c->generation = next_generation++;
+    ItemCatalog *old = current_catalog;
+    current_catalog = c;
+    item_count = c->count;
+    pthread_mutex_unlock(&publish_mutex);
+    
+    if (old) item_catalog_release(old);
+}
+
+/**
+ * Khởi tạo catalog lúc server start
+ * 
+ * Có data/catalogs/ thì mỗi <name>.bin (mmap) / <name>.txt là một catalog.
+ * Không có thì ưu tiên data/items.bin, rồi đến text:
+ *   name|value|image_url|tags
+ *   # Comment lines start with #
+ * 
+ * Ví dụ:
+ *   iPhone 15|1199|https://example.com/iphone.jpg|apple,phone
+ */
+void init_game_database() {
+    ItemCatalog *c = load_catalog();
+    if (!c) {
+        LOG_ERROR("DB", "❌ Failed to build item catalog");
+        exit(1);
+    }
+    publish_catalog(c);
+    
+    for (int i = 0; i < c->count && i < 5; i++) {
+        GameItem item = item_catalog_get(c, i);
+        LOG_INFO("DB", "   • %s: $%d", item.name, item.value);
+    }
+    if (c->count > 5) {
+        LOG_INFO("DB", "   ... and %d more items", c->count - 5);
+    }
+}
+
+/* ============================================================================
+ *                           REFERENCES
+ * ============================================================================ */
+
+ItemCatalog *item_catalog_acquire(void) {
+    pthread_mutex_lock(&publish_mutex);
+    ItemCatalog *c = current_catalog;
+    __atomic_add_fetch(&c->refs, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&publish_mutex);
+    return c;
+}
+
+void item_catalog_release(ItemCatalog *c) {
+    if (!c) return;
+    if (__atomic_sub_fetch(&c->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+    
+    LOG_INFO("CATALOG", "🗑️  Retired generation %u (%d items)", c->generation, c->count);
+    free_catalog(c);
+}
+
+int item_catalog_count(const ItemCatalog *c) {
+    return c ? c->count : 0;
+}
+
+GameItem item_catalog_get(const ItemCatalog *c, int index) {
+    if (!c || index < 0 || index >= c->count) {
+        GameItem empty = { "", 0, "" };
+        return empty;
+    }
+    return item_store_get(&c->items, (uint32_t)index);
+}
+
+uint32_t item_catalog_fingerprint(const ItemCatalog *c) {
+    return c ? c->items.fingerprint : 0;
+}
+
+int item_catalog_value(const ItemCatalog *c, int index) {
+    if (!c || index < 0 || index >= c->count) return 0;
+    return item_store_value(&c->items, (uint32_t)index);
+}
+
+int item_catalog_pick_ratio(const ItemCatalog *c, Prng *rng, const Bitmap *filter,
+                            int index_a, double lo, double hi) {
+    if (!c || index_a < 0 || index_a >= c->count) return -1;
+    int value_a = item_store_value(&c->items, (uint32_t)index_a);
+    return value_index_pick_ratio(&c->by_value, rng, filter, index_a, value_a, lo, hi);
+}
+
+/**
+ * Gọi fn cho từng tên trong danh sách "a,b,c" (bỏ khoảng trắng, tên rỗng)
+ * 
+ * @return 0, hoặc giá trị khác 0 đầu tiên fn trả về
+ */
+static int for_each_name(const char *list, int (*fn)(const char *name, void *ctx), void *ctx) {
+    char name[TAG_NAME_LEN > CATALOG_NAME_LEN ? TAG_NAME_LEN : CATALOG_NAME_LEN];
+    const char *p = list;
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        const char *start = p;
+        while (*p && *p != ',') p++;
+        const char *end = p;
+        while (end > start && end[-1] == ' ') end--;
+        if (end == start) continue;
         
-        // Parse: name|value|image_url
-        char *name = strtok(line, "|");
-        char *value_str = strtok(NULL, "|");
-        char *image_url = strtok(NULL, "|");
+        size_t len = (size_t)(end - start);
+        if (len >= sizeof(name)) len = sizeof(name) - 1;
+        memcpy(name, start, len);
+        name[len] = '\0';
+        int rc = fn(name, ctx);
+        if (rc != 0) return rc;
+    }
+    return 0;
+}
+
+typedef struct {
+    const ItemCatalog *catalog;
+    Bitmap *set;
+    char *error;
+    size_t error_len;
+    int first;
+} FilterBuild;
+
+static int add_catalog_range(const char *name, void *arg) {
+    FilterBuild *fb = arg;
+    for (int i = 0; i < fb->catalog->part_count; i++) {
+        const CatalogPart *part = &fb->catalog->parts[i];
+        if (strcmp(part->name, name) != 0) continue;
         
-        if (name && value_str && image_url) {
-            strncpy(game_database[item_count].name, name, ITEM_NAME_LEN - 1);
-            game_database[item_count].name[ITEM_NAME_LEN - 1] = '\0';
-            
-            game_database[item_count].value = atoi(value_str);
-            
-            strncpy(game_database[item_count].image_url, image_url, IMAGE_URL_LEN - 1);
-            game_database[item_count].image_url[IMAGE_URL_LEN - 1] = '\0';
-            
-            item_count++;
+        // Range phải tăng dần: gộp qua OR thay vì append
+        Bitmap range, merged;
+        bitmap_init(&range);
+        if (bitmap_add_range(&range, (uint32_t)part->base, (uint32_t)(part->base + part->count)) != 0 ||
+            bitmap_or(&merged, fb->set, &range) != 0) {
+            bitmap_free(&range);
+            return -2;
+        }
+        bitmap_free(&range);
+        bitmap_free(fb->set);
+        *fb->set = merged;
+        return 0;
+    }
+    snprintf(fb->error, fb->error_len, "Unknown catalog: %s", name);
+    return -1;
+}
+
+static int intersect_tag(const char *name, void *arg) {
+    FilterBuild *fb = arg;
+    const Bitmap *tag = tag_index_find(&fb->catalog->tags, name);
+    if (!tag) {
+        snprintf(fb->error, fb->error_len, "Unknown tag: %s", name);
+        return -1;
+    }
+    
+    Bitmap narrowed;
+    int rc = fb->first ? bitmap_copy(&narrowed, tag) : bitmap_and(&narrowed, fb->set, tag);
+    if (rc != 0) return -2;
+    bitmap_free(fb->set);
+    *fb->set = narrowed;
+    fb->first = 0;
+    return 0;
+}
+
+int item_catalog_filter(const ItemCatalog *c, const char *catalogs, const char *tags,
+                        Bitmap *out, char *error, size_t error_len) {
+    Bitmap scope, tagged;
+    bitmap_init(&scope);
+    bitmap_init(&tagged);
+    FilterBuild fb = { c, &scope, error, error_len, 1 };
+    
+    // OR các catalog được chọn
+    int rc = for_each_name(catalogs, add_catalog_range, &fb);
+    int scoped = scope.cardinality > 0;
+    
+    // AND các tag
+    fb.set = &tagged;
+    if (rc == 0) rc = for_each_name(tags, intersect_tag, &fb);
+    int has_tags = !fb.first;
+    
+    bitmap_init(out);
+    if (rc == 0) {
+        if (scoped && has_tags) {
+            rc = bitmap_and(out, &scope, &tagged) != 0 ? -2 : 0;
+        } else if (has_tags) {
+            *out = tagged;
+            bitmap_init(&tagged);
+        } else if (scoped) {
+            *out = scope;
+            bitmap_init(&scope);
+        } else {
+            rc = bitmap_add_range(out, 0, (uint32_t)c->count) != 0 ? -2 : 0;
         }
     }
     
-    fclose(file);
+    bitmap_free(&scope);
+    bitmap_free(&tagged);
+    if (rc == -2) snprintf(error, error_len, "Out of memory");
+    if (rc != 0) bitmap_free(out);
+    return rc;
+}
+
+void item_catalog_stats(ItemCatalogStats *out) {
+    pthread_mutex_lock(&stats_mutex);
+    *out = reload_stats;
+    pthread_mutex_unlock(&stats_mutex);
+    
+    pthread_mutex_lock(&publish_mutex);
+    out->generation = current_catalog ? current_catalog->generation : 0;
+    out->item_count = current_catalog ? current_catalog->count : 0;
+    pthread_mutex_unlock(&publish_mutex);
+}
+
+/**
+ * GET /catalogs - Các catalog và tag của phiên bản đang publish
+ */
+void handle_get_catalogs(int sock) {
+    ItemCatalog *c = item_catalog_acquire();
+    
+    JsonWriter w;
+    jw_init(&w);
+    jw_object_begin(&w);
+    jw_kv_str(&w, "action", "catalogs");
+    jw_kv_int(&w, "generation", (long long)c->generation);
+    jw_kv_int(&w, "item_count", c->count);
+    jw_key(&w, "catalogs");
+    jw_array_begin(&w);
+    for (int i = 0; i < c->part_count; i++) {
+        jw_object_begin(&w);
+        jw_kv_str(&w, "name", c->parts[i].name);
+        jw_kv_int(&w, "items", c->parts[i].count);
+        jw_object_end(&w);
+    }
+    jw_array_end(&w);
+    jw_key(&w, "tags");
+    jw_array_begin(&w);
+    for (int i = 0; i < c->tags.count; i++) {
+        jw_object_begin(&w);
+        jw_kv_str(&w, "name", c->tags.entries[i].name);
+        jw_kv_int(&w, "items", (long long)bitmap_cardinality(&c->tags.entries[i].items));
+        jw_object_end(&w);
+    }
+    jw_array_end(&w);
+    jw_object_end(&w);
+    
+    item_catalog_release(c);
+    send_json_response(sock, jw_str(&w));
+    jw_free(&w);
+}
+
+/* ============================================================================
+ *                           HOT RELOAD
+ * ============================================================================ */
+
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// Watch descriptor của data/catalogs/ (-1 nếu thư mục không có lúc khởi động)
+static int catalogs_wd = -1;
+
+/**
+ * Có event nào chạm items.txt / items.bin hoặc file .bin/.txt trong
+ * data/catalogs/ không
+ */
+static int events_touch_catalog(const char *buf, ssize_t len) {
+    const char *txt_name = base_name(ITEMS_FILE);
+    const char *bin_name = base_name(ITEMS_CATALOG_FILE);
+    int hit = 0;
     
-    if (item_count < 2) {
-        printf("⚠️  Warning: Not enough items loaded, adding defaults\n");
-        strcpy(game_database[0].name, "Item A");
-        game_database[0].value = 100;
-        strcpy(game_database[0].image_url, "https://via.placeholder.com/400");
+    for (const char *p = buf; p < buf + len; ) {
+        const struct inotify_event *ev = (const struct inotify_event *)p;
+        if (ev->len > 0) {
+            if (ev->wd == catalogs_wd) {
+                const char *dot = strrchr(ev->name, '.');
+                if (dot && (strcmp(dot, ".bin") == 0 || strcmp(dot, ".txt") == 0)) hit = 1;
+            } else if (strcmp(ev->name, txt_name) == 0 || strcmp(ev->name, bin_name) == 0) {
+                hit = 1;
+            }
+        }
+        p += sizeof(struct inotify_event) + ev->len;
+    }
+    return hit;
+}
+
+static void reload_catalog(void) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    ItemCatalog *c = load_catalog();
+    if (!c) {
+        pthread_mutex_lock(&stats_mutex);
+        reload_stats.failures++;
+        pthread_mutex_unlock(&stats_mutex);
+        LOG_ERROR("CATALOG", "❌ Reload failed, keeping current catalog");
+        return;
+    }
+    publish_catalog(c);
+    
+    double ms = elapsed_ms(&start);
+    pthread_mutex_lock(&stats_mutex);
+    reload_stats.reloads++;
+    reload_stats.last_reload_ms = ms;
+    pthread_mutex_unlock(&stats_mutex);
+    
+    LOG_INFO("CATALOG", "🔄 Reloaded %d items (generation %u) in %.1f ms",
+             c->count, c->generation, ms);
+}
+
+/**
+ * Watcher thread: theo dõi thư mục data/ (tool ghi file tạm rồi rename,
+ * nên phải watch thư mục chứ không watch file)
+ */
+static void *catalog_watcher(void *arg) {
+    int fd = *(int *)arg;
+    free(arg);
+    
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    
+    while (1) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        if (!events_touch_catalog(buf, n)) continue;
         
-        strcpy(game_database[1].name, "Item B");
-        game_database[1].value = 200;
-        strcpy(game_database[1].image_url, "https://via.placeholder.com/400");
+        // Gộp chuỗi event liên tiếp (editor ghi nhiều lần) thành một lần reload
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        while (poll(&pfd, 1, CATALOG_RELOAD_DEBOUNCE_MS) > 0) {
+            if (read(fd, buf, sizeof(buf)) <= 0) break;
+        }
         
-        item_count = 2;
+        reload_catalog();
     }
     
-    printf("📦 Game database loaded %d items from %s\n", item_count, ITEMS_FILE);
-    for (int i = 0; i < item_count && i < 5; i++) {
-        printf("   • %s: $%d\n", game_database[i].name, game_database[i].value);
+    close(fd);
+    LOG_WARN("CATALOG", "⚠️  Watcher stopped, hot reload disabled");
+    return NULL;
+}
+
+void init_catalog_watcher(void) {
+    char dir[256];
+    const char *slash = strrchr(ITEMS_FILE, '/');
+    if (slash) {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - ITEMS_FILE), ITEMS_FILE);
+    } else {
+        snprintf(dir, sizeof(dir), ".");
     }
-    if (item_count > 5) {
-        printf("   ... and %d more items\n", item_count - 5);
+    
+    int *fd = malloc(sizeof(int));
+    if (!fd) return;
+    *fd = inotify_init1(IN_CLOEXEC);
+    if (*fd < 0 || inotify_add_watch(*fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        perror("[CATALOG] inotify");
+        if (*fd >= 0) close(*fd);
+        free(fd);
+        return;
     }
+    // Xóa file (IN_DELETE) cũng đổi tập catalog
+    catalogs_wd = inotify_add_watch(*fd, CATALOGS_DIR, IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+    
+    pthread_t thread_id;
+    pthread_create(&thread_id, NULL, catalog_watcher, fd);
+    pthread_detach(thread_id);
+    
+    LOG_INFO("CATALOG", "👀 Watching %s/%s for catalog changes", dir,
+             catalogs_wd >= 0 ? " and " CATALOGS_DIR "/" : "");
 }
 
 /* ============================================================================
@@ -132,14 +855,24 @@ void init_game_database() {
 /**
  * Lấy random index khác với index cho trước
  * 
+ * @param catalog Catalog chứa index (của phòng, hoặc bản đã acquire)
  * @param except Index cần tránh
- * @return Random index trong khoảng [0, item_count)
+ * @return Random index trong khoảng [0, count)
  */
-int get_random_index_except(int except) {
-    if (item_count <= 1) return 0;
-    int index;
-    do {
-        index = rand() % item_count;
-    } while (index == except);
-    return index;
+int get_random_index_except(const ItemCatalog *catalog, int except) {
+    // Mỗi thread một PRNG: không tranh chấp state chung như rand()
+    static __thread Prng rng;
+    static __thread int seeded = 0;
+    if (!seeded) {
+        prng_seed(&rng, prng_entropy_seed());
+        seeded = 1;
+    }
+
+    int count = item_catalog_count(catalog);
+    if (count <= 1) return 0;
+    if (except < 0 || except >= count) return (int)prng_below(&rng, (uint64_t)count);
+
+    // Rút trong count-1 giá trị rồi nhảy qua except: không cần vòng lặp thử lại
+    int index = (int)prng_below(&rng, (uint64_t)count - 1);
+    return index >= except ? index + 1 : index;
 }
@@ -0,0 +1,134 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ITEM DECK
+ * ============================================================================
+ * File: deck.c
+ * Description: Rút k index khác nhau trong [0, n) rồi xáo
+ *
+ * - n nhỏ (<= DECK_FULL_SHUFFLE_LIMIT): Fisher-Yates từng phần trên mảng
+ *   0..n-1, lấy k lá đầu
+ * - n lớn (catalog hàng triệu item): thuật toán Floyd, chỉ tốn O(k) bộ nhớ,
+ *   sau đó Fisher-Yates k lá (thứ tự của Floyd không đều)
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/config.h"
+#include "../include/deck.h"
+
+/* ============================================================================
+ *                           SAMPLING
+ * ============================================================================ */
+
+static void shuffle(Prng *rng, int *cards, int size) {
+    for (int i = size - 1; i > 0; i--) {
+        int j = (int)prng_below(rng, (uint64_t)i + 1);
+        int tmp = cards[i];
+        cards[i] = cards[j];
+        cards[j] = tmp;
+    }
+}
+
+static int sample_small(Prng *rng, int *cards, int size, int n) {
+    int *all = malloc(sizeof(int) * n);
+    if (!all) return -1;
+    for (int i = 0; i < n; i++) all[i] = i;
+
+    for (int i = 0; i < size; i++) {
+        int j = i + (int)prng_below(rng, (uint64_t)(n - i));
+        int tmp = all[i];
+        all[i] = all[j];
+        all[j] = tmp;
+    }
+    memcpy(cards, all, sizeof(int) * size);
+    free(all);
+    return 0;
+}
+
+/**
+ * Floyd: với j = n-k..n-1, lấy t ngẫu nhiên trong [0, j]; t đã có thì lấy j
+ */
+static int sample_floyd(Prng *rng, int *cards, int size, int n) {
+    // Hash set mở (giá trị + 1, 0 = trống), load factor <= 0.5
+    size_t cap = 1;
+    while (cap < (size_t)size * 2) cap <<= 1;
+    unsigned int *set = calloc(cap, sizeof(unsigned int));
+    if (!set) return -1;
+
+    int count = 0;
+    for (int j = n - size; j < n; j++) {
+        unsigned int pick = (unsigned int)prng_below(rng, (uint64_t)j + 1);
+        for (int attempt = 0; attempt < 2; attempt++) {
+            size_t h = (pick * 0x9E3779B1u) & (cap - 1);
+            while (set[h] != 0 && set[h] != pick + 1) h = (h + 1) & (cap - 1);
+            if (set[h] == 0) {
+                set[h] = pick + 1;
+                cards[count++] = (int)pick;
+                break;
+            }
+            pick = (unsigned int)j;     // j chưa thể có trong set
+        }
+    }
+
+    free(set);
+    shuffle(rng, cards, size);
+    return 0;
+}
+
+static int fill(ItemDeck *deck) {
+    deck->pos = 0;
+    if (deck->item_count <= DECK_FULL_SHUFFLE_LIMIT) {
+        return sample_small(&deck->rng, deck->cards, deck->size, deck->item_count);
+    }
+    return sample_floyd(&deck->rng, deck->cards, deck->size, deck->item_count);
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+int deck_init(ItemDeck *deck, uint64_t seed, int item_count, int needed) {
+    memset(deck, 0, sizeof(*deck));
+    if (item_count < 1) return -1;
+
+    int size = needed;
+    if (size > ROOM_DECK_MAX) size = ROOM_DECK_MAX;
+    if (size > item_count) size = item_count;
+    if (size < 1) size = 1;
+
+    deck->cards = malloc(sizeof(int) * size);
+    if (!deck->cards) return -1;
+
+    deck->seed = seed;
+    deck->size = size;
+    deck->item_count = item_count;
+    prng_seed(&deck->rng, seed);
+
+    if (fill(deck) != 0) {
+        deck_free(deck);
+        return -1;
+    }
+    return 0;
+}
+
+int deck_next(ItemDeck *deck, int avoid) {
+    if (!deck->cards) return 0;
+
+    if (deck->pos >= deck->size) {
+        // Bộ mới có thể trùng lá vừa hiện; đẩy nó ra sau nếu đứng đầu
+        if (fill(deck) != 0) return (avoid == 0 && deck->item_count > 1) ? 1 : 0;
+        if (deck->size > 1 && deck->cards[0] == avoid) {
+            deck->cards[0] = deck->cards[1];
+            deck->cards[1] = avoid;
+        }
+    }
+    return deck->cards[deck->pos++];
+}
+
+void deck_free(ItemDeck *deck) {
+    free(deck->cards);
+    deck->cards = NULL;
+    deck->size = 0;
+    deck->pos = 0;
+}
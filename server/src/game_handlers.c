@@ -11,8 +11,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
 #include "../include/game.h"
 #include "../include/room_helpers.h"
+#include "../include/arena.h"
+#include "../include/room_rank.h"
+#include "../include/trace.h"
 
 /* ============================================================================
  *                           EXTERNAL VARIABLES
@@ -33,12 +37,15 @@ void handle_start_game(int sock, int session_id) {
         return;
     }
     
-    pthread_mutex_lock(&rooms_mutex);
+    uint64_t lock_wait = trace_start();
+    MUTEX_LOCK(&rooms_mutex);
+    uint64_t lock_held = trace_start();
+    trace_span("rooms_mutex wait", lock_wait, lock_held, session_id);
     
     // Find room with player
     int room_idx = find_room_with_player(session_id, NULL);
     if (room_idx == -1) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"You are not in any room\"}");
         return;
     }
@@ -47,54 +54,40 @@ void handle_start_game(int sock, int session_id) {
     
     // Validate permissions
     if (room->host_session_id != session_id) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Only the host can start the game\"}");
         return;
     }
     
     if (room->status != ROOM_WAITING) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Game has already started\"}");
         return;
     }
     
     // Initialize game state
-    room->status = ROOM_PLAYING;
-    room->current_round = 1;
-    room->current_index_A = rand() % item_count;
-    room->current_index_B = get_random_index_except(room->current_index_A);
-    
-    // Reset all players
-    for (int i = 0; i < room->player_count; i++) {
-        room->players[i].score = 0;
-        room->players[i].streak = 0;
-        room->players[i].game_over = 0;
-        room->players[i].has_answered = 0;
-        room->players[i].last_answer_correct = 0;
-    }
+    start_room_game(room_idx);
     
     int room_id = room->id;
-    GameItem *itemA = &game_database[room->current_index_A];
-    GameItem *itemB = &game_database[room->current_index_B];
+    GameItem itemA = room_item(room, room->current_index_A);
+    GameItem itemB = room_item(room, room->current_index_B);
     
     // Build response
-    char room_json[BUFFER_SIZE];
-    build_room_json(room, room_json, sizeof(room_json));
-    
-    char response[RESPONSE_SIZE];
-    snprintf(response, sizeof(response), 
-        "{\"action\":\"game_started\",\"room\":%s,\"round\":%d,"
-        "\"labelA\":\"%s\",\"valueA\":%d,\"labelB\":\"%s\"}",
-        room_json, room->current_round,
-        itemA->name, itemA->value, itemB->name);
+    uint64_t serialize_start = trace_start();
+    JsonWriter response;
+    jw_init(&response);
+    build_game_started_json(&response, room);
+    trace_end("serialize game_started", serialize_start, room_id);
     
-    printf("[ROOM] 🎮 Game started in room ID: %d by host %d\n", room_id, session_id);
-    printf("       Round 1: %s ($%d) vs %s (?)\n", itemA->name, itemA->value, itemB->name);
+    LOG_INFO("ROOM", "🎮 Game started in room ID: %d by host %d", room_id, session_id);
+    LOG_DEBUG("ROOM", "   Round 1: %s ($%d) vs %s (?)", itemA.name, itemA.value, itemB.name);
     
-    pthread_mutex_unlock(&rooms_mutex);
+    trace_end("rooms_mutex hold", lock_held, room_id);
+    MUTEX_UNLOCK(&rooms_mutex);
     
-    send_json_response(sock, response);
-    broadcast_sse_to_room(room_id, response);
+    send_json_response(sock, jw_str(&response));
+    broadcast_sse_to_room(room_id, jw_str(&response));
+    jw_free(&response);
 }
 
 /**
@@ -107,28 +100,26 @@ void handle_room_choice(int sock, int session_id, char *json_body) {
     }
     
     // Parse request
-    int choice = parse_json_int(json_body, "choice");
-    int response_time_ms = parse_json_int(json_body, "response_time");
+    RequestBody body;
+    if (parse_request_body(json_body, strlen(json_body), &body) != 0) {
+        send_json_response(sock, "{\"error\":\"Invalid JSON body\"}");
+        return;
+    }
+    
+    int choice = body.choice;
+    int response_time_ms = body.response_time;
     
-    pthread_mutex_lock(&rooms_mutex);
+    // trace_clock(): request có thể được trace muộn (khi nó đóng round)
+    uint64_t lock_wait = trace_clock();
+    MUTEX_LOCK(&rooms_mutex);
+    uint64_t lock_held = trace_clock();
     
-    // Find room and player
+    // Find room and player (O(1) qua session index)
     int player_idx;
-    int room_idx = -1;
-    
-    for (int i = 0; i < MAX_ROOMS; i++) {
-        if (rooms[i].status == ROOM_PLAYING) {
-            int p_idx = find_player_in_room(&rooms[i], session_id);
-            if (p_idx >= 0) {
-                room_idx = i;
-                player_idx = p_idx;
-                break;
-            }
-        }
-    }
+    int room_idx = find_room_with_player(session_id, &player_idx);
     
-    if (room_idx == -1) {
-        pthread_mutex_unlock(&rooms_mutex);
+    if (room_idx == -1 || rooms[room_idx].status != ROOM_PLAYING) {
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"No active game found\"}");
         return;
     }
@@ -138,120 +129,179 @@ void handle_room_choice(int sock, int session_id, char *json_body) {
     
     // Validate player state
     if (player->has_answered) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Already answered. Waiting for other players.\"}");
         return;
     }
     
     if (player->game_over) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Your game is over. Wait for others to finish.\"}");
         return;
     }
     
-    // Get current items
-    GameItem *itemA = &game_database[room->current_index_A];
-    GameItem *itemB = &game_database[room->current_index_B];
-    
     // Check answer: choice=1 means B>=A (higher), choice=2 means B<=A (lower)
+    // Chỉ đọc mảng value hot của catalog, không chạm chuỗi
+    int valueA = room_item_value(room, room->current_index_A);
+    int valueB = room_item_value(room, room->current_index_B);
     int correct = 0;
     if (choice == 1) {
-        correct = (itemB->value >= itemA->value);
+        correct = (valueB >= valueA);
     } else if (choice == 2) {
-        correct = (itemB->value <= itemA->value);
+        correct = (valueB <= valueA);
     }
     
-    // Update player state
-    player->has_answered = 1;
-    player->last_answer_correct = correct;
-    player->response_time_ms = response_time_ms;
+    // Tên item B cho message / kết quả round
+    GameItem itemB = room_item(room, room->current_index_B);
+    
+    // Update player state + room aggregates
+    apply_player_answer(room, player, correct, response_time_ms);
     
     char message[256];
-    if (correct) {
-        player->score += SCORE_PER_CORRECT;
-        player->streak++;
-        snprintf(message, sizeof(message), "%s: $%d - Đúng rồi!", itemB->name, itemB->value);
-    } else {
-        player->streak = 0;
-        snprintf(message, sizeof(message), "%s: $%d - Sai rồi!", itemB->name, itemB->value);
-    }
+    snprintf(message, sizeof(message), "%s: $%d - %s", itemB.name, itemB.value,
+             correct ? "Đúng rồi!" : "Sai rồi!");
     
     int room_id = room->id;
     int total_players = room->player_count;
     int answered_players = count_answered_players(room);
     
-    // Send immediate response to this player
-    char response[RESPONSE_SIZE];
-    snprintf(response, sizeof(response),
-        "{\"action\":\"choice_result\",\"correct\":%s,\"score\":%d,\"streak\":%d,"
-        "\"message\":\"%s\",\"valueB\":%d,\"waiting_for\":%d,\"response_time\":%d}",
-        correct ? "true" : "false",
-        player->score, player->streak, message,
-        itemB->value, total_players - answered_players, response_time_ms
-    );
-    send_json_response(sock, response);
-    
-    printf("[ROOM] 🎯 Player %d answered: %s (Score: %d, Time: %dms) - %d/%d answered\n", 
-           session_id, correct ? "✅" : "❌", player->score, response_time_ms, 
-           answered_players, total_players);
-    
-    // Check if all players answered
-    if (answered_players >= total_players) {
-        // Broadcast round results
-        char results_json[RESPONSE_SIZE];
-        build_round_results_json(room, room->current_round, itemB->value, itemB->name,
-                                  results_json, sizeof(results_json));
-        broadcast_sse_to_room(room_id, results_json);
-        printf("[ROOM] 📊 Round %d results broadcasted\n", room->current_round);
-        
-        // Check if game finished
-        if (room->max_rounds > 0 && room->current_round >= room->max_rounds) {
-            room->status = ROOM_FINISHED;
-            
-            char room_json[BUFFER_SIZE];
-            build_room_json(room, room_json, sizeof(room_json));
-            
-            char finish_json[RESPONSE_SIZE];
-            snprintf(finish_json, sizeof(finish_json),
-                "{\"action\":\"game_finished\",\"room\":%s}", room_json);
-            
-            pthread_mutex_unlock(&rooms_mutex);
-            broadcast_sse_to_room(room_id, finish_json);
-            
-            printf("[ROOM] 🏆 Game finished in room ID: %d (reached %d rounds)\n", 
-                   room_id, room->max_rounds);
-            return;
-        }
+    WireChoiceResult result = {
+        .correct = correct,
+        .score = player->score,
+        .streak = player->streak,
+        .message = message,
+        .valueB = itemB.value,
+        .waiting_for = total_players - answered_players,
+        .response_time = response_time_ms,
+    };
+    
+    JsonWriter response;
+    jw_init(&response);
+    wire_json_object(&response, WIRE_SCHEMA(CHOICE_RESULT), &result);
+    
+    if (!room->is_arena) {
+        LOG_DEBUG("ROOM", "🎯 Player %d answered: %s (Score: %d, Time: %dms) - %d/%d answered", 
+                  session_id, correct ? "✅" : "❌", player->score, response_time_ms, 
+                  answered_players, total_players);
+    }
+    
+    if (answered_players < total_players) {
+        trace_span("rooms_mutex wait", lock_wait, lock_held, room_id);
+        trace_end("rooms_mutex hold", lock_held, room_id);
+        MUTEX_UNLOCK(&rooms_mutex);
+        send_json_response(sock, jw_str(&response));
+        jw_free(&response);
+        return;
+    }
+    
+    /* ----- Round kết thúc: build mọi message khi còn giữ lock, gửi sau khi unlock ----- */
+    
+    trace_promote();
+    trace_span("rooms_mutex wait", lock_wait, lock_held, room_id);
+    uint64_t close_start = metrics_now_ns();
+    
+    RoundClose rc;
+    close_round_locked(room_idx, &rc);
+    
+    uint64_t close_end = metrics_now_ns();
+    MUTEX_UNLOCK(&rooms_mutex);
+    trace_span("rooms_mutex hold", lock_held, close_end, room_id);
+    
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
+    
+    if (rc.is_arena) {
+        LOG_DEBUG("ARENA", "⏱️  Round %d closed in %.3f ms (%d players)", rc.round,
+                  (close_end - close_start) / 1e6, total_players);
+    }
+    
+    publish_round_close(&rc);
+    trace_end("round_close", close_start, room_id);
+}
+
+/* ============================================================================
+ *                           ROUND CLOSE
+ * ============================================================================ */
+
+void close_round_locked(int room_idx, RoundClose *rc) {
+    GameRoom *room = &rooms[room_idx];
+    GameItem itemB = room_item(room, room->current_index_B);
+    int room_id = room->id;
+    
+    rc->room_id = room_id;
+    rc->round = room->current_round;
+    rc->is_arena = room->is_arena;
+    rc->players = room->player_count;
+    
+    // Snapshot key xếp hạng để mỗi người nhận my_rank/my_score riêng (sắp xếp sau khi unlock)
+    uint64_t span_start = trace_start();
+    rc->rank_keys = malloc(sizeof(RoomRankKey) * (rc->players > 0 ? rc->players : 1));
+    rc->rank_count = rc->rank_keys ? room_rank_snapshot(room, rc->rank_keys) : 0;
+    trace_end("rank_snapshot", span_start, room_id);
+    
+    // Round results (arena: thống kê + top K thay vì toàn bộ players)
+    span_start = trace_start();
+    jw_init(&rc->results_json);
+    if (rc->is_arena) {
+        build_arena_round_results_prefix(&rc->results_json, room, rc->round, itemB.value, itemB.name);
+    } else {
+        build_round_results_json(&rc->results_json, room, rc->round, itemB.value, itemB.name);
+    }
+    trace_end("serialize round_results", span_start, room_id);
+    
+    jw_init(&rc->next_json);
+    rc->finished = (room->max_rounds > 0 && room->current_round >= room->max_rounds);
+    
+    if (rc->finished) {
+        room->status = ROOM_FINISHED;
+        room->round_deadline_ns = 0;
+        touch_room(room);
+        notify_room_changed(room_idx);
+        leaderboard_submit_room(room);
         
+        span_start = trace_start();
+        build_game_finished_json(&rc->next_json, room);
+        trace_end("serialize game_finished", span_start, room_id);
+        LOG_INFO("ROOM", "🏆 Game finished in room ID: %d (reached %d rounds)", 
+                 room_id, room->max_rounds);
+    } else {
         // Move to next round
         room->current_round++;
+        touch_room(room);
         room->current_index_A = room->current_index_B;
-        room->current_index_B = get_random_index_except(room->current_index_A);
+        room->current_index_B = room_next_item(room);
         reset_round_state(room);
         
-        // Get new items
-        itemA = &game_database[room->current_index_A];
-        itemB = &game_database[room->current_index_B];
+        GameItem itemA = room_item(room, room->current_index_A);
+        itemB = room_item(room, room->current_index_B);
         
-        char room_json[BUFFER_SIZE];
-        build_room_json(room, room_json, sizeof(room_json));
+        span_start = trace_start();
+        build_new_round_json(&rc->next_json, room);
+        trace_end("serialize new_round", span_start, room_id);
         
-        char new_round_json[RESPONSE_SIZE];
-        snprintf(new_round_json, sizeof(new_round_json),
-            "{\"action\":\"new_round\",\"round\":%d,\"room\":%s,"
-            "\"labelA\":\"%s\",\"valueA\":%d,\"labelB\":\"%s\"}",
-            room->current_round, room_json,
-            itemA->name, itemA->value, itemB->name);
-        
-        pthread_mutex_unlock(&rooms_mutex);
-        broadcast_sse_to_room(room_id, new_round_json);
-        
-        printf("[ROOM] ➡️  Round %d/%d: %s ($%d) vs %s (?)\n", 
-               room->current_round, room->max_rounds, 
-               itemA->name, itemA->value, itemB->name);
+        LOG_DEBUG("ROOM", "➡️  Round %d/%d: %s ($%d) vs %s (?)", 
+                  room->current_round, room->max_rounds, 
+                  itemA.name, itemA.value, itemB.name);
+    }
+}
+
+void publish_round_close(RoundClose *rc) {
+    int rank_count = rc->rank_count;
+    SSE_RankEntry *ranks = malloc(sizeof(SSE_RankEntry) * (rank_count > 0 ? rank_count : 1));
+    if (!ranks) rank_count = 0;
+    if (rank_count > 0) room_rank_resolve(rc->rank_keys, rank_count, ranks);
+    free(rc->rank_keys);
+    
+    broadcast_sse_to_room_ranked(rc->room_id, jw_str(&rc->results_json), ranks, rank_count);
+    if (rc->finished) {
+        broadcast_sse_to_room_ranked(rc->room_id, jw_str(&rc->next_json), ranks, rank_count);
     } else {
-        pthread_mutex_unlock(&rooms_mutex);
+        broadcast_sse_to_room(rc->room_id, jw_str(&rc->next_json));
     }
+    free(ranks);
+    jw_free(&rc->results_json);
+    jw_free(&rc->next_json);
+    LOG_DEBUG("ROOM", "📊 Round %d results broadcasted", rc->round);
 }
 
 /**
@@ -263,14 +313,14 @@ void handle_get_room_info(int sock, int session_id) {
         return;
     }
     
-    pthread_mutex_lock(&rooms_mutex);
+    MUTEX_LOCK(&rooms_mutex);
     
     // Find room with player
     int player_idx;
     int room_idx = find_room_with_player(session_id, &player_idx);
     
     if (room_idx == -1) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"action\":\"room_info\",\"in_room\":false}");
         return;
     }
@@ -278,26 +328,32 @@ void handle_get_room_info(int sock, int session_id) {
     GameRoom *room = &rooms[room_idx];
     RoomPlayer *player = &room->players[player_idx];
     
-    GameItem *itemA = &game_database[room->current_index_A];
-    GameItem *itemB = &game_database[room->current_index_B];
-    
-    char room_json[BUFFER_SIZE];
-    build_room_json(room, room_json, sizeof(room_json));
-    
-    char response[RESPONSE_SIZE];
-    snprintf(response, sizeof(response),
-        "{\"action\":\"room_info\",\"in_room\":true,\"is_host\":%s,"
-        "\"room\":%s,\"round\":%d,\"my_score\":%d,\"my_streak\":%d,"
-        "\"my_game_over\":%s,\"has_answered\":%s,"
-        "\"labelA\":\"%s\",\"valueA\":%d,\"labelB\":\"%s\"}",
-        room->host_session_id == session_id ? "true" : "false",
-        room_json, room->current_round,
-        player->score, player->streak,
-        player->game_over ? "true" : "false",
-        player->has_answered ? "true" : "false",
-        itemA->name, itemA->value, itemB->name
-    );
-    
-    pthread_mutex_unlock(&rooms_mutex);
-    send_json_response(sock, response);
+    GameItem itemA = room_item(room, room->current_index_A);
+    GameItem itemB = room_item(room, room->current_index_B);
+    
+    WireRoomInfo info = {
+        .in_room = 1,
+        .is_host = room->host_session_id == session_id,
+        .round = room->current_round,
+        .my_score = player->score,
+        .my_streak = player->streak,
+        .my_rank = room_rank_of(room, player),
+        .my_game_over = player->game_over,
+        .has_answered = player->has_answered,
+        .labelA = itemA.name,
+        .valueA = itemA.value,
+        .labelB = itemB.name,
+    };
+    
+    JsonWriter response;
+    jw_init(&response);
+    jw_object_begin(&response);
+    wire_json_fields(&response, WIRE_SCHEMA(ROOM_INFO), &info);
+    jw_key(&response, "room");
+    build_room_json(&response, room);
+    jw_object_end(&response);
+    
+    MUTEX_UNLOCK(&rooms_mutex);
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
 }
@@ -3,30 +3,89 @@
  *                    HIGHER LOWER GAME - SINGLE PLAYER MODULE
  * ============================================================================
  * File: game_single.c
- * Description: Single player game logic (Legacy mode)
- * 
+ * Description: Single player game logic (stateless)
+ *
  * Chức năng:
  *   1. Khởi tạo game single player
  *   2. Xử lý lựa chọn của người chơi
- * 
- * Note: Đây là mode cũ, chủ yếu dùng cho testing.
- *       Mode chính là multiplayer rooms.
+ *
+ * Server không giữ state người chơi đơn: index A/B, score, streak, round
+ * và seed PRNG nằm trong token ký MAC (game_token.h) đi cùng mỗi request.
+ * Mọi worker / process có cùng key và cùng catalog phục vụ được mọi request;
+ * session_table chỉ nhớ round mới nhất mỗi game để từ chối token cũ.
  * ============================================================================
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <pthread.h>
 #include "../include/game.h"
+#include "../include/game_token.h"
+#include "../include/json_parse.h"
+#include "../include/prng.h"
+#include "../include/session_table.h"
+#include "../include/wire_schema.h"
 
 /* ============================================================================
- *                           EXTERNAL VARIABLES
+ *                           HELPERS
  * ============================================================================ */
 
-// Từ database.c
-extern GameItem game_database[MAX_ITEMS];
-extern int item_count;
+/**
+ * Index đều trong [0, count) khác except
+ */
+static int32_t draw_except(Prng *rng, int count, int32_t except) {
+    if (count < 2) return except;
+    int32_t index = (int32_t)prng_below(rng, (uint64_t)(count - 1));
+    return index >= except ? index + 1 : index;
+}
+
+/**
+ * PRNG của round hiện tại: cùng token => cùng item tiếp theo
+ */
+static void round_rng(const GameToken *token, Prng *rng) {
+    prng_seed(rng, token->seed + token->round);
+}
+
+/**
+ * Cặp A/B mới (game mới hoặc sau khi trả lời sai)
+ */
+static void draw_pair(const ItemCatalog *items, GameToken *token) {
+    Prng rng;
+    round_rng(token, &rng);
+    int count = item_catalog_count(items);
+    token->index_a = (int32_t)prng_below(&rng, (uint64_t)count);
+    token->index_b = draw_except(&rng, count, token->index_a);
+}
+
+/**
+ * Ký token mới và gửi update_game
+ */
+static void send_game_update(int sock, const ItemCatalog *items, GameToken *token, const char *message) {
+    char token_text[GAME_TOKEN_LEN];
+    game_token_encode(token, token_text, sizeof(token_text));
+
+    GameItem itemA = item_catalog_get(items, token->index_a);
+    GameItem itemB = item_catalog_get(items, token->index_b);
+
+    WireUpdateGame msg = {
+        .score = token->score,
+        .streak = token->streak,
+        .labelA = itemA.name,
+        .valueA = itemA.value,
+        .imageA = itemA.image_url,
+        .labelB = itemB.name,
+        .valueB = itemB.value,
+        .imageB = itemB.image_url,
+        .message = message,
+        .round = (int)token->round,
+        .token = token_text,
+    };
+    JsonWriter json;
+    jw_init(&json);
+    wire_json_object(&json, WIRE_SCHEMA(UPDATE_GAME), &msg);
+    send_json_response(sock, jw_str(&json));
+    jw_free(&json);
+}
 
 /* ============================================================================
  *                           SINGLE PLAYER HANDLERS
@@ -34,195 +93,105 @@ extern int item_count;
 
 /**
  * Khởi tạo game mới cho single player
- * 
+ *
  * Route: POST /game
- * Response: { action: "update_game", score, streak, labelA, valueA, ... }
+ * Response: { action: "update_game", score, streak, labelA, valueA, ..., token }
  */
-void handle_game_init(int sock, int session_id) {
-    if (session_id == 0) {
-        char error_json[] = "{\"error\":\"No session ID\"}";
-        send_json_response(sock, error_json);
-        return;
-    }
-    
-    pthread_mutex_lock(&game_state_mutex);
-    
-    // Find or create player state
-    int player_idx = -1;
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (player_states[i].active && player_states[i].session_id == session_id) {
-            player_idx = i;
-            break;
-        }
-        if (player_idx == -1 && !player_states[i].active) {
-            player_idx = i;
-        }
-    }
-    
-    if (player_idx == -1) {
-        pthread_mutex_unlock(&game_state_mutex);
-        char error_json[] = "{\"error\":\"Server full\"}";
-        send_json_response(sock, error_json);
-        return;
-    }
-    
-    // Initialize/reset player state
-    player_states[player_idx].active = 1;
-    player_states[player_idx].session_id = session_id;
-    player_states[player_idx].score = 0;
-    player_states[player_idx].streak = 0;
-    player_states[player_idx].current_index_A = rand() % item_count;
-    player_states[player_idx].current_index_B = get_random_index_except(player_states[player_idx].current_index_A);
-    
-    GameItem *itemA = &game_database[player_states[player_idx].current_index_A];
-    GameItem *itemB = &game_database[player_states[player_idx].current_index_B];
-    
-    // Build JSON response
-    char json[BUFFER_SIZE];
-    snprintf(json, sizeof(json),
-        "{"
-        "\"action\":\"update_game\","
-        "\"score\":%d,"
-        "\"streak\":%d,"
-        "\"labelA\":\"%s\","
-        "\"valueA\":%d,"
-        "\"imageA\":\"%s\","
-        "\"labelB\":\"%s\","
-        "\"valueB\":%d,"
-        "\"imageB\":\"%s\","
-        "\"message\":\"Game initialized! Make your guess.\""
-        "}",
-        player_states[player_idx].score, player_states[player_idx].streak,
-        itemA->name, itemA->value, itemA->image_url,
-        itemB->name, itemB->value, itemB->image_url
-    );
-    
-    pthread_mutex_unlock(&game_state_mutex);
-    
-    send_json_response(sock, json);
-    
-    printf("\n[GAME] 🎮 Single player game initialized (Session %d)\n", session_id);
-    printf("       Item A: %s ($%d)\n", itemA->name, itemA->value);
-    printf("       Item B: %s ($%d)\n", itemB->name, itemB->value);
-    printf("==========================================\n");
+void handle_game_init(int sock) {
+    // Item view hợp lệ khi còn giữ reference
+    ItemCatalog *items = item_catalog_acquire();
+
+    GameToken token = {
+        .catalog_id = item_catalog_fingerprint(items),
+        .seed = prng_entropy_seed(),
+    };
+    draw_pair(items, &token);
+    send_game_update(sock, items, &token, "Game initialized! Make your guess.");
+    item_catalog_release(items);
 }
 
 /**
  * Xử lý lựa chọn của người chơi (single player)
- * 
+ *
  * Route: POST /game/choice
- * Body: { choice: 1|2 }  // 1 = A cao hơn, 2 = B cao hơn
+ * Body: { token: "...", choice: 1|2 }  // 1 = A cao hơn, 2 = B cao hơn
  */
-void handle_player_choice(int sock, int session_id, char *json_body) {
-    if (session_id == 0) {
-        char error_json[] = "{\"error\":\"No session ID\"}";
-        send_json_response(sock, error_json);
+void handle_player_choice(int sock, char *json_body) {
+    // Parse choice + token from JSON
+    RequestBody body;
+    if (parse_request_body(json_body, strlen(json_body), &body) != 0 ||
+        !REQ_HAS(&body, CHOICE) || !REQ_HAS(&body, TOKEN)) {
+        send_json_response(sock, "{\"error\":\"Invalid request\"}");
         return;
     }
-    
-    // Parse choice from JSON
-    char *choice_ptr = strstr(json_body, "\"choice\"");
-    if (!choice_ptr) {
-        char error_json[] = "{\"error\":\"Invalid request\"}";
-        send_json_response(sock, error_json);
+    int choice = body.choice;
+
+    GameToken token;
+    GameTokenStatus status = game_token_decode(body.token, &token);
+    if (status == GAME_TOKEN_EXPIRED) {
+        send_json_response(sock, "{\"error\":\"Game expired. Please start a new game.\"}");
         return;
     }
-    
-    char *value_start = strchr(choice_ptr, ':');
-    if (!value_start) {
-        char error_json[] = "{\"error\":\"Invalid request\"}";
-        send_json_response(sock, error_json);
+    if (status != GAME_TOKEN_OK) {
+        send_json_response(sock, "{\"error\":\"Invalid game token\"}");
         return;
     }
-    
-    value_start++;
-    while (*value_start == ' ' || *value_start == '\t') value_start++;
-    int choice = atoi(value_start);
-    
-    pthread_mutex_lock(&game_state_mutex);
-    
-    // Find player state
-    int player_idx = -1;
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (player_states[i].active && player_states[i].session_id == session_id) {
-            player_idx = i;
-            break;
-        }
+
+    // Token đã được trả lời rồi (gửi lại / double submit): chỉ token mới nhất hợp lệ
+    SessionStatus session = session_table_advance(token.seed, token.round, token.issued_at);
+    if (session == SESSION_REPLAY) {
+        send_json_response(sock, "{\"error\":\"Game already advanced. Use the latest token.\"}");
+        return;
+    }
+    if (session == SESSION_FORGOTTEN) {
+        send_json_response(sock, "{\"error\":\"Game expired. Please start a new game.\"}");
+        return;
     }
-    
-    if (player_idx == -1) {
-        pthread_mutex_unlock(&game_state_mutex);
-        char error_json[] = "{\"error\":\"No game found. Please start a new game.\"}";
-        send_json_response(sock, error_json);
+
+    // Index trong token chỉ đúng với catalog đã ký nó
+    ItemCatalog *items = item_catalog_acquire();
+    int count = item_catalog_count(items);
+    if (token.catalog_id != item_catalog_fingerprint(items) ||
+        token.index_a < 0 || token.index_a >= count || token.index_b < 0 || token.index_b >= count) {
+        item_catalog_release(items);
+        send_json_response(sock, "{\"error\":\"Item catalog changed. Please start a new game.\"}");
         return;
     }
-    
-    PlayerGameState *player = &player_states[player_idx];
-    GameItem *itemA = &game_database[player->current_index_A];
-    GameItem *itemB = &game_database[player->current_index_B];
-    
+
+    // Check if choice is correct (chỉ đọc mảng value hot)
+    int valueA = item_catalog_value(items, token.index_a);
+    int valueB = item_catalog_value(items, token.index_b);
     int correct = 0;
-    char message[256];
-    
-    // Check if choice is correct
     if (choice == 1) {
-        correct = (itemA->value >= itemB->value);
+        correct = (valueA >= valueB);
     } else if (choice == 2) {
-        correct = (itemB->value >= itemA->value);
+        correct = (valueB >= valueA);
     }
-    
+
+    char message[256];
+    GameItem itemA = item_catalog_get(items, token.index_a);
+    GameItem itemB = item_catalog_get(items, token.index_b);
+    snprintf(message, sizeof(message), correct ? "Correct! %s ($%d) vs %s ($%d)"
+                                               : "Wrong! %s ($%d) vs %s ($%d). Streak reset!",
+             itemA.name, itemA.value, itemB.name, itemB.value);
+
+    token.round++;
     if (correct) {
-        player->score += SCORE_PER_CORRECT;
-        player->streak++;
-        snprintf(message, sizeof(message), "Correct! %s ($%d) vs %s ($%d)", 
-                 itemA->name, itemA->value, itemB->name, itemB->value);
-        
+        token.score += SCORE_PER_CORRECT;
+        token.streak++;
+
         // Move B to A, pick new B
-        player->current_index_A = player->current_index_B;
-        player->current_index_B = get_random_index_except(player->current_index_A);
+        Prng rng;
+        round_rng(&token, &rng);
+        token.index_a = token.index_b;
+        token.index_b = draw_except(&rng, count, token.index_a);
     } else {
-        player->streak = 0;
-        snprintf(message, sizeof(message), "Wrong! %s ($%d) vs %s ($%d). Streak reset!", 
-                 itemA->name, itemA->value, itemB->name, itemB->value);
-        
+        token.streak = 0;
+
         // Pick two new random items
-        player->current_index_A = rand() % item_count;
-        player->current_index_B = get_random_index_except(player->current_index_A);
+        draw_pair(items, &token);
     }
-    
-    // Get updated items
-    itemA = &game_database[player->current_index_A];
-    itemB = &game_database[player->current_index_B];
-    
-    // Build JSON response
-    char json[BUFFER_SIZE];
-    snprintf(json, sizeof(json),
-        "{"
-        "\"action\":\"update_game\","
-        "\"score\":%d,"
-        "\"streak\":%d,"
-        "\"labelA\":\"%s\","
-        "\"valueA\":%d,"
-        "\"imageA\":\"%s\","
-        "\"labelB\":\"%s\","
-        "\"valueB\":%d,"
-        "\"imageB\":\"%s\","
-        "\"message\":\"%s\""
-        "}",
-        player->score, player->streak,
-        itemA->name, itemA->value, itemA->image_url,
-        itemB->name, itemB->value, itemB->image_url,
-        message
-    );
-    
-    pthread_mutex_unlock(&game_state_mutex);
-    
-    send_json_response(sock, json);
-    
-    printf("[GAME] 🎯 Single player choice: %s (Session %d)\n", 
-           correct ? "✅ CORRECT" : "❌ WRONG", session_id);
-    printf("       Score: %d | Streak: %d\n", player->score, player->streak);
-    
-    // Broadcast update via SSE
-    broadcast_sse_to_session(session_id, json);
+
+    send_game_update(sock, items, &token, message);
+    item_catalog_release(items);
 }
@@ -0,0 +1,220 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - GAME TOKEN
+ * ============================================================================
+ * File: game_token.c
+ * Description: SipHash-2-4 + đóng gói / kiểm tra token chơi đơn
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/game_token.h"
+#include "../include/logger.h"
+#include "../include/prng.h"
+
+#define TOKEN_PAYLOAD_LEN   37
+#define TOKEN_TAG_LEN       8
+#define TOKEN_RAW_LEN       (TOKEN_PAYLOAD_LEN + TOKEN_TAG_LEN)
+#define TOKEN_TEXT_LEN      (TOKEN_RAW_LEN / 3 * 4)    // 45 byte chia hết cho 3: không padding
+
+// Chỉ ghi lúc khởi động (trước khi nhận request)
+static uint8_t token_key[16];
+
+/* ============================================================================
+ *                           SIPHASH-2-4
+ * ============================================================================ */
+
+static uint64_t load_le64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+#define SIPROUND do {                                                   \
+        v0 += v1; v1 = prng_rotl(v1, 13); v1 ^= v0; v0 = prng_rotl(v0, 32); \
+        v2 += v3; v3 = prng_rotl(v3, 16); v3 ^= v2;                     \
+        v0 += v3; v3 = prng_rotl(v3, 21); v3 ^= v0;                     \
+        v2 += v1; v1 = prng_rotl(v1, 17); v1 ^= v2; v2 = prng_rotl(v2, 32); \
+    } while (0)
+
+uint64_t siphash24(const uint8_t key[16], const void *data, size_t len) {
+    const uint8_t *in = data;
+    uint64_t k0 = load_le64(key);
+    uint64_t k1 = load_le64(key + 8);
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    size_t full = len & ~(size_t)7;
+    for (size_t i = 0; i < full; i += 8) {
+        uint64_t m = load_le64(in + i);
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    uint64_t b = (uint64_t)len << 56;
+    for (size_t i = 0; i < (len & 7); i++) b |= (uint64_t)in[full + i] << (8 * i);
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/* ============================================================================
+ *                           KEY
+ * ============================================================================ */
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void game_token_set_key(const uint8_t key[16]) {
+    memcpy(token_key, key, sizeof(token_key));
+}
+
+void game_token_init_key(void) {
+    const char *hex = getenv(GAME_TOKEN_KEY_ENV);
+    if (hex && strlen(hex) == 32) {
+        int ok = 1;
+        for (int i = 0; i < 16 && ok; i++) {
+            int hi = hex_value(hex[2 * i]), lo = hex_value(hex[2 * i + 1]);
+            if (hi < 0 || lo < 0) ok = 0;
+            token_key[i] = (uint8_t)(hi << 4 | lo);
+        }
+        if (ok) {
+            LOG_INFO("TOKEN", "🔑 Single-player token key from %s", GAME_TOKEN_KEY_ENV);
+            return;
+        }
+    }
+    if (hex) LOG_WARN("TOKEN", "⚠️  %s must be 32 hex characters, ignoring", GAME_TOKEN_KEY_ENV);
+
+    for (int i = 0; i < 16; i += 8) {
+        uint64_t r = prng_entropy_seed();
+        memcpy(token_key + i, &r, 8);
+    }
+    LOG_INFO("TOKEN", "🔑 Random single-player token key (set %s to share tokens across processes)",
+             GAME_TOKEN_KEY_ENV);
+}
+
+/* ============================================================================
+ *                           ENCODING
+ * ============================================================================ */
+
+static const char base64url[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static int base64url_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/**
+ * Layout payload (little-endian):
+ *   version(1) catalog_id(4) index_a(4) index_b(4) score(4) streak(4)
+ *   round(4) seed(8) issued_at(4)
+ */
+static void pack_payload(const GameToken *t, uint8_t *p) {
+    p[0] = GAME_TOKEN_VERSION;
+    put32(p + 1, t->catalog_id);
+    put32(p + 5, (uint32_t)t->index_a);
+    put32(p + 9, (uint32_t)t->index_b);
+    put32(p + 13, (uint32_t)t->score);
+    put32(p + 17, (uint32_t)t->streak);
+    put32(p + 21, t->round);
+    put32(p + 25, (uint32_t)t->seed);
+    put32(p + 29, (uint32_t)(t->seed >> 32));
+    put32(p + 33, t->issued_at);
+}
+
+static void unpack_payload(const uint8_t *p, GameToken *t) {
+    t->catalog_id = get32(p + 1);
+    t->index_a = (int32_t)get32(p + 5);
+    t->index_b = (int32_t)get32(p + 9);
+    t->score = (int32_t)get32(p + 13);
+    t->streak = (int32_t)get32(p + 17);
+    t->round = get32(p + 21);
+    t->seed = (uint64_t)get32(p + 25) | (uint64_t)get32(p + 29) << 32;
+    t->issued_at = get32(p + 33);
+}
+
+int game_token_encode(GameToken *token, char *out, size_t out_len) {
+    if (out_len < TOKEN_TEXT_LEN + 1) return -1;
+    token->issued_at = (uint32_t)time(NULL);
+
+    uint8_t raw[TOKEN_RAW_LEN];
+    pack_payload(token, raw);
+    uint64_t tag = siphash24(token_key, raw, TOKEN_PAYLOAD_LEN);
+    put32(raw + TOKEN_PAYLOAD_LEN, (uint32_t)tag);
+    put32(raw + TOKEN_PAYLOAD_LEN + 4, (uint32_t)(tag >> 32));
+
+    char *o = out;
+    for (int i = 0; i < TOKEN_RAW_LEN; i += 3) {
+        uint32_t v = (uint32_t)raw[i] << 16 | (uint32_t)raw[i + 1] << 8 | raw[i + 2];
+        *o++ = base64url[(v >> 18) & 63];
+        *o++ = base64url[(v >> 12) & 63];
+        *o++ = base64url[(v >> 6) & 63];
+        *o++ = base64url[v & 63];
+    }
+    *o = '\0';
+    return TOKEN_TEXT_LEN;
+}
+
+GameTokenStatus game_token_decode(const char *text, GameToken *out) {
+    if (strlen(text) != TOKEN_TEXT_LEN) return GAME_TOKEN_MALFORMED;
+
+    uint8_t raw[TOKEN_RAW_LEN];
+    for (int i = 0, j = 0; i < TOKEN_TEXT_LEN; i += 4, j += 3) {
+        uint32_t v = 0;
+        for (int k = 0; k < 4; k++) {
+            int d = base64url_value(text[i + k]);
+            if (d < 0) return GAME_TOKEN_MALFORMED;
+            v = v << 6 | (uint32_t)d;
+        }
+        raw[j] = (uint8_t)(v >> 16);
+        raw[j + 1] = (uint8_t)(v >> 8);
+        raw[j + 2] = (uint8_t)v;
+    }
+
+    // So sánh tag không rẽ nhánh theo byte (không lộ vị trí byte sai qua thời gian)
+    uint64_t tag = siphash24(token_key, raw, TOKEN_PAYLOAD_LEN);
+    uint8_t diff = 0;
+    for (int i = 0; i < TOKEN_TAG_LEN; i++) {
+        diff |= raw[TOKEN_PAYLOAD_LEN + i] ^ (uint8_t)(tag >> (8 * i));
+    }
+    if (diff != 0) return GAME_TOKEN_BAD_MAC;
+    if (raw[0] != GAME_TOKEN_VERSION) return GAME_TOKEN_MALFORMED;
+
+    unpack_payload(raw, out);
+    // Cho phép đồng hồ các process lệch nhau tới 5 phút
+    int64_t age = (int64_t)time(NULL) - (int64_t)out->issued_at;
+    if (age > GAME_TOKEN_TTL_SEC || age < -300) return GAME_TOKEN_EXPIRED;
+    return GAME_TOKEN_OK;
+}
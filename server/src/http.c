@@ -15,7 +15,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/uio.h>
 #include "../include/game.h"
+#include "../include/metrics.h"
 
 /* ============================================================================
  *                           HTTP RESPONSE FUNCTIONS
@@ -51,20 +53,48 @@ void send_cors_headers(int sock) {
  * @param sock Socket để gửi
  * @param body JSON string để gửi
  */
-void send_json_response(int sock, char *body) {
-    char response[RESPONSE_SIZE];
-    int body_len = strlen(body);
+void send_json_response(int sock, const char *body) {
+    send_response(sock, "application/json", body, strlen(body));
+}
+
+void send_response(int sock, const char *content_type, const char *body, size_t body_len) {
+    char headers[256];
     
-    int header_len = snprintf(response, sizeof(response),
+    int header_len = snprintf(headers, sizeof(headers),
         "HTTP/1.1 200 OK\r\n"
-        "Content-Type: application/json\r\n"
-        "Content-Length: %d\r\n"
+        "Content-Type: %s\r\n"
+        "Content-Length: %zu\r\n"
         "Access-Control-Allow-Origin: *\r\n"
         "Connection: close\r\n"
-        "\r\n"
-        "%s",
-        body_len, body
+        "\r\n",
+        content_type, body_len
     );
     
-    write(sock, response, header_len);
+    // Headers + body trong một writev: body không bị copy hay cắt ngắn
+    struct iovec iov[2] = {
+        { headers, (size_t)header_len },
+        { (void *)body, body_len }
+    };
+    size_t total = header_len + body_len;
+    size_t written = 0;
+    int idx = 0;
+    
+    while (written < total) {
+        ssize_t n = writev(sock, iov + idx, 2 - idx);
+        if (n <= 0) {
+            metrics_add(METRIC_WRITE_ERRORS, 1);
+            break;
+        }
+        written += n;
+        // Bỏ qua phần đã gửi (write ngắn khi body lớn hơn socket buffer)
+        while (idx < 2 && (size_t)n >= iov[idx].iov_len) {
+            n -= iov[idx].iov_len;
+            idx++;
+        }
+        if (idx < 2) {
+            iov[idx].iov_base = (char *)iov[idx].iov_base + n;
+            iov[idx].iov_len -= n;
+        }
+    }
+    metrics_add(METRIC_BYTES_OUT, written);
 }
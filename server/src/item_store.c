@@ -0,0 +1,58 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ITEM STORE
+ * ============================================================================
+ * File: item_store.c
+ * Description: Ghép các catalog đang map thành một dải index chung
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/item_store.h"
+
+/* ============================================================================
+ *                           BUILD
+ * ============================================================================ */
+
+int item_store_build(ItemStore *store, Catalog *const *parts, int part_count) {
+    memset(store, 0, sizeof(*store));
+
+    int n = part_count > 0 ? part_count : 1;
+    store->parts = calloc(n, sizeof(Catalog));
+    store->bases = calloc(n, sizeof(uint32_t));
+    if (!store->parts || !store->bases) {
+        for (int p = 0; p < part_count; p++) catalog_close(parts[p]);
+        item_store_free(store);
+        return -1;
+    }
+
+    uint64_t total = 0;
+    uint64_t h = 14695981039346656037ULL;           // FNV-1a 64 bit theo fingerprint từng part
+    for (int p = 0; p < part_count; p++) {
+        store->parts[p] = *parts[p];
+        memset(parts[p], 0, sizeof(Catalog));
+        store->bases[p] = (uint32_t)total;
+        total += store->parts[p].count;
+        h = (h ^ store->parts[p].fingerprint) * 1099511628211ULL;
+    }
+    store->part_count = part_count;
+    if (total > UINT32_MAX) {
+        item_store_free(store);
+        return -1;
+    }
+    store->count = (uint32_t)total;
+
+    // Một catalog: giữ nguyên fingerprint trong file (token chơi đơn cũ vẫn hợp lệ)
+    store->fingerprint = part_count == 1 ? store->parts[0].fingerprint : (uint32_t)(h ^ (h >> 32));
+    return 0;
+}
+
+void item_store_free(ItemStore *store) {
+    if (store->parts) {
+        for (int p = 0; p < store->part_count; p++) catalog_close(&store->parts[p]);
+    }
+    free(store->parts);
+    free(store->bases);
+    memset(store, 0, sizeof(*store));
+}
@@ -0,0 +1,64 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - JSON FRAGMENT CACHE
+ * ============================================================================
+ * File: json_cache.c
+ * Description: Lưu/tra JSON fragment theo version + bộ đếm hit/miss
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/json_cache.h"
+
+/* ============================================================================
+ *                           STATS
+ * ============================================================================ */
+
+static unsigned long long cache_hits = 0;
+static unsigned long long cache_misses = 0;
+
+void json_cache_stats(JsonCacheStats *out) {
+    out->hits = __atomic_load_n(&cache_hits, __ATOMIC_RELAXED);
+    out->misses = __atomic_load_n(&cache_misses, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ *                           FRAGMENT FUNCTIONS
+ * ============================================================================ */
+
+int json_fragment_lookup(const JsonFragment *f, unsigned int version) {
+    if (f->data && f->version == version) {
+        __atomic_fetch_add(&cache_hits, 1, __ATOMIC_RELAXED);
+        return 1;
+    }
+    __atomic_fetch_add(&cache_misses, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+void json_fragment_store(JsonFragment *f, unsigned int version, const char *data, size_t len) {
+    if (len + 1 > f->cap) {
+        size_t new_cap = f->cap ? f->cap : 128;
+        while (new_cap < len + 1) new_cap *= 2;
+        char *grown = realloc(f->data, new_cap);
+        if (!grown) {
+            // Không cache được thì thôi, lần sau build lại
+            json_fragment_free(f);
+            return;
+        }
+        f->data = grown;
+        f->cap = new_cap;
+    }
+    memcpy(f->data, data, len);
+    f->data[len] = '\0';
+    f->len = len;
+    f->version = version;
+}
+
+void json_fragment_free(JsonFragment *f) {
+    free(f->data);
+    f->data = NULL;
+    f->len = 0;
+    f->cap = 0;
+    f->version = 0;
+}
@@ -0,0 +1,370 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - REQUEST BODY PARSER
+ * ============================================================================
+ * File: json_parse.c
+ * Description: Tokenizer một lượt cho JSON body
+ *
+ * Phần tốn thời gian nhất là quét nội dung string (tên phòng, tên người
+ * chơi...), nên chỉ đoạn đó dùng SIMD: mỗi vòng so 16 byte với '"' và '\'
+ * cùng lúc. SSE2 luôn có trên x86-64 nên không cần cờ biên dịch thêm;
+ * kiến trúc khác dùng vòng lặp scalar.
+ * ============================================================================
+ */
+
+#include <string.h>
+#include <limits.h>
+#include <stddef.h>
+#include "../include/json_parse.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* ============================================================================
+ *                           KEY TABLE
+ * ============================================================================ */
+
+typedef enum {
+    FIELD_INT,
+    FIELD_STRING
+} FieldType;
+
+typedef struct {
+    const char *key;
+    unsigned char key_len;
+    unsigned char type;                 // FieldType
+    unsigned short offset;              // offsetof(RequestBody, field)
+    unsigned short size;                // Kích thước buffer (STRING)
+} FieldSpec;
+
+#define REQ_FIELD_SPEC(id, key, type, field, size) \
+    { key, sizeof(key) - 1, FIELD_##type, offsetof(RequestBody, field), size },
+
+static const FieldSpec field_specs[REQ_FIELD_COUNT] = {
+    REQUEST_FIELDS(REQ_FIELD_SPEC)
+};
+
+#undef REQ_FIELD_SPEC
+
+/**
+ * Tìm key trong bảng
+ * @return Index field, hoặc -1 nếu không phải key đã biết
+ */
+static int lookup_field(const char *key, size_t len) {
+    for (int i = 0; i < REQ_FIELD_COUNT; i++) {
+        if (field_specs[i].key_len == len && field_specs[i].key[0] == key[0] &&
+            memcmp(field_specs[i].key, key, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ============================================================================
+ *                           SCANNING
+ * ============================================================================ */
+
+static const char *skip_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    return p;
+}
+
+/**
+ * Tìm '"' hoặc '\' đầu tiên trong [p, end)
+ * @return Vị trí tìm thấy, hoặc end
+ */
+static const char *find_quote_or_backslash(const char *p, const char *end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                  _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\') p++;
+    return p;
+}
+
+/* ============================================================================
+ *                           STRINGS
+ * ============================================================================ */
+
+/**
+ * Buffer đích của string value (cắt bớt khi đầy, luôn NUL-terminated)
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    int truncated;
+} StringOut;
+
+static void out_append(StringOut *out, const char *data, size_t n) {
+    if (!out || n == 0) return;
+    size_t room = out->size - 1 - out->len;
+    if (n > room) {
+        n = room;
+        out->truncated = 1;
+    }
+    memcpy(out->buf + out->len, data, n);
+    out->len += n;
+}
+
+/**
+ * Kết thúc string; nếu bị cắt thì bỏ ký tự UTF-8 dở dang ở cuối
+ */
+static void out_finish(StringOut *out) {
+    if (out->truncated && out->len > 0) {
+        size_t start = out->len;
+        // Lùi về byte đầu của ký tự cuối cùng (tối đa 3 byte tiếp nối)
+        while (start > 0 && out->len - start < 4 &&
+               ((unsigned char)out->buf[start - 1] & 0xC0) == 0x80) {
+            start--;
+        }
+        if (start > 0) {
+            unsigned char lead = (unsigned char)out->buf[start - 1];
+            size_t need = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            if (out->len - (start - 1) < need) out->len = start - 1;
+        }
+    }
+    out->buf[out->len] = '\0';
+}
+
+static int hex4(const char *p, const char *end, unsigned int *value) {
+    if (end - p < 4) return -1;
+    unsigned int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9')      v |= c - '0';
+        else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+        else return -1;
+    }
+    *value = v;
+    return 0;
+}
+
+static void out_utf8(StringOut *out, unsigned int cp) {
+    char tmp[4];
+    size_t n;
+    if (cp == 0) return;    // Bỏ \u0000, chuỗi C không chứa được
+    if (cp < 0x80) {
+        tmp[0] = (char)cp; n = 1;
+    } else if (cp < 0x800) {
+        tmp[0] = (char)(0xC0 | (cp >> 6));
+        tmp[1] = (char)(0x80 | (cp & 0x3F)); n = 2;
+    } else if (cp < 0x10000) {
+        tmp[0] = (char)(0xE0 | (cp >> 12));
+        tmp[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        tmp[2] = (char)(0x80 | (cp & 0x3F)); n = 3;
+    } else {
+        tmp[0] = (char)(0xF0 | (cp >> 18));
+        tmp[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        tmp[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        tmp[3] = (char)(0x80 | (cp & 0x3F)); n = 4;
+    }
+    out_append(out, tmp, n);
+}
+
+/**
+ * Đọc string sau dấu " mở, decode escape vào out (NULL = chỉ bỏ qua)
+ * @return Vị trí ngay sau dấu " đóng, hoặc NULL nếu lỗi
+ */
+static const char *parse_string(const char *p, const char *end, StringOut *out) {
+    while (1) {
+        const char *special = find_quote_or_backslash(p, end);
+        out_append(out, p, special - p);
+        if (special >= end) return NULL;
+        p = special + 1;
+        if (*special == '"') return p;
+
+        // Escape
+        if (p >= end) return NULL;
+        char c = *p++;
+        switch (c) {
+            case '"':  out_append(out, "\"", 1); break;
+            case '\\': out_append(out, "\\", 1); break;
+            case '/':  out_append(out, "/", 1); break;
+            case 'b':  out_append(out, "\b", 1); break;
+            case 'f':  out_append(out, "\f", 1); break;
+            case 'n':  out_append(out, "\n", 1); break;
+            case 'r':  out_append(out, "\r", 1); break;
+            case 't':  out_append(out, "\t", 1); break;
+            case 'u': {
+                unsigned int cp;
+                if (hex4(p, end, &cp) != 0) return NULL;
+                p += 4;
+                // Surrogate pair -> một code point
+                if (cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    unsigned int low;
+                    if (hex4(p + 2, end, &low) == 0 && low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                }
+                if (cp >= 0xD800 && cp <= 0xDFFF) cp = 0xFFFD;
+                out_utf8(out, cp);
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+}
+
+/* ============================================================================
+ *                           NUMBERS & LITERALS
+ * ============================================================================ */
+
+/**
+ * Đọc number/true/false/null thành int (phần thập phân bị bỏ, chặn trong INT range)
+ * @return Vị trí sau value, hoặc NULL nếu không phải scalar hợp lệ
+ */
+static const char *parse_scalar(const char *p, const char *end, int *value) {
+    if (end - p >= 4 && memcmp(p, "true", 4) == 0)  { *value = 1; return p + 4; }
+    if (end - p >= 5 && memcmp(p, "false", 5) == 0) { *value = 0; return p + 5; }
+    if (end - p >= 4 && memcmp(p, "null", 4) == 0)  { *value = 0; return p + 4; }
+
+    int negative = 0;
+    if (p < end && *p == '-') { negative = 1; p++; }
+    if (p >= end || *p < '0' || *p > '9') return NULL;
+
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (v <= INT_MAX) v = v * 10 + (*p - '0');
+        p++;
+    }
+    // Phần thập phân / số mũ: chấp nhận nhưng bỏ qua
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') p++;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) p++;
+        while (p < end && *p >= '0' && *p <= '9') p++;
+    }
+
+    if (negative) v = -v;
+    if (v > INT_MAX) v = INT_MAX;
+    if (v < INT_MIN) v = INT_MIN;
+    *value = (int)v;
+    return p;
+}
+
+/**
+ * Bỏ qua một value bất kỳ (kể cả object/array lồng nhau)
+ * @return Vị trí sau value, hoặc NULL nếu lỗi
+ */
+static const char *skip_value(const char *p, const char *end) {
+    if (p >= end) return NULL;
+
+    if (*p == '"') return parse_string(p + 1, end, NULL);
+
+    if (*p != '{' && *p != '[') {
+        int ignored;
+        return parse_scalar(p, end, &ignored);
+    }
+
+    // Object/array: đếm độ sâu, string được quét riêng để bỏ qua ngoặc bên trong
+    int depth = 0;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            p = parse_string(p + 1, end, NULL);
+            if (!p) return NULL;
+            continue;
+        }
+        if (c == '{' || c == '[') depth++;
+        else if (c == '}' || c == ']') {
+            if (--depth == 0) return p + 1;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+int parse_request_body(const char *json, size_t len, RequestBody *out) {
+    memset(out, 0, sizeof(*out));
+
+    const char *p = json;
+    const char *end = json + len;
+
+    p = skip_ws(p, end);
+    if (p == end) return 0;
+    if (*p++ != '{') return -1;
+
+    p = skip_ws(p, end);
+    if (p < end && *p == '}') {
+        p++;
+    } else {
+        while (1) {
+            // Key
+            if (p >= end || *p != '"') return -1;
+            const char *key = p + 1;
+            const char *key_end = find_quote_or_backslash(key, end);
+            int field = -1;
+            if (key_end < end && *key_end == '"') {
+                field = lookup_field(key, key_end - key);
+                p = key_end + 1;
+            } else {
+                // Key có escape: decode rồi tra bảng
+                char decoded[32];
+                StringOut kout = { decoded, sizeof(decoded), 0, 0 };
+                p = parse_string(key, end, &kout);
+                if (!p) return -1;
+                field = kout.truncated ? -1 : lookup_field(decoded, kout.len);
+            }
+
+            p = skip_ws(p, end);
+            if (p >= end || *p++ != ':') return -1;
+            p = skip_ws(p, end);
+            if (p >= end) return -1;
+
+            // Value
+            const FieldSpec *spec = field >= 0 ? &field_specs[field] : NULL;
+            if (spec && spec->type == FIELD_STRING && *p == '"') {
+                StringOut sout = { (char *)out + spec->offset, spec->size, 0, 0 };
+                p = parse_string(p + 1, end, &sout);
+                if (!p) return -1;
+                out_finish(&sout);
+                out->present |= 1u << field;
+            } else if (spec && spec->type == FIELD_INT && *p != '"' && *p != '{' && *p != '[') {
+                int value;
+                p = parse_scalar(p, end, &value);
+                if (!p) return -1;
+                memcpy((char *)out + spec->offset, &value, sizeof(int));
+                out->present |= 1u << field;
+            } else {
+                // Key lạ hoặc sai kiểu: bỏ qua
+                p = skip_value(p, end);
+                if (!p) return -1;
+            }
+
+            p = skip_ws(p, end);
+            if (p >= end) return -1;
+            if (*p == ',') {
+                p = skip_ws(p + 1, end);
+                continue;
+            }
+            if (*p == '}') {
+                p++;
+                break;
+            }
+            return -1;
+        }
+    }
+
+    p = skip_ws(p, end);
+    return p == end ? 0 : -1;
+}
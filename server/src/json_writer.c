@@ -0,0 +1,293 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - JSON WRITER
+ * ============================================================================
+ * File: json_writer.c
+ * Description: Streaming JSON writer + pool buffer
+ *
+ * Pool giữ tối đa JW_POOL_SIZE buffer đã dùng; buffer lớn hơn
+ * JW_POOL_MAX_CAP (message arena khổng lồ) được free thay vì giữ lại.
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../include/config.h"
+#include "../include/json_writer.h"
+
+/* ============================================================================
+ *                           BUFFER POOL
+ * ============================================================================ */
+
+typedef struct {
+    char *buf;
+    size_t cap;
+} PooledBuffer;
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static PooledBuffer pool[JW_POOL_SIZE];
+static int pool_count = 0;
+
+static void pool_acquire(JsonWriter *w) {
+    pthread_mutex_lock(&pool_mutex);
+    if (pool_count > 0) {
+        pool_count--;
+        w->buf = pool[pool_count].buf;
+        w->cap = pool[pool_count].cap;
+        pthread_mutex_unlock(&pool_mutex);
+        return;
+    }
+    pthread_mutex_unlock(&pool_mutex);
+
+    w->buf = malloc(JW_INITIAL_CAP);
+    w->cap = w->buf ? JW_INITIAL_CAP : 0;
+}
+
+static void pool_release(char *buf, size_t cap) {
+    if (!buf) return;
+    if (cap <= JW_POOL_MAX_CAP) {
+        pthread_mutex_lock(&pool_mutex);
+        if (pool_count < JW_POOL_SIZE) {
+            pool[pool_count].buf = buf;
+            pool[pool_count].cap = cap;
+            pool_count++;
+            pthread_mutex_unlock(&pool_mutex);
+            return;
+        }
+        pthread_mutex_unlock(&pool_mutex);
+    }
+    free(buf);
+}
+
+/* ============================================================================
+ *                           LOW-LEVEL APPEND
+ * ============================================================================ */
+
+/**
+ * Đảm bảo còn chỗ cho extra byte + '\0', nhân đôi dung lượng khi thiếu
+ */
+static int reserve(JsonWriter *w, size_t extra) {
+    if (w->failed) return 0;
+    if (w->len + extra + 1 <= w->cap) return 1;
+
+    size_t new_cap = w->cap ? w->cap : JW_INITIAL_CAP;
+    while (new_cap < w->len + extra + 1) new_cap *= 2;
+
+    char *grown = realloc(w->buf, new_cap);
+    if (!grown) {
+        w->failed = 1;
+        return 0;
+    }
+    w->buf = grown;
+    w->cap = new_cap;
+    return 1;
+}
+
+static void append(JsonWriter *w, const char *data, size_t n) {
+    if (!reserve(w, n)) return;
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+    w->buf[w->len] = '\0';
+}
+
+static void append_char(JsonWriter *w, char c) {
+    if (!reserve(w, 1)) return;
+    w->buf[w->len++] = c;
+    w->buf[w->len] = '\0';
+}
+
+/**
+ * Chèn dấu phẩy nếu đây không phải phần tử đầu tiên của tầng hiện tại
+ */
+static void before_value(JsonWriter *w) {
+    if (w->after_key) {
+        w->after_key = 0;
+        return;
+    }
+    if (w->has_items[w->depth]) append_char(w, ',');
+    w->has_items[w->depth] = 1;
+}
+
+/* ============================================================================
+ *                           LIFECYCLE
+ * ============================================================================ */
+
+void jw_init(JsonWriter *w) {
+    memset(w, 0, sizeof(*w));
+    pool_acquire(w);
+    if (!w->buf) {
+        w->failed = 1;
+        return;
+    }
+    w->buf[0] = '\0';
+}
+
+void jw_free(JsonWriter *w) {
+    pool_release(w->buf, w->cap);
+    w->buf = NULL;
+    w->cap = 0;
+    w->len = 0;
+}
+
+void jw_reset(JsonWriter *w) {
+    w->len = 0;
+    w->depth = 0;
+    w->after_key = 0;
+    w->has_items[0] = 0;
+    w->failed = 0;
+
+    // jw_init không lấy được buffer: thử lại, realloc hỏng thì buffer cũ vẫn dùng được
+    if (!w->buf) pool_acquire(w);
+    if (!w->buf) {
+        w->failed = 1;
+        return;
+    }
+    w->buf[0] = '\0';
+}
+
+/* ============================================================================
+ *                           STRUCTURE
+ * ============================================================================ */
+
+static void open_container(JsonWriter *w, char c) {
+    before_value(w);
+    append_char(w, c);
+    if (w->depth < JW_MAX_DEPTH - 1) w->depth++;
+    w->has_items[w->depth] = 0;
+}
+
+static void close_container(JsonWriter *w, char c) {
+    append_char(w, c);
+    if (w->depth > 0) w->depth--;
+}
+
+void jw_object_begin(JsonWriter *w) { open_container(w, '{'); }
+void jw_object_end(JsonWriter *w)   { close_container(w, '}'); }
+void jw_array_begin(JsonWriter *w)  { open_container(w, '['); }
+void jw_array_end(JsonWriter *w)    { close_container(w, ']'); }
+
+void jw_key(JsonWriter *w, const char *key) {
+    jw_key_n(w, key, strlen(key));
+}
+
+void jw_key_n(JsonWriter *w, const char *key, size_t n) {
+    // Một lần reserve cho cả dấu phẩy, key và ":"
+    if (!reserve(w, n + 4)) return;
+    if (w->has_items[w->depth]) w->buf[w->len++] = ',';
+    w->has_items[w->depth] = 1;
+    w->buf[w->len++] = '"';
+    memcpy(w->buf + w->len, key, n);
+    w->len += n;
+    w->buf[w->len++] = '"';
+    w->buf[w->len++] = ':';
+    w->buf[w->len] = '\0';
+    w->after_key = 1;
+}
+
+/* ============================================================================
+ *                           VALUES
+ * ============================================================================ */
+
+void jw_string(JsonWriter *w, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    before_value(w);
+    if (!s) s = "";
+
+    append_char(w, '"');
+    const char *run = s;
+    for (const char *p = s; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        // Ghi đoạn không cần escape một lần
+        append(w, run, p - run);
+        run = p + 1;
+
+        switch (c) {
+            case '"':  append(w, "\\\"", 2); break;
+            case '\\': append(w, "\\\\", 2); break;
+            case '\n': append(w, "\\n", 2); break;
+            case '\r': append(w, "\\r", 2); break;
+            case '\t': append(w, "\\t", 2); break;
+            case '\b': append(w, "\\b", 2); break;
+            case '\f': append(w, "\\f", 2); break;
+            default: {
+                char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                append(w, esc, 6);
+            }
+        }
+    }
+    append(w, run, strlen(run));
+    append_char(w, '"');
+}
+
+void jw_int(JsonWriter *w, long long v) {
+    static const char digits2[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    before_value(w);
+
+    char tmp[24];
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+
+    // Hai chữ số mỗi vòng
+    while (u >= 100) {
+        unsigned idx = (unsigned)(u % 100) * 2;
+        u /= 100;
+        *--p = digits2[idx + 1];
+        *--p = digits2[idx];
+    }
+    if (u >= 10) {
+        unsigned idx = (unsigned)u * 2;
+        *--p = digits2[idx + 1];
+        *--p = digits2[idx];
+    } else {
+        *--p = (char)('0' + u);
+    }
+    if (v < 0) *--p = '-';
+
+    size_t n = end - p;
+    if (!reserve(w, n)) return;
+    memcpy(w->buf + w->len, p, n);
+    w->len += n;
+    w->buf[w->len] = '\0';
+}
+
+void jw_bool(JsonWriter *w, int v) {
+    before_value(w);
+    if (v) append(w, "true", 4);
+    else   append(w, "false", 5);
+}
+
+void jw_null(JsonWriter *w) {
+    before_value(w);
+    append(w, "null", 4);
+}
+
+void jw_raw(JsonWriter *w, const char *json, size_t len) {
+    before_value(w);
+    append(w, json, len);
+}
+
+/* ============================================================================
+ *                           KEY-VALUE SHORTCUTS
+ * ============================================================================ */
+
+void jw_kv_str(JsonWriter *w, const char *key, const char *s) {
+    jw_key(w, key);
+    jw_string(w, s);
+}
+
+void jw_kv_int(JsonWriter *w, const char *key, long long v) {
+    jw_key(w, key);
+    jw_int(w, v);
+}
+
+void jw_kv_bool(JsonWriter *w, const char *key, int v) {
+    jw_key(w, key);
+    jw_bool(w, v);
+}
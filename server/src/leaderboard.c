@@ -0,0 +1,480 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - GLOBAL LEADERBOARD
+ * ============================================================================
+ * File: leaderboard.c
+ * Description: Append-only log + writer thread + index theo window
+ *
+ * Luồng ghi:
+ *   game path --(copy, không I/O)--> pending buffer --(writer thread)-->
+ *   fwrite vào log --> cập nhật index trong bộ nhớ
+ * Writer đổi (swap) hai buffer nên game path chỉ giữ queue_mutex trong
+ * lúc memcpy; hàng đợi đầy thì bỏ record thay vì chờ. Ghi log lỗi thì batch
+ * bị cắt khỏi file và chỉ còn trong index (đếm trong unwritten).
+ *
+ * Index: mỗi window là skip list key [~score][~streak][response][time][name],
+ * value là index vào bảng tên. Mỗi tên chỉ giữ kết quả tốt nhất trong window.
+ * Daily/weekly được xóa khi sang ngày/tuần mới (UTC).
+ *
+ * Lock order: rooms_mutex -> queue_mutex. index_mutex không lồng với lock nào.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/game.h"
+#include "../include/skiplist.h"
+#include "../include/json_writer.h"
+#include "../include/leaderboard.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+#define LB_KEY_LEN          (4 + 4 + 4 + 8 + PLAYER_NAME_LEN)
+#define LB_REPLAY_CHUNK     4096            // Số record đọc mỗi lần khi replay
+
+/**
+ * LbBest - Kết quả tốt nhất của một tên trong một window
+ */
+typedef struct {
+    int valid;
+    int32_t score;
+    int32_t streak;
+    int32_t total_response_ms;
+    int64_t finished_at;
+} LbBest;
+
+/**
+ * LbName - Một tên trên bảng xếp hạng
+ */
+typedef struct {
+    char name[PLAYER_NAME_LEN];
+    LbBest best[LB_WINDOW_COUNT];
+} LbName;
+
+static const char *window_names[LB_WINDOW_COUNT] = { "all", "daily", "weekly" };
+
+/* ============================================================================
+ *                           STATE
+ * ============================================================================ */
+
+// Hàng đợi ghi (bảo vệ bởi queue_mutex)
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond = PTHREAD_COND_INITIALIZER;
+static LeaderboardRecord queue_buffers[2][LEADERBOARD_QUEUE_SIZE];
+static LeaderboardRecord *pending = queue_buffers[0];
+static int pending_count = 0;
+static unsigned long long dropped_total = 0;
+static unsigned long long unwritten_total = 0;  // Record chỉ còn trong bộ nhớ (ghi log lỗi)
+
+// Index trong bộ nhớ (bảo vệ bởi index_mutex)
+static pthread_mutex_t index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SkipList windows[LB_WINDOW_COUNT];
+static int64_t window_start[LB_WINDOW_COUNT];
+static LbName *names = NULL;
+static int name_count = 0;
+static int name_capacity = 0;
+static int *name_slots = NULL;              // Hash table: index + 1 (0 = trống)
+static int slot_capacity = 0;               // Lũy thừa của 2
+
+/* ============================================================================
+ *                           NAME TABLE
+ * ============================================================================ */
+
+static uint32_t hash_name(const char *name) {
+    uint32_t h = 2166136261u;               // FNV-1a
+    for (; *name; name++) {
+        h = (h ^ (unsigned char)*name) * 16777619u;
+    }
+    return h;
+}
+
+static void rehash_names(int new_capacity) {
+    free(name_slots);
+    name_slots = calloc(new_capacity, sizeof(int));
+    slot_capacity = new_capacity;
+
+    for (int i = 0; i < name_count; i++) {
+        uint32_t s = hash_name(names[i].name) & (slot_capacity - 1);
+        while (name_slots[s]) s = (s + 1) & (slot_capacity - 1);
+        name_slots[s] = i + 1;
+    }
+}
+
+static int find_name(const char *name) {
+    if (slot_capacity == 0) return -1;
+    uint32_t s = hash_name(name) & (slot_capacity - 1);
+    while (name_slots[s]) {
+        if (strcmp(names[name_slots[s] - 1].name, name) == 0) return name_slots[s] - 1;
+        s = (s + 1) & (slot_capacity - 1);
+    }
+    return -1;
+}
+
+static int find_or_add_name(const char *name) {
+    int idx = find_name(name);
+    if (idx >= 0) return idx;
+
+    if (name_count == name_capacity) {
+        int new_capacity = name_capacity ? name_capacity * 2 : 1024;
+        LbName *grown = realloc(names, new_capacity * sizeof(LbName));
+        if (!grown) return -1;
+        names = grown;
+        name_capacity = new_capacity;
+    }
+
+    idx = name_count++;
+    memset(&names[idx], 0, sizeof(LbName));
+    memcpy(names[idx].name, name, strnlen(name, PLAYER_NAME_LEN - 1));   // '\0' từ memset
+
+    // Giữ load factor <= 1/2
+    if (name_count * 2 > slot_capacity) {
+        rehash_names(slot_capacity ? slot_capacity * 2 : 2048);
+    } else {
+        uint32_t s = hash_name(name) & (slot_capacity - 1);
+        while (name_slots[s]) s = (s + 1) & (slot_capacity - 1);
+        name_slots[s] = idx + 1;
+    }
+    return idx;
+}
+
+/* ============================================================================
+ *                           WINDOWS & KEYS
+ * ============================================================================ */
+
+static int64_t compute_window_start(LeaderboardWindow w, int64_t now) {
+    int64_t day = now / 86400;
+    switch (w) {
+        case LB_WINDOW_DAILY:  return day * 86400;
+        case LB_WINDOW_WEEKLY: return (day - (day + 3) % 7) * 86400;  // 1/1/1970 là thứ Năm
+        default:               return 0;
+    }
+}
+
+/**
+ * Sang ngày/tuần mới thì xóa window tương ứng. Caller giữ index_mutex.
+ */
+static void roll_windows(int64_t now) {
+    for (int w = LB_WINDOW_DAILY; w < LB_WINDOW_COUNT; w++) {
+        int64_t start = compute_window_start((LeaderboardWindow)w, now);
+        if (start == window_start[w]) continue;
+
+        skiplist_free(&windows[w]);
+        skiplist_init(&windows[w], LB_KEY_LEN);
+        for (int i = 0; i < name_count; i++) {
+            names[i].best[w].valid = 0;
+        }
+        window_start[w] = start;
+    }
+}
+
+static void put_be(unsigned char *p, uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        p[i] = (unsigned char)v;
+        v >>= 8;
+    }
+}
+
+/**
+ * Key tăng dần = hạng tốt -> kém: điểm cao, streak cao, nhanh hơn, đạt sớm hơn
+ */
+static void build_lb_key(const LbBest *best, const char *name, unsigned char *key) {
+    put_be(key,      UINT32_MAX - (uint32_t)best->score, 4);
+    put_be(key + 4,  UINT32_MAX - (uint32_t)best->streak, 4);
+    put_be(key + 8,  (uint32_t)best->total_response_ms, 4);
+    put_be(key + 12, (uint64_t)best->finished_at, 8);
+    memset(key + 20, 0, PLAYER_NAME_LEN);
+    strncpy((char *)key + 20, name, PLAYER_NAME_LEN);
+}
+
+/**
+ * Áp dụng một record vào các window chứa nó. Caller giữ index_mutex.
+ */
+static void apply_record(const LeaderboardRecord *rec) {
+    int idx = find_or_add_name(rec->name);
+    if (idx < 0) return;
+    LbName *entry = &names[idx];
+
+    LbBest candidate = { 1, rec->score, rec->streak, rec->total_response_ms, rec->finished_at };
+    unsigned char new_key[LB_KEY_LEN], old_key[LB_KEY_LEN];
+    build_lb_key(&candidate, entry->name, new_key);
+
+    for (int w = 0; w < LB_WINDOW_COUNT; w++) {
+        if (rec->finished_at < window_start[w]) continue;
+
+        LbBest *best = &entry->best[w];
+        if (best->valid) {
+            build_lb_key(best, entry->name, old_key);
+            if (memcmp(new_key, old_key, LB_KEY_LEN) >= 0) continue;
+            skiplist_remove(&windows[w], old_key);
+        }
+        skiplist_insert(&windows[w], new_key, idx);
+        *best = candidate;
+    }
+}
+
+/* ============================================================================
+ *                           LOG REPLAY
+ * ============================================================================ */
+
+static void replay_log(void) {
+    FILE *file = fopen(LEADERBOARD_FILE, "rb");
+    if (!file) {
+        LOG_INFO("LEADER", "📄 No leaderboard log yet (%s)", LEADERBOARD_FILE);
+        return;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    LeaderboardRecord *chunk = malloc(LB_REPLAY_CHUNK * sizeof(LeaderboardRecord));
+    long valid_records = 0;
+    int corrupt = 0;
+    size_t n;
+
+    while (chunk && !corrupt && (n = fread(chunk, sizeof(LeaderboardRecord), LB_REPLAY_CHUNK, file)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (chunk[i].magic != LEADERBOARD_MAGIC) {
+                corrupt = 1;
+                break;
+            }
+            chunk[i].name[PLAYER_NAME_LEN - 1] = '\0';
+            apply_record(&chunk[i]);
+            valid_records++;
+        }
+    }
+    free(chunk);
+
+    // Cắt phần đuôi hỏng / record ghi dở để append tiếp theo thẳng hàng
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    long valid_size = valid_records * (long)sizeof(LeaderboardRecord);
+    fclose(file);
+
+    if (file_size != valid_size) {
+        if (truncate(LEADERBOARD_FILE, valid_size) == 0) {
+            LOG_WARN("LEADER", "⚠️  Truncated %ld trailing bytes from %s", file_size - valid_size, LEADERBOARD_FILE);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    LOG_INFO("LEADER", "🏅 Replayed %ld records (%d names) in %.1f ms", valid_records, name_count,
+             (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+}
+
+/* ============================================================================
+ *                           WRITER THREAD
+ * ============================================================================ */
+
+/**
+ * Mở log để append, trả về kích thước hiện tại qua size
+ */
+static FILE *open_log(long *size) {
+    FILE *file = fopen(LEADERBOARD_FILE, "ab");
+    if (file && fseek(file, 0, SEEK_END) == 0) {
+        *size = ftell(file);
+    }
+    return file;
+}
+
+static void count_unwritten(int count) {
+    pthread_mutex_lock(&queue_mutex);
+    unwritten_total += count;
+    pthread_mutex_unlock(&queue_mutex);
+}
+
+static void *leaderboard_writer(void *arg) {
+    (void)arg;
+    LeaderboardRecord *batch = queue_buffers[1];
+
+    long log_size = 0;
+    FILE *log_file = open_log(&log_size);
+    if (!log_file) {
+        LOG_WARN("LEADER", "⚠️  Cannot open %s for append, results kept in memory only", LEADERBOARD_FILE);
+    }
+
+    while (1) {
+        pthread_mutex_lock(&queue_mutex);
+        while (pending_count == 0) {
+            pthread_cond_wait(&queue_cond, &queue_mutex);
+        }
+
+        // Đổi buffer: game path ghi tiếp vào buffer trống ngay lập tức
+        LeaderboardRecord *full = pending;
+        int count = pending_count;
+        pending = batch;
+        pending_count = 0;
+        batch = full;
+        pthread_mutex_unlock(&queue_mutex);
+
+        if (log_file) {
+            size_t written = fwrite(batch, sizeof(LeaderboardRecord), count, log_file);
+            if (written != (size_t)count || fflush(log_file) != 0) {
+                int err = errno;
+                // Bỏ cả batch khỏi file: cắt về kích thước cũ để record sau vẫn thẳng hàng
+                fclose(log_file);
+                if (truncate(LEADERBOARD_FILE, log_size) != 0) {
+                    LOG_ERROR("LEADER", "❌ Cannot truncate %s to %ld bytes: %s", LEADERBOARD_FILE, log_size,
+                              strerror(errno));
+                }
+                log_file = open_log(&log_size);
+                LOG_ERROR("LEADER", "❌ Failed to write %d results to %s: %s", count, LEADERBOARD_FILE,
+                          strerror(err));
+                count_unwritten(count);
+            } else {
+                log_size += count * (long)sizeof(LeaderboardRecord);
+            }
+        } else {
+            count_unwritten(count);
+        }
+
+        pthread_mutex_lock(&index_mutex);
+        roll_windows(time(NULL));
+        for (int i = 0; i < count; i++) {
+            apply_record(&batch[i]);
+        }
+        pthread_mutex_unlock(&index_mutex);
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+void init_leaderboard(void) {
+    pthread_mutex_lock(&index_mutex);
+    int64_t now = time(NULL);
+    for (int w = 0; w < LB_WINDOW_COUNT; w++) {
+        skiplist_init(&windows[w], LB_KEY_LEN);
+        window_start[w] = compute_window_start((LeaderboardWindow)w, now);
+    }
+    replay_log();
+    pthread_mutex_unlock(&index_mutex);
+
+    pthread_t thread_id;
+    pthread_create(&thread_id, NULL, leaderboard_writer, NULL);
+    pthread_detach(thread_id);
+}
+
+void leaderboard_submit_room(GameRoom *room) {
+    int64_t now = time(NULL);
+
+    pthread_mutex_lock(&queue_mutex);
+
+    int space = LEADERBOARD_QUEUE_SIZE - pending_count;
+    int count = room->player_count < space ? room->player_count : space;
+
+    for (int i = 0; i < count; i++) {
+        RoomPlayer *p = &room->players[i];
+        LeaderboardRecord *rec = &pending[pending_count++];
+
+        memset(rec, 0, sizeof(*rec));
+        rec->magic = LEADERBOARD_MAGIC;
+        rec->score = p->score;
+        rec->streak = p->streak;
+        rec->total_response_ms = p->total_response_ms;
+        rec->finished_at = now;
+        rec->room_id = room->id;
+        rec->rounds = room->max_rounds;
+        memcpy(rec->name, p->name, strnlen(p->name, PLAYER_NAME_LEN - 1));   // '\0' từ memset
+    }
+    dropped_total += room->player_count - count;
+
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+
+    if (count < room->player_count) {
+        LOG_WARN("LEADER", "⚠️  Queue full, dropped %d results from room %d", room->player_count - count, room->id);
+    }
+}
+
+void leaderboard_stats(LeaderboardStats *out) {
+    pthread_mutex_lock(&queue_mutex);
+    out->pending = pending_count;
+    out->dropped = dropped_total;
+    out->unwritten = unwritten_total;
+    pthread_mutex_unlock(&queue_mutex);
+}
+
+/**
+ * GET /leaderboard - Top N + rank theo tên
+ */
+void handle_get_leaderboard(int sock, const char *query) {
+    char value[PLAYER_NAME_LEN];
+
+    LeaderboardWindow w = LB_WINDOW_ALL;
+    if (get_query_param(query, "window", value, sizeof(value))) {
+        if (strcmp(value, "daily") == 0)       w = LB_WINDOW_DAILY;
+        else if (strcmp(value, "weekly") == 0) w = LB_WINDOW_WEEKLY;
+        else if (strcmp(value, "all") != 0) {
+            send_json_response(sock, "{\"error\":\"Invalid window (all, daily, weekly)\"}");
+            return;
+        }
+    }
+
+    int limit = LEADERBOARD_DEFAULT_LIMIT;
+    if (get_query_param(query, "limit", value, sizeof(value))) limit = atoi(value);
+    if (limit < 1) limit = 1;
+    if (limit > LEADERBOARD_MAX_LIMIT) limit = LEADERBOARD_MAX_LIMIT;
+
+    char name[PLAYER_NAME_LEN] = "";
+    get_query_param(query, "name", name, sizeof(name));
+
+    JsonWriter response;
+    jw_init(&response);
+
+    pthread_mutex_lock(&index_mutex);
+    roll_windows(time(NULL));
+
+    SkipList *sl = &windows[w];
+    jw_object_begin(&response);
+    jw_kv_str(&response, "action", "leaderboard");
+    jw_kv_str(&response, "window", window_names[w]);
+    jw_kv_int(&response, "total", (long long)sl->length);
+    jw_key(&response, "entries");
+    jw_array_begin(&response);
+
+    int rank = 1;
+    for (SkipNode *node = skiplist_first(sl); node && rank <= limit; node = skiplist_next(node), rank++) {
+        LbName *entry = &names[node->value];
+        LbBest *best = &entry->best[w];
+        jw_object_begin(&response);
+        jw_kv_int(&response, "rank", rank);
+        jw_kv_str(&response, "name", entry->name);
+        jw_kv_int(&response, "score", best->score);
+        jw_kv_int(&response, "streak", best->streak);
+        jw_kv_int(&response, "total_response_time", best->total_response_ms);
+        jw_kv_int(&response, "finished_at", best->finished_at);
+        jw_object_end(&response);
+    }
+    jw_array_end(&response);
+
+    // Rank riêng của một tên, O(log n)
+    jw_key(&response, "me");
+    int idx = name[0] ? find_name(name) : -1;
+    if (idx >= 0 && names[idx].best[w].valid) {
+        unsigned char key[LB_KEY_LEN];
+        size_t ahead;
+        build_lb_key(&names[idx].best[w], names[idx].name, key);
+        skiplist_lower_bound(sl, key, &ahead);
+        jw_object_begin(&response);
+        jw_kv_str(&response, "name", names[idx].name);
+        jw_kv_int(&response, "rank", (long long)ahead + 1);
+        jw_kv_int(&response, "score", names[idx].best[w].score);
+        jw_object_end(&response);
+    } else {
+        jw_null(&response);
+    }
+    jw_object_end(&response);
+    pthread_mutex_unlock(&index_mutex);
+
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
+}
@@ -0,0 +1,187 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - LOBBY STREAM
+ * ============================================================================
+ * File: lobby.c
+ * Description: Đẩy thay đổi danh sách phòng đến các client đang ở lobby
+ * 
+ * Chức năng:
+ *   1. Theo dõi room slots bị thay đổi (dirty set)
+ *   2. Gộp (coalesce) thay đổi trong mỗi chu kỳ flush
+ *   3. Broadcast event "lobby_update" đến SSE clients chưa vào phòng nào
+ * 
+ * Mỗi slot nhớ room ID đã publish lần cuối, nên khi flush chỉ cần so sánh
+ * với trạng thái hiện tại để sinh đúng room_added / room_updated /
+ * room_removed, bất kể trong chu kỳ đó slot đã đổi bao nhiêu lần.
+ * 
+ * room_updated chỉ mang id + các field đã đổi so với summary đã publish
+ * (wire_json_delta trên schema ROOM_SUMMARY); client merge vào bản cũ.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/game.h"
+#include "../include/room_helpers.h"
+#include "../include/lobby.h"
+
+/* ============================================================================
+ *                           STATE (bảo vệ bởi rooms_mutex)
+ * ============================================================================ */
+
+static int published_room_id[MAX_ROOMS];   // Room ID client đang thấy (0 = không có)
+static int is_dirty[MAX_ROOMS];            // Slot đã nằm trong dirty_list chưa
+static int dirty_list[MAX_ROOMS];          // Các slot cần flush
+static int dirty_count = 0;
+
+// Summary client đang thấy, để tính delta cho room_updated
+static WireRoomSummary published_summary[MAX_ROOMS];
+static char published_name[MAX_ROOMS][ROOM_NAME_LEN];
+
+static pthread_cond_t lobby_cond = PTHREAD_COND_INITIALIZER;
+
+/* ============================================================================
+ *                           EVENT BUILDING
+ * ============================================================================ */
+
+/**
+ * Ghi event cho một slot, so sánh trạng thái hiện tại với lần publish trước
+ * 
+ * @return Số event đã ghi (0 nếu không có gì thay đổi với client)
+ */
+static int build_slot_events(JsonWriter *w, int room_idx) {
+    GameRoom *room = &rooms[room_idx];
+    int old_id = published_room_id[room_idx];
+    int listed = room_is_listed(room);
+    int new_id = listed ? room->id : 0;
+    int events = 0;
+    
+    // Slot bị tái sử dụng cho phòng khác, hoặc phòng đã biến mất khỏi lobby
+    if (old_id != 0 && old_id != new_id) {
+        jw_object_begin(w);
+        jw_kv_str(w, "type", "room_removed");
+        jw_kv_int(w, "room_id", old_id);
+        jw_object_end(w);
+        events++;
+    }
+    
+    if (new_id == 0) return events;
+    
+    WireRoomSummary current;
+    fill_room_summary(&current, room);
+    
+    if (old_id == new_id) {
+        // Slot dirty nhưng field hiển thị ở lobby không đổi => không gửi gì
+        if (wire_delta_count(WIRE_SCHEMA(ROOM_SUMMARY), &published_summary[room_idx], &current) > 0) {
+            jw_object_begin(w);
+            jw_kv_str(w, "type", "room_updated");
+            jw_key(w, "room");
+            wire_json_delta(w, WIRE_SCHEMA(ROOM_SUMMARY), &published_summary[room_idx], &current);
+            jw_object_end(w);
+            events++;
+        }
+    } else {
+        jw_object_begin(w);
+        jw_kv_str(w, "type", "room_added");
+        jw_key(w, "room");
+        wire_json_object(w, WIRE_SCHEMA(ROOM_SUMMARY), &current);
+        jw_object_end(w);
+        events++;
+    }
+    
+    // Ghi nhớ bản đã publish (copy name vì slot có thể bị tái sử dụng)
+    strncpy(published_name[room_idx], room->name, ROOM_NAME_LEN - 1);
+    published_name[room_idx][ROOM_NAME_LEN - 1] = '\0';
+    current.name = published_name[room_idx];
+    published_summary[room_idx] = current;
+    
+    return events;
+}
+
+/* ============================================================================
+ *                           FLUSHER THREAD
+ * ============================================================================ */
+
+/**
+ * Flusher thread
+ * 
+ * Chờ đến khi có slot dirty, build một message chứa tất cả events rồi
+ * broadcast ngoài rooms_mutex. Sau mỗi lần flush ngủ LOBBY_FLUSH_INTERVAL_MS
+ * để các thay đổi tiếp theo được gộp lại => tần suất broadcast bị chặn trên.
+ */
+static void *lobby_flusher(void *arg) {
+    (void)arg;
+    
+    // Một writer dùng suốt vòng đời thread; buffer lớn dần theo batch lớn nhất
+    JsonWriter message;
+    jw_init(&message);
+    
+    MUTEX_LOCK(&rooms_mutex);
+    
+    while (1) {
+        while (dirty_count == 0) {
+            MUTEX_COND_WAIT(&lobby_cond, &rooms_mutex);
+        }
+        
+        jw_reset(&message);
+        jw_object_begin(&message);
+        jw_kv_str(&message, "action", "lobby_update");
+        jw_key(&message, "events");
+        jw_array_begin(&message);
+        
+        int event_count = 0;
+        for (int i = 0; i < dirty_count; i++) {
+            int room_idx = dirty_list[i];
+            event_count += build_slot_events(&message, room_idx);
+            published_room_id[room_idx] = room_is_listed(&rooms[room_idx]) ? rooms[room_idx].id : 0;
+            is_dirty[room_idx] = 0;
+        }
+        dirty_count = 0;
+        
+        jw_array_end(&message);
+        jw_object_end(&message);
+        
+        MUTEX_UNLOCK(&rooms_mutex);
+        
+        if (event_count > 0) {
+            broadcast_sse_to_lobby(jw_str(&message));
+        }
+        
+        usleep(LOBBY_FLUSH_INTERVAL_MS * 1000);
+        
+        MUTEX_LOCK(&rooms_mutex);
+    }
+    
+    jw_free(&message);
+    return NULL;
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+void init_lobby_stream(void) {
+    MUTEX_LOCK(&rooms_mutex);
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        published_room_id[i] = 0;
+        is_dirty[i] = 0;
+    }
+    dirty_count = 0;
+    MUTEX_UNLOCK(&rooms_mutex);
+    
+    pthread_t thread_id;
+    pthread_create(&thread_id, NULL, lobby_flusher, NULL);
+    pthread_detach(thread_id);
+    
+    LOG_INFO("LOBBY", "📺 Lobby stream started (flush every %dms)", LOBBY_FLUSH_INTERVAL_MS);
+}
+
+void lobby_mark_dirty(int room_idx) {
+    if (room_idx < 0 || room_idx >= MAX_ROOMS || is_dirty[room_idx]) return;
+    
+    is_dirty[room_idx] = 1;
+    dirty_list[dirty_count++] = room_idx;
+    pthread_cond_signal(&lobby_cond);
+}
@@ -0,0 +1,239 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - LOGGER
+ * ============================================================================
+ * File: logger.c
+ * Description: Ring buffer MPSC lock-free + drainer thread
+ * ============================================================================
+ */
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/config.h"
+#include "../include/logger.h"
+
+#define RING_MASK (LOG_RING_SIZE - 1)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * LogSlot - Một dòng log đã format
+ *
+ * seq == vị trí + 1: producer đã ghi xong, drainer đọc được;
+ * seq == vị trí: slot trống cho producer của vòng này.
+ */
+typedef struct {
+    unsigned long long seq;
+    unsigned long long ts_ns;           // CLOCK_REALTIME
+    unsigned short len;
+    unsigned char level;
+    char tag[LOG_TAG_LEN];
+    char msg[LOG_MSG_LEN];
+} __attribute__((aligned(64))) LogSlot;
+
+typedef struct {
+    unsigned long long head __attribute__((aligned(64)));   // Producer (CAS)
+    unsigned long long tail __attribute__((aligned(64)));   // Chỉ drainer
+    LogSlot *slots;
+} LogRing;
+
+/* ============================================================================
+ *                           GLOBALS
+ * ============================================================================ */
+
+int log_level = LOG_LEVEL_INFO;
+
+static LogRing rings[LOG_RINGS];
+static int log_started = 0;             // Ghi 1 lần trong log_init, trước khi có thread khác
+static FILE *log_out = NULL;
+static pthread_mutex_t drain_mutex = PTHREAD_MUTEX_INITIALIZER;   // Chỉ phía consumer
+static unsigned int next_ring = 0;
+static __thread int thread_ring = -1;
+
+static unsigned long long written_total = 0;
+static unsigned long long dropped_total = 0;
+
+static const char *level_names[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+/* ============================================================================
+ *                           OUTPUT
+ * ============================================================================ */
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+static void emit(FILE *out, unsigned long long ts_ns, int level, const char *tag,
+                 const char *msg, int len) {
+    time_t sec = (time_t)(ts_ns / 1000000000ULL);
+    struct tm tm;
+    localtime_r(&sec, &tm);
+    fprintf(out, "%02d:%02d:%02d.%03d %s [%s] %.*s\n", tm.tm_hour, tm.tm_min, tm.tm_sec,
+            (int)(ts_ns / 1000000ULL % 1000), level_names[level], tag, len, msg);
+}
+
+/**
+ * Ghi mọi dòng đang chờ, trộn theo timestamp giữa các ring
+ * (gọi khi giữ drain_mutex)
+ * @return Số dòng đã ghi
+ */
+static int drain_rings(void) {
+    int count = 0;
+    while (1) {
+        LogRing *best = NULL;
+        LogSlot *best_slot = NULL;
+        for (int r = 0; r < LOG_RINGS; r++) {
+            LogSlot *slot = &rings[r].slots[rings[r].tail & RING_MASK];
+            if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != rings[r].tail + 1) continue;
+            if (!best || slot->ts_ns < best_slot->ts_ns) {
+                best = &rings[r];
+                best_slot = slot;
+            }
+        }
+        if (!best) break;
+
+        emit(log_out, best_slot->ts_ns, best_slot->level, best_slot->tag, best_slot->msg, best_slot->len);
+        // Trả slot cho producer của vòng sau
+        __atomic_store_n(&best_slot->seq, best->tail + LOG_RING_SIZE, __ATOMIC_RELEASE);
+        best->tail++;
+        count++;
+    }
+    if (count > 0) {
+        fflush(log_out);
+        __atomic_fetch_add(&written_total, (unsigned long long)count, __ATOMIC_RELAXED);
+    }
+    return count;
+}
+
+static void *log_drainer(void *arg) {
+    (void)arg;
+    while (1) {
+        pthread_mutex_lock(&drain_mutex);
+        int count = drain_rings();
+        pthread_mutex_unlock(&drain_mutex);
+        if (count == 0) usleep(LOG_DRAIN_INTERVAL_MS * 1000);
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+static int parse_level(const char *name) {
+    static const char *names[] = { "debug", "info", "warn", "error", "off" };
+    for (int i = 0; i <= LOG_LEVEL_OFF; i++) {
+        if (strcasecmp(name, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+void log_init(void) {
+    const char *level = getenv(LOG_LEVEL_ENV);
+    if (level) {
+        int parsed = parse_level(level);
+        if (parsed >= 0) log_level = parsed;
+        else fprintf(stderr, "⚠️  %s=%s is not debug|info|warn|error|off, using info\n", LOG_LEVEL_ENV, level);
+    }
+
+    log_out = stdout;
+    const char *path = getenv(LOG_FILE_ENV);
+    if (path) {
+        FILE *file = fopen(path, "a");
+        if (file) log_out = file;
+        else perror(path);
+    }
+
+    for (int r = 0; r < LOG_RINGS; r++) {
+        void *slots = NULL;
+        if (posix_memalign(&slots, 64, sizeof(LogSlot) * LOG_RING_SIZE) != 0) {
+            // Không có ring thì ghi thẳng như trước
+            fprintf(stderr, "⚠️  Logger: out of memory, logging synchronously\n");
+            return;
+        }
+        rings[r].slots = slots;
+        for (unsigned long long i = 0; i < LOG_RING_SIZE; i++) rings[r].slots[i].seq = i;
+    }
+
+    // Drainer fflush sau mỗi lô: buffer lớn gộp nhiều dòng vào một write()
+    setvbuf(log_out, NULL, _IOFBF, 1 << 16);
+    pthread_t thread_id;
+    if (pthread_create(&thread_id, NULL, log_drainer, NULL) != 0) return;
+    pthread_detach(thread_id);
+    log_started = 1;
+    atexit(log_flush);
+}
+
+void log_write(int level, const char *tag, const char *fmt, ...) {
+    va_list args;
+
+    if (!log_started) {
+        char msg[LOG_MSG_LEN];
+        va_start(args, fmt);
+        int len = vsnprintf(msg, sizeof(msg), fmt, args);
+        va_end(args);
+        if (len >= (int)sizeof(msg)) len = sizeof(msg) - 1;
+        emit(log_out ? log_out : stdout, now_ns(), level, tag, msg, len);
+        return;
+    }
+
+    if (thread_ring < 0) {
+        thread_ring = (int)(__atomic_fetch_add(&next_ring, 1, __ATOMIC_RELAXED) % LOG_RINGS);
+    }
+    LogRing *ring = &rings[thread_ring];
+
+    // Giành một slot: CAS head khi slot ở vị trí đó đã trống
+    unsigned long long pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    LogSlot *slot;
+    while (1) {
+        slot = &ring->slots[pos & RING_MASK];
+        unsigned long long seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        long long diff = (long long)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            // Ring đầy: drainer chưa kịp ghi, bỏ dòng này
+            __atomic_fetch_add(&dropped_total, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->ts_ns = now_ns();
+    slot->level = (unsigned char)level;
+    strncpy(slot->tag, tag, LOG_TAG_LEN - 1);
+    slot->tag[LOG_TAG_LEN - 1] = '\0';
+    va_start(args, fmt);
+    int len = vsnprintf(slot->msg, LOG_MSG_LEN, fmt, args);
+    va_end(args);
+    if (len < 0) len = 0;
+    slot->len = (unsigned short)(len >= LOG_MSG_LEN ? LOG_MSG_LEN - 1 : len);
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+void log_flush(void) {
+    if (!log_started) {
+        fflush(log_out ? log_out : stdout);
+        return;
+    }
+    pthread_mutex_lock(&drain_mutex);
+    drain_rings();
+    pthread_mutex_unlock(&drain_mutex);
+}
+
+void log_stats(LogStats *out) {
+    out->written = __atomic_load_n(&written_total, __ATOMIC_RELAXED);
+    out->dropped = __atomic_load_n(&dropped_total, __ATOMIC_RELAXED);
+}
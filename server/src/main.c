@@ -14,6 +14,13 @@
 #include <pthread.h>
 #include <arpa/inet.h>
 #include "../include/game.h"
+#include "../include/room_directory.h"
+#include "../include/arena.h"
+#include "../include/game_token.h"
+#include "../include/session_table.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+#include "../include/recorder.h"
 
 /* =============================================================================
  * BIẾN TOÀN CỤC (GLOBAL VARIABLES)
@@ -23,13 +30,7 @@
  * @brief Mảng lưu trữ các SSE client connections
  */
 SSE_Client sse_clients[MAX_CLIENTS];
-pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER;
-
-/**
- * @brief Mảng lưu trạng thái player (cho single player mode)
- */
-PlayerGameState player_states[MAX_CLIENTS];
-pthread_mutex_t game_state_mutex = PTHREAD_MUTEX_INITIALIZER;
+ProfiledMutex clients_mutex = PROFILED_MUTEX_INITIALIZER("clients_mutex");
 
 /**
  * @brief ID tự tăng cho session mới
@@ -48,17 +49,44 @@ int main() {
     struct sockaddr_in address;
     int addrlen = sizeof(address);
     
+    // Logger trước mọi module khác (GAME_LOG_LEVEL, GAME_LOG_FILE)
+    log_init();
+    
+    // Tracing (GAME_TRACE_SAMPLE, dump qua GET /trace hoặc SIGUSR2)
+    trace_init();
+    
+    // Ghi request cho tools/replay (GAME_RECORD_FILE)
+    recorder_init();
+    
+    // Quyền vào endpoint vận hành (GAME_ADMIN_TOKEN)
+    init_admin_access();
+    
     // Khởi tạo database từ file items.txt
     init_game_database();
+    init_catalog_watcher();
+    
+    // Key ký token chơi đơn (GAME_TOKEN_KEY để nhiều process dùng chung)
+    game_token_init_key();
+    if (session_table_init(SESSION_TABLE_CAPACITY) != 0) {
+        exit(EXIT_FAILURE);
+    }
     
     // Khởi tạo rooms cho multiplayer
     init_rooms();
+    init_room_directory();
+    init_arena_timer();
     
-    // Khởi tạo SSE clients
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        sse_clients[i].active = 0;
-        sse_clients[i].socket = -1;
-    }
+    // Khởi tạo lobby stream (push room changes qua SSE)
+    init_lobby_stream();
+    
+    // Khởi tạo quick-play matchmaking
+    init_matchmaking();
+    
+    // Replay leaderboard log + khởi động writer thread
+    init_leaderboard();
+    
+    // Khởi tạo SSE clients + thread flush queue
+    init_sse();
     
     // Tạo socket
     if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
@@ -85,16 +113,12 @@ int main() {
     }
     
     // Listen
-    if (listen(server_fd, 10) < 0) {
+    if (listen(server_fd, BACKLOG) < 0) {
         perror("Listen failed");
         exit(EXIT_FAILURE);
     }
     
-    printf("===========================================\n");
-    printf("  Higher Lower Game Server\n");
-    printf("  Port: %d\n", PORT);
-    printf("  Loaded: %d items\n", item_count);
-    printf("===========================================\n");
+    LOG_INFO("SERVER", "🚀 Higher Lower Game Server listening on port %d (%d items)", PORT, item_count);
     
     // Vòng lặp chính - accept connections
     while (1) {
@@ -102,6 +126,7 @@ int main() {
             perror("Accept failed");
             continue;
         }
+        metrics_add(METRIC_CONNECTIONS, 1);
         
         // Tạo thread để xử lý client
         int *client_socket = malloc(sizeof(int));
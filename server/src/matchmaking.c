@@ -0,0 +1,517 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - MATCHMAKING
+ * ============================================================================
+ * File: matchmaking.c
+ * Description: Quick-play queue và matcher thread
+ * 
+ * Hàng đợi là skip list với key [max_rounds][enqueue_ms][session_id]:
+ *   - Mỗi giá trị max_rounds là một bucket liền mạch trong skip list
+ *   - Trong bucket, người chờ lâu nhất đứng đầu
+ *   - Đếm số người trong bucket = hiệu hai rank, O(log n)
+ * Một skip list thứ hai (key = session_id) cho phép hủy vé O(log n).
+ * 
+ * Matcher thread mỗi MATCH_TICK_MS:
+ *   1. Bucket đủ MATCH_TARGET_PLAYERS -> tạo phòng, start game ngay
+ *   2. Người đầu bucket chờ quá MATCH_MAX_WAIT_MS:
+ *        - Đủ MATCH_MIN_PLAYERS -> tạo phòng với cả bucket, start game
+ *        - Chỉ một người -> ghép vào phòng đang chờ cùng max_rounds
+ * 
+ * Lock order: rooms_mutex và mm_mutex KHÔNG bao giờ giữ lồng nhau -
+ * vé được lấy ra khỏi queue dưới mm_mutex, phòng được tạo dưới rooms_mutex.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/game.h"
+#include "../include/room_helpers.h"
+#include "../include/room_directory.h"
+#include "../include/skiplist.h"
+#include "../include/matchmaking.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+#define QUEUE_KEY_LEN       14          // [rounds:2][enqueue_ms:8][session:4]
+#define SESSION_KEY_LEN     4
+
+/**
+ * MatchTicket - Một người chơi trong hàng đợi
+ */
+typedef struct {
+    int session_id;
+    char player_name[PLAYER_NAME_LEN];
+    int max_rounds;
+    unsigned long long enqueue_ms;
+} MatchTicket;
+
+/* ============================================================================
+ *                           STATE (bảo vệ bởi mm_mutex)
+ * ============================================================================ */
+
+static pthread_mutex_t mm_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static MatchTicket tickets[MAX_CLIENTS];
+static int free_slots[MAX_CLIENTS];     // Stack slot vé trống
+static int free_count = 0;
+static SkipList queue;                  // [rounds][enqueue_ms][session] -> ticket
+static SkipList by_session;             // [session] -> ticket
+
+// Time-to-match của MATCH_STATS_SAMPLES lần ghép gần nhất (ring buffer)
+static unsigned int wait_samples[MATCH_STATS_SAMPLES];
+static int sample_count = 0;
+static int sample_next = 0;
+static unsigned long long matched_total = 0;
+
+/* ============================================================================
+ *                           HELPERS
+ * ============================================================================ */
+
+static unsigned long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+static void encode_queue_key(unsigned char *key, int rounds, unsigned long long enqueue_ms, int session_id) {
+    key[0] = (unsigned char)(rounds >> 8);
+    key[1] = (unsigned char)rounds;
+    for (int i = 0; i < 8; i++) {
+        key[2 + i] = (unsigned char)(enqueue_ms >> (56 - 8 * i));
+    }
+    key[10] = (unsigned char)(session_id >> 24);
+    key[11] = (unsigned char)(session_id >> 16);
+    key[12] = (unsigned char)(session_id >> 8);
+    key[13] = (unsigned char)session_id;
+}
+
+static void encode_session_key(unsigned char *key, int session_id) {
+    key[0] = (unsigned char)(session_id >> 24);
+    key[1] = (unsigned char)(session_id >> 16);
+    key[2] = (unsigned char)(session_id >> 8);
+    key[3] = (unsigned char)session_id;
+}
+
+static int bucket_of(SkipNode *node) {
+    return (node->key[0] << 8) | node->key[1];
+}
+
+/**
+ * Thêm vé vào queue (caller giữ mm_mutex)
+ * @return 0 nếu thành công, -1 nếu đã có trong queue hoặc queue đầy
+ */
+static int enqueue_locked(int session_id, const char *player_name, int max_rounds,
+                          unsigned long long enqueue_ms) {
+    unsigned char skey[SESSION_KEY_LEN];
+    encode_session_key(skey, session_id);
+    
+    size_t rank;
+    SkipNode *existing = skiplist_lower_bound(&by_session, skey, &rank);
+    if (existing && memcmp(existing->key, skey, SESSION_KEY_LEN) == 0) return -1;
+    
+    if (free_count == 0) return -1;
+    int slot = free_slots[--free_count];
+    
+    MatchTicket *t = &tickets[slot];
+    t->session_id = session_id;
+    strncpy(t->player_name, player_name, PLAYER_NAME_LEN - 1);
+    t->player_name[PLAYER_NAME_LEN - 1] = '\0';
+    t->max_rounds = max_rounds;
+    t->enqueue_ms = enqueue_ms;
+    
+    unsigned char qkey[QUEUE_KEY_LEN];
+    encode_queue_key(qkey, max_rounds, enqueue_ms, session_id);
+    skiplist_insert(&queue, qkey, slot);
+    skiplist_insert(&by_session, skey, slot);
+    return 0;
+}
+
+/**
+ * Xóa vé khỏi cả hai skip list (caller giữ mm_mutex)
+ */
+static void dequeue_locked(int slot) {
+    MatchTicket *t = &tickets[slot];
+    unsigned char qkey[QUEUE_KEY_LEN], skey[SESSION_KEY_LEN];
+    encode_queue_key(qkey, t->max_rounds, t->enqueue_ms, t->session_id);
+    encode_session_key(skey, t->session_id);
+    skiplist_remove(&queue, qkey);
+    skiplist_remove(&by_session, skey);
+    free_slots[free_count++] = slot;
+}
+
+static void record_wait_locked(unsigned long long waited_ms) {
+    wait_samples[sample_next] = (unsigned int)waited_ms;
+    sample_next = (sample_next + 1) % MATCH_STATS_SAMPLES;
+    if (sample_count < MATCH_STATS_SAMPLES) sample_count++;
+    matched_total++;
+}
+
+/* ============================================================================
+ *                           MATCHER
+ * ============================================================================ */
+
+/**
+ * Tìm batch kế tiếp từ bucket from_bucket trở đi và lấy ra khỏi queue
+ * 
+ * @param from_bucket In/out: bucket bắt đầu quét, cập nhật thành bucket của batch
+ * @param batch Output: các vé được lấy ra
+ * @return Số vé trong batch, 0 nếu không còn batch nào sẵn sàng
+ */
+static int pop_next_batch(int *from_bucket, MatchTicket *batch, unsigned long long now) {
+    unsigned char key[QUEUE_KEY_LEN];
+    encode_queue_key(key, *from_bucket, 0, 0);
+    
+    size_t bucket_rank;
+    SkipNode *node = skiplist_lower_bound(&queue, key, &bucket_rank);
+    
+    while (node) {
+        int bucket = bucket_of(node);
+        
+        size_t next_rank;
+        encode_queue_key(key, bucket + 1, 0, 0);
+        SkipNode *next_bucket = skiplist_lower_bound(&queue, key, &next_rank);
+        int count = (int)(next_rank - bucket_rank);
+        
+        MatchTicket *oldest = &tickets[node->value];
+        int take = 0;
+        if (count >= MATCH_TARGET_PLAYERS) {
+            take = MATCH_TARGET_PLAYERS;
+        } else if (now - oldest->enqueue_ms >= MATCH_MAX_WAIT_MS) {
+            take = count;
+        }
+        
+        if (take > 0) {
+            for (int i = 0; i < take; i++) {
+                SkipNode *first = skiplist_at(&queue, bucket_rank);
+                batch[i] = tickets[first->value];
+                dequeue_locked(first->value);
+            }
+            *from_bucket = bucket;
+            return take;
+        }
+        
+        node = next_bucket;
+        bucket_rank = next_rank;
+    }
+    return 0;
+}
+
+static void build_match_found_json(JsonWriter *w, GameRoom *room) {
+    jw_object_begin(w);
+    jw_kv_str(w, "action", "match_found");
+    jw_key(w, "room");
+    build_room_json(w, room);
+    jw_object_end(w);
+}
+
+/**
+ * Tạo phòng từ batch hoặc ghép người lẻ vào phòng đang chờ
+ * 
+ * @param valid Output: index trong batch của các vé còn hiệu lực (người đã
+ *              tự vào phòng trong lúc chờ bị bỏ qua)
+ * @param out_count Output: số phần tử của valid
+ * @return 1 nếu mọi vé trong valid đã được xếp phòng, 0 nếu chưa (không
+ *         còn phòng trống / người lẻ chưa có phòng để vào)
+ */
+static int form_match(MatchTicket *batch, int batch_size, int *valid, int *out_count) {
+    int valid_count = 0;
+    int rounds = batch[0].max_rounds;
+    
+    MUTEX_LOCK(&rooms_mutex);
+    
+    // Bỏ qua người đã tự vào phòng trong lúc chờ
+    for (int i = 0; i < batch_size; i++) {
+        if (!is_player_in_any_room(batch[i].session_id)) {
+            valid[valid_count++] = i;
+        }
+    }
+    *out_count = valid_count;
+    
+    if (valid_count == 0) {
+        MUTEX_UNLOCK(&rooms_mutex);
+        return 1;
+    }
+    
+    if (valid_count >= MATCH_MIN_PLAYERS) {
+        MatchTicket *host = &batch[valid[0]];
+        char room_name[ROOM_NAME_LEN];
+        snprintf(room_name, sizeof(room_name), "Quick Play #%d", next_room_id);
+        
+        int room_idx = create_room(host->session_id, room_name, host->player_name, rounds, 0,
+                                   DIFFICULTY_RANDOM, NULL, NULL);
+        if (room_idx == -1) {
+            MUTEX_UNLOCK(&rooms_mutex);
+            LOG_WARN("MATCH", "⚠️  No room slot for quick-play batch");
+            return 0;
+        }
+        
+        GameRoom *room = &rooms[room_idx];
+        for (int i = 1; i < valid_count; i++) {
+            MatchTicket *t = &batch[valid[i]];
+            add_player_to_room(room, t->session_id, t->player_name, 0);
+        }
+        start_room_game(room_idx);
+        
+        int room_id = room->id;
+        JsonWriter match_json, started_json;
+        jw_init(&match_json);
+        jw_init(&started_json);
+        build_match_found_json(&match_json, room);
+        build_game_started_json(&started_json, room);
+        
+        MUTEX_UNLOCK(&rooms_mutex);
+        
+        broadcast_sse_to_room(room_id, jw_str(&match_json));
+        broadcast_sse_to_room(room_id, jw_str(&started_json));
+        jw_free(&match_json);
+        jw_free(&started_json);
+        LOG_INFO("MATCH", "🤝 Quick-play room %d started with %d players (%d rounds)",
+                 room_id, valid_count, rounds);
+        return 1;
+    }
+    
+    // Chỉ còn một người: tìm phòng đang chờ cùng max_rounds còn chỗ
+    RoomQuery query;
+    memset(&query, 0, sizeof(query));
+    query.status_mask = 1 << ROOM_WAITING;
+    query.players_min = 1;
+    query.players_max = -1;
+    query.only_open = 1;
+    query.arena = 0;
+    query.rounds_min = query.rounds_max = rounds;
+    query.limit = 1;
+    
+    int room_idx;
+    if (room_dir_query(&query, &room_idx, 1, NULL, 0) != 1) {
+        MUTEX_UNLOCK(&rooms_mutex);
+        return 0;
+    }
+    
+    MatchTicket *t = &batch[valid[0]];
+    GameRoom *room = &rooms[room_idx];
+    add_player_to_room(room, t->session_id, t->player_name, 0);
+    notify_room_changed(room_idx);
+    
+    int room_id = room->id;
+    JsonWriter match_json, notify_json;
+    jw_init(&match_json);
+    jw_init(&notify_json);
+    build_match_found_json(&match_json, room);
+    jw_object_begin(&notify_json);
+    jw_kv_str(&notify_json, "action", "player_joined");
+    jw_key(&notify_json, "room");
+    build_room_json(&notify_json, room);
+    jw_object_end(&notify_json);
+    
+    MUTEX_UNLOCK(&rooms_mutex);
+    
+    broadcast_sse_to_session(t->session_id, jw_str(&match_json));
+    broadcast_sse_to_room(room_id, jw_str(&notify_json));
+    jw_free(&match_json);
+    jw_free(&notify_json);
+    LOG_INFO("MATCH", "🤝 Session %d placed into waiting room %d", t->session_id, room_id);
+    return 1;
+}
+
+static void *matcher_thread(void *arg) {
+    (void)arg;
+    MatchTicket batch[MATCH_TARGET_PLAYERS];
+    int valid[MATCH_TARGET_PLAYERS];
+    
+    while (1) {
+        usleep(MATCH_TICK_MS * 1000);
+        
+        int bucket = 0;
+        while (1) {
+            unsigned long long now = now_ms();
+            
+            pthread_mutex_lock(&mm_mutex);
+            int batch_size = pop_next_batch(&bucket, batch, now);
+            pthread_mutex_unlock(&mm_mutex);
+            
+            if (batch_size == 0) break;
+            
+            int valid_count;
+            int done = form_match(batch, batch_size, valid, &valid_count);
+            
+            // Vé của người đã tự vào phòng bị bỏ: không tính là ghép, không trả về queue
+            pthread_mutex_lock(&mm_mutex);
+            if (done) {
+                for (int i = 0; i < valid_count; i++) {
+                    record_wait_locked(now - batch[valid[i]].enqueue_ms);
+                }
+            } else {
+                // Chưa ghép được: trả vé về queue với thời điểm vào hàng cũ
+                for (int i = 0; i < valid_count; i++) {
+                    MatchTicket *t = &batch[valid[i]];
+                    enqueue_locked(t->session_id, t->player_name, t->max_rounds, t->enqueue_ms);
+                }
+                bucket++;   // Thử bucket khác, bucket này chờ tick sau
+            }
+            pthread_mutex_unlock(&mm_mutex);
+        }
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ *                           INITIALIZATION
+ * ============================================================================ */
+
+void init_matchmaking(void) {
+    pthread_mutex_lock(&mm_mutex);
+    skiplist_init(&queue, QUEUE_KEY_LEN);
+    skiplist_init(&by_session, SESSION_KEY_LEN);
+    free_count = 0;
+    for (int i = MAX_CLIENTS - 1; i >= 0; i--) {
+        free_slots[free_count++] = i;
+    }
+    pthread_mutex_unlock(&mm_mutex);
+    
+    pthread_t thread_id;
+    pthread_create(&thread_id, NULL, matcher_thread, NULL);
+    pthread_detach(thread_id);
+    
+    LOG_INFO("MATCH", "🎲 Matchmaking started (target %d players, max wait %dms)",
+             MATCH_TARGET_PLAYERS, MATCH_MAX_WAIT_MS);
+}
+
+/* ============================================================================
+ *                           HTTP HANDLERS
+ * ============================================================================ */
+
+/**
+ * POST /matchmaking/join - Vào hàng đợi
+ */
+void handle_matchmaking_join(int sock, int session_id, char *json_body) {
+    if (session_id == 0) {
+        send_json_response(sock, "{\"error\":\"No session ID\"}");
+        return;
+    }
+    
+    RequestBody body;
+    if (parse_request_body(json_body, strlen(json_body), &body) != 0) {
+        send_json_response(sock, "{\"error\":\"Invalid JSON body\"}");
+        return;
+    }
+    const char *player_name = body.player_name;
+    
+    int max_rounds = body.max_rounds;
+    if (max_rounds < 5) max_rounds = 10;
+    if (max_rounds > MAX_ROUNDS_PER_GAME) max_rounds = MAX_ROUNDS_PER_GAME;
+    
+    MUTEX_LOCK(&rooms_mutex);
+    int in_room = is_player_in_any_room(session_id);
+    MUTEX_UNLOCK(&rooms_mutex);
+    
+    if (in_room) {
+        send_json_response(sock, "{\"error\":\"You are already in a room\"}");
+        return;
+    }
+    
+    pthread_mutex_lock(&mm_mutex);
+    int result = enqueue_locked(session_id, player_name, max_rounds, now_ms());
+    int queue_size = (int)queue.length;
+    pthread_mutex_unlock(&mm_mutex);
+    
+    if (result != 0) {
+        send_json_response(sock, "{\"error\":\"Already in queue or queue is full\"}");
+        return;
+    }
+    
+    JsonWriter w;
+    jw_init(&w);
+    jw_object_begin(&w);
+    jw_kv_str(&w, "action", "matchmaking_queued");
+    jw_kv_int(&w, "max_rounds", max_rounds);
+    jw_kv_int(&w, "queue_size", queue_size);
+    jw_object_end(&w);
+    send_json_response(sock, jw_str(&w));
+    jw_free(&w);
+    
+    LOG_DEBUG("MATCH", "⏳ Session %d queued (%d rounds, queue size %d)", session_id, max_rounds, queue_size);
+}
+
+int matchmaking_cancel(int session_id) {
+    unsigned char skey[SESSION_KEY_LEN];
+    encode_session_key(skey, session_id);
+    
+    pthread_mutex_lock(&mm_mutex);
+    SkipNode *node = skiplist_lower_bound(&by_session, skey, NULL);
+    int found = node && memcmp(node->key, skey, SESSION_KEY_LEN) == 0;
+    if (found) {
+        dequeue_locked(node->value);
+    }
+    pthread_mutex_unlock(&mm_mutex);
+    return found;
+}
+
+/**
+ * POST /matchmaking/leave - Rời hàng đợi
+ */
+void handle_matchmaking_leave(int sock, int session_id) {
+    if (session_id == 0) {
+        send_json_response(sock, "{\"error\":\"No session ID\"}");
+        return;
+    }
+    
+    if (!matchmaking_cancel(session_id)) {
+        send_json_response(sock, "{\"error\":\"You are not in the queue\"}");
+        return;
+    }
+    send_json_response(sock, "{\"action\":\"matchmaking_left\"}");
+}
+
+static int compare_uint(const void *a, const void *b) {
+    unsigned int x = *(const unsigned int *)a;
+    unsigned int y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * GET /matchmaking/stats - Thống kê time-to-match
+ */
+void handle_matchmaking_stats(int sock) {
+    unsigned int sorted[MATCH_STATS_SAMPLES];
+    
+    pthread_mutex_lock(&mm_mutex);
+    int n = sample_count;
+    memcpy(sorted, wait_samples, n * sizeof(unsigned int));
+    int queued = (int)queue.length;
+    unsigned long long matched = matched_total;
+    pthread_mutex_unlock(&mm_mutex);
+    
+    qsort(sorted, n, sizeof(unsigned int), compare_uint);
+    
+    unsigned int p50 = 0, p90 = 0, p99 = 0, max = 0;
+    if (n > 0) {
+        p50 = sorted[(n - 1) * 50 / 100];
+        p90 = sorted[(n - 1) * 90 / 100];
+        p99 = sorted[(n - 1) * 99 / 100];
+        max = sorted[n - 1];
+    }
+    
+    JsonWriter w;
+    jw_init(&w);
+    jw_object_begin(&w);
+    jw_kv_str(&w, "action", "matchmaking_stats");
+    jw_kv_int(&w, "queued", queued);
+    jw_kv_int(&w, "matched", (long long)matched);
+    jw_kv_int(&w, "samples", n);
+    jw_key(&w, "time_to_match_ms");
+    jw_object_begin(&w);
+    jw_kv_int(&w, "p50", p50);
+    jw_kv_int(&w, "p90", p90);
+    jw_kv_int(&w, "p99", p99);
+    jw_kv_int(&w, "max", max);
+    jw_object_end(&w);
+    jw_object_end(&w);
+    send_json_response(sock, jw_str(&w));
+    jw_free(&w);
+}
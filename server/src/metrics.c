@@ -0,0 +1,429 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - METRICS
+ * ============================================================================
+ * File: metrics.c
+ * Description: Counter/histogram theo shard + GET /metrics (Prometheus)
+ * ============================================================================
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/game.h"
+#include "../include/json_cache.h"
+#include "../include/json_writer.h"
+#include "../include/metrics.h"
+#include "../include/session_table.h"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    uint64_t buckets[METRIC_BUCKETS];   // Bucket cuối: vượt cận trên lớn nhất
+    uint64_t sum_ns;
+} Histogram;
+
+typedef struct {
+    Histogram routes[ROUTE_COUNT];
+    Histogram broadcasts[BROADCAST_COUNT];
+    uint64_t recipients[BROADCAST_COUNT];
+    uint64_t counters[METRIC_COUNTER_COUNT];
+} __attribute__((aligned(64))) MetricShard;
+
+static MetricShard shards[METRIC_SHARDS];
+static unsigned int next_shard = 0;
+static __thread int thread_shard = -1;
+
+static const struct {
+    const char *method;
+    const char *path;
+} route_table[ROUTE_COUNT] = {
+#define X(id, method, path) { method, path },
+    METRIC_ROUTES(X)
+#undef X
+};
+
+static const char *route_names[ROUTE_COUNT] = {
+#define X(id, method, path) method " " path,
+    METRIC_ROUTES(X)
+#undef X
+};
+
+static const char *broadcast_names[BROADCAST_COUNT] = {
+#define X(id, name) name,
+    METRIC_BROADCASTS(X)
+#undef X
+};
+
+/* ============================================================================
+ *                           RECORDING
+ * ============================================================================ */
+
+static MetricShard *my_shard(void) {
+    if (thread_shard < 0) {
+        thread_shard = (int)(__atomic_fetch_add(&next_shard, 1, __ATOMIC_RELAXED) % METRIC_SHARDS);
+    }
+    return &shards[thread_shard];
+}
+
+static void observe(Histogram *h, uint64_t ns) {
+    __atomic_fetch_add(&h->buckets[metrics_bucket_of(ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->sum_ns, ns, __ATOMIC_RELAXED);
+}
+
+MetricRoute metrics_match_route(const char *method, const char *path) {
+    for (int r = 0; r < ROUTE_NOT_FOUND; r++) {
+        if (strcmp(method, route_table[r].method) != 0) continue;
+        if (route_table[r].path[0] == '*' || strcmp(path, route_table[r].path) == 0) {
+            return (MetricRoute)r;
+        }
+    }
+    return ROUTE_NOT_FOUND;
+}
+
+const char *metrics_route_name(MetricRoute route) {
+    return route == ROUTE_NOT_FOUND ? "not_found" : route_names[route];
+}
+
+void metrics_add(MetricCounter counter, uint64_t n) {
+    __atomic_fetch_add(&my_shard()->counters[counter], n, __ATOMIC_RELAXED);
+}
+
+void metrics_observe_route(MetricRoute route, uint64_t ns) {
+    observe(&my_shard()->routes[route], ns);
+}
+
+void metrics_observe_broadcast(MetricBroadcast kind, uint64_t ns, int recipients) {
+    MetricShard *shard = my_shard();
+    observe(&shard->broadcasts[kind], ns);
+    __atomic_fetch_add(&shard->recipients[kind], (uint64_t)recipients, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ *                           EXPOSITION
+ * ============================================================================ */
+
+static void emit(JsonWriter *w, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void emit(JsonWriter *w, const char *fmt, ...) {
+    char line[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+    if (len <= 0) return;
+    // Writer chỉ làm buffer (pool, tự grow): text format không có dấu phẩy giữa các dòng
+    jw_raw(w, line, (size_t)len);
+    w->has_items[w->depth] = 0;
+}
+
+static void emit_header(JsonWriter *w, const char *name, const char *type, const char *help) {
+    emit(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static uint64_t sum_counter(MetricCounter counter) {
+    uint64_t total = 0;
+    for (int s = 0; s < METRIC_SHARDS; s++) {
+        total += __atomic_load_n(&shards[s].counters[counter], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/**
+ * Cộng histogram của mọi shard (offset của histogram trong MetricShard)
+ */
+static void merge_histogram(size_t offset, Histogram *out) {
+    memset(out, 0, sizeof(*out));
+    for (int s = 0; s < METRIC_SHARDS; s++) {
+        const Histogram *h = (const Histogram *)((const char *)&shards[s] + offset);
+        for (int j = 0; j < METRIC_BUCKETS; j++) {
+            out->buckets[j] += __atomic_load_n(&h->buckets[j], __ATOMIC_RELAXED);
+        }
+        out->sum_ns += __atomic_load_n(&h->sum_ns, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Bucket cộng dồn + sum + count; count lấy từ tổng bucket để luôn khớp
+ * với bucket +Inf dù shard đang được ghi
+ */
+static void emit_histogram(JsonWriter *w, const char *name, const char *labels, const Histogram *h) {
+    uint64_t cumulative = 0;
+    for (int j = 0; j < METRIC_BUCKETS - 1; j++) {
+        cumulative += h->buckets[j];
+        uint64_t us = metrics_bucket_bound_us(j);
+        emit(w, "%s_bucket{%s,le=\"%llu.%06llu\"} %llu\n", name, labels,
+             (unsigned long long)(us / 1000000), (unsigned long long)(us % 1000000),
+             (unsigned long long)cumulative);
+    }
+    cumulative += h->buckets[METRIC_BUCKETS - 1];
+    emit(w, "%s_bucket{%s,le=\"+Inf\"} %llu\n", name, labels, (unsigned long long)cumulative);
+    emit(w, "%s_sum{%s} %.9f\n", name, labels, h->sum_ns / 1e9);
+    emit(w, "%s_count{%s} %llu\n", name, labels, (unsigned long long)cumulative);
+}
+
+static void emit_counter(JsonWriter *w, const char *name, const char *help, unsigned long long value) {
+    emit_header(w, name, "counter", help);
+    emit(w, "%s %llu\n", name, value);
+}
+
+static void emit_gauge(JsonWriter *w, const char *name, const char *help, double value) {
+    emit_header(w, name, "gauge", help);
+    emit(w, "%s %.17g\n", name, value);
+}
+
+static void write_request_metrics(JsonWriter *w) {
+    Histogram h;
+    char labels[128];
+
+    emit_header(w, "game_http_request_duration_seconds", "histogram",
+                "Request latency by route, measured around handle_client dispatch");
+    for (int r = 0; r < ROUTE_COUNT; r++) {
+        merge_histogram(offsetof(MetricShard, routes) + r * sizeof(Histogram), &h);
+        uint64_t count = 0;
+        for (int j = 0; j < METRIC_BUCKETS; j++) count += h.buckets[j];
+        if (count == 0) continue;           // Series xuất hiện từ request đầu tiên
+        snprintf(labels, sizeof(labels), "method=\"%s\",route=\"%s\"",
+                 route_table[r].method, r == ROUTE_NOT_FOUND ? "not_found" : route_table[r].path);
+        emit_histogram(w, "game_http_request_duration_seconds", labels, &h);
+    }
+
+    emit_header(w, "game_sse_broadcast_duration_seconds", "histogram",
+                "Time to write one SSE event to every target client, including clients_mutex wait");
+    for (int b = 0; b < BROADCAST_COUNT; b++) {
+        merge_histogram(offsetof(MetricShard, broadcasts) + b * sizeof(Histogram), &h);
+        snprintf(labels, sizeof(labels), "type=\"%s\"", broadcast_names[b]);
+        emit_histogram(w, "game_sse_broadcast_duration_seconds", labels, &h);
+    }
+
+    emit_header(w, "game_sse_broadcast_recipients_total", "counter", "Clients reached by SSE broadcasts");
+    for (int b = 0; b < BROADCAST_COUNT; b++) {
+        uint64_t total = 0;
+        for (int s = 0; s < METRIC_SHARDS; s++) {
+            total += __atomic_load_n(&shards[s].recipients[b], __ATOMIC_RELAXED);
+        }
+        emit(w, "game_sse_broadcast_recipients_total{type=\"%s\"} %llu\n", broadcast_names[b],
+             (unsigned long long)total);
+    }
+
+    emit_counter(w, "game_connections_total", "Accepted TCP connections", sum_counter(METRIC_CONNECTIONS));
+    emit_counter(w, "game_http_received_bytes_total", "Request bytes read", sum_counter(METRIC_BYTES_IN));
+    emit_counter(w, "game_http_sent_bytes_total", "HTTP response bytes written", sum_counter(METRIC_BYTES_OUT));
+    emit_counter(w, "game_sse_sent_bytes_total", "SSE event bytes written", sum_counter(METRIC_SSE_BYTES_OUT));
+    emit_counter(w, "game_sse_messages_total", "SSE events delivered (one per client)",
+                 sum_counter(METRIC_SSE_MESSAGES));
+
+    emit_header(w, "game_errors_total", "counter", "Request read/write failures, unknown routes, dropped SSE clients");
+    emit(w, "game_errors_total{kind=\"read\"} %llu\n", (unsigned long long)sum_counter(METRIC_READ_ERRORS));
+    emit(w, "game_errors_total{kind=\"write\"} %llu\n", (unsigned long long)sum_counter(METRIC_WRITE_ERRORS));
+    merge_histogram(offsetof(MetricShard, routes) + ROUTE_NOT_FOUND * sizeof(Histogram), &h);
+    uint64_t not_found = 0;
+    for (int j = 0; j < METRIC_BUCKETS; j++) not_found += h.buckets[j];
+    emit(w, "game_errors_total{kind=\"not_found\"} %llu\n", (unsigned long long)not_found);
+    emit(w, "game_errors_total{kind=\"sse_disconnect\"} %llu\n",
+         (unsigned long long)sum_counter(METRIC_SSE_DISCONNECTS));
+    emit(w, "game_errors_total{kind=\"sse_slow_client\"} %llu\n",
+         (unsigned long long)sum_counter(METRIC_SSE_SLOW_DROPS));
+}
+
+/**
+ * Histogram wait / hold của mỗi ProfiledMutex
+ */
+static void write_lock_metrics(JsonWriter *w) {
+    ProfiledMutex *locks[LOCK_REGISTRY];
+    int count = profiled_mutex_list(locks, LOCK_REGISTRY);
+    Histogram h;
+    char labels[64];
+
+    static const struct {
+        const char *name;
+        const char *help;
+        size_t buckets;
+        size_t sum;
+    } kinds[] = {
+        { "game_lock_wait_seconds", "Time spent waiting to acquire a lock",
+          offsetof(ProfiledMutex, wait_buckets), offsetof(ProfiledMutex, wait_ns) },
+        { "game_lock_hold_seconds", "Time a lock was held",
+          offsetof(ProfiledMutex, hold_buckets), offsetof(ProfiledMutex, hold_ns) },
+    };
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        emit_header(w, kinds[k].name, "histogram", kinds[k].help);
+        for (int i = 0; i < count; i++) {
+            const uint64_t *buckets = (const uint64_t *)((const char *)locks[i] + kinds[k].buckets);
+            for (int j = 0; j < METRIC_BUCKETS; j++) {
+                h.buckets[j] = __atomic_load_n(&buckets[j], __ATOMIC_RELAXED);
+            }
+            h.sum_ns = __atomic_load_n((const uint64_t *)((const char *)locks[i] + kinds[k].sum), __ATOMIC_RELAXED);
+            snprintf(labels, sizeof(labels), "lock=\"%s\"", locks[i]->name);
+            emit_histogram(w, kinds[k].name, labels, &h);
+        }
+    }
+
+    emit_header(w, "game_lock_contended_total", "counter", "Lock acquisitions that had to wait");
+    for (int i = 0; i < count; i++) {
+        emit(w, "game_lock_contended_total{lock=\"%s\"} %llu\n", locks[i]->name,
+             (unsigned long long)__atomic_load_n(&locks[i]->contended, __ATOMIC_RELAXED));
+    }
+}
+
+/**
+ * Gauge đọc từ state của các module (mỗi lock giữ riêng, không lồng nhau)
+ */
+static void write_state_metrics(JsonWriter *w) {
+    SSE_Stats sse;
+    sse_stats(&sse);
+    emit_gauge(w, "game_sse_clients", "Open SSE connections (active sessions)", sse.clients);
+    emit_gauge(w, "game_sse_queued_bytes", "SSE bytes waiting for slow clients", (double)sse.queued_bytes);
+
+    int by_status[ROOM_FINISHED + 1] = {0};
+    int players = 0;
+    MUTEX_LOCK(&rooms_mutex);
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        if (rooms[i].status == ROOM_EMPTY) continue;
+        by_status[rooms[i].status]++;
+        players += rooms[i].player_count;
+    }
+    MUTEX_UNLOCK(&rooms_mutex);
+    emit_header(w, "game_rooms", "gauge", "Rooms by status");
+    emit(w, "game_rooms{status=\"waiting\"} %d\n", by_status[ROOM_WAITING]);
+    emit(w, "game_rooms{status=\"playing\"} %d\n", by_status[ROOM_PLAYING]);
+    emit(w, "game_rooms{status=\"finished\"} %d\n", by_status[ROOM_FINISHED]);
+    emit_gauge(w, "game_room_players", "Players in rooms", players);
+
+    SessionTableStats sessions;
+    session_table_stats(&sessions);
+    emit_gauge(w, "game_single_player_sessions", "Single-player games tracked for replay protection",
+               (double)sessions.count);
+    emit_counter(w, "game_single_player_evictions_total", "Single-player games evicted (LRU or idle)",
+                 sessions.evicted + sessions.expired);
+    emit_counter(w, "game_single_player_replays_total", "Stale single-player tokens rejected", sessions.replays);
+    emit_counter(w, "game_single_player_forgotten_total",
+                 "Single-player tokens rejected because their game was dropped from the table",
+                 sessions.forgotten);
+
+    ItemCatalogStats catalog;
+    item_catalog_stats(&catalog);
+    emit_gauge(w, "game_catalog_items", "Items in the published catalog", catalog.item_count);
+    emit_gauge(w, "game_catalog_generation", "Published catalog generation", catalog.generation);
+    emit_counter(w, "game_catalog_reloads_total", "Successful catalog hot reloads", catalog.reloads);
+    emit_counter(w, "game_catalog_reload_failures_total", "Failed catalog reloads", catalog.failures);
+    emit_gauge(w, "game_catalog_last_reload_seconds", "Duration of the last catalog reload",
+               catalog.last_reload_ms / 1e3);
+
+    JsonCacheStats cache;
+    json_cache_stats(&cache);
+    emit_counter(w, "game_json_cache_hits_total", "Room/player JSON fragment cache hits", cache.hits);
+    emit_counter(w, "game_json_cache_misses_total", "Room/player JSON fragment cache misses", cache.misses);
+
+    LeaderboardStats leaderboard;
+    leaderboard_stats(&leaderboard);
+    emit_gauge(w, "game_leaderboard_pending", "Results queued for the leaderboard writer", leaderboard.pending);
+    emit_counter(w, "game_leaderboard_dropped_total", "Results dropped because the queue was full",
+                 leaderboard.dropped);
+    emit_counter(w, "game_leaderboard_unwritten_total", "Results kept in memory only because the log write failed",
+                 leaderboard.unwritten);
+
+    LogStats log;
+    log_stats(&log);
+    emit_counter(w, "game_log_lines_total", "Log lines written", log.written);
+    emit_counter(w, "game_log_dropped_total", "Log lines dropped because a ring was full", log.dropped);
+}
+
+/* ============================================================================
+ *                           LOCK REPORT
+ * ============================================================================ */
+
+static int cmp_wait(const void *a, const void *b) {
+    const LockSiteStats *x = a, *y = b;
+    return (x->wait_ns < y->wait_ns) - (x->wait_ns > y->wait_ns);
+}
+
+static int cmp_hold(const void *a, const void *b) {
+    const LockSiteStats *x = a, *y = b;
+    return (x->hold_ns < y->hold_ns) - (x->hold_ns > y->hold_ns);
+}
+
+static int cmp_blocked(const void *a, const void *b) {
+    const LockSiteStats *x = a, *y = b;
+    return (x->blocked_ns < y->blocked_ns) - (x->blocked_ns > y->blocked_ns);
+}
+
+static void write_lock_sites(JsonWriter *w, const char *key, LockSiteStats *sites, int count,
+                             int limit, int (*cmp)(const void *, const void *)) {
+    qsort(sites, count, sizeof(LockSiteStats), cmp);
+    jw_key(w, key);
+    jw_array_begin(w);
+    for (int i = 0; i < count && i < limit; i++) {
+        const LockSiteStats *s = &sites[i];
+        jw_object_begin(w);
+        jw_kv_str(w, "lock", s->lock);
+        jw_kv_str(w, "site", s->site);
+        jw_kv_str(w, "function", s->func ? s->func : "");
+        jw_kv_int(w, "acquisitions", (long long)s->acquisitions);
+        jw_kv_int(w, "contended", (long long)s->contended);
+        jw_kv_int(w, "wait_us", (long long)(s->wait_ns / 1000));
+        jw_kv_int(w, "wait_max_us", (long long)(s->wait_max_ns / 1000));
+        jw_kv_int(w, "hold_us", (long long)(s->hold_ns / 1000));
+        jw_kv_int(w, "hold_max_us", (long long)(s->hold_max_ns / 1000));
+        jw_kv_int(w, "blocked_others", (long long)s->blocked_count);
+        jw_kv_int(w, "blocked_others_us", (long long)(s->blocked_ns / 1000));
+        jw_object_end(w);
+    }
+    jw_array_end(w);
+}
+
+void handle_locks(int sock, const char *query) {
+    char value[16];
+    int limit = LOCK_TOP_N;
+    if (get_query_param(query, "limit", value, sizeof(value)) && atoi(value) > 0) limit = atoi(value);
+
+    ProfiledMutex *locks[LOCK_REGISTRY];
+    int lock_count = profiled_mutex_list(locks, LOCK_REGISTRY);
+    LockSiteStats *sites = malloc(sizeof(LockSiteStats) * LOCK_SITES);
+    int site_count = sites ? profiled_mutex_sites(sites, LOCK_SITES) : 0;
+
+    JsonWriter w;
+    jw_init(&w);
+    jw_object_begin(&w);
+    jw_kv_str(&w, "action", "lock_report");
+    jw_key(&w, "locks");
+    jw_array_begin(&w);
+    for (int i = 0; i < lock_count; i++) {
+        ProfiledMutex *m = locks[i];
+        const char *holder = __atomic_load_n(&m->holder_site, __ATOMIC_RELAXED);
+        jw_object_begin(&w);
+        jw_kv_str(&w, "name", m->name);
+        jw_kv_int(&w, "acquisitions", (long long)__atomic_load_n(&m->acquisitions, __ATOMIC_RELAXED));
+        jw_kv_int(&w, "contended", (long long)__atomic_load_n(&m->contended, __ATOMIC_RELAXED));
+        jw_kv_int(&w, "wait_us", (long long)(__atomic_load_n(&m->wait_ns, __ATOMIC_RELAXED) / 1000));
+        jw_kv_int(&w, "hold_us", (long long)(__atomic_load_n(&m->hold_ns, __ATOMIC_RELAXED) / 1000));
+        jw_key(&w, "holder");
+        if (holder) jw_string(&w, holder);
+        else jw_null(&w);
+        jw_object_end(&w);
+    }
+    jw_array_end(&w);
+    write_lock_sites(&w, "top_wait", sites, site_count, limit, cmp_wait);
+    write_lock_sites(&w, "top_hold", sites, site_count, limit, cmp_hold);
+    write_lock_sites(&w, "top_blocking", sites, site_count, limit, cmp_blocked);
+    jw_object_end(&w);
+
+    send_json_response(sock, jw_str(&w));
+    jw_free(&w);
+    free(sites);
+}
+
+void handle_metrics(int sock) {
+    JsonWriter w;
+    jw_init(&w);
+    write_request_metrics(&w);
+    write_lock_metrics(&w);
+    write_state_metrics(&w);
+    send_response(sock, "text/plain; version=0.0.4", jw_str(&w), jw_len(&w));
+    jw_free(&w);
+}
@@ -0,0 +1,44 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - PRNG
+ * ============================================================================
+ * File: prng.c
+ * Description: Seed cho xoshiro256** (splitmix64 + entropy từ kernel)
+ * ============================================================================
+ */
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/random.h>
+#include "../include/prng.h"
+
+/**
+ * splitmix64: trải seed 64-bit thành state 256-bit không toàn 0
+ */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void prng_seed(Prng *rng, uint64_t seed) {
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&x);
+    }
+}
+
+uint64_t prng_entropy_seed(void) {
+    uint64_t seed;
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) == (ssize_t)sizeof(seed)) {
+        return seed;
+    }
+
+    // Kernel chưa đủ entropy: trộn thời gian, pid và địa chỉ stack
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t x = (uint64_t)ts.tv_nsec ^ ((uint64_t)ts.tv_sec << 32) ^
+                 ((uint64_t)getpid() << 16) ^ (uint64_t)(uintptr_t)&seed;
+    return splitmix64(&x);
+}
@@ -0,0 +1,201 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - PROFILED MUTEX
+ * ============================================================================
+ * File: profiled_mutex.c
+ * Description: Đo wait / hold của lock, bảng thống kê theo call site
+ * ============================================================================
+ */
+
+#include <stdint.h>
+#include "../include/config.h"
+#include "../include/profiled_mutex.h"
+
+#define SITE_MASK (LOCK_SITES - 1)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * LockSite - Thống kê của một call site
+ *
+ * Slot được chiếm bằng CAS trên site (key); số liệu chỉ được ghi khi giữ
+ * lock của site đó nên ghi bằng load + store, không cần RMW atomic.
+ */
+typedef struct {
+    const char *site;                   // Key: chuỗi hằng LOCK_SITE (so sánh con trỏ)
+    const char *func;
+    const ProfiledMutex *lock;          // NULL khi slot đang được chiếm
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+    uint64_t wait_max_ns;
+    uint64_t hold_ns;
+    uint64_t hold_max_ns;
+    uint64_t blocked_ns;
+    uint64_t blocked_count;
+} LockSite;
+
+/* ============================================================================
+ *                           GLOBALS
+ * ============================================================================ */
+
+static LockSite sites[LOCK_SITES];
+static ProfiledMutex *locks[LOCK_REGISTRY];
+static int lock_count = 0;
+
+/* ============================================================================
+ *                           HELPERS
+ * ============================================================================ */
+
+// Người ghi duy nhất (đang giữ lock); người đọc không lock thấy giá trị nguyên vẹn
+static inline void bump(uint64_t *field, uint64_t n) {
+    __atomic_store_n(field, *field + n, __ATOMIC_RELAXED);
+}
+
+static inline void bump_max(uint64_t *field, uint64_t v) {
+    if (v > *field) __atomic_store_n(field, v, __ATOMIC_RELAXED);
+}
+
+/**
+ * Slot của call site; create = 0 chỉ tìm
+ * @return NULL nếu bảng đầy (site đó không được thống kê)
+ */
+static LockSite *find_site(const char *site, const char *func, const ProfiledMutex *m, int create) {
+    uint64_t h = (uint64_t)(uintptr_t)site * 0x9E3779B97F4A7C15ULL;
+    for (int probe = 0; probe < LOCK_SITES; probe++) {
+        LockSite *slot = &sites[((h >> 32) + probe) & SITE_MASK];
+        const char *key = __atomic_load_n(&slot->site, __ATOMIC_ACQUIRE);
+        if (key == site) return slot;
+        if (key != NULL) continue;
+        if (!create) return NULL;
+
+        const char *expected = NULL;
+        if (__atomic_compare_exchange_n(&slot->site, &expected, site, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            slot->func = func;
+            __atomic_store_n(&slot->lock, m, __ATOMIC_RELEASE);
+            return slot;
+        }
+        if (expected == site) return slot;
+    }
+    return NULL;
+}
+
+/**
+ * Thêm lock vào danh sách (gọi khi đang giữ m, một lần)
+ */
+static void register_lock(ProfiledMutex *m) {
+    m->registered = 1;
+    int idx = __atomic_fetch_add(&lock_count, 1, __ATOMIC_RELAXED);
+    if (idx < LOCK_REGISTRY) __atomic_store_n(&locks[idx], m, __ATOMIC_RELEASE);
+}
+
+/**
+ * Ghi lần lock (gọi ngay sau khi lấy được m)
+ * @param blocker Site giữ lock lúc bắt đầu chờ (NULL nếu không tranh chấp)
+ */
+static void on_acquired(ProfiledMutex *m, const char *site, const char *func,
+                        uint64_t now, uint64_t wait, int contended, const char *blocker) {
+    if (!m->registered) register_lock(m);
+
+    LockSite *entry = find_site(site, func, m, 1);
+    m->acquired_ns = now;
+    m->holder_func = func;
+    m->holder_entry = entry;
+    __atomic_store_n(&m->holder_site, site, __ATOMIC_RELAXED);
+
+    bump(&m->acquisitions, 1);
+    bump(&m->wait_ns, wait);
+    bump(&m->wait_buckets[metrics_bucket_of(wait)], 1);
+    if (entry) {
+        bump(&entry->acquisitions, 1);
+        bump(&entry->wait_ns, wait);
+        bump_max(&entry->wait_max_ns, wait);
+    }
+
+    if (!contended) return;
+    bump(&m->contended, 1);
+    if (entry) bump(&entry->contended, 1);
+    // Thời gian chờ tính cho site giữ lock lúc bắt đầu chờ
+    LockSite *culprit = blocker ? find_site(blocker, NULL, m, 0) : NULL;
+    if (culprit) {
+        bump(&culprit->blocked_ns, wait);
+        bump(&culprit->blocked_count, 1);
+    }
+}
+
+static void on_release(ProfiledMutex *m, uint64_t now) {
+    uint64_t hold = now - m->acquired_ns;
+    bump(&m->hold_ns, hold);
+    bump(&m->hold_buckets[metrics_bucket_of(hold)], 1);
+
+    LockSite *entry = m->holder_entry;
+    if (entry) {
+        bump(&entry->hold_ns, hold);
+        bump_max(&entry->hold_max_ns, hold);
+    }
+    __atomic_store_n(&m->holder_site, NULL, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+void profiled_mutex_lock(ProfiledMutex *m, const char *site, const char *func) {
+    if (pthread_mutex_trylock(&m->mutex) == 0) {
+        on_acquired(m, site, func, metrics_now_ns(), 0, 0, NULL);
+        return;
+    }
+
+    const char *blocker = __atomic_load_n(&m->holder_site, __ATOMIC_RELAXED);
+    uint64_t start = metrics_now_ns();
+    pthread_mutex_lock(&m->mutex);
+    uint64_t now = metrics_now_ns();
+    on_acquired(m, site, func, now, now - start, 1, blocker);
+}
+
+void profiled_mutex_unlock(ProfiledMutex *m) {
+    on_release(m, metrics_now_ns());
+    pthread_mutex_unlock(&m->mutex);
+}
+
+void profiled_mutex_cond_wait(pthread_cond_t *cond, ProfiledMutex *m, const char *site, const char *func) {
+    on_release(m, metrics_now_ns());
+    pthread_cond_wait(cond, &m->mutex);
+    on_acquired(m, site, func, metrics_now_ns(), 0, 0, NULL);
+}
+
+int profiled_mutex_list(ProfiledMutex **out, int max) {
+    int count = __atomic_load_n(&lock_count, __ATOMIC_RELAXED);
+    if (count > LOCK_REGISTRY) count = LOCK_REGISTRY;
+    int n = 0;
+    for (int i = 0; i < count && n < max; i++) {
+        ProfiledMutex *m = __atomic_load_n(&locks[i], __ATOMIC_ACQUIRE);
+        if (m) out[n++] = m;
+    }
+    return n;
+}
+
+int profiled_mutex_sites(LockSiteStats *out, int max) {
+    int n = 0;
+    for (int i = 0; i < LOCK_SITES && n < max; i++) {
+        LockSite *slot = &sites[i];
+        const ProfiledMutex *m = __atomic_load_n(&slot->lock, __ATOMIC_ACQUIRE);
+        if (!m) continue;
+        out[n].lock = m->name;
+        out[n].site = slot->site;
+        out[n].func = slot->func;
+        out[n].acquisitions = __atomic_load_n(&slot->acquisitions, __ATOMIC_RELAXED);
+        out[n].contended = __atomic_load_n(&slot->contended, __ATOMIC_RELAXED);
+        out[n].wait_ns = __atomic_load_n(&slot->wait_ns, __ATOMIC_RELAXED);
+        out[n].wait_max_ns = __atomic_load_n(&slot->wait_max_ns, __ATOMIC_RELAXED);
+        out[n].hold_ns = __atomic_load_n(&slot->hold_ns, __ATOMIC_RELAXED);
+        out[n].hold_max_ns = __atomic_load_n(&slot->hold_max_ns, __ATOMIC_RELAXED);
+        out[n].blocked_ns = __atomic_load_n(&slot->blocked_ns, __ATOMIC_RELAXED);
+        out[n].blocked_count = __atomic_load_n(&slot->blocked_count, __ATOMIC_RELAXED);
+        n++;
+    }
+    return n;
+}
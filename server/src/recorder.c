@@ -0,0 +1,113 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TRAFFIC RECORDER
+ * ============================================================================
+ * File: recorder.c
+ * Description: Log nhị phân các request cho tools/replay.c
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/game.h"
+#include "../include/metrics.h"
+#include "../include/recorder.h"
+
+/* ============================================================================
+ *                           GLOBALS
+ * ============================================================================ */
+
+int recorder_enabled = 0;
+__thread int recorder_assigned_id = 0;
+
+static FILE *record_file = NULL;
+static pthread_mutex_t record_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t record_start_ns = 0;
+static int record_dirty = 0;
+static unsigned long long record_count = 0;
+
+/* ============================================================================
+ *                           WRITER
+ * ============================================================================ */
+
+void recorder_write(const HttpRequest *req, uint64_t arrival_ns) {
+    size_t path_len = strlen(req->path);
+    size_t query_len = strlen(req->query);
+    size_t target_len = path_len + (query_len ? 1 + query_len : 0);
+    size_t body_len = req->body ? strlen(req->body) : 0;
+
+    // Phần cố định (varint + method) ghép trên stack, target và body ghi thẳng
+    uint8_t head[64];
+    size_t n = 0;
+    n += record_put_varint(head + n, arrival_ns > record_start_ns ? (arrival_ns - record_start_ns) / 1000 : 0);
+    n += record_put_varint(head + n, (uint64_t)(req->session_id > 0 ? req->session_id : 0));
+    n += record_put_varint(head + n, (uint64_t)(recorder_assigned_id > 0 ? recorder_assigned_id : 0));
+    head[n++] = (uint8_t)record_method_of(req->method);
+    n += record_put_varint(head + n, target_len);
+
+    uint8_t body_head[10];
+    size_t body_head_len = record_put_varint(body_head, body_len);
+
+    pthread_mutex_lock(&record_mutex);
+    fwrite(head, 1, n, record_file);
+    fwrite(req->path, 1, path_len, record_file);
+    if (query_len) {
+        fputc('?', record_file);
+        fwrite(req->query, 1, query_len, record_file);
+    }
+    fwrite(body_head, 1, body_head_len, record_file);
+    fwrite(req->body ? req->body : "", 1, body_len, record_file);
+    record_dirty = 1;
+    record_count++;
+    pthread_mutex_unlock(&record_mutex);
+
+    recorder_assigned_id = 0;
+}
+
+/**
+ * Flush buffer stdio định kỳ: server bị kill chỉ mất tối đa RECORD_FLUSH_MS
+ */
+static void *record_flusher(void *arg) {
+    (void)arg;
+    for (;;) {
+        usleep(RECORD_FLUSH_MS * 1000);
+        pthread_mutex_lock(&record_mutex);
+        if (record_dirty) {
+            fflush(record_file);
+            record_dirty = 0;
+        }
+        pthread_mutex_unlock(&record_mutex);
+    }
+    return NULL;
+}
+
+void recorder_init(void) {
+    const char *path = getenv(RECORD_FILE_ENV);
+    if (!path || !path[0]) return;
+
+    record_file = fopen(path, "wb");
+    if (!record_file) {
+        LOG_ERROR("RECORD", "❌ Cannot open %s", path);
+        return;
+    }
+    setvbuf(record_file, NULL, _IOFBF, 1 << 16);
+
+    uint8_t header[RECORD_HEADER_LEN];
+    memcpy(header, RECORD_MAGIC, RECORD_MAGIC_LEN);
+    uint64_t wall_ms = (uint64_t)time(NULL) * 1000;
+    for (int i = 0; i < 8; i++) header[RECORD_MAGIC_LEN + i] = (uint8_t)(wall_ms >> (8 * i));
+    fwrite(header, 1, sizeof(header), record_file);
+    fflush(record_file);
+    record_start_ns = metrics_now_ns();
+
+    pthread_t thread_id;
+    if (pthread_create(&thread_id, NULL, record_flusher, NULL) == 0) {
+        pthread_detach(thread_id);
+    }
+    recorder_enabled = 1;
+    LOG_INFO("RECORD", "📼 Recording requests to %s", path);
+}
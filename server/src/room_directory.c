@@ -0,0 +1,280 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ROOM DIRECTORY
+ * ============================================================================
+ * File: room_directory.c
+ * Description: Secondary indexes trên rooms[] dùng skip list
+ * 
+ * Các index (tất cả bắt đầu bằng status để lọc status là một range scan):
+ *   BY_STATUS : [status][room_id]
+ *   BY_FILL   : [status][player_count][room_id]
+ *   BY_ROUNDS : [status][max_rounds][room_id]
+ *   BY_NAME   : [status][tên viết thường, pad 0][room_id]
+ * 
+ * Mọi key cùng độ dài ROOM_DIR_KEY_LEN, số được encode big-endian nên
+ * memcmp cho đúng thứ tự. Cursor là key của phòng cuối trang trước, nên
+ * phân trang ổn định kể cả khi phòng được tạo/xóa giữa hai request.
+ * 
+ * Mọi hàm chạy dưới rooms_mutex.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "../include/game.h"
+#include "../include/room_helpers.h"
+#include "../include/skiplist.h"
+#include "../include/room_directory.h"
+
+/* ============================================================================
+ *                           INDEX DEFINITIONS
+ * ============================================================================ */
+
+typedef enum {
+    ROOM_DIR_BY_STATUS = 0,
+    ROOM_DIR_BY_FILL,
+    ROOM_DIR_BY_ROUNDS,
+    ROOM_DIR_BY_NAME,
+    ROOM_DIR_INDEX_COUNT
+} RoomDirIndex;
+
+static SkipList indexes[ROOM_DIR_INDEX_COUNT];
+
+// Key hiện tại của từng slot trong từng index (để xóa khi room thay đổi)
+static unsigned char slot_keys[MAX_ROOMS][ROOM_DIR_INDEX_COUNT][ROOM_DIR_KEY_LEN];
+static int slot_indexed[MAX_ROOMS];
+
+/* ============================================================================
+ *                           KEY ENCODING
+ * ============================================================================ */
+
+static void put_u16(unsigned char *p, int v) {
+    p[0] = (unsigned char)(v >> 8);
+    p[1] = (unsigned char)v;
+}
+
+static void put_u32(unsigned char *p, unsigned int v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+/**
+ * Ghi tên viết thường vào vùng attr (ROOM_NAME_LEN byte, pad 0)
+ */
+static void put_name(unsigned char *p, const char *name) {
+    memset(p, 0, ROOM_NAME_LEN);
+    for (int i = 0; i < ROOM_NAME_LEN - 1 && name[i]; i++) {
+        p[i] = (unsigned char)tolower((unsigned char)name[i]);
+    }
+}
+
+static void build_key(RoomDirIndex index, GameRoom *room, unsigned char *key) {
+    memset(key, 0, ROOM_DIR_KEY_LEN);
+    key[0] = (unsigned char)room->status;
+    
+    switch (index) {
+        case ROOM_DIR_BY_FILL:   put_u16(key + 1, room->player_count); break;
+        case ROOM_DIR_BY_ROUNDS: put_u16(key + 1, room->max_rounds); break;
+        case ROOM_DIR_BY_NAME:   put_name(key + 1, room->name); break;
+        default: break;
+    }
+    put_u32(key + ROOM_DIR_KEY_LEN - 4, (unsigned int)room->id);
+}
+
+/**
+ * Build khoảng [lo, hi] của một status trong index đã chọn
+ */
+static void build_range(RoomDirIndex index, int status, const RoomQuery *q,
+                        unsigned char *lo, unsigned char *hi) {
+    memset(lo, 0x00, ROOM_DIR_KEY_LEN);
+    memset(hi, 0xFF, ROOM_DIR_KEY_LEN);
+    lo[0] = hi[0] = (unsigned char)status;
+    
+    switch (index) {
+        case ROOM_DIR_BY_FILL:
+            put_u16(lo + 1, q->players_min >= 0 ? q->players_min : 0);
+            put_u16(hi + 1, q->players_max >= 0 ? q->players_max : 0xFFFF);
+            break;
+        case ROOM_DIR_BY_ROUNDS:
+            put_u16(lo + 1, q->rounds_min >= 0 ? q->rounds_min : 0);
+            put_u16(hi + 1, q->rounds_max >= 0 ? q->rounds_max : 0xFFFF);
+            break;
+        case ROOM_DIR_BY_NAME: {
+            // Mọi tên bắt đầu bằng prefix nằm giữa [prefix 00..] và [prefix FF..]
+            unsigned char prefix[ROOM_NAME_LEN];
+            put_name(prefix, q->name_prefix);
+            size_t len = strlen((const char *)prefix);
+            memcpy(lo + 1, prefix, len);
+            memcpy(hi + 1, prefix, len);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/* ============================================================================
+ *                           CURSOR ENCODING
+ * ============================================================================ */
+
+static void encode_cursor(RoomDirIndex index, const unsigned char *key, char *out, size_t out_size) {
+    static const char hex[] = "0123456789abcdef";
+    if (out_size < ROOM_DIR_CURSOR_LEN) {
+        if (out_size > 0) out[0] = '\0';
+        return;
+    }
+    out[0] = hex[(index >> 4) & 0xF];
+    out[1] = hex[index & 0xF];
+    for (int i = 0; i < ROOM_DIR_KEY_LEN; i++) {
+        out[2 + 2 * i] = hex[key[i] >> 4];
+        out[3 + 2 * i] = hex[key[i] & 0xF];
+    }
+    out[ROOM_DIR_CURSOR_LEN - 1] = '\0';
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @return Index tag của cursor, hoặc -1 nếu cursor sai định dạng
+ */
+static int decode_cursor(const char *cursor, unsigned char *key) {
+    if (strlen(cursor) != ROOM_DIR_CURSOR_LEN - 1) return -1;
+    
+    unsigned char bytes[1 + ROOM_DIR_KEY_LEN];
+    for (int i = 0; i < 1 + ROOM_DIR_KEY_LEN; i++) {
+        int hi = hex_value(cursor[2 * i]);
+        int lo = hex_value(cursor[2 * i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        bytes[i] = (unsigned char)((hi << 4) | lo);
+    }
+    if (bytes[0] >= ROOM_DIR_INDEX_COUNT) return -1;
+    
+    memcpy(key, bytes + 1, ROOM_DIR_KEY_LEN);
+    return bytes[0];
+}
+
+/* ============================================================================
+ *                           FILTERING
+ * ============================================================================ */
+
+static int name_has_prefix(const char *name, const char *prefix) {
+    for (; *prefix; prefix++, name++) {
+        if (tolower((unsigned char)*name) != tolower((unsigned char)*prefix)) return 0;
+    }
+    return 1;
+}
+
+static int room_matches(GameRoom *room, const RoomQuery *q) {
+    if (!(q->status_mask & (1 << room->status))) return 0;
+    if (q->players_min >= 0 && room->player_count < q->players_min) return 0;
+    if (q->players_max >= 0 && room->player_count > q->players_max) return 0;
+    if (q->rounds_min >= 0 && room->max_rounds < q->rounds_min) return 0;
+    if (q->rounds_max >= 0 && room->max_rounds > q->rounds_max) return 0;
+    if (q->only_open && room->player_count >= room->max_players) return 0;
+    if (q->arena >= 0 && room->is_arena != q->arena) return 0;
+    if (q->name_prefix[0] && !name_has_prefix(room->name, q->name_prefix)) return 0;
+    return 1;
+}
+
+static RoomDirIndex choose_index(const RoomQuery *q) {
+    if (q->name_prefix[0]) return ROOM_DIR_BY_NAME;
+    if (q->players_min >= 0 || q->players_max >= 0) return ROOM_DIR_BY_FILL;
+    if (q->rounds_min >= 0 || q->rounds_max >= 0) return ROOM_DIR_BY_ROUNDS;
+    return ROOM_DIR_BY_STATUS;
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+void init_room_directory(void) {
+    MUTEX_LOCK(&rooms_mutex);
+    for (int i = 0; i < ROOM_DIR_INDEX_COUNT; i++) {
+        skiplist_init(&indexes[i], ROOM_DIR_KEY_LEN);
+    }
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        slot_indexed[i] = 0;
+    }
+    MUTEX_UNLOCK(&rooms_mutex);
+}
+
+void room_dir_update(int room_idx) {
+    if (room_idx < 0 || room_idx >= MAX_ROOMS) return;
+    
+    GameRoom *room = &rooms[room_idx];
+    
+    if (slot_indexed[room_idx]) {
+        for (int i = 0; i < ROOM_DIR_INDEX_COUNT; i++) {
+            skiplist_remove(&indexes[i], slot_keys[room_idx][i]);
+        }
+        slot_indexed[room_idx] = 0;
+    }
+    
+    if (room->status == ROOM_EMPTY) return;
+    
+    for (int i = 0; i < ROOM_DIR_INDEX_COUNT; i++) {
+        build_key((RoomDirIndex)i, room, slot_keys[room_idx][i]);
+        skiplist_insert(&indexes[i], slot_keys[room_idx][i], room_idx);
+    }
+    slot_indexed[room_idx] = 1;
+}
+
+int room_dir_query(const RoomQuery *query, int *out_slots, int max_out,
+                   char *next_cursor, size_t cursor_size) {
+    RoomDirIndex index = choose_index(query);
+    SkipList *sl = &indexes[index];
+    
+    unsigned char cursor_key[ROOM_DIR_KEY_LEN];
+    int has_cursor = query->cursor[0] != '\0';
+    if (has_cursor && decode_cursor(query->cursor, cursor_key) != (int)index) {
+        return -1;
+    }
+    
+    int limit = query->limit < max_out ? query->limit : max_out;
+    int count = 0;
+    const unsigned char *last_key = NULL;
+    int more = 0;
+    
+    if (next_cursor && cursor_size > 0) next_cursor[0] = '\0';
+    
+    for (int status = ROOM_WAITING; status <= ROOM_FINISHED && !more; status++) {
+        if (!(query->status_mask & (1 << status))) continue;
+        
+        unsigned char lo[ROOM_DIR_KEY_LEN], hi[ROOM_DIR_KEY_LEN];
+        build_range(index, status, query, lo, hi);
+        
+        SkipNode *node;
+        if (has_cursor && memcmp(cursor_key, hi, ROOM_DIR_KEY_LEN) >= 0) {
+            continue;   // Trang trước đã đi qua hết range này
+        } else if (has_cursor && memcmp(cursor_key, lo, ROOM_DIR_KEY_LEN) >= 0) {
+            node = skiplist_upper_bound(sl, cursor_key, NULL);
+        } else {
+            node = skiplist_lower_bound(sl, lo, NULL);
+        }
+        
+        for (; node && memcmp(node->key, hi, ROOM_DIR_KEY_LEN) <= 0; node = skiplist_next(node)) {
+            GameRoom *room = &rooms[node->value];
+            if (!room_matches(room, query)) continue;
+            
+            if (count == limit) {
+                more = 1;   // Còn ít nhất một phòng => có trang kế
+                break;
+            }
+            out_slots[count++] = node->value;
+            last_key = node->key;
+        }
+    }
+    
+    if (more && last_key && next_cursor) {
+        encode_cursor(index, last_key, next_cursor, cursor_size);
+    }
+    return count;
+}
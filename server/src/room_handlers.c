@@ -13,6 +13,9 @@
 #include <pthread.h>
 #include "../include/game.h"
 #include "../include/room_helpers.h"
+#include "../include/room_directory.h"
+#include "../include/arena.h"
+#include "../include/recorder.h"
 
 /* ============================================================================
  *                           EXTERNAL VARIABLES
@@ -25,33 +28,87 @@ extern int item_count;
  * ============================================================================ */
 
 /**
- * GET /rooms - Lấy danh sách phòng
+ * Parse query string của GET /rooms thành RoomQuery
  */
-void handle_list_rooms(int sock) {
-    pthread_mutex_lock(&rooms_mutex);
-    
-    char response[BUFFER_SIZE] = "{\"action\":\"room_list\",\"rooms\":[";
-    int first = 1;
-    
-    for (int i = 0; i < MAX_ROOMS; i++) {
-        if (rooms[i].status == ROOM_WAITING || rooms[i].status == ROOM_PLAYING) {
-            char entry[512];
-            snprintf(entry, sizeof(entry),
-                "%s{\"id\":%d,\"name\":\"%s\",\"player_count\":%d,\"max_players\":%d,\"status\":\"%s\"}",
-                first ? "" : ",",
-                rooms[i].id, rooms[i].name, rooms[i].player_count, rooms[i].max_players,
-                rooms[i].status == ROOM_WAITING ? "waiting" : "playing"
-            );
-            strcat(response, entry);
-            first = 0;
-        }
+static void parse_room_query(const char *query, RoomQuery *q) {
+    char value[ROOM_DIR_CURSOR_LEN];
+    
+    memset(q, 0, sizeof(*q));
+    q->status_mask = (1 << ROOM_WAITING) | (1 << ROOM_PLAYING);
+    q->players_min = q->players_max = -1;
+    q->rounds_min = q->rounds_max = -1;
+    q->arena = -1;
+    q->limit = ROOM_LIST_DEFAULT_LIMIT;
+    
+    if (get_query_param(query, "status", value, sizeof(value))) {
+        q->status_mask = 0;
+        if (strstr(value, "waiting"))  q->status_mask |= 1 << ROOM_WAITING;
+        if (strstr(value, "playing"))  q->status_mask |= 1 << ROOM_PLAYING;
+        if (strstr(value, "finished")) q->status_mask |= 1 << ROOM_FINISHED;
     }
-    strcat(response, "]}");
     
-    pthread_mutex_unlock(&rooms_mutex);
+    get_query_param(query, "prefix", q->name_prefix, sizeof(q->name_prefix));
+    get_query_param(query, "cursor", q->cursor, sizeof(q->cursor));
     
-    send_json_response(sock, response);
-    printf("[ROOM] 📋 Room list requested\n");
+    if (get_query_param(query, "players_min", value, sizeof(value))) q->players_min = atoi(value);
+    if (get_query_param(query, "players_max", value, sizeof(value))) q->players_max = atoi(value);
+    if (get_query_param(query, "rounds_min", value, sizeof(value)))  q->rounds_min = atoi(value);
+    if (get_query_param(query, "rounds_max", value, sizeof(value)))  q->rounds_max = atoi(value);
+    if (get_query_param(query, "rounds", value, sizeof(value))) {
+        q->rounds_min = q->rounds_max = atoi(value);
+    }
+    
+    // open=1: chỉ các phòng còn chỗ
+    if (get_query_param(query, "open", value, sizeof(value))) q->only_open = atoi(value) != 0;
+    if (get_query_param(query, "arena", value, sizeof(value))) q->arena = atoi(value) != 0;
+    
+    if (get_query_param(query, "limit", value, sizeof(value))) q->limit = atoi(value);
+    if (q->limit < 1) q->limit = 1;
+    if (q->limit > ROOM_LIST_MAX_LIMIT) q->limit = ROOM_LIST_MAX_LIMIT;
+}
+
+/**
+ * GET /rooms - Lấy danh sách phòng (filter + cursor pagination)
+ */
+void handle_list_rooms(int sock, const char *query) {
+    RoomQuery q;
+    parse_room_query(query, &q);
+    
+    int slots[ROOM_LIST_MAX_LIMIT];
+    char next_cursor[ROOM_DIR_CURSOR_LEN];
+    
+    MUTEX_LOCK(&rooms_mutex);
+    
+    int count = room_dir_query(&q, slots, ROOM_LIST_MAX_LIMIT, next_cursor, sizeof(next_cursor));
+    if (count < 0) {
+        MUTEX_UNLOCK(&rooms_mutex);
+        send_json_response(sock, "{\"error\":\"Invalid cursor\"}");
+        return;
+    }
+    
+    JsonWriter response;
+    jw_init(&response);
+    jw_object_begin(&response);
+    jw_kv_str(&response, "action", "room_list");
+    jw_key(&response, "rooms");
+    jw_array_begin(&response);
+    for (int i = 0; i < count; i++) {
+        build_room_summary_json(&response, &rooms[slots[i]]);
+    }
+    jw_array_end(&response);
+    MUTEX_UNLOCK(&rooms_mutex);
+    
+    jw_key(&response, "next_cursor");
+    if (next_cursor[0]) {
+        jw_string(&response, next_cursor);
+    } else {
+        jw_null(&response);
+    }
+    jw_object_end(&response);
+    
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
+    LOG_DEBUG("ROOM", "📋 Room list requested (%d rooms)", count);
 }
 
 /**
@@ -64,62 +121,91 @@ void handle_create_room(int sock, int session_id, char *json_body) {
     }
     
     // Parse request body
-    char room_name[ROOM_NAME_LEN] = "Game Room";
-    char player_name[PLAYER_NAME_LEN] = "";
+    RequestBody body;
+    if (parse_request_body(json_body, strlen(json_body), &body) != 0) {
+        send_json_response(sock, "{\"error\":\"Invalid JSON body\"}");
+        return;
+    }
     
-    parse_json_string(json_body, "room_name", room_name, sizeof(room_name));
-    parse_json_string(json_body, "player_name", player_name, sizeof(player_name));
+    const char *room_name = body.room_name[0] ? body.room_name : "Game Room";
+    const char *player_name = body.player_name;
     
-    int max_rounds = parse_json_int(json_body, "max_rounds");
+    int max_rounds = body.max_rounds;
     if (max_rounds < 5) max_rounds = 10;
-    if (max_rounds > 50) max_rounds = 50;
+    if (max_rounds > MAX_ROUNDS_PER_GAME) max_rounds = MAX_ROUNDS_PER_GAME;
+    
+    int is_arena = body.arena != 0;
+    
+    RoomDifficulty difficulty = DIFFICULTY_RANDOM;
+    if (body.difficulty[0]) {
+        int value = wire_enum_value(&wire_room_difficulty_enum, body.difficulty);
+        if (value < 0) {
+            send_json_response(sock, "{\"error\":\"Unknown difficulty (random, ramp)\"}");
+            return;
+        }
+        difficulty = (RoomDifficulty)value;
+    }
+    
+    // Bộ lọc phải khớp catalog đang publish và còn ít nhất một cặp item
+    if (body.catalogs[0] || body.tags[0]) {
+        ItemCatalog *catalog = item_catalog_acquire();
+        Bitmap pool;
+        char error[128];
+        int rc = item_catalog_filter(catalog, body.catalogs, body.tags, &pool, error, sizeof(error));
+        uint64_t matched = rc == 0 ? bitmap_cardinality(&pool) : 0;
+        if (rc == 0) bitmap_free(&pool);
+        item_catalog_release(catalog);
+        
+        if (rc != 0 || matched < 2) {
+            JsonWriter err;
+            jw_init(&err);
+            jw_object_begin(&err);
+            jw_kv_str(&err, "error", rc != 0 ? error : "Filter matches fewer than 2 items");
+            jw_object_end(&err);
+            send_json_response(sock, jw_str(&err));
+            jw_free(&err);
+            return;
+        }
+    }
     
-    pthread_mutex_lock(&rooms_mutex);
+    MUTEX_LOCK(&rooms_mutex);
     
     // Check if already in a room
     if (is_player_in_any_room(session_id)) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"You are already in a room\"}");
         return;
     }
     
-    // Find empty slot
-    int room_idx = find_empty_room_slot();
+    // Create room with host as first player
+    int room_idx = create_room(session_id, room_name, player_name, max_rounds, is_arena, difficulty,
+                               body.catalogs, body.tags);
     if (room_idx == -1) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Server is full, no room slots available\"}");
         return;
     }
-    
-    // Initialize room
     GameRoom *room = &rooms[room_idx];
-    room->id = next_room_id++;
-    strncpy(room->name, room_name, ROOM_NAME_LEN - 1);
-    room->name[ROOM_NAME_LEN - 1] = '\0';
-    room->host_session_id = session_id;
-    room->max_players = MAX_PLAYERS_PER_ROOM;
-    room->max_rounds = max_rounds;
-    room->status = ROOM_WAITING;
-    room->player_count = 1;
-    room->current_round = 0;
-    
-    // Add host as first player
-    init_room_player(&room->players[0], session_id, player_name, 1);
-    
-    // Update SSE client
-    update_sse_client_room(session_id, room->id, player_name);
+    recorder_assigned_id = room->id;
     
     // Build response
-    char room_json[BUFFER_SIZE];
-    build_room_json(room, room_json, sizeof(room_json));
-    
-    char response[RESPONSE_SIZE];
-    snprintf(response, sizeof(response), "{\"action\":\"room_created\",\"room\":%s}", room_json);
-    
-    printf("[ROOM] 🏠 Room created: \"%s\" (ID: %d) by session %d\n", room_name, room->id, session_id);
-    
-    pthread_mutex_unlock(&rooms_mutex);
-    send_json_response(sock, response);
+    JsonWriter response;
+    jw_init(&response);
+    jw_object_begin(&response);
+    jw_kv_str(&response, "action", "room_created");
+    jw_key(&response, "room");
+    build_room_json(&response, room);
+    jw_object_end(&response);
+    
+    LOG_INFO("ROOM", "🏠 %s created: \"%s\" (ID: %d) by session %d",
+             is_arena ? "Arena" : "Room", room_name, room->id, session_id);
+    
+    MUTEX_UNLOCK(&rooms_mutex);
+    
+    // Đã có phòng: vé quick-play còn trong hàng đợi không còn ý nghĩa
+    matchmaking_cancel(session_id);
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
 }
 
 /**
@@ -132,20 +218,25 @@ void handle_join_room(int sock, int session_id, char *json_body) {
     }
     
     // Parse request body
-    int room_id = parse_json_int(json_body, "room_id");
-    char player_name[PLAYER_NAME_LEN] = "";
-    parse_json_string(json_body, "player_name", player_name, sizeof(player_name));
+    RequestBody body;
+    if (parse_request_body(json_body, strlen(json_body), &body) != 0) {
+        send_json_response(sock, "{\"error\":\"Invalid JSON body\"}");
+        return;
+    }
+    
+    int room_id = body.room_id;
+    const char *player_name = body.player_name;
     
     if (room_id == 0) {
         send_json_response(sock, "{\"error\":\"Invalid room ID\"}");
         return;
     }
     
-    pthread_mutex_lock(&rooms_mutex);
+    MUTEX_LOCK(&rooms_mutex);
     
     // Check if already in a room
     if (is_player_in_any_room(session_id)) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"You are already in a room\"}");
         return;
     }
@@ -153,7 +244,7 @@ void handle_join_room(int sock, int session_id, char *json_body) {
     // Find room
     int room_idx = find_room_index(room_id);
     if (room_idx == -1) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Room not found\"}");
         return;
     }
@@ -162,40 +253,51 @@ void handle_join_room(int sock, int session_id, char *json_body) {
     
     // Validate room state
     if (room->status != ROOM_WAITING) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Room is not accepting players (game in progress)\"}");
         return;
     }
     
-    if (room->player_count >= MAX_PLAYERS_PER_ROOM) {
-        pthread_mutex_unlock(&rooms_mutex);
+    if (room->player_count >= room->max_players) {
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"Room is full\"}");
         return;
     }
     
     // Add player
-    init_room_player(&room->players[room->player_count], session_id, player_name, 0);
-    room->player_count++;
-    
-    // Update SSE client
-    update_sse_client_room(session_id, room->id, player_name);
-    
-    // Build response
-    char room_json[BUFFER_SIZE];
-    build_room_json(room, room_json, sizeof(room_json));
-    
-    char response[RESPONSE_SIZE];
-    snprintf(response, sizeof(response), "{\"action\":\"room_joined\",\"room\":%s}", room_json);
-    
-    char notify_json[RESPONSE_SIZE];
-    snprintf(notify_json, sizeof(notify_json), "{\"action\":\"player_joined\",\"room\":%s}", room_json);
-    
-    printf("[ROOM] 👤 Player %d joined room \"%s\" (ID: %d)\n", session_id, room->name, room_id);
+    add_player_to_room(room, session_id, player_name, 0);
+    notify_room_changed(room_idx);
+    
+    // Build response (lần build room thứ hai lấy từ cache)
+    JsonWriter response, notify_json;
+    jw_init(&response);
+    jw_init(&notify_json);
+    
+    jw_object_begin(&response);
+    jw_kv_str(&response, "action", "room_joined");
+    jw_key(&response, "room");
+    build_room_json(&response, room);
+    jw_object_end(&response);
+    
+    // Arena không broadcast từng lượt join (O(N^2) message); số người có trên lobby stream
+    if (!room->is_arena) {
+        jw_object_begin(&notify_json);
+        jw_kv_str(&notify_json, "action", "player_joined");
+        jw_key(&notify_json, "room");
+        build_room_json(&notify_json, room);
+        jw_object_end(&notify_json);
+        LOG_INFO("ROOM", "👤 Player %d joined room \"%s\" (ID: %d)", session_id, room->name, room_id);
+    }
     
-    pthread_mutex_unlock(&rooms_mutex);
+    MUTEX_UNLOCK(&rooms_mutex);
     
-    send_json_response(sock, response);
-    broadcast_sse_to_room(room_id, notify_json);
+    matchmaking_cancel(session_id);
+    send_json_response(sock, jw_str(&response));
+    if (jw_len(&notify_json) > 0) {
+        broadcast_sse_to_room(room_id, jw_str(&notify_json));
+    }
+    jw_free(&response);
+    jw_free(&notify_json);
 }
 
 /**
@@ -207,14 +309,14 @@ void handle_leave_room(int sock, int session_id) {
         return;
     }
     
-    pthread_mutex_lock(&rooms_mutex);
+    MUTEX_LOCK(&rooms_mutex);
     
     // Find room with player
     int player_idx;
     int room_idx = find_room_with_player(session_id, &player_idx);
     
     if (room_idx == -1) {
-        pthread_mutex_unlock(&rooms_mutex);
+        MUTEX_UNLOCK(&rooms_mutex);
         send_json_response(sock, "{\"error\":\"You are not in any room\"}");
         return;
     }
@@ -223,42 +325,118 @@ void handle_leave_room(int sock, int session_id) {
     int room_id = room->id;
     int was_host = (room->host_session_id == session_id);
     
-    // Remove player (shift remaining players)
-    for (int i = player_idx; i < room->player_count - 1; i++) {
-        room->players[i] = room->players[i + 1];
-    }
-    room->player_count--;
+    // Remove player
+    remove_player_from_room(room, player_idx);
     
     // Update SSE client
     update_sse_client_room(session_id, -1, NULL);
     
-    char response[256];
-    char notify_json[RESPONSE_SIZE] = "";
+    const char *response;
+    JsonWriter notify_json;
+    jw_init(&notify_json);
+    RoundClose rc;
+    int round_closed = 0;
     
     if (room->player_count == 0) {
         // Room empty - delete it
-        room->status = ROOM_EMPTY;
-        room->id = 0;
-        snprintf(response, sizeof(response), "{\"action\":\"room_left\",\"message\":\"Room deleted (empty)\"}");
+        destroy_room(room_idx);
+        response = "{\"action\":\"room_left\",\"message\":\"Room deleted (empty)\"}";
     } else {
         // Assign new host if needed
         if (was_host) {
             room->host_session_id = room->players[0].session_id;
             room->players[0].is_ready = 1;
+            touch_player(room, &room->players[0]);
+        }
+        notify_room_changed(room_idx);
+        
+        if (!room->is_arena || was_host) {
+            jw_object_begin(&notify_json);
+            jw_kv_str(&notify_json, "action", "player_left");
+            jw_key(&notify_json, "room");
+            build_room_json(&notify_json, room);
+            jw_object_end(&notify_json);
         }
+        response = "{\"action\":\"room_left\",\"message\":\"Left room successfully\"}";
         
-        char room_json[BUFFER_SIZE];
-        build_room_json(room, room_json, sizeof(room_json));
-        snprintf(notify_json, sizeof(notify_json), "{\"action\":\"player_left\",\"room\":%s}", room_json);
-        snprintf(response, sizeof(response), "{\"action\":\"room_left\",\"message\":\"Left room successfully\"}");
+        // Người rời là người duy nhất chưa trả lời: round đóng ngay, không chờ
+        if (room->status == ROOM_PLAYING && count_answered_players(room) >= room->player_count) {
+            close_round_locked(room_idx, &rc);
+            round_closed = 1;
+        }
     }
     
-    printf("[ROOM] 🚪 Player %d left room ID: %d\n", session_id, room_id);
+    LOG_INFO("ROOM", "🚪 Player %d left room ID: %d", session_id, room_id);
     
-    pthread_mutex_unlock(&rooms_mutex);
+    MUTEX_UNLOCK(&rooms_mutex);
     
     send_json_response(sock, response);
-    if (strlen(notify_json) > 0) {
-        broadcast_sse_to_room(room_id, notify_json);
+    if (jw_len(&notify_json) > 0) {
+        broadcast_sse_to_room(room_id, jw_str(&notify_json));
+    }
+    jw_free(&notify_json);
+    if (round_closed) publish_round_close(&rc);
+}
+
+/**
+ * GET /rooms/player?session_id=N - Chi tiết một người chơi trong phòng của mình
+ * 
+ * Arena chỉ broadcast top K nên client lấy chi tiết người khác theo yêu cầu.
+ * Không có session_id thì trả về chính mình.
+ */
+void handle_get_room_player(int sock, int session_id, const char *query) {
+    if (session_id == 0) {
+        send_json_response(sock, "{\"error\":\"No session ID\"}");
+        return;
+    }
+    
+    int target_session = session_id;
+    char value[16];
+    if (get_query_param(query, "session_id", value, sizeof(value))) {
+        target_session = atoi(value);
+    }
+    
+    MUTEX_LOCK(&rooms_mutex);
+    
+    int room_idx = find_room_with_player(session_id, NULL);
+    if (room_idx == -1) {
+        MUTEX_UNLOCK(&rooms_mutex);
+        send_json_response(sock, "{\"error\":\"You are not in any room\"}");
+        return;
     }
+    
+    GameRoom *room = &rooms[room_idx];
+    int player_idx = find_player_in_room(room, target_session);
+    if (player_idx == -1) {
+        MUTEX_UNLOCK(&rooms_mutex);
+        send_json_response(sock, "{\"error\":\"Player not found in your room\"}");
+        return;
+    }
+    
+    JsonWriter response;
+    jw_init(&response);
+    build_arena_player_json(&response, room, player_idx);
+    
+    MUTEX_UNLOCK(&rooms_mutex);
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
+}
+
+/**
+ * GET /rooms/cache - Thống kê cache JSON của room/player
+ */
+void handle_room_cache_stats(int sock) {
+    JsonCacheStats stats;
+    json_cache_stats(&stats);
+    
+    JsonWriter response;
+    jw_init(&response);
+    jw_object_begin(&response);
+    jw_kv_str(&response, "action", "cache_stats");
+    jw_kv_int(&response, "hits", (long long)stats.hits);
+    jw_kv_int(&response, "misses", (long long)stats.misses);
+    jw_object_end(&response);
+    
+    send_json_response(sock, jw_str(&response));
+    jw_free(&response);
 }
@@ -13,6 +13,73 @@
 #include <pthread.h>
 #include "../include/game.h"
 #include "../include/room_helpers.h"
+#include "../include/room_directory.h"
+#include "../include/arena.h"
+#include "../include/room_rank.h"
+#include "../include/metrics.h"
+
+/* ============================================================================
+ *                           SESSION INDEX
+ * ============================================================================ */
+
+/**
+ * Bảng băm open addressing: session_id -> (room slot, player index)
+ * 
+ * Thay cho việc quét toàn bộ rooms x players mỗi request. Xóa dùng
+ * backward-shift nên không cần tombstone. Bảo vệ bởi rooms_mutex.
+ */
+typedef struct {
+    int session_id;                     // 0 = slot trống
+    int room_idx;
+    int player_idx;
+} SessionSlot;
+
+static SessionSlot session_index[SESSION_INDEX_SIZE];
+
+static unsigned int session_hash(int session_id) {
+    return ((unsigned int)session_id * 2654435761u) & (SESSION_INDEX_SIZE - 1);
+}
+
+static SessionSlot *session_index_find(int session_id) {
+    unsigned int i = session_hash(session_id);
+    while (session_index[i].session_id != 0) {
+        if (session_index[i].session_id == session_id) return &session_index[i];
+        i = (i + 1) & (SESSION_INDEX_SIZE - 1);
+    }
+    return NULL;
+}
+
+static void session_index_set(int session_id, int room_idx, int player_idx) {
+    unsigned int i = session_hash(session_id);
+    while (session_index[i].session_id != 0 && session_index[i].session_id != session_id) {
+        i = (i + 1) & (SESSION_INDEX_SIZE - 1);
+    }
+    session_index[i].session_id = session_id;
+    session_index[i].room_idx = room_idx;
+    session_index[i].player_idx = player_idx;
+}
+
+static void session_index_remove(int session_id) {
+    SessionSlot *slot = session_index_find(session_id);
+    if (!slot) return;
+    
+    unsigned int hole = (unsigned int)(slot - session_index);
+    unsigned int j = hole;
+    
+    // Dời các entry phía sau về lỗ trống nếu vị trí gốc của chúng không nằm giữa (hole, j]
+    while (1) {
+        j = (j + 1) & (SESSION_INDEX_SIZE - 1);
+        if (session_index[j].session_id == 0) break;
+        
+        unsigned int home = session_hash(session_index[j].session_id);
+        int between = (hole <= j) ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!between) {
+            session_index[hole] = session_index[j];
+            hole = j;
+        }
+    }
+    session_index[hole].session_id = 0;
+}
 
 /* ============================================================================
  *                           ROOM FINDER FUNCTIONS
@@ -28,25 +95,18 @@ int find_room_index(int room_id) {
 }
 
 int find_player_in_room(GameRoom *room, int session_id) {
-    for (int i = 0; i < room->player_count; i++) {
-        if (room->players[i].session_id == session_id) {
-            return i;
-        }
+    SessionSlot *slot = session_index_find(session_id);
+    if (slot && &rooms[slot->room_idx] == room) {
+        return slot->player_idx;
     }
     return -1;
 }
 
 int find_room_with_player(int session_id, int *player_idx) {
-    for (int i = 0; i < MAX_ROOMS; i++) {
-        if (rooms[i].status != ROOM_EMPTY) {
-            int p_idx = find_player_in_room(&rooms[i], session_id);
-            if (p_idx >= 0) {
-                if (player_idx) *player_idx = p_idx;
-                return i;
-            }
-        }
-    }
-    return -1;
+    SessionSlot *slot = session_index_find(session_id);
+    if (!slot) return -1;
+    if (player_idx) *player_idx = slot->player_idx;
+    return slot->room_idx;
 }
 
 int find_empty_room_slot(void) {
@@ -58,6 +118,57 @@ int find_empty_room_slot(void) {
     return -1;
 }
 
+int room_is_listed(GameRoom *room) {
+    return room->status == ROOM_WAITING || room->status == ROOM_PLAYING;
+}
+
+/**
+ * Lá tiếp theo của bộ; phòng có pool thì lá là thứ hạng trong pool
+ */
+static int draw_card(GameRoom *room, int avoid) {
+    if (bitmap_cardinality(&room->pool) == 0) return deck_next(&room->deck, avoid);
+    
+    int avoid_rank = -1;
+    if (avoid >= 0 && bitmap_contains(&room->pool, (uint32_t)avoid)) {
+        avoid_rank = (int)bitmap_rank(&room->pool, (uint32_t)avoid);
+    }
+    return (int)bitmap_select(&room->pool, (uint64_t)deck_next(&room->deck, avoid_rank));
+}
+
+/**
+ * Khoảng tỉ lệ giá của một round: nội suy tuyến tính từ EASY đến HARD
+ */
+static void difficulty_window(const GameRoom *room, int round, double *lo, double *hi) {
+    int span = room->max_rounds > 1 ? room->max_rounds : DIFFICULTY_RAMP_ROUNDS;
+    double t = (double)(round - 1) / (span - 1);
+    if (t < 0.0) t = 0.0;
+    if (t > 1.0) t = 1.0;
+    
+    *lo = DIFFICULTY_EASY_MIN_RATIO + (DIFFICULTY_HARD_MIN_RATIO - DIFFICULTY_EASY_MIN_RATIO) * t;
+    *hi = DIFFICULTY_EASY_MAX_RATIO + (DIFFICULTY_HARD_MAX_RATIO - DIFFICULTY_EASY_MAX_RATIO) * t;
+}
+
+int room_next_item(GameRoom *room) {
+    if (room->difficulty == DIFFICULTY_RAMP) {
+        double lo, hi;
+        difficulty_window(room, room->current_round, &lo, &hi);
+        // Dùng PRNG của bộ: game ramp vẫn replay được theo seed
+        const Bitmap *filter = bitmap_cardinality(&room->pool) > 0 ? &room->pool : NULL;
+        int pick = item_catalog_pick_ratio(room->items, &room->deck.rng, filter,
+                                           room->current_index_A, lo, hi);
+        if (pick >= 0) return pick;
+    }
+    return draw_card(room, room->current_index_A);
+}
+
+GameItem room_item(GameRoom *room, int index) {
+    return item_catalog_get(room->items, index);
+}
+
+int room_item_value(GameRoom *room, int index) {
+    return item_catalog_value(room->items, index);
+}
+
 int is_player_in_any_room(int session_id) {
     return find_room_with_player(session_id, NULL) >= 0;
 }
@@ -66,18 +177,197 @@ int is_player_in_any_room(int session_id) {
  *                           SSE & PLAYER HELPERS
  * ============================================================================ */
 
-void update_sse_client_room(int session_id, int room_id, const char *player_name) {
-    pthread_mutex_lock(&clients_mutex);
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (sse_clients[i].active && sse_clients[i].session_id == session_id) {
-            sse_clients[i].room_id = room_id;
-            if (player_name && strlen(player_name) > 0) {
-                strncpy(sse_clients[i].player_name, player_name, PLAYER_NAME_LEN - 1);
-            }
-            break;
+void notify_room_changed(int room_idx) {
+    room_dir_update(room_idx);
+    lobby_mark_dirty(room_idx);
+}
+
+void touch_room(GameRoom *room) {
+    room->version++;
+}
+
+void touch_player(GameRoom *room, RoomPlayer *player) {
+    player->version++;
+    room->version++;
+}
+
+int create_room(int host_session_id, const char *room_name, const char *host_name,
+                int max_rounds, int is_arena, RoomDifficulty difficulty,
+                const char *catalogs, const char *tags) {
+    int room_idx = find_empty_room_slot();
+    if (room_idx == -1) return -1;
+    
+    GameRoom *room = &rooms[room_idx];
+    room->max_players = is_arena ? ARENA_MAX_PLAYERS : MAX_PLAYERS_PER_ROOM;
+    room->players = calloc(room->max_players, sizeof(RoomPlayer));
+    if (!room->players) return -1;
+    if (room_rank_init(room) != 0) {
+        free(room->players);
+        room->players = NULL;
+        return -1;
+    }
+    
+    room->id = next_room_id++;
+    strncpy(room->name, room_name, ROOM_NAME_LEN - 1);
+    room->name[ROOM_NAME_LEN - 1] = '\0';
+    room->host_session_id = host_session_id;
+    room->is_arena = is_arena;
+    room->max_rounds = max_rounds;
+    room->difficulty = difficulty;
+    snprintf(room->catalogs, sizeof(room->catalogs), "%s", catalogs ? catalogs : "");
+    snprintf(room->tags, sizeof(room->tags), "%s", tags ? tags : "");
+    room->status = ROOM_WAITING;
+    room->player_count = 0;
+    room->current_round = 0;
+    room->answered_count = 0;
+    room->correct_count = 0;
+    room->version = 1;
+    
+    add_player_to_room(room, host_session_id, host_name, 1);
+    notify_room_changed(room_idx);
+    return room_idx;
+}
+
+void destroy_room(int room_idx) {
+    GameRoom *room = &rooms[room_idx];
+    
+    for (int i = 0; i < room->player_count; i++) {
+        session_index_remove(room->players[i].session_id);
+        json_fragment_free(&room->players[i].json);
+    }
+    json_fragment_free(&room->json);
+    item_catalog_release(room->items);
+    room->items = NULL;
+    deck_free(&room->deck);
+    bitmap_free(&room->pool);
+    room_rank_free(room);
+    free(room->players);
+    room->players = NULL;
+    room->player_count = 0;
+    room->status = ROOM_EMPTY;
+    room->id = 0;
+    notify_room_changed(room_idx);
+}
+
+void add_player_to_room(GameRoom *room, int session_id, const char *player_name, int is_host) {
+    int player_idx = room->player_count;
+    init_room_player(&room->players[player_idx], session_id, player_name, is_host);
+    room->player_count++;
+    session_index_set(session_id, (int)(room - rooms), player_idx);
+    room_rank_insert(room, &room->players[player_idx]);
+    touch_room(room);
+    update_sse_client_room(session_id, room->id, player_name);
+}
+
+void remove_player_from_room(GameRoom *room, int player_idx) {
+    RoomPlayer *player = &room->players[player_idx];
+    int room_idx = (int)(room - rooms);
+    
+    room_rank_remove(room, player);
+    if (player->has_answered) {
+        room->answered_count--;
+        if (player->last_answer_correct) room->correct_count--;
+    }
+    session_index_remove(player->session_id);
+    json_fragment_free(&player->json);
+    touch_room(room);
+    
+    int last = room->player_count - 1;
+    if (room->is_arena) {
+        // Arena: swap-remove O(1), thứ tự players không quan trọng
+        if (player_idx != last) {
+            room->players[player_idx] = room->players[last];
+            session_index_set(room->players[player_idx].session_id, room_idx, player_idx);
         }
+    } else {
+        // Phòng thường: giữ thứ tự vào phòng (shift)
+        for (int i = player_idx; i < last; i++) {
+            room->players[i] = room->players[i + 1];
+            session_index_set(room->players[i].session_id, room_idx, i);
+        }
+    }
+    room->player_count--;
+}
+
+void apply_player_answer(GameRoom *room, RoomPlayer *player, int correct, int response_time_ms) {
+    // Key xếp hạng phụ thuộc score/streak/total_response_ms: xóa trước khi đổi
+    room_rank_remove(room, player);
+    
+    player->has_answered = 1;
+    player->last_answer_correct = correct;
+    player->response_time_ms = response_time_ms;
+    if (response_time_ms > 0) {
+        player->total_response_ms += response_time_ms < MAX_RESPONSE_TIME_MS ? response_time_ms : MAX_RESPONSE_TIME_MS;
+    }
+    room->answered_count++;
+    
+    if (correct) {
+        player->score += SCORE_PER_CORRECT;
+        player->streak++;
+        room->correct_count++;
+    } else {
+        player->streak = 0;
     }
-    pthread_mutex_unlock(&clients_mutex);
+    
+    touch_player(room, player);
+    room_rank_insert(room, player);
+}
+
+void start_room_game(int room_idx) {
+    start_room_game_seeded(room_idx, prng_entropy_seed());
+}
+
+void start_room_game_seeded(int room_idx, uint64_t seed) {
+    GameRoom *room = &rooms[room_idx];
+    
+    room->status = ROOM_PLAYING;
+    room->current_round = 1;
+    
+    // Cả game dùng catalog lúc bắt đầu, kể cả khi catalog được reload giữa chừng
+    item_catalog_release(room->items);
+    room->items = item_catalog_acquire();
+    
+    // Bộ lọc được giải lại trên catalog của game này (tên có thể đổi sau reload)
+    bitmap_free(&room->pool);
+    if (room->catalogs[0] || room->tags[0]) {
+        char error[128];
+        if (item_catalog_filter(room->items, room->catalogs, room->tags, &room->pool,
+                                error, sizeof(error)) != 0 || bitmap_cardinality(&room->pool) < 2) {
+            LOG_WARN("ROOM", "⚠️  Room %d filter unusable (%s), using all items", room->id,
+                     bitmap_cardinality(&room->pool) < 2 ? "fewer than 2 items" : error);
+            bitmap_free(&room->pool);
+        }
+    }
+    int population = bitmap_cardinality(&room->pool) > 0 ? (int)bitmap_cardinality(&room->pool)
+                                                         : item_catalog_count(room->items);
+    
+    // Đủ lá cho mọi round (A của round 1 + B của mỗi round) => không lặp item
+    int needed = room->max_rounds > 0 ? room->max_rounds + 1 : ROOM_DECK_MAX;
+    deck_free(&room->deck);
+    if (deck_init(&room->deck, seed, population, needed) != 0) {
+        LOG_WARN("ROOM", "⚠️  Could not draw item deck for room %d", room->id);
+    }
+    room->current_index_A = draw_card(room, -1);
+    room->current_index_B = room_next_item(room);
+    LOG_DEBUG("ROOM", "🎲 Room %d seed %016llx (%d cards)", room->id,
+              (unsigned long long)seed, room->deck.size);
+    
+    // Reset all players
+    for (int i = 0; i < room->player_count; i++) {
+        room->players[i].score = 0;
+        room->players[i].streak = 0;
+        room->players[i].game_over = 0;
+        room->players[i].has_answered = 0;
+        room->players[i].last_answer_correct = 0;
+        room->players[i].total_response_ms = 0;
+        touch_player(room, &room->players[i]);
+    }
+    room->answered_count = 0;
+    room->correct_count = 0;
+    arm_round_deadline(room);
+    room_rank_rebuild(room);
+    
+    notify_room_changed(room_idx);
 }
 
 void init_room_player(RoomPlayer *player, int session_id, const char *name, int is_host) {
@@ -95,131 +385,240 @@ void init_room_player(RoomPlayer *player, int session_id, const char *name, int
     player->has_answered = 0;
     player->last_answer_correct = 0;
     player->response_time_ms = 0;
+    player->total_response_ms = 0;
+    player->version = 1;
+    memset(&player->json, 0, sizeof(player->json));
 }
 
 int count_answered_players(GameRoom *room) {
-    int count = 0;
-    for (int i = 0; i < room->player_count; i++) {
-        if (room->players[i].has_answered) {
-            count++;
-        }
-    }
-    return count;
+    return room->answered_count;
+}
+
+void arm_round_deadline(GameRoom *room) {
+    room->round_deadline_ns = room->is_arena
+        ? metrics_now_ns() + (uint64_t)ARENA_ROUND_DEADLINE_MS * 1000000ULL : 0;
 }
 
 void reset_round_state(GameRoom *room) {
     for (int i = 0; i < room->player_count; i++) {
         room->players[i].has_answered = 0;
+        touch_player(room, &room->players[i]);
     }
+    room->answered_count = 0;
+    room->correct_count = 0;
+    arm_round_deadline(room);
 }
 
 /* ============================================================================
- *                           JSON PARSE HELPERS
+ *                           JSON BUILDERS
  * ============================================================================ */
 
-void parse_json_string(const char *json, const char *key, char *out, size_t out_size) {
-    char search_key[64];
-    snprintf(search_key, sizeof(search_key), "\"%s\"", key);
-    
-    char *ptr = strstr(json, search_key);
-    if (!ptr) return;
+static void build_player_entry(JsonWriter *w, GameRoom *room, RoomPlayer *p) {
+    WirePlayer msg = {
+        .session_id = p->session_id,
+        .name = p->name,
+        .score = p->score,
+        .streak = p->streak,
+        .is_ready = p->is_ready,
+        .game_over = p->game_over,
+        .has_answered = p->has_answered,
+        .is_host = p->session_id == room->host_session_id,
+    };
+    wire_json_object(w, WIRE_SCHEMA(PLAYER), &msg);
+}
+
+void build_players_json(JsonWriter *w, GameRoom *room) {
+    // Arena chỉ gửi top K, chi tiết từng người lấy qua GET /rooms/player
+    RoomPlayer *top[ARENA_TOP_K];
+    int count = room->player_count;
+    if (room->is_arena) {
+        count = room_rank_top(room, top, ARENA_TOP_K);
+    }
     
-    char *value_start = strchr(ptr, ':');
-    if (!value_start) return;
+    // Scratch writer chỉ lấy khi có player phải build lại
+    JsonWriter scratch;
+    int scratch_ready = 0;
     
-    value_start++;
-    while (*value_start == ' ' || *value_start == '"') value_start++;
+    jw_array_begin(w);
+    for (int i = 0; i < count; i++) {
+        RoomPlayer *p = room->is_arena ? top[i] : &room->players[i];
+        if (!json_fragment_lookup(&p->json, p->version)) {
+            if (!scratch_ready) {
+                jw_init(&scratch);
+                scratch_ready = 1;
+            } else {
+                jw_reset(&scratch);
+            }
+            build_player_entry(&scratch, room, p);
+            
+            // Hết bộ nhớ giữa chừng: không cache bản thiếu dưới version hiện tại
+            if (jw_failed(&scratch)) {
+                build_player_entry(w, room, p);
+                continue;
+            }
+            json_fragment_store(&p->json, p->version, jw_str(&scratch), jw_len(&scratch));
+            if (!p->json.data) {
+                build_player_entry(w, room, p);
+                continue;
+            }
+        }
+        jw_raw(w, p->json.data, p->json.len);
+    }
+    jw_array_end(w);
     
-    char *value_end = strchr(value_start, '"');
-    if (!value_end) return;
+    if (scratch_ready) jw_free(&scratch);
+}
+
+void build_room_json(JsonWriter *w, GameRoom *room) {
+    if (json_fragment_lookup(&room->json, room->version)) {
+        jw_raw(w, room->json.data, room->json.len);
+        return;
+    }
     
-    int len = value_end - value_start;
-    if (len > 0 && len < (int)out_size) {
-        strncpy(out, value_start, len);
-        out[len] = '\0';
+    JsonWriter scratch;
+    jw_init(&scratch);
+    build_room_json_uncached(&scratch, room);
+    if (jw_failed(&scratch)) {
+        build_room_json_uncached(w, room);
+    } else {
+        json_fragment_store(&room->json, room->version, jw_str(&scratch), jw_len(&scratch));
+        jw_raw(w, jw_str(&scratch), jw_len(&scratch));
     }
+    jw_free(&scratch);
 }
 
-int parse_json_int(const char *json, const char *key) {
-    char search_key[64];
-    snprintf(search_key, sizeof(search_key), "\"%s\"", key);
+void build_room_json_uncached(JsonWriter *w, GameRoom *room) {
+    WireRoom msg = {
+        .id = room->id,
+        .name = room->name,
+        .host_session_id = room->host_session_id,
+        .player_count = room->player_count,
+        .max_players = room->max_players,
+        .max_rounds = room->max_rounds,
+        .status = room->status,
+        .current_round = room->current_round,
+        .arena = room->is_arena,
+        .difficulty = room->difficulty,
+        .catalogs = room->catalogs,
+        .tags = room->tags,
+    };
     
-    char *ptr = strstr(json, search_key);
-    if (!ptr) return 0;
+    jw_object_begin(w);
+    wire_json_fields(w, WIRE_SCHEMA(ROOM), &msg);
+    jw_key(w, "players");
+    build_players_json(w, room);
+    jw_object_end(w);
+}
+
+/**
+ * game_started và new_round cùng dạng: room + cặp item của round hiện tại
+ */
+static void build_round_start_json(JsonWriter *w, GameRoom *room, const char *action) {
+    GameItem itemA = room_item(room, room->current_index_A);
+    GameItem itemB = room_item(room, room->current_index_B);
     
-    char *value_start = strchr(ptr, ':');
-    if (!value_start) return 0;
+    WireRoundStart msg = {
+        .round = room->current_round,
+        .labelA = itemA.name,
+        .valueA = itemA.value,
+        .labelB = itemB.name,
+    };
     
-    return atoi(value_start + 1);
+    jw_object_begin(w);
+    jw_kv_str(w, "action", action);
+    jw_key(w, "room");
+    build_room_json(w, room);
+    wire_json_fields(w, WIRE_SCHEMA(ROUND_START), &msg);
+    jw_object_end(w);
 }
 
-/* ============================================================================
- *                           JSON BUILDERS
- * ============================================================================ */
+void build_game_started_json(JsonWriter *w, GameRoom *room) {
+    build_round_start_json(w, room, "game_started");
+}
 
-void build_players_json(GameRoom *room, char *json, size_t json_size) {
-    strcpy(json, "[");
+void build_new_round_json(JsonWriter *w, GameRoom *room) {
+    build_round_start_json(w, room, "new_round");
+}
+
+void fill_room_summary(WireRoomSummary *out, GameRoom *room) {
+    out->id = room->id;
+    out->name = room->name;
+    out->player_count = room->player_count;
+    out->max_players = room->max_players;
+    out->status = room->status;
+    out->arena = room->is_arena;
+}
+
+void build_room_summary_json(JsonWriter *w, GameRoom *room) {
+    WireRoomSummary msg;
+    fill_room_summary(&msg, room);
+    wire_json_object(w, WIRE_SCHEMA(ROOM_SUMMARY), &msg);
+}
+
+void build_leaderboard_json(JsonWriter *w, GameRoom *room) {
+    RoomPlayer *top[LEADERBOARD_TOP_K];
+    int count = room_rank_top(room, top, LEADERBOARD_TOP_K);
     
-    for (int i = 0; i < room->player_count; i++) {
-        RoomPlayer *p = &room->players[i];
-        char entry[512];
-        snprintf(entry, sizeof(entry),
-            "%s{\"session_id\":%d,\"name\":\"%s\",\"score\":%d,\"streak\":%d,"
-            "\"is_ready\":%d,\"game_over\":%d,\"has_answered\":%d,\"is_host\":%s}",
-            i > 0 ? "," : "",
-            p->session_id, p->name, p->score, p->streak,
-            p->is_ready, p->game_over, p->has_answered,
-            p->session_id == room->host_session_id ? "true" : "false"
-        );
-        
-        if (strlen(json) + strlen(entry) < json_size - 2) {
-            strcat(json, entry);
-        }
+    jw_array_begin(w);
+    for (int i = 0; i < count; i++) {
+        RoomPlayer *p = top[i];
+        WireLeaderboardEntry msg = {
+            .rank = i + 1,
+            .session_id = p->session_id,
+            .name = p->name,
+            .score = p->score,
+            .streak = p->streak,
+            .total_response_time = p->total_response_ms,
+        };
+        wire_json_object(w, WIRE_SCHEMA(LEADERBOARD_ENTRY), &msg);
     }
-    strcat(json, "]");
+    jw_array_end(w);
 }
 
-void build_room_json(GameRoom *room, char *json, size_t json_size) {
-    char players_json[4096];
-    build_players_json(room, players_json, sizeof(players_json));
-    
-    const char *status_str;
-    switch (room->status) {
-        case ROOM_WAITING:  status_str = "waiting"; break;
-        case ROOM_PLAYING:  status_str = "playing"; break;
-        case ROOM_FINISHED: status_str = "finished"; break;
-        default:            status_str = "empty"; break;
+void build_round_result_entries(JsonWriter *w, RoomPlayer **ordered, int count) {
+    jw_array_begin(w);
+    for (int i = 0; i < count; i++) {
+        RoomPlayer *p = ordered[i];
+        WireRoundResult msg = {
+            .rank = i + 1,
+            .session_id = p->session_id,
+            .name = p->name,
+            .correct = p->last_answer_correct,
+            .score = p->score,
+            .streak = p->streak,
+            .response_time = p->response_time_ms,
+        };
+        wire_json_object(w, WIRE_SCHEMA(ROUND_RESULT), &msg);
     }
-    
-    snprintf(json, json_size,
-        "{\"id\":%d,\"name\":\"%s\",\"host_session_id\":%d,\"player_count\":%d,"
-        "\"max_players\":%d,\"max_rounds\":%d,\"status\":\"%s\",\"current_round\":%d,\"players\":%s}",
-        room->id, room->name, room->host_session_id, room->player_count,
-        room->max_players, room->max_rounds, status_str, room->current_round, players_json
-    );
+    jw_array_end(w);
 }
 
-void build_round_results_json(GameRoom *room, int round, int valueB, const char *labelB, 
-                               char *json, size_t json_size) {
-    char results[2048] = "[";
+void build_round_results_json(JsonWriter *w, GameRoom *room, int round, int valueB,
+                              const char *labelB) {
+    // Kết quả theo thứ hạng hiện tại
+    RoomPlayer *ordered[MAX_PLAYERS_PER_ROOM];
+    int count = room_rank_top(room, ordered, MAX_PLAYERS_PER_ROOM);
     
-    for (int i = 0; i < room->player_count; i++) {
-        RoomPlayer *p = &room->players[i];
-        char entry[256];
-        snprintf(entry, sizeof(entry),
-            "%s{\"session_id\":%d,\"name\":\"%s\",\"correct\":%s,"
-            "\"score\":%d,\"streak\":%d,\"response_time\":%d}",
-            i > 0 ? "," : "",
-            p->session_id, p->name,
-            p->last_answer_correct ? "true" : "false",
-            p->score, p->streak, p->response_time_ms
-        );
-        strcat(results, entry);
-    }
-    strcat(results, "]");
-    
-    snprintf(json, json_size,
-        "{\"action\":\"round_results\",\"round\":%d,\"valueB\":%d,\"labelB\":\"%s\",\"results\":%s}",
-        round, valueB, labelB, results
-    );
+    WireRoundResults header = { .round = round, .valueB = valueB, .labelB = labelB };
+    
+    jw_object_begin(w);
+    wire_json_fields(w, WIRE_SCHEMA(ROUND_RESULTS), &header);
+    
+    jw_key(w, "results");
+    build_round_result_entries(w, ordered, count);
+    
+    jw_key(w, "leaderboard");
+    build_leaderboard_json(w, room);
+    // Object để mở: broadcast_sse_to_room_ranked() ghép phần đuôi
+}
+
+void build_game_finished_json(JsonWriter *w, GameRoom *room) {
+    jw_object_begin(w);
+    jw_kv_str(w, "action", "game_finished");
+    if (room->is_arena) jw_kv_bool(w, "arena", 1);
+    jw_key(w, "room");
+    build_room_json(w, room);
+    jw_key(w, "leaderboard");
+    build_leaderboard_json(w, room);
+    // Object để mở: broadcast_sse_to_room_ranked() ghép phần đuôi
 }
@@ -16,7 +16,7 @@
  * ============================================================================ */
 
 GameRoom rooms[MAX_ROOMS];                              // Mảng tất cả phòng chơi
-pthread_mutex_t rooms_mutex = PTHREAD_MUTEX_INITIALIZER; // Mutex bảo vệ rooms
+ProfiledMutex rooms_mutex = PROFILED_MUTEX_INITIALIZER("rooms_mutex"); // Mutex bảo vệ rooms
 int next_room_id = 1;                                   // ID phòng tiếp theo
 
 /* ============================================================================
@@ -24,13 +24,14 @@ int next_room_id = 1;                                   // ID phòng tiếp theo
  * ============================================================================ */
 
 void init_rooms(void) {
-    pthread_mutex_lock(&rooms_mutex);
+    MUTEX_LOCK(&rooms_mutex);
     for (int i = 0; i < MAX_ROOMS; i++) {
         rooms[i].id = 0;
         rooms[i].status = ROOM_EMPTY;
         rooms[i].player_count = 0;
         rooms[i].host_session_id = 0;
+        rooms[i].players = NULL;
     }
-    pthread_mutex_unlock(&rooms_mutex);
-    printf("[ROOM] 🏠 Room system initialized (max %d rooms)\n", MAX_ROOMS);
+    MUTEX_UNLOCK(&rooms_mutex);
+    LOG_INFO("ROOM", "🏠 Room system initialized (max %d rooms)", MAX_ROOMS);
 }
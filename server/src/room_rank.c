@@ -0,0 +1,128 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - ROOM RANKING
+ * ============================================================================
+ * File: room_rank.c
+ * Description: Bảng xếp hạng incremental của từng phòng
+ * 
+ * Mỗi câu trả lời chỉ xóa key cũ và thêm key mới của một player (O(log n)),
+ * không sắp xếp lại toàn bộ phòng. Value của node là session_id, player
+ * được tra lại qua session index (index trong players có thể đổi khi
+ * người khác rời phòng).
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../include/game.h"
+#include "../include/room_rank.h"
+#include "../include/room_helpers.h"
+
+/* ============================================================================
+ *                           KEY ENCODING
+ * ============================================================================ */
+
+static void put_u32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static uint32_t get_u32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/**
+ * Encode key sao cho memcmp tăng dần = thứ hạng tốt -> kém
+ */
+static void build_rank_key(const RoomPlayer *player, unsigned char *key) {
+    put_u32(key,      UINT32_MAX - (uint32_t)player->score);
+    put_u32(key + 4,  UINT32_MAX - (uint32_t)player->streak);
+    put_u32(key + 8,  (uint32_t)player->total_response_ms);
+    put_u32(key + 12, (uint32_t)player->session_id);
+}
+
+/* ============================================================================
+ *                           LIFECYCLE
+ * ============================================================================ */
+
+int room_rank_init(GameRoom *room) {
+    return skiplist_init(&room->ranking, ROOM_RANK_KEY_LEN);
+}
+
+void room_rank_free(GameRoom *room) {
+    skiplist_free(&room->ranking);
+}
+
+void room_rank_rebuild(GameRoom *room) {
+    skiplist_free(&room->ranking);
+    skiplist_init(&room->ranking, ROOM_RANK_KEY_LEN);
+    for (int i = 0; i < room->player_count; i++) {
+        room_rank_insert(room, &room->players[i]);
+    }
+}
+
+/* ============================================================================
+ *                           UPDATES
+ * ============================================================================ */
+
+void room_rank_insert(GameRoom *room, RoomPlayer *player) {
+    unsigned char key[ROOM_RANK_KEY_LEN];
+    build_rank_key(player, key);
+    skiplist_insert(&room->ranking, key, player->session_id);
+}
+
+void room_rank_remove(GameRoom *room, RoomPlayer *player) {
+    unsigned char key[ROOM_RANK_KEY_LEN];
+    build_rank_key(player, key);
+    skiplist_remove(&room->ranking, key);
+}
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+int room_rank_of(GameRoom *room, RoomPlayer *player) {
+    unsigned char key[ROOM_RANK_KEY_LEN];
+    build_rank_key(player, key);
+    
+    size_t ahead;
+    SkipNode *node = skiplist_lower_bound(&room->ranking, key, &ahead);
+    if (!node || node->value != player->session_id) return 0;
+    return (int)ahead + 1;
+}
+
+int room_rank_top(GameRoom *room, RoomPlayer **out, int k) {
+    int n = 0;
+    for (SkipNode *node = skiplist_first(&room->ranking); node && n < k; node = skiplist_next(node)) {
+        int player_idx = find_player_in_room(room, node->value);
+        if (player_idx >= 0) {
+            out[n++] = &room->players[player_idx];
+        }
+    }
+    return n;
+}
+
+int room_rank_snapshot(GameRoom *room, RoomRankKey *out) {
+    for (int i = 0; i < room->player_count; i++) {
+        build_rank_key(&room->players[i], out[i].key);
+    }
+    return room->player_count;
+}
+
+static int rank_key_cmp(const void *a, const void *b) {
+    return memcmp(a, b, ROOM_RANK_KEY_LEN);
+}
+
+void room_rank_resolve(RoomRankKey *keys, int n, SSE_RankEntry *out) {
+    qsort(keys, n, sizeof(RoomRankKey), rank_key_cmp);
+    
+    for (int i = 0; i < n; i++) {
+        out[i].session_id = (int)get_u32(keys[i].key + 12);
+        out[i].rank = i + 1;
+        out[i].score = (int)(UINT32_MAX - get_u32(keys[i].key));
+    }
+}
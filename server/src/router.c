@@ -16,7 +16,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <arpa/inet.h>
 #include "../include/game.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+#include "../include/recorder.h"
 
 /* ============================================================================
  *                           HTTP HELPERS
@@ -39,6 +43,130 @@ int get_session_from_request(char *request) {
     return 0; // No session ID found
 }
 
+/**
+ * Parse request line + header cần cho routing (dùng chung với bench/server_bench.c)
+ */
+void parse_http_request(char *buffer, HttpRequest *req) {
+    req->method[0] = '\0';
+    req->path[0] = '\0';
+    sscanf(buffer, "%15s %255s", req->method, req->path);
+    
+    // Tách query string khỏi path: "/rooms?status=waiting" -> "/rooms" + "status=waiting"
+    req->query = strchr(req->path, '?');
+    if (req->query) {
+        *req->query++ = '\0';
+    } else {
+        req->query = "";
+    }
+    
+    char *body_start = strstr(buffer, "\r\n\r\n");
+    req->body = body_start ? body_start + 4 : NULL;
+    req->session_id = get_session_from_request(buffer);
+}
+
+/**
+ * Lấy giá trị query parameter (URL-decode %XX và '+')
+ * 
+ * @return 1 nếu tìm thấy, 0 nếu không
+ */
+int get_query_param(const char *query, const char *name, char *out, size_t out_size) {
+    size_t name_len = strlen(name);
+    const char *p = query;
+    
+    while (p && *p) {
+        const char *end = strchr(p, '&');
+        if (!end) end = p + strlen(p);
+        
+        if ((size_t)(end - p) > name_len && strncmp(p, name, name_len) == 0 && p[name_len] == '=') {
+            const char *v = p + name_len + 1;
+            size_t len = 0;
+            while (v < end && len + 1 < out_size) {
+                if (*v == '%' && end - v >= 3) {
+                    char hex[3] = { v[1], v[2], '\0' };
+                    out[len++] = (char)strtol(hex, NULL, 16);
+                    v += 3;
+                } else {
+                    out[len++] = (*v == '+') ? ' ' : *v;
+                    v++;
+                }
+            }
+            out[len] = '\0';
+            return 1;
+        }
+        p = (*end == '&') ? end + 1 : end;
+    }
+    return 0;
+}
+
+/**
+ * Gửi response dựng sẵn (OPTIONS, 404) và đếm byte vào metrics
+ */
+static void send_raw(int sock, const char *data, size_t len) {
+    ssize_t n = write(sock, data, len);
+    if (n <= 0) {
+        metrics_add(METRIC_WRITE_ERRORS, 1);
+        return;
+    }
+    metrics_add(METRIC_BYTES_OUT, (uint64_t)n);
+}
+
+/* ============================================================================
+ *                           ADMIN ACCESS
+ * ============================================================================ */
+
+static char admin_token[ADMIN_TOKEN_MAX];
+static size_t admin_token_len = 0;
+
+void init_admin_access(void) {
+    const char *token = getenv(ADMIN_TOKEN_ENV);
+    size_t len = token ? strlen(token) : 0;
+    if (len >= ADMIN_TOKEN_MAX) {
+        LOG_WARN("SERVER", "⚠️  %s longer than %d bytes, ignored", ADMIN_TOKEN_ENV, ADMIN_TOKEN_MAX - 1);
+        len = 0;
+    }
+    memcpy(admin_token, token ? token : "", len);
+    admin_token[len] = '\0';
+    admin_token_len = len;
+    LOG_INFO("SERVER", "🔐 Admin endpoints: %s", len ? "bearer token" : "loopback only");
+}
+
+/**
+ * Endpoint vận hành lộ tên route, phòng, call site: có GAME_ADMIN_TOKEN thì
+ * cần "Authorization: Bearer <token>" (so sánh không rẽ nhánh theo byte),
+ * không thì chỉ nhận kết nối từ 127.0.0.0/8
+ * 
+ * @param headers_end Đầu body (NULL = cả buffer là header)
+ */
+static int admin_allowed(int sock, const char *buffer, const char *headers_end) {
+    if (admin_token_len == 0) {
+        struct sockaddr_in peer;
+        socklen_t len = sizeof(peer);
+        return getpeername(sock, (struct sockaddr *)&peer, &len) == 0 &&
+               peer.sin_family == AF_INET && (ntohl(peer.sin_addr.s_addr) >> 24) == 127;
+    }
+    
+    const char *h = strstr(buffer, "Authorization: Bearer ");
+    if (!h || (headers_end && h >= headers_end)) return 0;
+    h += 22; // Skip "Authorization: Bearer "
+    size_t n = strcspn(h, "\r\n");
+    if (n != admin_token_len) return 0;
+    
+    unsigned char diff = 0;
+    for (size_t i = 0; i < n; i++) diff |= (unsigned char)(h[i] ^ admin_token[i]);
+    return diff == 0;
+}
+
+static void send_forbidden(int sock) {
+    static const char response[] =
+        "HTTP/1.1 403 Forbidden\r\n"
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "{\"error\":\"Forbidden\"}";
+    send_raw(sock, response, sizeof(response) - 1);
+}
+
 /* ============================================================================
  *                           HTTP REQUEST ROUTER
  * ============================================================================ */
@@ -48,13 +176,29 @@ int get_session_from_request(char *request) {
  * 
  * Supported routes:
  *   - GET  /subscribe      -> SSE connection
- *   - GET  /rooms          -> List all rooms
+ *   - GET  /rooms          -> List rooms (filter + cursor pagination)
  *   - GET  /rooms/info     -> Get current room info
+ *   - GET  /rooms/player   -> Get one player's details (arena)
+ *   - GET  /rooms/cache    -> Room/player JSON cache hit/miss counters
  *   - POST /rooms/create   -> Create new room
  *   - POST /rooms/join     -> Join a room
  *   - POST /rooms/leave    -> Leave room
  *   - POST /rooms/start    -> Start game (host only)
  *   - POST /rooms/choice   -> Make a choice
+ *   - POST /matchmaking/join  -> Join quick-play queue
+ *   - POST /matchmaking/leave -> Leave quick-play queue
+ *   - GET  /matchmaking/stats -> Queue & time-to-match stats
+ *   - GET  /leaderboard       -> Global leaderboard (all/daily/weekly)
+ *   - POST /game              -> New single-player game (state in token)
+ *   - POST /game/choice       -> Single-player choice
+ *   - GET  /catalogs          -> Catalogs & tags for room filters
+ *   - GET  /metrics           -> Prometheus metrics (admin)
+ *   - GET  /trace             -> Sampled spans (Chrome trace-event JSON, admin)
+ *   - GET  /locks             -> Lock contention report (top-N call sites, admin)
+ * 
+ * Bảng route nằm ở METRIC_ROUTES (metrics.h); latency mỗi request
+ * (trừ /subscribe giữ kết nối mở) được ghi vào histogram của route đó.
+ * GAME_RECORD_FILE bật: request được ghi vào log replay sau khi trả lời.
  */
 void *handle_client(void *arg) {
     int client_sock = *(int *)arg;
@@ -64,120 +208,202 @@ void *handle_client(void *arg) {
     int bytes_read = read(client_sock, buffer, sizeof(buffer) - 1);
     
     if (bytes_read <= 0) {
+        metrics_add(METRIC_READ_ERRORS, 1);
         close(client_sock);
         return NULL;
     }
     
+    metrics_add(METRIC_BYTES_IN, (uint64_t)bytes_read);
     buffer[bytes_read] = '\0';
     
-    // Parse HTTP method and path
-    char method[16], path[256];
-    sscanf(buffer, "%s %s", method, path);
+    trace_request_begin();
+    uint64_t parse_start = trace_start();
+    
+    HttpRequest req;
+    parse_http_request(buffer, &req);
+    char *method = req.method, *path = req.path, *query = req.query;
+    char *body = req.body ? req.body : "";
+    int session_id = req.session_id;
+    
+    MetricRoute route = metrics_match_route(method, path);
+    uint64_t start = metrics_now_ns();
+    trace_end("parse", parse_start, session_id);
+    
+    switch (route) {
     
     /* ---------- OPTIONS (CORS Preflight) ---------- */
     
-    if (strcmp(method, "OPTIONS") == 0) {
-        char response[512];
-        snprintf(response, sizeof(response),
+    case ROUTE_OPTIONS: {
+        static const char response[] =
             "HTTP/1.1 204 No Content\r\n"
             "Access-Control-Allow-Origin: *\r\n"
             "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
             "Access-Control-Allow-Headers: Content-Type, X-Session-ID\r\n"
             "Connection: close\r\n"
-            "\r\n"
-        );
-        write(client_sock, response, strlen(response));
-        close(client_sock);
-        return NULL;
+            "\r\n";
+        send_raw(client_sock, response, sizeof(response) - 1);
+        break;
     }
     
     /* ---------- SSE ENDPOINT ---------- */
     
     // GET /subscribe - SSE Connection
-    if (strcmp(method, "GET") == 0 && strcmp(path, "/subscribe") == 0) {
+    case ROUTE_SUBSCRIBE:
+        trace_request_end();
         handle_sse_subscribe(client_sock);
+        if (recorder_enabled) recorder_write(&req, start);
         return NULL;  // KHÔNG close socket - SSE connection giữ mở
-    }
     
     /* ---------- ROOM ENDPOINTS ---------- */
     
     // GET /rooms - Lấy danh sách phòng
-    if (strcmp(method, "GET") == 0 && strcmp(path, "/rooms") == 0) {
-        handle_list_rooms(client_sock);
-        close(client_sock);
-        return NULL;
-    }
+    case ROUTE_ROOMS:
+        handle_list_rooms(client_sock, query);
+        break;
     
     // POST /rooms/create - Tạo phòng mới
-    if (strcmp(method, "POST") == 0 && strcmp(path, "/rooms/create") == 0) {
-        char *body_start = strstr(buffer, "\r\n\r\n");
-        int session_id = get_session_from_request(buffer);
-        handle_create_room(client_sock, session_id, body_start ? body_start + 4 : "");
-        close(client_sock);
-        return NULL;
-    }
+    case ROUTE_ROOMS_CREATE:
+        handle_create_room(client_sock, session_id, body);
+        break;
     
     // POST /rooms/join - Vào phòng
-    if (strcmp(method, "POST") == 0 && strcmp(path, "/rooms/join") == 0) {
-        char *body_start = strstr(buffer, "\r\n\r\n");
-        int session_id = get_session_from_request(buffer);
-        handle_join_room(client_sock, session_id, body_start ? body_start + 4 : "");
-        close(client_sock);
-        return NULL;
-    }
+    case ROUTE_ROOMS_JOIN:
+        handle_join_room(client_sock, session_id, body);
+        break;
     
     // POST /rooms/leave - Rời phòng
-    if (strcmp(method, "POST") == 0 && strcmp(path, "/rooms/leave") == 0) {
-        int session_id = get_session_from_request(buffer);
+    case ROUTE_ROOMS_LEAVE:
         handle_leave_room(client_sock, session_id);
-        close(client_sock);
-        return NULL;
-    }
+        break;
     
     // POST /rooms/start - Bắt đầu game (host only)
-    if (strcmp(method, "POST") == 0 && strcmp(path, "/rooms/start") == 0) {
-        int session_id = get_session_from_request(buffer);
+    case ROUTE_ROOMS_START:
         handle_start_game(client_sock, session_id);
-        close(client_sock);
-        return NULL;
-    }
+        break;
     
     // POST /rooms/choice - Chọn đáp án trong game
-    if (strcmp(method, "POST") == 0 && strcmp(path, "/rooms/choice") == 0) {
-        char *body_start = strstr(buffer, "\r\n\r\n");
-        int session_id = get_session_from_request(buffer);
-        if (body_start) {
-            handle_room_choice(client_sock, session_id, body_start + 4);
+    case ROUTE_ROOMS_CHOICE:
+        if (req.body) {
+            handle_room_choice(client_sock, session_id, req.body);
         } else {
             char error_json[] = "{\"error\":\"No body found\"}";
             send_json_response(client_sock, error_json);
         }
-        close(client_sock);
-        return NULL;
-    }
+        break;
     
     // GET /rooms/info - Lấy thông tin phòng hiện tại
-    if (strcmp(method, "GET") == 0 && strcmp(path, "/rooms/info") == 0) {
-        int session_id = get_session_from_request(buffer);
+    case ROUTE_ROOMS_INFO:
         handle_get_room_info(client_sock, session_id);
-        close(client_sock);
-        return NULL;
-    }
+        break;
+    
+    // GET /rooms/player - Chi tiết một người chơi (arena)
+    case ROUTE_ROOMS_PLAYER:
+        handle_get_room_player(client_sock, session_id, query);
+        break;
+    
+    // GET /rooms/cache - Thống kê cache JSON
+    case ROUTE_ROOMS_CACHE:
+        handle_room_cache_stats(client_sock);
+        break;
+    
+    /* ---------- MATCHMAKING ENDPOINTS ---------- */
+    
+    // POST /matchmaking/join - Vào hàng đợi quick-play
+    case ROUTE_MATCHMAKING_JOIN:
+        handle_matchmaking_join(client_sock, session_id, body);
+        break;
+    
+    // POST /matchmaking/leave - Rời hàng đợi
+    case ROUTE_MATCHMAKING_LEAVE:
+        handle_matchmaking_leave(client_sock, session_id);
+        break;
+    
+    // GET /matchmaking/stats - Thống kê hàng đợi
+    case ROUTE_MATCHMAKING_STATS:
+        handle_matchmaking_stats(client_sock);
+        break;
+    
+    /* ---------- CATALOG ENDPOINTS ---------- */
+    
+    // GET /catalogs - Catalog và tag đang có (cho bộ lọc của phòng)
+    case ROUTE_CATALOGS:
+        handle_get_catalogs(client_sock);
+        break;
+    
+    /* ---------- SINGLE PLAYER ENDPOINTS ---------- */
+    
+    // POST /game - Game chơi đơn mới (state nằm trong token, server không lưu)
+    case ROUTE_GAME:
+        handle_game_init(client_sock);
+        break;
+    
+    // POST /game/choice - Chọn đáp án, gửi kèm token
+    case ROUTE_GAME_CHOICE:
+        handle_player_choice(client_sock, body);
+        break;
+    
+    /* ---------- LEADERBOARD ENDPOINTS ---------- */
+    
+    // GET /leaderboard - Bảng xếp hạng toàn server
+    case ROUTE_LEADERBOARD:
+        handle_get_leaderboard(client_sock, query);
+        break;
+    
+    /* ---------- METRICS ---------- */
+    
+    // GET /metrics - Prometheus scrape (admin)
+    case ROUTE_METRICS:
+        if (admin_allowed(client_sock, buffer, req.body)) {
+            handle_metrics(client_sock);
+        } else {
+            send_forbidden(client_sock);
+        }
+        break;
+    
+    // GET /trace - Span đã sample (Chrome trace JSON, admin)
+    case ROUTE_TRACE:
+        if (admin_allowed(client_sock, buffer, req.body)) {
+            handle_trace(client_sock);
+        } else {
+            send_forbidden(client_sock);
+        }
+        break;
+    
+    // GET /locks - Top-N call site theo thời gian chờ / giữ lock (admin)
+    case ROUTE_LOCKS:
+        if (admin_allowed(client_sock, buffer, req.body)) {
+            handle_locks(client_sock, query);
+        } else {
+            send_forbidden(client_sock);
+        }
+        break;
     
     /* ---------- 404 NOT FOUND ---------- */
     
-    char not_found[512];
-    snprintf(not_found, sizeof(not_found),
-        "HTTP/1.1 404 Not Found\r\n"
-        "Content-Type: application/json\r\n"
-        "Access-Control-Allow-Origin: *\r\n"
-        "Connection: close\r\n"
-        "\r\n"
-        "{\"error\":\"Route not found: %s %s\"}",
-        method, path
-    );
-    write(client_sock, not_found, strlen(not_found));
+    case ROUTE_NOT_FOUND:
+    default: {
+        char not_found[512];
+        int len = snprintf(not_found, sizeof(not_found),
+            "HTTP/1.1 404 Not Found\r\n"
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n"
+            "Connection: close\r\n"
+            "\r\n"
+            "{\"error\":\"Route not found: %s %s\"}",
+            method, path
+        );
+        if (len >= (int)sizeof(not_found)) len = sizeof(not_found) - 1;
+        send_raw(client_sock, not_found, (size_t)len);
+        break;
+    }
+    }
+    
+    uint64_t end = metrics_now_ns();
+    metrics_observe_route(route, end - start);
+    trace_span(metrics_route_name(route), start, end, session_id);
+    trace_request_end();
     close(client_sock);
+    if (recorder_enabled) recorder_write(&req, start);
     
     return NULL;
 }
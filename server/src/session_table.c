@@ -0,0 +1,254 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - SESSION TABLE
+ * ============================================================================
+ * File: session_table.c
+ * Description: Shard + open addressing + LRU cho game chơi đơn
+ * ============================================================================
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/logger.h"
+#include "../include/session_table.h"
+
+_Static_assert(SESSION_IDLE_SEC > GAME_TOKEN_TTL_SEC,
+               "idle games must outlive their tokens or old tokens pass as new games");
+
+#define NIL                 UINT32_MAX
+#define EXPIRE_PER_CALL     2       // Dọn tối đa bấy nhiêu game idle mỗi thao tác
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef struct {
+    uint64_t game_id;
+    uint32_t next_round;
+    uint32_t last_used;             // Unix time (so được với issued_at của token)
+    uint32_t prev;                  // LRU: prev gần head (mới hơn)
+    uint32_t next;
+} SessionEntry;
+
+/**
+ * Shard - Mỗi shard nằm trên cache line riêng (lock không chia line)
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    SessionEntry *entries;
+    uint32_t *slots;                // Index entry + 1, 0 = trống
+    uint32_t slot_mask;
+    uint32_t capacity;
+    uint32_t used;                  // Entry đã từng cấp (phần sau chưa chạm)
+    uint32_t count;
+    uint32_t free_head;             // Entry đã bỏ, nối qua next
+    uint32_t head;                  // LRU: mới nhất
+    uint32_t tail;                  // LRU: cũ nhất
+    uint32_t dropped_until;         // last_used lớn nhất của game đã bị bỏ
+    unsigned long long evicted;
+    unsigned long long expired;
+    unsigned long long replays;
+    unsigned long long forgotten;
+} __attribute__((aligned(64))) SessionShard;
+
+static SessionShard shards[SESSION_TABLE_SHARDS];
+
+/* ============================================================================
+ *                           HELPERS
+ * ============================================================================ */
+
+// Wall clock như issued_at của token; đồng hồ lùi chỉ làm game trông mới hơn
+static uint32_t now_sec(void) {
+    return (uint32_t)time(NULL);
+}
+
+// game_id là seed ngẫu nhiên nhưng vẫn trộn lại (finalizer splitmix64):
+// bit cao chọn shard, bit thấp chọn slot
+static uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static SessionShard *shard_of(uint64_t hash) {
+    return &shards[(hash >> 48) & (SESSION_TABLE_SHARDS - 1)];
+}
+
+static uint32_t home_slot(const SessionShard *s, uint64_t game_id) {
+    return (uint32_t)mix(game_id) & s->slot_mask;
+}
+
+static uint32_t find_slot(const SessionShard *s, uint64_t game_id) {
+    uint32_t i = home_slot(s, game_id);
+    while (s->slots[i] != 0) {
+        if (s->entries[s->slots[i] - 1].game_id == game_id) return i;
+        i = (i + 1) & s->slot_mask;
+    }
+    return NIL;
+}
+
+// Xóa slot bằng backward-shift (như session index của room_helpers)
+static void remove_slot(SessionShard *s, uint32_t hole) {
+    uint32_t j = hole;
+    while (1) {
+        j = (j + 1) & s->slot_mask;
+        if (s->slots[j] == 0) break;
+
+        uint32_t home = home_slot(s, s->entries[s->slots[j] - 1].game_id);
+        int between = (hole <= j) ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!between) {
+            s->slots[hole] = s->slots[j];
+            hole = j;
+        }
+    }
+    s->slots[hole] = 0;
+}
+
+static void lru_unlink(SessionShard *s, uint32_t e) {
+    SessionEntry *entry = &s->entries[e];
+    if (entry->prev != NIL) s->entries[entry->prev].next = entry->next;
+    else s->head = entry->next;
+    if (entry->next != NIL) s->entries[entry->next].prev = entry->prev;
+    else s->tail = entry->prev;
+}
+
+static void lru_push_head(SessionShard *s, uint32_t e) {
+    s->entries[e].prev = NIL;
+    s->entries[e].next = s->head;
+    if (s->head != NIL) s->entries[s->head].prev = e;
+    else s->tail = e;
+    s->head = e;
+}
+
+/**
+ * Bỏ game cũ nhất (tail) khỏi bảng băm + LRU, entry vào free list
+ */
+static void drop_tail(SessionShard *s) {
+    uint32_t e = s->tail;
+    if ((int32_t)(s->entries[e].last_used - s->dropped_until) > 0) {
+        s->dropped_until = s->entries[e].last_used;
+    }
+    remove_slot(s, find_slot(s, s->entries[e].game_id));
+    lru_unlink(s, e);
+    s->entries[e].next = s->free_head;
+    s->free_head = e;
+    s->count--;
+}
+
+/**
+ * Entry trống: free list, rồi phần pool chưa dùng, cuối cùng bỏ game LRU
+ */
+static uint32_t alloc_entry(SessionShard *s) {
+    if (s->free_head == NIL && s->used == s->capacity) {
+        drop_tail(s);
+        s->evicted++;
+    }
+    if (s->free_head != NIL) {
+        uint32_t e = s->free_head;
+        s->free_head = s->entries[e].next;
+        return e;
+    }
+    return s->used++;
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+int session_table_init(uint32_t capacity) {
+    uint32_t per_shard = (capacity + SESSION_TABLE_SHARDS - 1) / SESSION_TABLE_SHARDS;
+    if (per_shard == 0) per_shard = 1;
+
+    // Load factor <= 1/2: probe ngắn kể cả khi pool đầy
+    uint32_t slot_count = 2;
+    while (slot_count < per_shard * 2) slot_count *= 2;
+
+    for (int i = 0; i < SESSION_TABLE_SHARDS; i++) {
+        SessionShard *s = &shards[i];
+        pthread_mutex_init(&s->lock, NULL);
+        // calloc: trang chưa dùng không chiếm RAM cho đến khi có game
+        s->entries = calloc(per_shard, sizeof(SessionEntry));
+        s->slots = calloc(slot_count, sizeof(uint32_t));
+        if (!s->entries || !s->slots) {
+            LOG_ERROR("SESSION", "❌ Out of memory for %u sessions", capacity);
+            return -1;
+        }
+        s->slot_mask = slot_count - 1;
+        s->capacity = per_shard;
+        s->free_head = NIL;
+        s->head = NIL;
+        s->tail = NIL;
+    }
+    LOG_INFO("SESSION", "📇 Single-player session table: %u sessions, %d shards, idle %ds",
+             per_shard * SESSION_TABLE_SHARDS, SESSION_TABLE_SHARDS, SESSION_IDLE_SEC);
+    return 0;
+}
+
+SessionStatus session_table_advance(uint64_t game_id, uint32_t round, uint32_t issued_at) {
+    SessionShard *s = shard_of(mix(game_id));
+    uint32_t now = now_sec();
+    SessionStatus status = SESSION_OK;
+
+    pthread_mutex_lock(&s->lock);
+
+    for (int n = 0; n < EXPIRE_PER_CALL && s->tail != NIL; n++) {
+        if ((int32_t)(now - s->entries[s->tail].last_used) <= SESSION_IDLE_SEC) break;
+        drop_tail(s);
+        s->expired++;
+    }
+
+    uint32_t slot = find_slot(s, game_id);
+    if (slot != NIL) {
+        uint32_t e = s->slots[slot] - 1;
+        SessionEntry *entry = &s->entries[e];
+        if (round < entry->next_round) {
+            s->replays++;
+            status = SESSION_REPLAY;
+        } else {
+            entry->next_round = round + 1;
+        }
+        entry->last_used = now;
+        lru_unlink(s, e);
+        lru_push_head(s, e);
+    } else if (round > 0 && s->dropped_until != 0 &&
+               (int32_t)(issued_at - s->dropped_until) <= 1) {
+        // Token được ký ngay sau lần dùng cuối của game (cùng giây hoặc giây sau):
+        // không mới hơn mốc bỏ => có thể là token cũ của game đã bị bỏ
+        s->forgotten++;
+        status = SESSION_FORGOTTEN;
+    } else {
+        uint32_t e = alloc_entry(s);
+        SessionEntry *entry = &s->entries[e];
+        entry->game_id = game_id;
+        entry->next_round = round + 1;
+        entry->last_used = now;
+        lru_push_head(s, e);
+
+        // Sau drop_tail, slot trống có thể đã dời: tìm lại từ home
+        uint32_t i = home_slot(s, game_id);
+        while (s->slots[i] != 0) i = (i + 1) & s->slot_mask;
+        s->slots[i] = e + 1;
+        s->count++;
+    }
+
+    pthread_mutex_unlock(&s->lock);
+    return status;
+}
+
+void session_table_stats(SessionTableStats *out) {
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < SESSION_TABLE_SHARDS; i++) {
+        SessionShard *s = &shards[i];
+        pthread_mutex_lock(&s->lock);
+        out->count += s->count;
+        out->capacity += s->capacity;
+        out->evicted += s->evicted;
+        out->expired += s->expired;
+        out->replays += s->replays;
+        out->forgotten += s->forgotten;
+        pthread_mutex_unlock(&s->lock);
+    }
+}
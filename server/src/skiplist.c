@@ -0,0 +1,235 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - INDEXED SKIP LIST
+ * ============================================================================
+ * File: skiplist.c
+ * Description: Skip list với span (rank/select O(log n))
+ * 
+ * Cách đếm rank giống sorted set của Redis: links[i].span là số node ở
+ * tầng 0 mà link tầng i nhảy qua. Cộng dồn span khi đi xuống từ head
+ * cho ra vị trí (1-based) của node đang đứng.
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/skiplist.h"
+
+/* ============================================================================
+ *                           INTERNAL HELPERS
+ * ============================================================================ */
+
+static SkipNode *create_node(int level, size_t key_len, const void *key, int value) {
+    size_t links_size = (size_t)level * sizeof(((SkipNode *)0)->links[0]);
+    SkipNode *node = malloc(sizeof(SkipNode) + links_size + key_len);
+    if (!node) return NULL;
+    
+    node->value = value;
+    node->level = level;
+    node->key = (unsigned char *)node + sizeof(SkipNode) + links_size;
+    if (key) {
+        memcpy(node->key, key, key_len);
+    } else {
+        memset(node->key, 0, key_len);
+    }
+    for (int i = 0; i < level; i++) {
+        node->links[i].next = NULL;
+        node->links[i].span = 0;
+    }
+    return node;
+}
+
+/**
+ * Chọn level ngẫu nhiên với xác suất 1/2 mỗi tầng (xorshift32)
+ */
+static int random_level(SkipList *sl) {
+    uint32_t x = sl->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sl->rng_state = x;
+    
+    int level = 1;
+    while ((x & 1) && level < SKIPLIST_MAX_LEVEL) {
+        level++;
+        x >>= 1;
+    }
+    return level;
+}
+
+/* ============================================================================
+ *                           LIFECYCLE
+ * ============================================================================ */
+
+int skiplist_init(SkipList *sl, size_t key_len) {
+    sl->head = create_node(SKIPLIST_MAX_LEVEL, key_len, NULL, 0);
+    if (!sl->head) return -1;
+    sl->key_len = key_len;
+    sl->length = 0;
+    sl->level = 1;
+    sl->rng_state = 0x9E3779B9u ^ (uint32_t)(uintptr_t)sl;
+    if (sl->rng_state == 0) sl->rng_state = 1;
+    return 0;
+}
+
+void skiplist_free(SkipList *sl) {
+    if (!sl->head) return;
+    SkipNode *node = sl->head->links[0].next;
+    while (node) {
+        SkipNode *next = node->links[0].next;
+        free(node);
+        node = next;
+    }
+    free(sl->head);
+    sl->head = NULL;
+    sl->length = 0;
+    sl->level = 1;
+}
+
+/* ============================================================================
+ *                           MODIFICATION
+ * ============================================================================ */
+
+int skiplist_insert(SkipList *sl, const void *key, int value) {
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    size_t rank[SKIPLIST_MAX_LEVEL];
+    SkipNode *x = sl->head;
+    
+    for (int i = sl->level - 1; i >= 0; i--) {
+        rank[i] = (i == sl->level - 1) ? 0 : rank[i + 1];
+        while (x->links[i].next && memcmp(x->links[i].next->key, key, sl->key_len) < 0) {
+            rank[i] += x->links[i].span;
+            x = x->links[i].next;
+        }
+        update[i] = x;
+    }
+    
+    SkipNode *next = x->links[0].next;
+    if (next && memcmp(next->key, key, sl->key_len) == 0) {
+        return -1;  // Key đã tồn tại
+    }
+    
+    int level = random_level(sl);
+    if (level > sl->level) {
+        for (int i = sl->level; i < level; i++) {
+            rank[i] = 0;
+            update[i] = sl->head;
+            update[i]->links[i].span = sl->length;
+        }
+        sl->level = level;
+    }
+    
+    x = create_node(level, sl->key_len, key, value);
+    if (!x) return -1;
+    
+    for (int i = 0; i < level; i++) {
+        x->links[i].next = update[i]->links[i].next;
+        update[i]->links[i].next = x;
+        
+        x->links[i].span = update[i]->links[i].span - (rank[0] - rank[i]);
+        update[i]->links[i].span = (rank[0] - rank[i]) + 1;
+    }
+    
+    // Các tầng cao hơn node mới: link nhảy qua thêm một node
+    for (int i = level; i < sl->level; i++) {
+        update[i]->links[i].span++;
+    }
+    
+    sl->length++;
+    return 0;
+}
+
+int skiplist_remove(SkipList *sl, const void *key) {
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    SkipNode *x = sl->head;
+    
+    for (int i = sl->level - 1; i >= 0; i--) {
+        while (x->links[i].next && memcmp(x->links[i].next->key, key, sl->key_len) < 0) {
+            x = x->links[i].next;
+        }
+        update[i] = x;
+    }
+    
+    x = x->links[0].next;
+    if (!x || memcmp(x->key, key, sl->key_len) != 0) {
+        return -1;
+    }
+    
+    for (int i = 0; i < sl->level; i++) {
+        if (update[i]->links[i].next == x) {
+            update[i]->links[i].span += x->links[i].span - 1;
+            update[i]->links[i].next = x->links[i].next;
+        } else {
+            update[i]->links[i].span--;
+        }
+    }
+    
+    while (sl->level > 1 && sl->head->links[sl->level - 1].next == NULL) {
+        sl->level--;
+    }
+    
+    free(x);
+    sl->length--;
+    return 0;
+}
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+/**
+ * Đi đến node cuối cùng thỏa (cmp < 0) hoặc (cmp <= 0)
+ * @param inclusive 0 => dừng trước key bằng, 1 => đi qua key bằng
+ */
+static SkipNode *seek(SkipList *sl, const void *key, int inclusive, size_t *rank) {
+    SkipNode *x = sl->head;
+    size_t traversed = 0;
+    
+    for (int i = sl->level - 1; i >= 0; i--) {
+        while (x->links[i].next) {
+            int cmp = memcmp(x->links[i].next->key, key, sl->key_len);
+            if (cmp < 0 || (inclusive && cmp == 0)) {
+                traversed += x->links[i].span;
+                x = x->links[i].next;
+            } else {
+                break;
+            }
+        }
+    }
+    
+    if (rank) *rank = traversed;
+    return x->links[0].next;
+}
+
+SkipNode *skiplist_lower_bound(SkipList *sl, const void *key, size_t *rank) {
+    return seek(sl, key, 0, rank);
+}
+
+SkipNode *skiplist_upper_bound(SkipList *sl, const void *key, size_t *rank) {
+    return seek(sl, key, 1, rank);
+}
+
+SkipNode *skiplist_at(SkipList *sl, size_t rank) {
+    if (rank >= sl->length) return NULL;
+    
+    size_t target = rank + 1;
+    size_t traversed = 0;
+    SkipNode *x = sl->head;
+    
+    for (int i = sl->level - 1; i >= 0; i--) {
+        while (x->links[i].next && traversed + x->links[i].span <= target) {
+            traversed += x->links[i].span;
+            x = x->links[i].next;
+        }
+        if (traversed == target) return x;
+    }
+    return NULL;
+}
+
+SkipNode *skiplist_first(SkipList *sl) {
+    return sl->head->links[0].next;
+}
+
+SkipNode *skiplist_next(SkipNode *node) {
+    return node ? node->links[0].next : NULL;
+}
@@ -11,126 +11,451 @@
  * ============================================================================
  */
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include "../include/game.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+#include "../include/recorder.h"
+
+/* ============================================================================
+ *                           CLIENT INDEX
+ * ============================================================================ */
+
+/*
+ * Mọi biến dưới đây được bảo vệ bởi clients_mutex.
+ *
+ * - session_heads: bảng băm session_id -> slot (chuỗi qua session_next)
+ * - room_heads: danh sách liên kết đôi các client theo room_id & mask;
+ *   room id tăng dần nên MAX_ROOMS phòng đang mở hầu như không chung bucket,
+ *   broadcast vẫn so room_id từng client
+ * - lobby_head: client chưa vào phòng nào (room_id == -1)
+ */
+static int session_heads[SSE_SESSION_BUCKETS];
+static int room_heads[SSE_ROOM_BUCKETS];
+static int lobby_head = -1;
+static int free_slots[MAX_CLIENTS];         // Stack slot trống
+static int free_count = 0;
+static int active_count = 0;
+static size_t queued_bytes = 0;
+static int sse_epoll_fd = -1;
+
+static int *room_list_head(int room_id) {
+    if (room_id == -1) return &lobby_head;
+    if (room_id <= 0) return NULL;
+    return &room_heads[room_id & (SSE_ROOM_BUCKETS - 1)];
+}
+
+static void link_room_locked(int slot) {
+    SSE_Client *c = &sse_clients[slot];
+    int *head = room_list_head(c->room_id);
+    c->room_prev = -1;
+    c->room_next = -1;
+    if (!head) return;
+    c->room_next = *head;
+    if (*head >= 0) sse_clients[*head].room_prev = slot;
+    *head = slot;
+}
+
+static void unlink_room_locked(int slot) {
+    SSE_Client *c = &sse_clients[slot];
+    if (c->room_prev >= 0) {
+        sse_clients[c->room_prev].room_next = c->room_next;
+    } else {
+        int *head = room_list_head(c->room_id);
+        if (head && *head == slot) *head = c->room_next;
+    }
+    if (c->room_next >= 0) sse_clients[c->room_next].room_prev = c->room_prev;
+    c->room_prev = -1;
+    c->room_next = -1;
+}
+
+static int find_slot_locked(int session_id) {
+    for (int i = session_heads[session_id & (SSE_SESSION_BUCKETS - 1)]; i >= 0; i = sse_clients[i].session_next) {
+        if (sse_clients[i].session_id == session_id) return i;
+    }
+    return -1;
+}
+
+static void unlink_session_locked(int slot) {
+    int *link = &session_heads[sse_clients[slot].session_id & (SSE_SESSION_BUCKETS - 1)];
+    while (*link >= 0 && *link != slot) link = &sse_clients[*link].session_next;
+    if (*link == slot) *link = sse_clients[slot].session_next;
+    sse_clients[slot].session_next = -1;
+}
+
+/**
+ * Theo dõi socket trên epoll của thread flush: luôn EPOLLRDHUP (client
+ * đóng tab), thêm EPOLLOUT khi queue còn byte chưa gửi.
+ * data = session << 32 | slot để bỏ qua event cũ của slot đã được dùng lại.
+ */
+static void watch_locked(int slot, int op, int want_out) {
+    SSE_Client *c = &sse_clients[slot];
+    struct epoll_event ev = {
+        .events = EPOLLRDHUP | (want_out ? EPOLLOUT : 0),
+        .data.u64 = ((uint64_t)(uint32_t)c->session_id << 32) | (uint32_t)slot
+    };
+    epoll_ctl(sse_epoll_fd, op, c->socket, &ev);
+}
+
+/**
+ * Đóng socket và trả slot (close cũng gỡ socket khỏi epoll)
+ */
+static void drop_client_locked(int slot, const char *reason) {
+    SSE_Client *c = &sse_clients[slot];
+    LOG_INFO("SSE", "❌ Client disconnected: socket %d (session %d, room %d, %s)",
+             c->socket, c->session_id, c->room_id, reason);
+    close(c->socket);
+    unlink_room_locked(slot);
+    unlink_session_locked(slot);
+    queued_bytes -= c->out_len - c->out_off;
+    free(c->out);
+    c->out = NULL;
+    c->out_off = c->out_len = c->out_cap = 0;
+    c->active = 0;
+    c->socket = -1;
+    free_slots[free_count++] = slot;
+    active_count--;
+}
+
+/* ============================================================================
+ *                           OUTPUT QUEUE
+ * ============================================================================ */
+
+/**
+ * Chép iov (bỏ skip byte đầu đã gửi) vào cuối queue của client
+ * @return 0 nếu thành công, -1 nếu vượt SSE_QUEUE_MAX_BYTES
+ */
+static int queue_locked(int slot, const struct iovec *iov, int iovcnt, size_t skip) {
+    SSE_Client *c = &sse_clients[slot];
+    size_t pending = c->out_len - c->out_off;
+    size_t add = 0;
+    for (int i = 0; i < iovcnt; i++) add += iov[i].iov_len;
+    add -= skip;
+    if (pending + add > SSE_QUEUE_MAX_BYTES) return -1;
+
+    if (c->out_off > 0) {
+        memmove(c->out, c->out + c->out_off, pending);
+        c->out_off = 0;
+        c->out_len = pending;
+    }
+    if (pending + add > c->out_cap) {
+        size_t cap = c->out_cap ? c->out_cap : 4096;
+        while (cap < pending + add) cap *= 2;
+        char *grown = realloc(c->out, cap);
+        if (!grown) return -1;
+        c->out = grown;
+        c->out_cap = cap;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        size_t len = iov[i].iov_len;
+        const char *base = iov[i].iov_base;
+        if (skip >= len) {
+            skip -= len;
+            continue;
+        }
+        memcpy(c->out + c->out_len, base + skip, len - skip);
+        c->out_len += len - skip;
+        skip = 0;
+    }
+    queued_bytes += add;
+    if (pending == 0) watch_locked(slot, EPOLL_CTL_MOD, 1);
+    return 0;
+}
+
+/**
+ * Gửi một event cho client, không bao giờ chặn
+ * 
+ * Queue rỗng: writev thẳng, phần socket chưa nhận vào queue. Queue đang có
+ * byte: cả event xếp sau để giữ thứ tự (không bao giờ có frame bị cắt).
+ * 
+ * @return Số byte event (đã gửi hoặc đã xếp hàng), -1 nếu client bị ngắt
+ */
+static ssize_t sse_send_locked(int slot, struct iovec *iov, int iovcnt) {
+    SSE_Client *c = &sse_clients[slot];
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) total += iov[i].iov_len;
+
+    size_t written = 0;
+    if (c->out_off == c->out_len) {
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = (size_t)iovcnt };
+        uint64_t write_start = trace_start();
+        ssize_t n = sendmsg(c->socket, &msg, MSG_NOSIGNAL);
+        trace_end("sse_write", write_start, c->session_id);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            drop_client_locked(slot, "write failed");
+            return -1;
+        }
+        written = n > 0 ? (size_t)n : 0;
+        if (written == total) return (ssize_t)total;
+    }
+
+    if (queue_locked(slot, iov, iovcnt, written) != 0) {
+        metrics_add(METRIC_SSE_SLOW_DROPS, 1);
+        drop_client_locked(slot, "slow reader, queue full");
+        return -1;
+    }
+    return (ssize_t)total;
+}
+
+/**
+ * Gửi tiếp queue khi socket ghi được (thread flush)
+ */
+static void flush_locked(int slot) {
+    SSE_Client *c = &sse_clients[slot];
+    while (c->out_off < c->out_len) {
+        ssize_t n = send(c->socket, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+            metrics_add(METRIC_SSE_DISCONNECTS, 1);
+            drop_client_locked(slot, "write failed");
+            return;
+        }
+        c->out_off += (size_t)n;
+        queued_bytes -= (size_t)n;
+    }
+    c->out_off = c->out_len = 0;
+    watch_locked(slot, EPOLL_CTL_MOD, 0);
+}
+
+/**
+ * Thread flush: queue của client chậm + phát hiện client đã đóng kết nối
+ */
+static void *sse_flusher(void *arg) {
+    (void)arg;
+    struct epoll_event events[256];
+    for (;;) {
+        int n = epoll_wait(sse_epoll_fd, events, 256, -1);
+        if (n <= 0) continue;
+
+        MUTEX_LOCK(&clients_mutex);
+        for (int i = 0; i < n; i++) {
+            int slot = (int)(uint32_t)events[i].data.u64;
+            int session_id = (int)(events[i].data.u64 >> 32);
+            SSE_Client *c = &sse_clients[slot];
+            if (!c->active || c->session_id != session_id) continue;   // Event của client cũ
+
+            if (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                metrics_add(METRIC_SSE_DISCONNECTS, 1);
+                drop_client_locked(slot, "closed by peer");
+            } else if (events[i].events & EPOLLOUT) {
+                flush_locked(slot);
+            }
+        }
+        MUTEX_UNLOCK(&clients_mutex);
+    }
+    return NULL;
+}
+
+void init_sse(void) {
+    for (int i = 0; i < SSE_SESSION_BUCKETS; i++) session_heads[i] = -1;
+    for (int i = 0; i < SSE_ROOM_BUCKETS; i++) room_heads[i] = -1;
+    lobby_head = -1;
+    free_count = 0;
+    for (int i = MAX_CLIENTS - 1; i >= 0; i--) {
+        sse_clients[i] = (SSE_Client){ .socket = -1, .room_prev = -1, .room_next = -1, .session_next = -1 };
+        free_slots[free_count++] = i;
+    }
+    active_count = 0;
+    queued_bytes = 0;
+
+    sse_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (sse_epoll_fd < 0) {
+        perror("epoll_create1");
+        exit(EXIT_FAILURE);
+    }
+    pthread_t thread_id;
+    if (pthread_create(&thread_id, NULL, sse_flusher, NULL) == 0) {
+        pthread_detach(thread_id);
+    }
+}
 
 /* ============================================================================
  *                           SSE SUBSCRIPTION
  * ============================================================================ */
 
+int sse_register_client(int client_sock) {
+    fcntl(client_sock, F_SETFL, fcntl(client_sock, F_GETFL, 0) | O_NONBLOCK);
+
+    MUTEX_LOCK(&clients_mutex);
+    if (free_count == 0) {
+        MUTEX_UNLOCK(&clients_mutex);
+        LOG_WARN("SSE", "⚠️  SSE client limit reached");
+        close(client_sock);
+        return -1;
+    }
+
+    int slot = free_slots[--free_count];
+    int session_id = next_session_id++;
+    SSE_Client *c = &sse_clients[slot];
+    *c = (SSE_Client){ .socket = client_sock, .active = 1, .session_id = session_id, .room_id = -1 };
+    c->session_next = session_heads[session_id & (SSE_SESSION_BUCKETS - 1)];
+    session_heads[session_id & (SSE_SESSION_BUCKETS - 1)] = slot;
+    link_room_locked(slot);
+    active_count++;
+    watch_locked(slot, EPOLL_CTL_ADD, 0);
+
+    // Message connected gửi trong lock: luôn là event đầu tiên, trước mọi broadcast lobby
+    char init_message[128];
+    int len = snprintf(init_message, sizeof(init_message),
+                       "data: {\"message\":\"Connected to SSE stream\",\"session_id\":%d}\n\n", session_id);
+    struct iovec iov = { init_message, (size_t)len };
+    int ok = sse_send_locked(slot, &iov, 1) >= 0;
+    int active = active_count;
+    MUTEX_UNLOCK(&clients_mutex);
+
+    if (!ok) return -1;
+    LOG_INFO("SSE", "✅ New client connected: socket %d | session %d | slot %d | active %d/%d",
+             client_sock, session_id, slot, active, MAX_CLIENTS);
+    return session_id;
+}
+
 /**
  * Xử lý SSE subscription request
  * 
  * Flow:
  *   1. Gửi SSE headers
- *   2. Tạo session ID mới
- *   3. Thêm client vào sse_clients array
- *   4. Gửi connected message
- *   5. Giữ connection mở
+ *   2. Tạo session ID mới, thêm client vào sse_clients + index
+ *   3. Gửi connected message
+ *   4. Giữ connection mở
  */
 void handle_sse_subscribe(int client_sock) {
-    // Send SSE headers
-    char sse_headers[512];
-    snprintf(sse_headers, sizeof(sse_headers),
+    // Send SSE headers (socket còn blocking, buffer gửi đang trống)
+    static const char sse_headers[] =
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: text/event-stream\r\n"
         "Cache-Control: no-cache\r\n"
         "Connection: keep-alive\r\n"
         "Access-Control-Allow-Origin: *\r\n"
-        "\r\n"
-    );
-    
-    write(client_sock, sse_headers, strlen(sse_headers));
-    
-    // Generate session ID and add client
-    pthread_mutex_lock(&clients_mutex);
-    
-    int session_id = next_session_id++;
-    int added = 0;
-    int active_count = 0;
-    
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (sse_clients[i].active) active_count++;
-        
-        if (!added && !sse_clients[i].active) {
-            sse_clients[i].socket = client_sock;
-            sse_clients[i].active = 1;
-            sse_clients[i].session_id = session_id;
-            sse_clients[i].room_id = -1;  // Not in any room
-            sse_clients[i].player_name[0] = '\0';  // No name yet
-            added = 1;
-            active_count++;
-            printf("\n[SSE] ✅ New client connected\n");
-            printf("      Socket: %d | Session: %d | Slot: %d\n", client_sock, session_id, i);
-            printf("      Active SSE clients: %d/%d\n", active_count, MAX_CLIENTS);
-            printf("==========================================\n");
-        }
-    }
-    
-    pthread_mutex_unlock(&clients_mutex);
-    
-    if (!added) {
-        printf("Warning: SSE client limit reached\n");
+        "\r\n";
+    if (send(client_sock, sse_headers, sizeof(sse_headers) - 1, MSG_NOSIGNAL) < 0) {
         close(client_sock);
         return;
     }
     
-    // Send initial connection message with session ID
-    char init_message[512];
-    snprintf(init_message, sizeof(init_message), 
-             "data: {\"message\":\"Connected to SSE stream\",\"session_id\":%d}\n\n", session_id);
-    write(client_sock, init_message, strlen(init_message));
+    int session_id = sse_register_client(client_sock);
+    if (session_id < 0) return;
+    
+    recorder_assigned_id = session_id;
     
     // QUAN TRỌNG: Giữ connection mở - KHÔNG close socket
-    // Socket sẽ bị close khi client disconnect hoặc broadcast fail
+    // Socket sẽ bị close khi client disconnect, gửi lỗi hoặc đọc quá chậm
+}
+
+void sse_close_session(int session_id) {
+    MUTEX_LOCK(&clients_mutex);
+    int slot = find_slot_locked(session_id);
+    if (slot >= 0) drop_client_locked(slot, "closed by server");
+    MUTEX_UNLOCK(&clients_mutex);
+}
+
+void update_sse_client_room(int session_id, int room_id, const char *player_name) {
+    MUTEX_LOCK(&clients_mutex);
+    int slot = find_slot_locked(session_id);
+    if (slot >= 0) {
+        SSE_Client *c = &sse_clients[slot];
+        unlink_room_locked(slot);
+        c->room_id = room_id;
+        link_room_locked(slot);
+        if (player_name && strlen(player_name) > 0) {
+            strncpy(c->player_name, player_name, PLAYER_NAME_LEN - 1);
+        }
+    }
+    MUTEX_UNLOCK(&clients_mutex);
+}
+
+void sse_stats(SSE_Stats *out) {
+    MUTEX_LOCK(&clients_mutex);
+    out->clients = active_count;
+    out->queued_bytes = queued_bytes;
+    MUTEX_UNLOCK(&clients_mutex);
 }
 
 /* ============================================================================
  *                           SSE BROADCAST FUNCTIONS
  * ============================================================================ */
 
+/**
+ * Chuẩn bị iovec cho một SSE event: "data: " + json + "\n\n"
+ * 
+ * JSON không bị copy hay cắt ngắn, message lớn cỡ nào cũng gửi đủ.
+ */
+static void sse_frame(struct iovec iov[3], const char *json_data, size_t json_len) {
+    static const char head[] = "data: ";
+    static const char tail[] = "\n\n";
+    iov[0].iov_base = (void *)head;
+    iov[0].iov_len = sizeof(head) - 1;
+    iov[1].iov_base = (void *)json_data;
+    iov[1].iov_len = json_len;
+    iov[2].iov_base = (void *)tail;
+    iov[2].iov_len = sizeof(tail) - 1;
+}
+
+static const char *broadcast_spans[BROADCAST_COUNT] = {
+    "sse_session", "sse_room", "sse_lobby", "sse_room_ranked"
+};
+
+/**
+ * Ghi metrics của một lần fan-out (thời gian tính cả chờ clients_mutex)
+ * và span chờ / giữ clients_mutex nếu request đang được trace
+ */
+static void sse_record_broadcast(MetricBroadcast kind, uint64_t start, uint64_t locked,
+                                 int sent, int disconnects, size_t bytes, int id) {
+    uint64_t end = metrics_now_ns();
+    metrics_observe_broadcast(kind, end - start, sent);
+    trace_span("clients_mutex wait", start, locked, id);
+    trace_span(broadcast_spans[kind], locked, end, id);
+    metrics_add(METRIC_SSE_MESSAGES, (uint64_t)sent);
+    metrics_add(METRIC_SSE_BYTES_OUT, bytes);
+    if (disconnects > 0) metrics_add(METRIC_SSE_DISCONNECTS, (uint64_t)disconnects);
+}
+
 /**
  * Gửi SSE message đến một session cụ thể
  * 
  * @param session_id Session ID cần gửi
  * @param json_data JSON data để gửi
  */
-void broadcast_sse_to_session(int session_id, char *json_data) {
-    char sse_message[BUFFER_SIZE];
+void broadcast_sse_to_session(int session_id, const char *json_data) {
+    // Format as SSE: "data: {json}\n\n" - ghép bằng writev, không copy JSON
+    struct iovec iov[3];
+    sse_frame(iov, json_data, strlen(json_data));
     
-    // Format as SSE: "data: {json}\n\n"
-    snprintf(sse_message, sizeof(sse_message), "data: %s\n\n", json_data);
-    
-    pthread_mutex_lock(&clients_mutex);
+    uint64_t start = metrics_now_ns();
+    MUTEX_LOCK(&clients_mutex);
+    uint64_t locked = trace_start();
     
     int sent = 0;
+    int disconnects = 0;
+    size_t bytes = 0;
     
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (sse_clients[i].active && sse_clients[i].session_id == session_id) {
-            int bytes_sent = write(sse_clients[i].socket, sse_message, strlen(sse_message));
-            
-            // If write fails, mark client as inactive
-            if (bytes_sent <= 0) {
-                printf("\n[SSE] ❌ Client disconnected: socket %d (session %d)\n", sse_clients[i].socket, session_id);
-                close(sse_clients[i].socket);
-                sse_clients[i].active = 0;
-            } else {
-                sent = 1;
-                printf("[SSE] 📡 Update sent to session %d\n", session_id);
-            }
-            break; // Only one client per session
+    int slot = find_slot_locked(session_id);
+    if (slot >= 0) {
+        ssize_t bytes_sent = sse_send_locked(slot, iov, 3);
+        if (bytes_sent < 0) {
+            disconnects = 1;
+        } else {
+            sent = 1;
+            bytes = (size_t)bytes_sent;
+            LOG_DEBUG("SSE", "📡 Update sent to session %d", session_id);
         }
     }
     
     if (!sent) {
-        printf("[SSE] ⚠️  No active client for session %d\n", session_id);
+        LOG_WARN("SSE", "⚠️  No active client for session %d", session_id);
     }
     
-    pthread_mutex_unlock(&clients_mutex);
+    MUTEX_UNLOCK(&clients_mutex);
+    
+    sse_record_broadcast(BROADCAST_SESSION, start, locked, sent, disconnects, bytes, session_id);
 }
 
 /**
@@ -139,34 +464,148 @@ void broadcast_sse_to_session(int session_id, char *json_data) {
  * @param room_id Room ID cần gửi
  * @param json_data JSON data để gửi
  */
-void broadcast_sse_to_room(int room_id, char *json_data) {
+void broadcast_sse_to_room(int room_id, const char *json_data) {
     if (room_id <= 0) return;
     
-    char sse_message[BUFFER_SIZE];
-    snprintf(sse_message, sizeof(sse_message), "data: %s\n\n", json_data);
+    struct iovec iov[3];
+    sse_frame(iov, json_data, strlen(json_data));
     
-    pthread_mutex_lock(&clients_mutex);
+    uint64_t start = metrics_now_ns();
+    MUTEX_LOCK(&clients_mutex);
+    uint64_t locked = trace_start();
     
     int sent_count = 0;
+    int disconnects = 0;
+    size_t bytes = 0;
     
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (sse_clients[i].active && sse_clients[i].room_id == room_id) {
-            int bytes_sent = write(sse_clients[i].socket, sse_message, strlen(sse_message));
-            
-            if (bytes_sent <= 0) {
-                printf("[SSE] ❌ Client disconnected: socket %d (session %d, room %d)\n", 
-                       sse_clients[i].socket, sse_clients[i].session_id, room_id);
-                close(sse_clients[i].socket);
-                sse_clients[i].active = 0;
-            } else {
-                sent_count++;
-            }
+    int *list = room_list_head(room_id);
+    for (int i = *list, next; i >= 0; i = next) {
+        next = sse_clients[i].room_next;        // sse_send_locked có thể gỡ client i
+        if (sse_clients[i].room_id != room_id) continue;
+        
+        ssize_t bytes_sent = sse_send_locked(i, iov, 3);
+        if (bytes_sent < 0) {
+            disconnects++;
+        } else {
+            sent_count++;
+            bytes += (size_t)bytes_sent;
         }
     }
     
-    pthread_mutex_unlock(&clients_mutex);
+    MUTEX_UNLOCK(&clients_mutex);
+    
+    sse_record_broadcast(BROADCAST_ROOM, start, locked, sent_count, disconnects, bytes, room_id);
+    
+    if (sent_count > 0) {
+        LOG_DEBUG("SSE", "📡 Broadcast to room %d: %d clients", room_id, sent_count);
+    }
+}
+
+/**
+ * Gửi SSE message đến tất cả clients đang ở lobby (room_id == -1)
+ * 
+ * @param json_data JSON data để gửi
+ */
+void broadcast_sse_to_lobby(const char *json_data) {
+    struct iovec iov[3];
+    sse_frame(iov, json_data, strlen(json_data));
+    
+    uint64_t start = metrics_now_ns();
+    MUTEX_LOCK(&clients_mutex);
+    uint64_t locked = trace_start();
+    
+    int sent_count = 0;
+    int disconnects = 0;
+    size_t bytes = 0;
+    
+    for (int i = lobby_head, next; i >= 0; i = next) {
+        next = sse_clients[i].room_next;
+        
+        ssize_t bytes_sent = sse_send_locked(i, iov, 3);
+        if (bytes_sent < 0) {
+            disconnects++;
+        } else {
+            sent_count++;
+            bytes += (size_t)bytes_sent;
+        }
+    }
+    
+    MUTEX_UNLOCK(&clients_mutex);
+    
+    sse_record_broadcast(BROADCAST_LOBBY, start, locked, sent_count, disconnects, bytes, -1);
+    
+    if (sent_count > 0) {
+        LOG_DEBUG("SSE", "📺 Lobby update: %d clients", sent_count);
+    }
+}
+
+static int rank_entry_cmp(const void *a, const void *b) {
+    const SSE_RankEntry *x = a, *y = b;
+    return (x->session_id > y->session_id) - (x->session_id < y->session_id);
+}
+
+/**
+ * Gửi message chung + phần rank riêng cho từng người chơi trong phòng
+ * 
+ * json_prefix là JSON object chưa đóng; mỗi client nhận thêm
+ * ,"my_rank":R,"my_score":S} (hoặc chỉ } nếu không có trong ranks).
+ * Phần chung chỉ build một lần, mỗi client một sendmsg (hoặc vào queue).
+ * 
+ * @param ranks Snapshot rank (sẽ bị sắp xếp lại theo session_id)
+ */
+void broadcast_sse_to_room_ranked(int room_id, const char *json_prefix, SSE_RankEntry *ranks, int rank_count) {
+    if (room_id <= 0) return;
+    
+    qsort(ranks, rank_count, sizeof(SSE_RankEntry), rank_entry_cmp);
+    
+    static const char head[] = "data: ";
+    size_t prefix_len = strlen(json_prefix);
+    
+    uint64_t start = metrics_now_ns();
+    MUTEX_LOCK(&clients_mutex);
+    uint64_t locked = trace_start();
+    
+    int sent_count = 0;
+    int disconnects = 0;
+    size_t bytes = 0;
+    
+    int *list = room_list_head(room_id);
+    for (int i = *list, next; i >= 0; i = next) {
+        next = sse_clients[i].room_next;
+        if (sse_clients[i].room_id != room_id) continue;
+        
+        SSE_RankEntry key = { .session_id = sse_clients[i].session_id };
+        SSE_RankEntry *mine = bsearch(&key, ranks, rank_count, sizeof(SSE_RankEntry), rank_entry_cmp);
+        
+        char tail[96];
+        int tail_len;
+        if (mine) {
+            tail_len = snprintf(tail, sizeof(tail), ",\"my_rank\":%d,\"my_score\":%d}\n\n",
+                                mine->rank, mine->score);
+        } else {
+            tail_len = snprintf(tail, sizeof(tail), "}\n\n");
+        }
+        
+        struct iovec iov[3] = {
+            { (void *)head, sizeof(head) - 1 },
+            { (void *)json_prefix, prefix_len },
+            { tail, (size_t)tail_len }
+        };
+        
+        ssize_t bytes_sent = sse_send_locked(i, iov, 3);
+        if (bytes_sent < 0) {
+            disconnects++;
+        } else {
+            sent_count++;
+            bytes += (size_t)bytes_sent;
+        }
+    }
+    
+    MUTEX_UNLOCK(&clients_mutex);
+    
+    sse_record_broadcast(BROADCAST_RANKED, start, locked, sent_count, disconnects, bytes, room_id);
     
     if (sent_count > 0) {
-        printf("[SSE] 📡 Broadcast to room %d: %d clients\n", room_id, sent_count);
+        LOG_DEBUG("SSE", "📡 Ranked broadcast to room %d: %d clients", room_id, sent_count);
     }
 }
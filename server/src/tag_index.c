@@ -0,0 +1,145 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TAG INDEX
+ * ============================================================================
+ * File: tag_index.c
+ * Description: Parse cột tag của catalog và build bitmap cho từng tag
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/config.h"
+#include "../include/tag_index.h"
+
+/* ============================================================================
+ *                           NAME TABLE
+ * ============================================================================ */
+
+static uint32_t hash_tag(const char *name, size_t len) {
+    uint32_t h = 2166136261u;               // FNV-1a
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return h;
+}
+
+static int rehash(TagIndex *index, int new_count) {
+    int *slots = calloc(new_count, sizeof(int));
+    if (!slots) return -1;
+    free(index->slots);
+    index->slots = slots;
+    index->slot_count = new_count;
+
+    for (int i = 0; i < index->count; i++) {
+        const char *name = index->entries[i].name;
+        uint32_t s = hash_tag(name, strlen(name)) & (new_count - 1);
+        while (slots[s]) s = (s + 1) & (new_count - 1);
+        slots[s] = i + 1;
+    }
+    return 0;
+}
+
+static int find_tag(const TagIndex *index, const char *name, size_t len) {
+    if (index->slot_count == 0) return -1;
+    uint32_t s = hash_tag(name, len) & (index->slot_count - 1);
+    while (index->slots[s]) {
+        const char *candidate = index->entries[index->slots[s] - 1].name;
+        if (strncmp(candidate, name, len) == 0 && candidate[len] == '\0') return index->slots[s] - 1;
+        s = (s + 1) & (index->slot_count - 1);
+    }
+    return -1;
+}
+
+static TagEntry *find_or_add_tag(TagIndex *index, const char *name, size_t len) {
+    int idx = find_tag(index, name, len);
+    if (idx >= 0) return &index->entries[idx];
+
+    if (index->count == index->cap) {
+        int new_cap = index->cap ? index->cap * 2 : 64;
+        TagEntry *grown = realloc(index->entries, new_cap * sizeof(TagEntry));
+        if (!grown) return NULL;
+        index->entries = grown;
+        index->cap = new_cap;
+    }
+
+    char *copy = malloc(len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, name, len);
+    copy[len] = '\0';
+
+    idx = index->count++;
+    index->entries[idx].name = copy;
+    bitmap_init(&index->entries[idx].items);
+
+    // Giữ load factor <= 1/2
+    if (index->count * 2 > index->slot_count) {
+        if (rehash(index, index->slot_count ? index->slot_count * 2 : 128) != 0) {
+            index->count--;
+            free(copy);
+            return NULL;
+        }
+    } else {
+        uint32_t s = hash_tag(name, len) & (index->slot_count - 1);
+        while (index->slots[s]) s = (s + 1) & (index->slot_count - 1);
+        index->slots[s] = idx + 1;
+    }
+    return &index->entries[idx];
+}
+
+/* ============================================================================
+ *                           PUBLIC API
+ * ============================================================================ */
+
+void tag_index_init(TagIndex *index) {
+    memset(index, 0, sizeof(*index));
+}
+
+void tag_index_free(TagIndex *index) {
+    for (int i = 0; i < index->count; i++) {
+        free(index->entries[i].name);
+        bitmap_free(&index->entries[i].items);
+    }
+    free(index->entries);
+    free(index->slots);
+    memset(index, 0, sizeof(*index));
+}
+
+int tag_index_add_catalog(TagIndex *index, const Catalog *catalog, uint32_t base) {
+    for (uint32_t i = 0; i < catalog->count; i++) {
+        const char *p = catalog_item_tags(catalog, i);
+
+        while (*p) {
+            // Tag cách nhau bởi dấu phẩy, bỏ khoảng trắng hai đầu
+            while (*p == ' ' || *p == ',') p++;
+            const char *start = p;
+            while (*p && *p != ',') p++;
+            const char *end = p;
+            while (end > start && end[-1] == ' ') end--;
+
+            size_t len = (size_t)(end - start);
+            if (len == 0 || len >= TAG_NAME_LEN) continue;
+
+            TagEntry *tag = find_or_add_tag(index, start, len);
+            if (!tag) return -1;
+            // Tag lặp lại trong cùng item: bitmap_add từ chối, bỏ qua
+            if (tag->items.cardinality > 0 && tag->items.max == base + i) continue;
+            if (bitmap_add(&tag->items, base + i) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+int tag_index_merge(TagIndex *dst, const TagIndex *src, uint32_t offset) {
+    for (int i = 0; i < src->count; i++) {
+        const TagEntry *s = &src->entries[i];
+        TagEntry *d = find_or_add_tag(dst, s->name, strlen(s->name));
+        if (!d || bitmap_append_shifted(&d->items, &s->items, offset) != 0) return -1;
+    }
+    return 0;
+}
+
+const Bitmap *tag_index_find(const TagIndex *index, const char *name) {
+    int idx = find_tag(index, name, strlen(name));
+    return idx >= 0 ? &index->entries[idx].items : NULL;
+}
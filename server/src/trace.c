@@ -0,0 +1,220 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TRACING
+ * ============================================================================
+ * File: trace.c
+ * Description: Ring span ghi đè + dump Chrome trace-event JSON
+ * ============================================================================
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include "../include/game.h"
+#include "../include/json_writer.h"
+#include "../include/trace.h"
+
+#define SPAN_MASK (TRACE_BUFFER_SPANS - 1)
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+/**
+ * TraceSlot - Một span đã đóng
+ *
+ * seq == vị trí + 1 khi ghi xong, 0 trong lúc đang ghi (dump đọc kiểu
+ * seqlock: seq trước và sau khi copy phải khớp).
+ */
+typedef struct {
+    uint64_t seq;
+    uint64_t start_ns;                  // CLOCK_MONOTONIC
+    uint64_t dur_ns;
+    const char *name;                   // Chuỗi hằng
+    int64_t arg;                        // Room / session id
+    int tid;
+} TraceSlot;
+
+typedef struct {
+    uint64_t head __attribute__((aligned(64)));     // Vị trí tiếp theo (fetch_add)
+    TraceSlot slots[TRACE_BUFFER_SPANS];
+} TraceRing;
+
+/* ============================================================================
+ *                           GLOBALS
+ * ============================================================================ */
+
+__thread int trace_sampled = 0;
+int trace_sample_every = 0;
+
+static TraceRing rings[TRACE_BUFFERS];
+static unsigned int next_ring = 0;
+static unsigned long long request_counter = 0;
+static __thread int thread_ring = -1;
+static __thread int thread_tid = 0;
+
+static int dump_pipe[2] = { -1, -1 };  // Self-pipe: handler SIGUSR2 -> thread dump
+
+/* ============================================================================
+ *                           RECORDING
+ * ============================================================================ */
+
+void trace_request_begin(void) {
+    int every = __atomic_load_n(&trace_sample_every, __ATOMIC_RELAXED);
+    trace_sampled = every > 0 &&
+        __atomic_fetch_add(&request_counter, 1, __ATOMIC_RELAXED) % (unsigned)every == 0;
+}
+
+void trace_span(const char *name, uint64_t start, uint64_t end, int64_t arg) {
+    if (!trace_sampled || start == 0 || end < start) return;
+
+    if (thread_ring < 0) {
+        thread_ring = (int)(__atomic_fetch_add(&next_ring, 1, __ATOMIC_RELAXED) % TRACE_BUFFERS);
+        thread_tid = (int)syscall(SYS_gettid);
+    }
+    TraceRing *ring = &rings[thread_ring];
+
+    uint64_t pos = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    TraceSlot *slot = &ring->slots[pos & SPAN_MASK];
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->start_ns = start;
+    slot->dur_ns = end - start;
+    slot->name = name;
+    slot->arg = arg;
+    slot->tid = thread_tid;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+/* ============================================================================
+ *                           EXPORT
+ * ============================================================================ */
+
+static void jw_kv_us(JsonWriter *w, const char *key, uint64_t ns) {
+    char num[32];
+    int len = snprintf(num, sizeof(num), "%llu.%03llu",
+                       (unsigned long long)(ns / 1000), (unsigned long long)(ns % 1000));
+    jw_key(w, key);
+    jw_raw(w, num, (size_t)len);
+}
+
+/**
+ * {"traceEvents":[{"name","cat","ph":"X","ts","dur","pid","tid","args"}...],...}
+ * @return Số span đã ghi
+ */
+static int write_trace(JsonWriter *w) {
+    int spans = 0;
+    uint64_t overwritten = 0;
+
+    jw_object_begin(w);
+    jw_key(w, "traceEvents");
+    jw_array_begin(w);
+    for (int r = 0; r < TRACE_BUFFERS; r++) {
+        TraceRing *ring = &rings[r];
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t first = head > TRACE_BUFFER_SPANS ? head - TRACE_BUFFER_SPANS : 0;
+        overwritten += first;
+
+        for (uint64_t pos = first; pos < head; pos++) {
+            TraceSlot *slot = &ring->slots[pos & SPAN_MASK];
+            uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+            if (seq != pos + 1) continue;           // Đang ghi hoặc đã bị ghi đè
+            TraceSlot copy = *slot;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) continue;
+
+            jw_object_begin(w);
+            jw_kv_str(w, "name", copy.name);
+            jw_kv_str(w, "cat", "game");
+            jw_kv_str(w, "ph", "X");
+            jw_kv_us(w, "ts", copy.start_ns);
+            jw_kv_us(w, "dur", copy.dur_ns);
+            jw_kv_int(w, "pid", 1);
+            jw_kv_int(w, "tid", copy.tid);
+            jw_key(w, "args");
+            jw_object_begin(w);
+            jw_kv_int(w, "id", copy.arg);
+            jw_object_end(w);
+            jw_object_end(w);
+            spans++;
+        }
+    }
+    jw_array_end(w);
+    jw_kv_str(w, "displayTimeUnit", "ms");
+    jw_key(w, "otherData");
+    jw_object_begin(w);
+    jw_kv_int(w, "sample_every", __atomic_load_n(&trace_sample_every, __ATOMIC_RELAXED));
+    jw_kv_int(w, "spans", spans);
+    jw_kv_int(w, "overwritten", (long long)overwritten);
+    jw_object_end(w);
+    jw_object_end(w);
+    return spans;
+}
+
+void handle_trace(int sock) {
+    JsonWriter w;
+    jw_init(&w);
+    write_trace(&w);
+    send_response(sock, "application/json", jw_str(&w), jw_len(&w));
+    jw_free(&w);
+}
+
+/* ============================================================================
+ *                           SIGNAL DUMP
+ * ============================================================================ */
+
+static void on_dump_signal(int sig) {
+    (void)sig;
+    char c = 1;
+    ssize_t n = write(dump_pipe[1], &c, 1);     // Async-signal-safe
+    (void)n;
+}
+
+static void *trace_dumper(void *arg) {
+    (void)arg;
+    const char *path = getenv(TRACE_FILE_ENV);
+    if (!path) path = TRACE_FILE_DEFAULT;
+
+    char c;
+    while (read(dump_pipe[0], &c, 1) > 0) {
+        JsonWriter w;
+        jw_init(&w);
+        int spans = write_trace(&w);
+        FILE *file = fopen(path, "w");
+        if (file) {
+            fwrite(jw_str(&w), 1, jw_len(&w), file);
+            fclose(file);
+            LOG_INFO("TRACE", "🧵 %d spans written to %s", spans, path);
+        } else {
+            LOG_ERROR("TRACE", "❌ Cannot write %s", path);
+        }
+        jw_free(&w);
+    }
+    return NULL;
+}
+
+void trace_init(void) {
+    const char *sample = getenv(TRACE_SAMPLE_ENV);
+    if (sample) trace_sample_every = atoi(sample) > 0 ? atoi(sample) : 0;
+
+    if (pipe(dump_pipe) != 0) return;
+    pthread_t thread_id;
+    if (pthread_create(&thread_id, NULL, trace_dumper, NULL) != 0) return;
+    pthread_detach(thread_id);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_dump_signal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR2, &sa, NULL);
+
+    if (trace_sample_every > 0) {
+        LOG_INFO("TRACE", "🧵 Tracing 1/%d requests (GET /trace, SIGUSR2 -> %s)",
+                 trace_sample_every, getenv(TRACE_FILE_ENV) ? getenv(TRACE_FILE_ENV) : TRACE_FILE_DEFAULT);
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - VALUE INDEX
+ * ============================================================================
+ * File: value_index.c
+ * Description: Radix sort item theo value + chọn item theo khoảng tỉ lệ
+ *
+ * Sort: LSD radix 3 lượt x 11 bit trên key = value ^ 0x80000000 (thứ tự
+ * không dấu trùng thứ tự có dấu). Lượt nào mọi key cùng digit thì bỏ qua
+ * (giá tiền thường không dùng tới 11 bit cao).
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include "../include/value_index.h"
+
+#define RADIX_BITS      11
+#define RADIX_BUCKETS   (1u << RADIX_BITS)
+#define RADIX_PASSES    3
+#define PICK_ATTEMPTS   8           // Số lần rút lại khi trúng except / ngoài filter
+#define PICK_MAX_ATTEMPTS 1024      // Filter thưa: số lần rút tăng theo 1 / mật độ, tối đa chừng này
+#define PICK_SCAN_LIMIT 4096        // Khoảng ứng viên nhỏ hơn: duyệt hết thay vì rút ngẫu nhiên
+
+/* ============================================================================
+ *                           BUILD
+ * ============================================================================ */
+
+int value_index_build(ValueIndex *index, const ItemStore *store) {
+    index->values = NULL;
+    index->items = NULL;
+    index->count = 0;
+    if (store->count == 0 || store->count > INT32_MAX) return store->count == 0 ? 0 : -1;
+    int count = (int)store->count;
+
+    size_t n = (size_t)count;
+    uint32_t *keys = malloc(sizeof(uint32_t) * n);
+    uint32_t *items = malloc(sizeof(uint32_t) * n);
+    uint32_t *tmp_keys = malloc(sizeof(uint32_t) * n);
+    uint32_t *tmp_items = malloc(sizeof(uint32_t) * n);
+    size_t *hist = malloc(sizeof(size_t) * RADIX_BUCKETS);
+    if (!keys || !items || !tmp_keys || !tmp_items || !hist) {
+        free(keys);
+        free(items);
+        free(tmp_keys);
+        free(tmp_items);
+        free(hist);
+        return -1;
+    }
+
+    for (int p = 0; p < store->part_count; p++) {
+        const int32_t *values = store->parts[p].values;
+        uint32_t base = store->bases[p];
+        for (uint32_t j = 0; j < store->parts[p].count; j++) {
+            keys[base + j] = (uint32_t)values[j] ^ 0x80000000u;
+            items[base + j] = base + j;
+        }
+    }
+
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        int shift = pass * RADIX_BITS;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++) hist[b] = 0;
+        for (size_t i = 0; i < n; i++) hist[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        if (hist[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n) continue;
+
+        size_t sum = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++) {
+            size_t c = hist[b];
+            hist[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            size_t dst = hist[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            tmp_keys[dst] = keys[i];
+            tmp_items[dst] = items[i];
+        }
+
+        uint32_t *t = keys; keys = tmp_keys; tmp_keys = t;
+        t = items; items = tmp_items; tmp_items = t;
+    }
+    free(tmp_keys);
+    free(tmp_items);
+    free(hist);
+
+    // Đổi key về value ngay trong buffer
+    int32_t *sorted = (int32_t *)keys;
+    for (size_t i = 0; i < n; i++) sorted[i] = (int32_t)(keys[i] ^ 0x80000000u);
+
+    index->values = sorted;
+    index->items = items;
+    index->count = count;
+    return 0;
+}
+
+void value_index_free(ValueIndex *index) {
+    free(index->values);
+    free(index->items);
+    index->values = NULL;
+    index->items = NULL;
+    index->count = 0;
+}
+
+/* ============================================================================
+ *                           QUERIES
+ * ============================================================================ */
+
+int value_index_lower_bound(const ValueIndex *index, int64_t value) {
+    int lo = 0, hi = index->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (index->values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// floor/ceil cho số đã chặn trong phạm vi int32, không cần libm
+static int64_t floor_i64(double x) {
+    int64_t i = (int64_t)x;
+    return x < (double)i ? i - 1 : i;
+}
+
+static int64_t ceil_i64(double x) {
+    int64_t i = (int64_t)x;
+    return x > (double)i ? i + 1 : i;
+}
+
+/**
+ * Khoảng vị trí [*first, *last) có value trong [ceil(min), floor(max)]
+ */
+static void value_range(const ValueIndex *index, double min, double max, int *first, int *last) {
+    // Chặn trong phạm vi int32 (+1) để chuyển sang int64 không tràn
+    if (min < (double)INT32_MIN) min = (double)INT32_MIN;
+    if (max > (double)INT32_MAX + 1.0) max = (double)INT32_MAX + 1.0;
+    *first = value_index_lower_bound(index, ceil_i64(min));
+    *last = value_index_lower_bound(index, floor_i64(max) + 1);
+    if (*last < *first) *last = *first;
+}
+
+int value_index_pick_ratio(const ValueIndex *index, Prng *rng, const Bitmap *filter,
+                           int except, int value_a, double lo, double hi) {
+    if (index->count < 2 || value_a <= 0) return -1;
+    if (lo < 1.0) lo = 1.0;
+    if (hi < lo) return -1;
+
+    // B lớn hơn: [vA * lo, vA * hi]; B nhỏ hơn: [vA / hi, vA / lo]
+    // lo == 1 thì hai khoảng chạm nhau ở vA, gộp làm một
+    int up_first, up_last, down_first, down_last;
+    if (lo <= 1.0) {
+        value_range(index, value_a / hi, value_a * hi, &down_first, &down_last);
+        up_first = up_last = 0;
+    } else {
+        value_range(index, value_a / hi, value_a / lo, &down_first, &down_last);
+        value_range(index, value_a * lo, value_a * hi, &up_first, &up_last);
+    }
+
+    uint64_t down = (uint64_t)(down_last - down_first);
+    uint64_t total = down + (uint64_t)(up_last - up_first);
+    if (total == 0) return -1;
+
+    int attempts = PICK_ATTEMPTS;
+    if (filter) {
+        // Khoảng nhỏ: reservoir sampling trên mọi ứng viên trong filter (chính xác)
+        if (total <= PICK_SCAN_LIMIT) {
+            uint64_t seen = 0;
+            int chosen = -1;
+            for (uint64_t r = 0; r < total; r++) {
+                int pos = r < down ? down_first + (int)r : up_first + (int)(r - down);
+                int item = (int)index->items[pos];
+                if (item == except || !bitmap_contains(filter, (uint32_t)item)) continue;
+                if (prng_below(rng, ++seen) == 0) chosen = item;
+            }
+            return chosen;
+        }
+        uint64_t members = bitmap_cardinality(filter);
+        uint64_t scaled = members ? (uint64_t)PICK_ATTEMPTS * (uint64_t)index->count / members : PICK_MAX_ATTEMPTS;
+        attempts = scaled > PICK_MAX_ATTEMPTS ? PICK_MAX_ATTEMPTS : (int)scaled;
+    }
+
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        uint64_t r = prng_below(rng, total);
+        int pos = r < down ? down_first + (int)r : up_first + (int)(r - down);
+        int item = (int)index->items[pos];
+        if (item != except && (!filter || bitmap_contains(filter, (uint32_t)item))) return item;
+        if (total == 1) break;
+    }
+    return -1;
+}
@@ -0,0 +1,280 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - WIRE MESSAGE SCHEMAS
+ * ============================================================================
+ * File: wire_schema.c
+ * Description: Bảng field sinh từ X-macro + encoder JSON/binary/delta
+ * ============================================================================
+ */
+
+#include <string.h>
+#include "../include/wire_schema.h"
+
+/* ============================================================================
+ *                           ENUM TABLES
+ * ============================================================================ */
+
+// Cùng thứ tự với RoomStatus trong types.h
+static const char *const room_status_names[] = { "empty", "waiting", "playing", "finished" };
+
+const WireEnum wire_room_status_enum = {
+    room_status_names, (int)(sizeof(room_status_names) / sizeof(room_status_names[0]))
+};
+
+// Cùng thứ tự với RoomDifficulty trong types.h
+static const char *const room_difficulty_names[] = { "random", "ramp" };
+
+const WireEnum wire_room_difficulty_enum = {
+    room_difficulty_names, (int)(sizeof(room_difficulty_names) / sizeof(room_difficulty_names[0]))
+};
+
+int wire_enum_value(const WireEnum *e, const char *name) {
+    for (int i = 0; i < e->count; i++) {
+        if (strcmp(e->names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+/* ============================================================================
+ *                           SCHEMA TABLES
+ * ============================================================================ */
+
+#define WIRE_FIELD_ROW(stype, field, key, type, names) \
+    { key, sizeof(key) - 1, WF_##type, offsetof(stype, field), names },
+
+#define WIRE_FIELD_TABLE(id, type, action, fields) \
+    static const WireField wire_fields_##id[] = { fields(WIRE_FIELD_ROW, type) };
+
+WIRE_SCHEMAS(WIRE_FIELD_TABLE)
+
+#define WIRE_SCHEMA_ENTRY(id, type, action, fields) \
+    [WIRE_SCHEMA_##id] = { #id, action, WIRE_SCHEMA_##id, \
+                           sizeof(wire_fields_##id) / sizeof(WireField), wire_fields_##id },
+
+const WireSchema wire_schemas[WIRE_SCHEMA_COUNT] = {
+    WIRE_SCHEMAS(WIRE_SCHEMA_ENTRY)
+};
+
+// Bitmask delta binary là unsigned int
+#define WIRE_CHECK_SIZE(id, type, action, fields) \
+    _Static_assert(sizeof(wire_fields_##id) / sizeof(WireField) <= WIRE_MAX_FIELDS, \
+                   "Schema " #id " has too many fields");
+WIRE_SCHEMAS(WIRE_CHECK_SIZE)
+
+/* ============================================================================
+ *                           FIELD ACCESS
+ * ============================================================================ */
+
+static inline int field_int(const void *msg, const WireField *f) {
+    int v;
+    memcpy(&v, (const char *)msg + f->offset, sizeof(v));
+    return v;
+}
+
+static inline const char *field_str(const void *msg, const WireField *f) {
+    const char *s;
+    memcpy(&s, (const char *)msg + f->offset, sizeof(s));
+    return s ? s : "";
+}
+
+static int field_equal(const void *a, const void *b, const WireField *f) {
+    if (f->type == WF_STRING) return strcmp(field_str(a, f), field_str(b, f)) == 0;
+    return field_int(a, f) == field_int(b, f);
+}
+
+/* ============================================================================
+ *                           JSON ENCODERS
+ * ============================================================================ */
+
+static void json_field(JsonWriter *w, const WireField *f, const void *msg) {
+    jw_key_n(w, f->key, f->key_len);
+    switch (f->type) {
+        case WF_INT:
+            jw_int(w, field_int(msg, f));
+            break;
+        case WF_BOOL:
+            jw_bool(w, field_int(msg, f));
+            break;
+        case WF_STRING:
+            jw_string(w, field_str(msg, f));
+            break;
+        case WF_ENUM: {
+            int v = field_int(msg, f);
+            jw_string(w, (v >= 0 && v < f->names->count) ? f->names->names[v] : "");
+            break;
+        }
+    }
+}
+
+void wire_json_fields(JsonWriter *w, const WireSchema *schema, const void *msg) {
+    if (schema->action) jw_kv_str(w, "action", schema->action);
+    for (int i = 0; i < schema->field_count; i++) {
+        json_field(w, &schema->fields[i], msg);
+    }
+}
+
+void wire_json_object(JsonWriter *w, const WireSchema *schema, const void *msg) {
+    jw_object_begin(w);
+    wire_json_fields(w, schema, msg);
+    jw_object_end(w);
+}
+
+int wire_delta_count(const WireSchema *schema, const void *old, const void *cur) {
+    int changed = 0;
+    for (int i = 1; i < schema->field_count; i++) {
+        changed += !field_equal(old, cur, &schema->fields[i]);
+    }
+    return changed;
+}
+
+int wire_json_delta(JsonWriter *w, const WireSchema *schema, const void *old, const void *cur) {
+    int changed = 0;
+
+    jw_object_begin(w);
+    json_field(w, &schema->fields[0], cur);
+    for (int i = 1; i < schema->field_count; i++) {
+        const WireField *f = &schema->fields[i];
+        if (field_equal(old, cur, f)) continue;
+        json_field(w, f, cur);
+        changed++;
+    }
+    jw_object_end(w);
+
+    return changed;
+}
+
+/* ============================================================================
+ *                           BINARY ENCODERS
+ * ============================================================================ */
+
+typedef struct {
+    unsigned char *p;
+    unsigned char *end;
+    int overflow;
+} ByteOut;
+
+static void put_varint(ByteOut *o, unsigned int v) {
+    do {
+        if (o->p >= o->end) {
+            o->overflow = 1;
+            return;
+        }
+        unsigned char b = v & 0x7F;
+        v >>= 7;
+        *o->p++ = b | (v ? 0x80 : 0);
+    } while (v);
+}
+
+static void binary_field(ByteOut *o, const WireField *f, const void *msg) {
+    switch (f->type) {
+        case WF_INT: {
+            int v = field_int(msg, f);
+            // Zigzag: số âm nhỏ vẫn chiếm ít byte
+            put_varint(o, ((unsigned int)v << 1) ^ (unsigned int)(v >> 31));
+            break;
+        }
+        case WF_BOOL:
+            put_varint(o, field_int(msg, f) ? 1 : 0);
+            break;
+        case WF_ENUM:
+            put_varint(o, (unsigned int)field_int(msg, f));
+            break;
+        case WF_STRING: {
+            const char *s = field_str(msg, f);
+            size_t n = strlen(s);
+            put_varint(o, (unsigned int)n);
+            if ((size_t)(o->end - o->p) < n) {
+                o->overflow = 1;
+                return;
+            }
+            memcpy(o->p, s, n);
+            o->p += n;
+            break;
+        }
+    }
+}
+
+size_t wire_binary_encode(const WireSchema *schema, const void *msg, unsigned char *out, size_t cap) {
+    ByteOut o = { out, out + cap, 0 };
+
+    put_varint(&o, schema->id);
+    for (int i = 0; i < schema->field_count && !o.overflow; i++) {
+        binary_field(&o, &schema->fields[i], msg);
+    }
+
+    return o.overflow ? 0 : (size_t)(o.p - out);
+}
+
+size_t wire_binary_delta(const WireSchema *schema, const void *old, const void *cur,
+                         unsigned char *out, size_t cap) {
+    ByteOut o = { out, out + cap, 0 };
+
+    unsigned int mask = 1;
+    for (int i = 1; i < schema->field_count; i++) {
+        if (!field_equal(old, cur, &schema->fields[i])) mask |= 1u << i;
+    }
+
+    put_varint(&o, schema->id);
+    put_varint(&o, mask);
+    for (int i = 0; i < schema->field_count && !o.overflow; i++) {
+        if (mask & (1u << i)) binary_field(&o, &schema->fields[i], cur);
+    }
+
+    return o.overflow ? 0 : (size_t)(o.p - out);
+}
+
+/* ============================================================================
+ *                           BINARY DECODER
+ * ============================================================================ */
+
+typedef struct {
+    const unsigned char *p;
+    const unsigned char *end;
+    int error;
+} ByteIn;
+
+static unsigned int get_varint(ByteIn *in) {
+    unsigned int v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (in->p >= in->end) break;
+        unsigned char b = *in->p++;
+        v |= (unsigned int)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    in->error = 1;
+    return 0;
+}
+
+int wire_binary_decode(const WireSchema *schema, const unsigned char *data, size_t len,
+                       int is_delta, void *msg, char *strings, size_t strings_cap) {
+    ByteIn in = { data, data + len, 0 };
+    size_t used = 0;
+
+    if (get_varint(&in) != schema->id || in.error) return -1;
+    unsigned int mask = is_delta ? get_varint(&in) : ~0u;
+    if (in.error) return -1;
+
+    for (int i = 0; i < schema->field_count; i++) {
+        if (!(mask & (1u << i))) continue;
+
+        const WireField *f = &schema->fields[i];
+        char *dst = (char *)msg + f->offset;
+        unsigned int raw = get_varint(&in);
+        if (in.error) return -1;
+
+        if (f->type == WF_STRING) {
+            if ((size_t)(in.end - in.p) < raw || used + raw + 1 > strings_cap) return -1;
+            char *s = strings + used;
+            memcpy(s, in.p, raw);
+            s[raw] = '\0';
+            in.p += raw;
+            used += raw + 1;
+            memcpy(dst, &s, sizeof(s));
+        } else {
+            int v = f->type == WF_INT ? (int)((raw >> 1) ^ (0u - (raw & 1))) : (int)raw;
+            memcpy(dst, &v, sizeof(v));
+        }
+    }
+
+    return in.p == in.end ? 0 : -1;
+}
@@ -0,0 +1,131 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - CATALOG COMPILER
+ * ============================================================================
+ * File: catalog_compile.c
+ * Description: Biên dịch items.txt (name|value|image_url|tags) thành catalog
+ *              nhị phân để server mmap lúc khởi động
+ *
+ * Dùng:
+ *   catalog_compile <input.txt> <output.bin>
+ *   catalog_compile --verify <catalog.bin>
+ *
+ * Ghi ra file tạm rồi rename(), server đang chạy không bao giờ thấy file
+ * ghi dở. make catalog chạy tool này cho data/items.txt.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/catalog.h"
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* ============================================================================
+ *                           COMMANDS
+ * ============================================================================ */
+
+static int compile(const char *input, const char *output) {
+    FILE *in = fopen(input, "r");
+    if (!in) {
+        perror(input);
+        return 1;
+    }
+
+    double t0 = now_ms();
+    CatalogBuilder builder;
+    catalog_builder_init(&builder);
+    long skipped = 0;
+    long added = catalog_builder_add_text(&builder, in, &skipped);
+    fclose(in);
+    if (added < 0) {
+        fprintf(stderr, "❌ Out of memory after %zu items\n", builder.count);
+        catalog_builder_free(&builder);
+        return 1;
+    }
+
+    void *buf;
+    size_t size;
+    if (catalog_builder_finish(&builder, &buf, &size) != 0) {
+        fprintf(stderr, "❌ Out of memory\n");
+        catalog_builder_free(&builder);
+        return 1;
+    }
+    size_t unique = builder.interned_count;
+    catalog_builder_free(&builder);
+
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", output);
+    FILE *out = fopen(tmp_path, "wb");
+    if (!out) {
+        perror(tmp_path);
+        free(buf);
+        return 1;
+    }
+    int ok = fwrite(buf, 1, size, out) == size;
+    ok = (fclose(out) == 0) && ok;
+    free(buf);
+    if (!ok || rename(tmp_path, output) != 0) {
+        perror(output);
+        remove(tmp_path);
+        return 1;
+    }
+
+    printf("✅ %s: %ld items, %zu unique strings, %.1f MB in %.0f ms",
+           output, added, unique, size / (1024.0 * 1024.0), now_ms() - t0);
+    if (skipped > 0) printf(" (%ld malformed lines skipped)", skipped);
+    printf("\n");
+    return 0;
+}
+
+/**
+ * Mở như server rồi đọc hết item (kiểm tra mọi offset nằm trong heap,
+ * mảng value khớp offset table và fingerprint trong header)
+ */
+static int verify(const char *path) {
+    Catalog c;
+    if (catalog_open(&c, path) != 0) {
+        fprintf(stderr, "❌ %s: cannot open catalog\n", path);
+        return 1;
+    }
+
+    unsigned long bad = 0;
+    for (uint32_t i = 0; i < c.count; i++) {
+        if (c.records[i].name_offset >= c.strings_size || c.records[i].image_offset >= c.strings_size ||
+            c.records[i].tags_offset >= c.strings_size || c.records[i].value != c.values[i]) bad++;
+    }
+    if (catalog_fingerprint(c.values, c.count) != c.fingerprint) bad++;
+
+    printf("%s: version %d, %u items, %.1f MB, fingerprint %08x, %lu bad records\n",
+           path, CATALOG_VERSION, c.count, c.size / (1024.0 * 1024.0), c.fingerprint, bad);
+    if (c.count > 0) {
+        GameItem first = catalog_item(&c, 0);
+        GameItem last = catalog_item(&c, c.count - 1);
+        printf("  first: %s ($%d)\n  last:  %s ($%d)\n", first.name, first.value, last.name, last.value);
+    }
+    catalog_close(&c);
+    return bad ? 1 : 0;
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "--verify") == 0) {
+        return verify(argv[2]);
+    }
+    if (argc == 3) {
+        return compile(argv[1], argv[2]);
+    }
+
+    fprintf(stderr, "Usage: %s <input.txt> <output.bin>\n", argv[0]);
+    fprintf(stderr, "       %s --verify <catalog.bin>\n", argv[0]);
+    return 2;
+}
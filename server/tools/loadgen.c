@@ -0,0 +1,817 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - LOAD GENERATOR
+ * ============================================================================
+ * File: loadgen.c
+ * Description: Giả lập nhiều phòng chơi đầy đủ qua REST + SSE thật của server
+ *
+ * Mỗi người chơi ảo giữ một stream GET /subscribe. Host tạo phòng
+ * (POST /rooms/create), người khác join, host start, mỗi round ai cũng chờ
+ * một think time rồi POST /rooms/choice. Phòng chơi lại --games lần
+ * (leave hết rồi tạo lại). Có thể mở thêm stream lobby không chơi (--idle).
+ *
+ * Độ trễ đo được:
+ *   choice          - POST /rooms/choice: connect -> đọc xong response
+ *   round_results   - câu trả lời cuối của round được gửi -> từng người
+ *                     nhận round_results trên SSE
+ *   new_round       - như trên, tới lúc nhận new_round
+ *   game_finished   - như trên, round cuối
+ *
+ * Mỗi worker thread một epoll, sở hữu trọn một số phòng (không chia sẻ
+ * state giữa thread). Request REST là socket non-blocking, một connection
+ * mỗi request như client thật (server trả Connection: close).
+ *
+ * Dùng:
+ *   loadgen [--port 8080] [--rooms 10] [--players 4] [--rounds 5]
+ *           [--games 1] [--threads 4] [--idle 0]
+ *           [--think uniform:200:1500 | fixed:MS | exp:MEAN] [--timeout 120]
+ *
+ * Chỉ nối tới server trên máy (127.0.0.1), không cần dịch vụ ngoài.
+ * make loadgen build tool này ra bin/loadgen.
+ * ============================================================================
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "../include/prng.h"
+
+#define MAX_PLAYERS         50          // = MAX_PLAYERS_PER_ROOM của server
+#define MAX_WORKERS         64
+#define EVENT_HEADER        64          // Đủ chứa "data: {\"action\":\"...\""
+#define RESPONSE_KEEP       2048        // Phần đầu response giữ lại để parse
+#define REQUEST_RETRIES     5           // Lỗi kết nối (không phải lỗi JSON)
+#define RETRY_DELAY_MS      20
+#define EPOLL_BATCH         256
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef enum { CONN_SSE, CONN_REQUEST } ConnKind;
+
+typedef enum { REQ_CREATE, REQ_JOIN, REQ_START, REQ_CHOICE, REQ_LEAVE } RequestType;
+
+static const char *request_paths[] = {
+    "/rooms/create", "/rooms/join", "/rooms/start", "/rooms/choice", "/rooms/leave"
+};
+
+typedef enum { THINK_FIXED, THINK_UNIFORM, THINK_EXP } ThinkKind;
+
+typedef struct {
+    ThinkKind kind;
+    double a, b;                        // fixed: a | uniform: [a, b] | exp: mean a
+} ThinkDist;
+
+typedef struct {
+    uint64_t *ns;
+    size_t count, cap;
+} Samples;
+
+typedef enum { LAT_CHOICE, LAT_RESULTS, LAT_NEW_ROUND, LAT_FINISHED, LAT_COUNT } LatencyKind;
+
+static const char *latency_names[LAT_COUNT] = { "choice", "round_results", "new_round", "game_finished" };
+
+struct Room;
+
+/**
+ * Player - Người chơi ảo (hoặc stream lobby khi room == NULL)
+ *
+ * Stream SSE được đọc theo kiểu streaming: chỉ giữ EVENT_HEADER byte đầu
+ * của mỗi event (đủ thấy action), phần còn lại bỏ qua tới "\n\n".
+ */
+typedef struct {
+    ConnKind kind;                      // CONN_SSE (tag cho epoll data.ptr)
+    struct Room *room;
+    int index;                          // 0 = host
+    int fd;
+    int session_id;
+    char header[EVENT_HEADER];
+    int header_len;
+    int prev_newline;
+    int think_ms;                       // Think time của câu trả lời đang chờ gửi
+} Player;
+
+typedef struct Room {
+    int room_id;
+    Player *players;
+    int player_count;
+    int pending;                        // Join / leave đang chờ response
+    int answered;                       // Câu trả lời đã gửi trong round
+    uint64_t close_sent_ns;             // Lúc gửi câu trả lời cuối của round
+    int finished_players;
+    int games_done;
+    int done;
+} Room;
+
+typedef struct {
+    ConnKind kind;                      // CONN_REQUEST
+    RequestType type;
+    Player *player;
+    int fd;
+    int retries;
+    uint64_t start_ns;
+    char out[512];
+    int out_len, out_sent;
+    char in[RESPONSE_KEEP];
+    int in_len;
+} Request;
+
+typedef struct {
+    uint64_t due_ns;
+    int is_retry;
+    void *target;                       // Player (think) hoặc Request (retry)
+} Timer;
+
+typedef struct {
+    int id;
+    int epfd;
+    Prng rng;
+    Room **rooms;
+    int room_count;
+    int rooms_done;
+    Player **idle;
+    int idle_count;
+    Timer *heap;
+    int heap_len, heap_cap;
+
+    uint64_t requests;
+    uint64_t request_errors;
+    uint64_t retries;
+    uint64_t rounds;
+    uint64_t games;
+    uint64_t events;
+    Samples latency[LAT_COUNT];
+    pthread_t thread;
+} Worker;
+
+/* ============================================================================
+ *                           CONFIG
+ * ============================================================================ */
+
+static struct {
+    char host[64];
+    int port;
+    int rooms;
+    int players;
+    int rounds;
+    int games;
+    int threads;
+    int idle;
+    int timeout_s;
+    uint64_t seed;
+    ThinkDist think;
+    char think_spec[64];
+} cfg = { "127.0.0.1", 8080, 10, 4, 5, 1, 4, 0, 120, 0, { THINK_UNIFORM, 200, 1500 }, "uniform:200:1500" };
+
+static struct sockaddr_in server_addr;
+static uint64_t deadline_ns;
+
+/* ============================================================================
+ *                           HELPERS
+ * ============================================================================ */
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void samples_add(Samples *s, uint64_t ns) {
+    if (s->count == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 1024;
+        uint64_t *grown = realloc(s->ns, cap * sizeof(uint64_t));
+        if (!grown) return;
+        s->ns = grown;
+        s->cap = cap;
+    }
+    s->ns[s->count++] = ns;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile trên mảng đã sort
+static double percentile_ms(const Samples *s, double p) {
+    if (s->count == 0) return 0;
+    size_t rank = (size_t)(p * (double)s->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > s->count) rank = s->count;
+    return s->ns[rank - 1] / 1e6;
+}
+
+/**
+ * "fixed:MS" | "uniform:LO:HI" | "exp:MEAN"
+ * @return 0 nếu hợp lệ
+ */
+static int parse_think(const char *spec, ThinkDist *out) {
+    double a = 0, b = 0;
+    if (sscanf(spec, "fixed:%lf", &a) == 1 && a >= 0) {
+        *out = (ThinkDist){ THINK_FIXED, a, a };
+    } else if (sscanf(spec, "uniform:%lf:%lf", &a, &b) == 2 && a >= 0 && b >= a) {
+        *out = (ThinkDist){ THINK_UNIFORM, a, b };
+    } else if (sscanf(spec, "exp:%lf", &a) == 1 && a > 0) {
+        *out = (ThinkDist){ THINK_EXP, a, 0 };
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static int sample_think_ms(Worker *w) {
+    double u = (double)(prng_next(&w->rng) >> 11) / 9007199254740992.0;    // [0, 1)
+    double ms;
+    switch (cfg.think.kind) {
+        case THINK_UNIFORM: ms = cfg.think.a + u * (cfg.think.b - cfg.think.a); break;
+        case THINK_EXP:     ms = -cfg.think.a * log1p(-u); break;
+        default:            ms = cfg.think.a; break;
+    }
+    // Đuôi exp bị chặn ở 10 x mean để một người không giữ cả phòng quá lâu
+    if (cfg.think.kind == THINK_EXP && ms > 10 * cfg.think.a) ms = 10 * cfg.think.a;
+    return (int)ms;
+}
+
+/* ============================================================================
+ *                           TIMER HEAP
+ * ============================================================================ */
+
+static void timer_push(Worker *w, uint64_t due, int is_retry, void *target) {
+    if (w->heap_len == w->heap_cap) {
+        int cap = w->heap_cap ? w->heap_cap * 2 : 256;
+        Timer *grown = realloc(w->heap, (size_t)cap * sizeof(Timer));
+        if (!grown) return;
+        w->heap = grown;
+        w->heap_cap = cap;
+    }
+    int i = w->heap_len++;
+    while (i > 0 && w->heap[(i - 1) / 2].due_ns > due) {
+        w->heap[i] = w->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    w->heap[i] = (Timer){ due, is_retry, target };
+}
+
+static Timer timer_pop(Worker *w) {
+    Timer top = w->heap[0];
+    Timer last = w->heap[--w->heap_len];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= w->heap_len) break;
+        if (child + 1 < w->heap_len && w->heap[child + 1].due_ns < w->heap[child].due_ns) child++;
+        if (w->heap[child].due_ns >= last.due_ns) break;
+        w->heap[i] = w->heap[child];
+        i = child;
+    }
+    if (w->heap_len > 0) w->heap[i] = last;
+    return top;
+}
+
+/* ============================================================================
+ *                           REST REQUESTS
+ * ============================================================================ */
+
+static void request_connect(Worker *w, Request *req);
+
+static void request_send(Worker *w, Player *p, RequestType type, const char *body) {
+    Request *req = calloc(1, sizeof(Request));
+    if (!req) return;
+    req->kind = CONN_REQUEST;
+    req->type = type;
+    req->player = p;
+    req->fd = -1;
+    req->out_len = snprintf(req->out, sizeof(req->out),
+        "POST %s HTTP/1.1\r\n"
+        "Host: %s:%d\r\n"
+        "X-Session-ID: %d\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: %zu\r\n"
+        "Connection: close\r\n"
+        "\r\n%s",
+        request_paths[type], cfg.host, cfg.port, p->session_id, strlen(body), body);
+    request_connect(w, req);
+}
+
+static void request_retry(Worker *w, Request *req) {
+    if (req->fd >= 0) {
+        close(req->fd);
+        req->fd = -1;
+    }
+    req->out_sent = 0;
+    req->in_len = 0;
+    w->retries++;
+    timer_push(w, now_ns() + RETRY_DELAY_MS * 1000000ULL, 1, req);
+}
+
+static void request_connect(Worker *w, Request *req) {
+    req->start_ns = now_ns();
+    req->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (req->fd < 0) {
+        request_retry(w, req);
+        return;
+    }
+    int one = 1;
+    setsockopt(req->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(req->fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 && errno != EINPROGRESS) {
+        request_retry(w, req);
+        return;
+    }
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = req };
+    epoll_ctl(w->epfd, EPOLL_CTL_ADD, req->fd, &ev);
+}
+
+static void on_response(Worker *w, Request *req, const char *body, int ok);
+
+static void on_request_ready(Worker *w, Request *req, uint32_t events) {
+    if (req->out_sent < req->out_len) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(req->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0 || (events & EPOLLERR)) {
+            if (req->retries++ < REQUEST_RETRIES) request_retry(w, req);
+            else on_response(w, req, "", 0);
+            return;
+        }
+        ssize_t n = send(req->fd, req->out + req->out_sent, (size_t)(req->out_len - req->out_sent), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN) return;
+            if (req->retries++ < REQUEST_RETRIES) request_retry(w, req);
+            else on_response(w, req, "", 0);
+            return;
+        }
+        req->out_sent += (int)n;
+        if (req->out_sent == req->out_len) {
+            struct epoll_event ev = { .events = EPOLLIN, .data.ptr = req };
+            epoll_ctl(w->epfd, EPOLL_CTL_MOD, req->fd, &ev);
+        }
+        return;
+    }
+
+    // Đọc tới EOF, chỉ giữ RESPONSE_KEEP byte đầu
+    char scratch[4096];
+    for (;;) {
+        char *dst = req->in_len < RESPONSE_KEEP - 1 ? req->in + req->in_len : scratch;
+        size_t room = req->in_len < RESPONSE_KEEP - 1 ? (size_t)(RESPONSE_KEEP - 1 - req->in_len) : sizeof(scratch);
+        ssize_t n = recv(req->fd, dst, room, 0);
+        if (n > 0) {
+            if (dst != scratch) req->in_len += (int)n;
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN) return;
+        break;
+    }
+    req->in[req->in_len] = '\0';
+
+    const char *body = strstr(req->in, "\r\n\r\n");
+    int ok = strncmp(req->in, "HTTP/1.1 200", 12) == 0 && body;
+    if (!body && req->retries++ < REQUEST_RETRIES) {
+        request_retry(w, req);              // Kết nối bị cắt trước khi có response
+        return;
+    }
+    body = body ? body + 4 : "";
+    if (strstr(body, "\"error\"")) ok = 0;
+    on_response(w, req, body, ok);
+}
+
+/* ============================================================================
+ *                           GAME FLOW
+ * ============================================================================ */
+
+static void room_create(Worker *w, Room *room) {
+    char body[160];
+    snprintf(body, sizeof(body), "{\"room_name\":\"loadgen-%d\",\"player_name\":\"bot-%d\",\"max_rounds\":%d}",
+             room->players[0].session_id, room->players[0].session_id, cfg.rounds);
+    room->room_id = 0;
+    room->finished_players = 0;
+    room->answered = 0;
+    room->close_sent_ns = 0;
+    request_send(w, &room->players[0], REQ_CREATE, body);
+}
+
+static void room_finish(Worker *w, Room *room) {
+    room->done = 1;
+    w->rooms_done++;
+}
+
+static void on_response(Worker *w, Request *req, const char *body, int ok) {
+    Player *p = req->player;
+    Room *room = p->room;
+    uint64_t now = now_ns();
+
+    w->requests++;
+    if (!ok) {
+        w->request_errors++;
+        if (w->request_errors <= 5) {
+            fprintf(stderr, "loadgen: %s (session %d) failed: %.120s\n",
+                    request_paths[req->type], p->session_id, body);
+        }
+    }
+    if (req->type == REQ_CHOICE) samples_add(&w->latency[LAT_CHOICE], now - req->start_ns);
+
+    switch (req->type) {
+        case REQ_CREATE: {
+            const char *id = ok ? strstr(body, "\"room\":{\"id\":") : NULL;
+            if (!id) {
+                room_finish(w, room);       // Không tạo được phòng: bỏ phòng này
+                break;
+            }
+            room->room_id = atoi(id + 13);
+            if (room->player_count == 1) {
+                request_send(w, p, REQ_START, "");
+                break;
+            }
+            room->pending = room->player_count - 1;
+            for (int i = 1; i < room->player_count; i++) {
+                char join[96];
+                snprintf(join, sizeof(join), "{\"room_id\":%d,\"player_name\":\"bot-%d\"}",
+                         room->room_id, room->players[i].session_id);
+                request_send(w, &room->players[i], REQ_JOIN, join);
+            }
+            break;
+        }
+        case REQ_JOIN:
+            if (--room->pending == 0) request_send(w, &room->players[0], REQ_START, "");
+            break;
+        case REQ_START:
+            if (!ok) room_finish(w, room);
+            break;                          // Round 1 bắt đầu khi game_started tới qua SSE
+        case REQ_CHOICE:
+            break;
+        case REQ_LEAVE:
+            if (--room->pending == 0) room_create(w, room);
+            break;
+    }
+
+    if (req->fd >= 0) close(req->fd);
+    free(req);
+}
+
+/**
+ * Sau game_started / new_round: chờ think time rồi trả lời
+ */
+static void schedule_answer(Worker *w, Player *p) {
+    p->think_ms = sample_think_ms(w);
+    timer_push(w, now_ns() + (uint64_t)p->think_ms * 1000000ULL, 0, p);
+}
+
+static void send_answer(Worker *w, Player *p) {
+    Room *room = p->room;
+    char body[64];
+    snprintf(body, sizeof(body), "{\"choice\":%d,\"response_time\":%d}",
+             (int)prng_below(&w->rng, 2) + 1, p->think_ms);
+    if (++room->answered == room->player_count) {
+        room->answered = 0;
+        room->close_sent_ns = now_ns();
+        w->rounds++;
+    }
+    request_send(w, p, REQ_CHOICE, body);
+}
+
+static void on_event(Worker *w, Player *p) {
+    w->events++;
+    Room *room = p->room;
+    if (!room || room->done) return;
+
+    const char *action = strstr(p->header, "\"action\":\"");
+    if (!action) return;
+    action += 10;
+
+    uint64_t now = now_ns();
+    uint64_t since_close = room->close_sent_ns ? now - room->close_sent_ns : 0;
+
+    if (strncmp(action, "game_started\"", 13) == 0) {
+        schedule_answer(w, p);
+    } else if (strncmp(action, "round_results\"", 14) == 0) {
+        if (since_close) samples_add(&w->latency[LAT_RESULTS], since_close);
+    } else if (strncmp(action, "new_round\"", 10) == 0) {
+        if (since_close) samples_add(&w->latency[LAT_NEW_ROUND], since_close);
+        schedule_answer(w, p);
+    } else if (strncmp(action, "game_finished\"", 14) == 0) {
+        if (since_close) samples_add(&w->latency[LAT_FINISHED], since_close);
+        if (++room->finished_players < room->player_count) return;
+
+        w->games++;
+        if (++room->games_done >= cfg.games) {
+            room_finish(w, room);
+            return;
+        }
+        // Chơi lại: mọi người rời phòng (phòng bị xoá), host tạo phòng mới
+        room->pending = room->player_count;
+        for (int i = 0; i < room->player_count; i++) {
+            request_send(w, &room->players[i], REQ_LEAVE, "");
+        }
+    }
+}
+
+/**
+ * Đọc stream SSE, tách event theo "\n\n"
+ * @return -1 nếu server đóng stream
+ */
+static int on_sse_readable(Worker *w, Player *p) {
+    char buf[16384];
+    for (;;) {
+        ssize_t n = recv(p->fd, buf, sizeof(buf), 0);
+        if (n == 0) return -1;
+        if (n < 0) return errno == EAGAIN ? 0 : -1;
+
+        for (ssize_t i = 0; i < n; i++) {
+            char c = buf[i];
+            if (c == '\n' && p->prev_newline) {
+                p->header[p->header_len] = '\0';
+                on_event(w, p);
+                p->header_len = 0;
+                p->prev_newline = 0;
+                continue;
+            }
+            p->prev_newline = (c == '\n');
+            if (p->header_len < EVENT_HEADER - 1) p->header[p->header_len++] = c;
+        }
+    }
+}
+
+/* ============================================================================
+ *                           WORKER
+ * ============================================================================ */
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    struct epoll_event events[EPOLL_BATCH];
+
+    for (int r = 0; r < w->room_count; r++) room_create(w, w->rooms[r]);
+
+    while (w->rooms_done < w->room_count) {
+        uint64_t now = now_ns();
+        if (now >= deadline_ns) {
+            fprintf(stderr, "loadgen: worker %d timed out with %d/%d rooms unfinished\n",
+                    w->id, w->room_count - w->rooms_done, w->room_count);
+            break;
+        }
+        while (w->heap_len > 0 && w->heap[0].due_ns <= now) {
+            Timer t = timer_pop(w);
+            if (t.is_retry) request_connect(w, t.target);
+            else send_answer(w, t.target);
+        }
+
+        int timeout_ms = 100;
+        if (w->heap_len > 0) {
+            uint64_t wait = (w->heap[0].due_ns - now + 999999) / 1000000;
+            if (wait < (uint64_t)timeout_ms) timeout_ms = (int)wait;
+        }
+        int n = epoll_wait(w->epfd, events, EPOLL_BATCH, timeout_ms);
+        for (int i = 0; i < n; i++) {
+            ConnKind kind = *(ConnKind *)events[i].data.ptr;
+            if (kind == CONN_REQUEST) {
+                on_request_ready(w, events[i].data.ptr, events[i].events);
+                continue;
+            }
+            Player *p = events[i].data.ptr;
+            if (on_sse_readable(w, p) < 0) {
+                fprintf(stderr, "loadgen: SSE stream of session %d closed by server\n", p->session_id);
+                epoll_ctl(w->epfd, EPOLL_CTL_DEL, p->fd, NULL);
+                if (p->room && !p->room->done) room_finish(w, p->room);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ *                           SETUP
+ * ============================================================================ */
+
+/**
+ * Mở GET /subscribe (blocking), đọc session_id rồi chuyển sang non-blocking
+ * @return 0 nếu thành công
+ */
+static int subscribe(Worker *w, Player *p) {
+    p->kind = CONN_SSE;
+    p->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (p->fd < 0) return -1;
+    if (connect(p->fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        close(p->fd);
+        return -1;
+    }
+    char req[128];
+    int len = snprintf(req, sizeof(req), "GET /subscribe HTTP/1.1\r\nHost: %s:%d\r\n\r\n", cfg.host, cfg.port);
+    if (send(p->fd, req, (size_t)len, MSG_NOSIGNAL) != len) {
+        close(p->fd);
+        return -1;
+    }
+
+    char buf[2048];
+    int used = 0;
+    char *event_end = NULL;
+    while (used < (int)sizeof(buf) - 1) {
+        ssize_t n = recv(p->fd, buf + used, sizeof(buf) - 1 - (size_t)used, 0);
+        if (n <= 0) break;
+        used += (int)n;
+        buf[used] = '\0';
+        char *id = strstr(buf, "\"session_id\":");
+        if (id && (event_end = strstr(id, "\n\n")) != NULL) {
+            p->session_id = atoi(id + 13);
+            break;
+        }
+    }
+    if (!event_end) {
+        close(p->fd);
+        return -1;
+    }
+
+    // Byte thừa sau event đầu tiên (nếu có) thuộc event kế tiếp
+    event_end += 2;
+    for (char *c = event_end; c < buf + used; c++) {
+        if (p->header_len < EVENT_HEADER - 1) p->header[p->header_len++] = *c;
+    }
+    fcntl(p->fd, F_SETFL, fcntl(p->fd, F_GETFL) | O_NONBLOCK);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = p };
+    epoll_ctl(w->epfd, EPOLL_CTL_ADD, p->fd, &ev);
+    return 0;
+}
+
+static void raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) return;
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -p, --port N        Server port on 127.0.0.1 (default 8080)\n"
+        "  -r, --rooms N       Rooms to play (default 10)\n"
+        "  -n, --players N     Players per room, 1-%d (default 4)\n"
+        "  -R, --rounds N      Rounds per game, 5-50 (default 5)\n"
+        "  -g, --games N       Games per room (default 1)\n"
+        "  -t, --threads N     Worker threads (default 4)\n"
+        "  -i, --idle N        Extra lobby-only SSE streams (default 0)\n"
+        "  -k, --think SPEC    fixed:MS | uniform:LO:HI | exp:MEAN (default uniform:200:1500)\n"
+        "  -T, --timeout S     Give up after S seconds (default 120)\n"
+        "  -s, --seed N        PRNG seed (default: random)\n",
+        prog, MAX_PLAYERS);
+}
+
+static int parse_args(int argc, char **argv) {
+    static const struct option options[] = {
+        { "port", required_argument, 0, 'p' },
+        { "rooms", required_argument, 0, 'r' },
+        { "players", required_argument, 0, 'n' },
+        { "rounds", required_argument, 0, 'R' },
+        { "games", required_argument, 0, 'g' },
+        { "threads", required_argument, 0, 't' },
+        { "idle", required_argument, 0, 'i' },
+        { "think", required_argument, 0, 'k' },
+        { "timeout", required_argument, 0, 'T' },
+        { "seed", required_argument, 0, 's' },
+        { "help", no_argument, 0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:r:n:R:g:t:i:k:T:s:h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'p': cfg.port = atoi(optarg); break;
+            case 'r': cfg.rooms = atoi(optarg); break;
+            case 'n': cfg.players = atoi(optarg); break;
+            case 'R': cfg.rounds = atoi(optarg); break;
+            case 'g': cfg.games = atoi(optarg); break;
+            case 't': cfg.threads = atoi(optarg); break;
+            case 'i': cfg.idle = atoi(optarg); break;
+            case 'T': cfg.timeout_s = atoi(optarg); break;
+            case 's': cfg.seed = strtoull(optarg, NULL, 10); break;
+            case 'k':
+                if (parse_think(optarg, &cfg.think) != 0) {
+                    fprintf(stderr, "loadgen: bad think time \"%s\"\n", optarg);
+                    return -1;
+                }
+                snprintf(cfg.think_spec, sizeof(cfg.think_spec), "%s", optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return -1;
+        }
+    }
+    if (cfg.rooms < 1 || cfg.players < 1 || cfg.players > MAX_PLAYERS || cfg.games < 1 ||
+        cfg.rounds < 5 || cfg.rounds > 50 || cfg.idle < 0 || cfg.timeout_s < 1) {
+        usage(argv[0]);
+        return -1;
+    }
+    if (cfg.threads < 1) cfg.threads = 1;
+    if (cfg.threads > MAX_WORKERS) cfg.threads = MAX_WORKERS;
+    if (cfg.threads > cfg.rooms) cfg.threads = cfg.rooms;
+    return 0;
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+    if (parse_args(argc, argv) != 0) return 1;
+    raise_fd_limit();
+
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons((uint16_t)cfg.port);
+    inet_pton(AF_INET, cfg.host, &server_addr.sin_addr);
+    if (!cfg.seed) cfg.seed = prng_entropy_seed();
+
+    Worker *workers = calloc((size_t)cfg.threads, sizeof(Worker));
+    Room *rooms = calloc((size_t)cfg.rooms, sizeof(Room));
+    Player *idle = calloc((size_t)cfg.idle + 1, sizeof(Player));
+    if (!workers || !rooms || !idle) return 1;
+
+    for (int t = 0; t < cfg.threads; t++) {
+        workers[t].id = t;
+        workers[t].epfd = epoll_create1(0);
+        workers[t].rooms = calloc((size_t)cfg.rooms, sizeof(Room *));
+        workers[t].idle = calloc((size_t)cfg.idle + 1, sizeof(Player *));
+        prng_seed(&workers[t].rng, cfg.seed + (uint64_t)t);
+    }
+
+    // Mở mọi stream trước khi chơi (đo được cả chi phí fan-out khi có nhiều stream)
+    uint64_t setup_start = now_ns();
+    int streams = 0;
+    for (int r = 0; r < cfg.rooms; r++) {
+        Worker *w = &workers[r % cfg.threads];
+        Room *room = &rooms[r];
+        room->players = calloc((size_t)cfg.players, sizeof(Player));
+        room->player_count = cfg.players;
+        for (int i = 0; i < cfg.players; i++) {
+            room->players[i].room = room;
+            room->players[i].index = i;
+            if (subscribe(w, &room->players[i]) != 0) {
+                fprintf(stderr, "loadgen: cannot subscribe to %s:%d (stream %d)\n", cfg.host, cfg.port, streams);
+                return 1;
+            }
+            streams++;
+        }
+        w->rooms[w->room_count++] = room;
+    }
+    for (int i = 0; i < cfg.idle; i++) {
+        Worker *w = &workers[i % cfg.threads];
+        if (subscribe(w, &idle[i]) != 0) {
+            fprintf(stderr, "loadgen: cannot subscribe to %s:%d (stream %d)\n", cfg.host, cfg.port, streams);
+            return 1;
+        }
+        w->idle[w->idle_count++] = &idle[i];
+        streams++;
+    }
+    printf("loadgen: %d SSE streams open in %.1f ms (%d rooms x %d players + %d idle)\n",
+           streams, (now_ns() - setup_start) / 1e6, cfg.rooms, cfg.players, cfg.idle);
+    printf("loadgen: %d round(s) x %d game(s), %d thread(s), think %s, seed %llu\n",
+           cfg.rounds, cfg.games, cfg.threads, cfg.think_spec, (unsigned long long)cfg.seed);
+
+    uint64_t start = now_ns();
+    deadline_ns = start + (uint64_t)cfg.timeout_s * 1000000000ULL;
+    for (int t = 0; t < cfg.threads; t++) pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]);
+    for (int t = 0; t < cfg.threads; t++) pthread_join(workers[t].thread, NULL);
+    double elapsed = (now_ns() - start) / 1e9;
+
+    // Gộp kết quả
+    Worker total;
+    memset(&total, 0, sizeof(total));
+    for (int t = 0; t < cfg.threads; t++) {
+        Worker *w = &workers[t];
+        total.requests += w->requests;
+        total.request_errors += w->request_errors;
+        total.retries += w->retries;
+        total.rounds += w->rounds;
+        total.games += w->games;
+        total.events += w->events;
+        total.rooms_done += w->rooms_done;
+        for (int k = 0; k < LAT_COUNT; k++) {
+            for (size_t i = 0; i < w->latency[k].count; i++) samples_add(&total.latency[k], w->latency[k].ns[i]);
+        }
+    }
+
+    printf("\nelapsed     %.2f s, %d/%d rooms finished, %llu games, %llu rounds\n",
+           elapsed, total.rooms_done, cfg.rooms, (unsigned long long)total.games, (unsigned long long)total.rounds);
+    printf("requests    %llu (%.1f req/s), %llu errors, %llu retries\n",
+           (unsigned long long)total.requests, total.requests / elapsed,
+           (unsigned long long)total.request_errors, (unsigned long long)total.retries);
+    printf("sse events  %llu (%.1f events/s)\n\n", (unsigned long long)total.events, total.events / elapsed);
+
+    printf("%-14s %9s %10s %10s %10s %10s\n", "latency (ms)", "count", "p50", "p99", "p999", "max");
+    for (int k = 0; k < LAT_COUNT; k++) {
+        Samples *s = &total.latency[k];
+        qsort(s->ns, s->count, sizeof(uint64_t), cmp_u64);
+        printf("%-14s %9zu %10.3f %10.3f %10.3f %10.3f\n", latency_names[k], s->count,
+               percentile_ms(s, 0.50), percentile_ms(s, 0.99), percentile_ms(s, 0.999), percentile_ms(s, 1.0));
+    }
+    return total.rooms_done == cfg.rooms && total.request_errors == 0 ? 0 : 2;
+}
@@ -0,0 +1,838 @@
+/*
+ * ============================================================================
+ *                    HIGHER LOWER GAME - TRAFFIC REPLAY
+ * ============================================================================
+ * File: replay.c
+ * Description: Phát lại log GAME_RECORD_FILE vào server trên máy và so sánh
+ *              phân phối latency giữa hai build
+ *
+ * - Tốc độ: --speed 1 (như lúc ghi), --speed N (nhanh N lần), --speed max
+ * - Ánh xạ id tất định: mỗi session ghi được có một stream /subscribe mới,
+ *   id cũ -> id server mới cấp (X-Session-ID, ?session_id=); room id lấy từ
+ *   response của /rooms/create được phát lại ("room_id" trong body)
+ * - Request của cùng một session được gửi tuần tự như client thật; join
+ *   vào phòng chưa được tạo lại thì chờ create xong
+ * - Session có request nhưng không có /subscribe trong log (ghi giữa chừng)
+ *   được subscribe trước khi phát
+ *
+ * Dùng:
+ *   replay [--port 8080] [--speed 1|N|max] [--concurrency 256]
+ *          [--timeout 30] [--save result.jsonl] traffic.rec
+ *   replay --compare before.jsonl after.jsonl
+ *
+ * So sánh hai build: chạy build A, replay --save a.jsonl; chạy build B
+ * (server mới, cùng dữ liệu), replay --save b.jsonl; replay --compare.
+ * make replay build tool này ra bin/replay.
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE                     // memmem
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "../include/recorder.h"
+
+#define EPOLL_BATCH         256
+#define RESPONSE_KEEP       2048        // Phần đầu response giữ lại (room id, status)
+#define MAX_ROUTES          64
+#define SUBSCRIBE_PATH      "/subscribe"
+
+/* ============================================================================
+ *                           STRUCTURES
+ * ============================================================================ */
+
+typedef enum { CONN_SSE, CONN_REQUEST } ConnKind;
+
+/**
+ * Record - Một request trong log (target / body trỏ vào buffer file)
+ */
+typedef struct {
+    uint64_t t_us;
+    int session_id;
+    int assigned_id;
+    RecordMethod method;
+    const char *target;
+    size_t target_len;
+    const char *body;
+    size_t body_len;
+    int seq;                            // Thứ tự trong file (sort ổn định)
+    int next_in_session;                // Record kế tiếp của cùng session (-1 = hết)
+    int released;                       // Đã tới giờ gửi
+    int issued;
+} Record;
+
+typedef struct {
+    int new_id;                         // 0 = chưa có
+    int has_subscribe;                  // Log có /subscribe cấp session này
+    int head;                           // Record tiếp theo cần gửi (-1 = hết)
+    int busy;                           // Đang có request chưa xong
+} SessionState;
+
+typedef struct {
+    int new_id;                         // 0 = chưa tạo lại
+    int created_in_log;                 // Log có /rooms/create cấp room này
+} RoomState;
+
+typedef struct {
+    ConnKind kind;
+    Record *rec;                        // NULL: stream subscribe cho session không có trong log
+    int old_session;
+    int fd;
+    int done;                           // Đã đọc được session_id
+    uint64_t start_ns;
+    char buf[512];
+    int len;
+} Stream;
+
+typedef struct {
+    ConnKind kind;
+    Record *rec;
+    int fd;
+    uint64_t start_ns;
+    char *out;
+    int out_len, out_sent;
+    char in[RESPONSE_KEEP];
+    int in_len;
+} Request;
+
+typedef struct {
+    uint64_t *ns;
+    size_t count, cap;
+} Samples;
+
+typedef struct {
+    char name[96];                      // "POST /rooms/choice"
+    Samples latency;
+} Route;
+
+/* ============================================================================
+ *                           GLOBALS
+ * ============================================================================ */
+
+static struct {
+    int port;
+    double speed;                       // 0 = max
+    int concurrency;
+    int timeout_s;
+    const char *save;
+} cfg = { 8080, 1.0, 256, 30, NULL };
+
+static struct sockaddr_in server_addr;
+static int epfd;
+
+static Record *records;
+static int record_count;
+static SessionState *sessions;
+static int session_cap;
+static RoomState *rooms;
+static int room_cap;
+
+static int *waiting;                    // Record đã tới giờ nhưng chưa gửi
+static int waiting_count;
+static int in_flight;
+static int completed;
+static int failed;
+
+static Route routes[MAX_ROUTES];
+static int route_count;
+static Samples lag;                     // Trễ so với lịch (issue - due)
+
+/* ============================================================================
+ *                           HELPERS
+ * ============================================================================ */
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void samples_add(Samples *s, uint64_t ns) {
+    if (s->count == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 256;
+        uint64_t *grown = realloc(s->ns, cap * sizeof(uint64_t));
+        if (!grown) return;
+        s->ns = grown;
+        s->cap = cap;
+    }
+    s->ns[s->count++] = ns;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile (ms) trên mảng đã sort
+static double percentile_ms(const Samples *s, double p) {
+    if (s->count == 0) return 0;
+    size_t rank = (size_t)(p * (double)s->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > s->count) rank = s->count;
+    return s->ns[rank - 1] / 1e6;
+}
+
+static Route *route_of(RecordMethod method, const char *target, size_t target_len) {
+    size_t path_len = 0;
+    while (path_len < target_len && target[path_len] != '?') path_len++;
+    char name[96];
+    snprintf(name, sizeof(name), "%s %.*s", record_method_name(method), (int)path_len, target);
+    for (int i = 0; i < route_count; i++) {
+        if (strcmp(routes[i].name, name) == 0) return &routes[i];
+    }
+    if (route_count == MAX_ROUTES) return &routes[MAX_ROUTES - 1];
+    snprintf(routes[route_count].name, sizeof(routes[route_count].name), "%s", name);
+    return &routes[route_count++];
+}
+
+static int is_subscribe(const Record *r) {
+    size_t len = strlen(SUBSCRIBE_PATH);
+    return r->method == RECORD_METHOD_GET && r->target_len >= len &&
+           memcmp(r->target, SUBSCRIBE_PATH, len) == 0 &&
+           (r->target_len == len || r->target[len] == '?');
+}
+
+/* ============================================================================
+ *                           LOADING
+ * ============================================================================ */
+
+static int cmp_record(const void *a, const void *b) {
+    const Record *x = a, *y = b;
+    if (x->t_us != y->t_us) return (x->t_us > y->t_us) - (x->t_us < y->t_us);
+    return x->seq - y->seq;
+}
+
+static void *grow_table(void *table, int *cap, int need, size_t elem) {
+    if (need < *cap) return table;
+    int new_cap = *cap ? *cap : 1024;
+    while (new_cap <= need) new_cap *= 2;
+    char *grown = realloc(table, (size_t)new_cap * elem);
+    if (!grown) {
+        perror("realloc");
+        exit(1);
+    }
+    memset(grown + (size_t)*cap * elem, 0, (size_t)(new_cap - *cap) * elem);
+    *cap = new_cap;
+    return grown;
+}
+
+static SessionState *session_at(int id) {
+    sessions = grow_table(sessions, &session_cap, id, sizeof(SessionState));
+    return &sessions[id];
+}
+
+static RoomState *room_at(int id) {
+    rooms = grow_table(rooms, &room_cap, id, sizeof(RoomState));
+    return &rooms[id];
+}
+
+/**
+ * Đọc cả file vào bộ nhớ, parse record, sort theo thời điểm tới
+ * @return 0 nếu hợp lệ
+ */
+static int load_recording(const char *path, uint64_t *recorded_at_ms) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *data = malloc((size_t)size + 1);
+    if (!data || fread(data, 1, (size_t)size, file) != (size_t)size) {
+        fclose(file);
+        fprintf(stderr, "replay: cannot read %s\n", path);
+        return -1;
+    }
+    fclose(file);
+
+    if (size < RECORD_HEADER_LEN || memcmp(data, RECORD_MAGIC, RECORD_MAGIC_LEN) != 0) {
+        fprintf(stderr, "replay: %s is not a traffic recording\n", path);
+        return -1;
+    }
+    *recorded_at_ms = 0;
+    for (int i = 0; i < 8; i++) *recorded_at_ms |= (uint64_t)data[RECORD_MAGIC_LEN + i] << (8 * i);
+
+    const uint8_t *p = data + RECORD_HEADER_LEN, *end = data + size;
+    int cap = 0;
+    while (p < end) {
+        uint64_t t_us, session, assigned, target_len, body_len;
+        if (record_get_varint(&p, end, &t_us) || record_get_varint(&p, end, &session) ||
+            record_get_varint(&p, end, &assigned) || p >= end) break;
+        RecordMethod method = (RecordMethod)*p++;
+        if (record_get_varint(&p, end, &target_len) || target_len > (uint64_t)(end - p)) break;
+        const char *target = (const char *)p;
+        p += target_len;
+        if (record_get_varint(&p, end, &body_len) || body_len > (uint64_t)(end - p)) break;
+        const char *body = (const char *)p;
+        p += body_len;
+
+        records = grow_table(records, &cap, record_count, sizeof(Record));
+        records[record_count] = (Record){
+            .t_us = t_us, .session_id = (int)session, .assigned_id = (int)assigned,
+            .method = method, .target = target, .target_len = (size_t)target_len,
+            .body = body, .body_len = (size_t)body_len, .seq = record_count,
+        };
+        record_count++;
+    }
+    if (p < end) fprintf(stderr, "replay: truncated record at byte %ld ignored\n", (long)(p - data));
+
+    qsort(records, (size_t)record_count, sizeof(Record), cmp_record);
+
+    // Chuỗi record theo session (duyệt ngược để nối head)
+    for (int i = record_count - 1; i >= 0; i--) {
+        Record *r = &records[i];
+        r->next_in_session = -1;
+        if (is_subscribe(r)) {
+            if (r->assigned_id > 0) session_at(r->assigned_id)->has_subscribe = 1;
+            continue;
+        }
+        if (r->assigned_id > 0 && r->target_len >= 13 && memcmp(r->target, "/rooms/create", 13) == 0) {
+            room_at(r->assigned_id)->created_in_log = 1;
+        }
+        if (r->session_id > 0) {
+            SessionState *s = session_at(r->session_id);
+            r->next_in_session = s->head ? s->head - 1 : -1;
+            s->head = i + 1;            // +1: 0 = chưa có record
+        }
+    }
+    for (int id = 0; id < session_cap; id++) sessions[id].head -= 1;
+    return 0;
+}
+
+/* ============================================================================
+ *                           CONNECTIONS
+ * ============================================================================ */
+
+static int open_socket(void) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void open_stream(Record *rec, int old_session) {
+    Stream *st = calloc(1, sizeof(Stream));
+    st->kind = CONN_SSE;
+    st->rec = rec;
+    st->old_session = old_session;
+    st->start_ns = now_ns();
+    st->fd = open_socket();
+    if (st->fd < 0) {
+        failed++;
+        free(st);
+        return;
+    }
+    in_flight++;
+    // Request nhỏ: gửi ngay khi connect xong (EPOLLOUT)
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = st };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, st->fd, &ev);
+}
+
+static void close_stream(Stream *st) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, st->fd, NULL);
+    close(st->fd);
+    if (!st->done) {
+        // Server đóng stream trước khi cấp session
+        failed++;
+        in_flight--;
+        completed++;
+    }
+    free(st);
+}
+
+static void on_stream(Stream *st, uint32_t events) {
+    if (events & EPOLLERR) {
+        close_stream(st);
+        return;
+    }
+    if (events & EPOLLOUT) {
+        static const char req[] = "GET " SUBSCRIBE_PATH " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+        if (send(st->fd, req, sizeof(req) - 1, MSG_NOSIGNAL) != (ssize_t)(sizeof(req) - 1)) {
+            close_stream(st);
+            return;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = st };
+        epoll_ctl(epfd, EPOLL_CTL_MOD, st->fd, &ev);
+        return;
+    }
+
+    char scratch[16384];
+    for (;;) {
+        char *dst = st->done ? scratch : st->buf + st->len;
+        size_t room = st->done ? sizeof(scratch) : sizeof(st->buf) - 1 - (size_t)st->len;
+        ssize_t n = recv(st->fd, dst, room, 0);
+        if (n < 0 && errno == EAGAIN) return;
+        if (n <= 0) {
+            close_stream(st);
+            return;
+        }
+        if (st->done) continue;                 // Stream chỉ cần được đọc cạn
+
+        st->len += (int)n;
+        st->buf[st->len] = '\0';
+        char *id = strstr(st->buf, "\"session_id\":");
+        if (!id || !strchr(id, '}')) {
+            if (st->len >= (int)sizeof(st->buf) - 1) st->len = 0;
+            continue;
+        }
+        st->done = 1;
+        in_flight--;
+        completed++;
+        session_at(st->old_session)->new_id = atoi(id + 13);
+        if (st->rec) {
+            samples_add(&route_of(RECORD_METHOD_GET, SUBSCRIBE_PATH, strlen(SUBSCRIBE_PATH))->latency,
+                        now_ns() - st->start_ns);
+        }
+    }
+}
+
+/**
+ * Ghép lại request với id đã ánh xạ
+ */
+static int build_request(Record *r, char **out) {
+    // ?session_id=N (GET /rooms/player)
+    char target[1024];
+    size_t tlen = r->target_len < sizeof(target) - 1 ? r->target_len : sizeof(target) - 1;
+    memcpy(target, r->target, tlen);
+    target[tlen] = '\0';
+    char *q = strstr(target, "session_id=");
+    if (q && (q == target || q[-1] == '?' || q[-1] == '&')) {
+        int old = atoi(q + 11);
+        int mapped = old > 0 && old < session_cap ? sessions[old].new_id : 0;
+        if (mapped) {
+            char *rest = q + 11;
+            while (*rest >= '0' && *rest <= '9') rest++;
+            char tail[1024];
+            snprintf(tail, sizeof(tail), "%s", rest);
+            snprintf(q, sizeof(target) - (size_t)(q - target), "session_id=%d%s", mapped, tail);
+        }
+    }
+
+    // "room_id":N trong body (POST /rooms/join)
+    char *body = malloc(r->body_len + 32);
+    memcpy(body, r->body, r->body_len);
+    body[r->body_len] = '\0';
+    char *rid = strstr(body, "\"room_id\":");
+    if (rid) {
+        char *num = rid + 10;
+        while (*num == ' ') num++;
+        int old = atoi(num);
+        int mapped = old > 0 && old < room_cap ? rooms[old].new_id : 0;
+        if (mapped) {
+            char *rest = num;
+            while (*rest >= '0' && *rest <= '9') rest++;
+            char *tail = strdup(rest);
+            sprintf(num, "%d%s", mapped, tail);
+            free(tail);
+        }
+    }
+
+    int session = r->session_id > 0 && r->session_id < session_cap ? sessions[r->session_id].new_id : 0;
+    char session_header[48] = "";
+    if (session) snprintf(session_header, sizeof(session_header), "X-Session-ID: %d\r\n", session);
+
+    size_t body_len = strlen(body);
+    size_t cap = strlen(target) + body_len + 256;
+    *out = malloc(cap);
+    int len = snprintf(*out, cap,
+        "%s %s HTTP/1.1\r\n"
+        "Host: 127.0.0.1:%d\r\n"
+        "%s"
+        "Content-Type: application/json\r\n"
+        "Content-Length: %zu\r\n"
+        "Connection: close\r\n"
+        "\r\n%s",
+        record_method_name(r->method), target, cfg.port, session_header, body_len, body);
+    free(body);
+    return len;
+}
+
+static void finish_request(Request *req, int ok) {
+    Record *r = req->rec;
+    uint64_t elapsed = now_ns() - req->start_ns;
+    samples_add(&route_of(r->method, r->target, r->target_len)->latency, elapsed);
+
+    if (!ok) failed++;
+    in_flight--;
+    completed++;
+    if (r->session_id > 0) {
+        SessionState *s = session_at(r->session_id);
+        s->busy = 0;
+        s->head = r->next_in_session;
+    }
+
+    // Room được tạo lại: ánh xạ room id cũ -> mới
+    if (r->assigned_id > 0 && ok) {
+        const char *id = strstr(req->in, "\"room\":{\"id\":");
+        if (id) room_at(r->assigned_id)->new_id = atoi(id + 13);
+    }
+    if (req->fd >= 0) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, req->fd, NULL);
+        close(req->fd);
+    }
+    free(req->out);
+    free(req);
+}
+
+static void on_request(Request *req, uint32_t events) {
+    if (req->out_sent < req->out_len) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(req->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err || (events & EPOLLERR)) {
+            finish_request(req, 0);
+            return;
+        }
+        ssize_t n = send(req->fd, req->out + req->out_sent, (size_t)(req->out_len - req->out_sent), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN) finish_request(req, 0);
+            return;
+        }
+        req->out_sent += (int)n;
+        if (req->out_sent == req->out_len) {
+            struct epoll_event ev = { .events = EPOLLIN, .data.ptr = req };
+            epoll_ctl(epfd, EPOLL_CTL_MOD, req->fd, &ev);
+        }
+        return;
+    }
+
+    char scratch[4096];
+    for (;;) {
+        int keep = req->in_len < RESPONSE_KEEP - 1;
+        ssize_t n = recv(req->fd, keep ? req->in + req->in_len : scratch,
+                         keep ? (size_t)(RESPONSE_KEEP - 1 - req->in_len) : sizeof(scratch), 0);
+        if (n > 0) {
+            if (keep) req->in_len += (int)n;
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN) return;
+        break;
+    }
+    req->in[req->in_len] = '\0';
+    int ok = strncmp(req->in, "HTTP/1.1 2", 10) == 0;
+    finish_request(req, ok);
+}
+
+static void issue(Record *r) {
+    r->issued = 1;
+    if (is_subscribe(r)) {
+        open_stream(r, r->assigned_id);
+        return;
+    }
+
+    Request *req = calloc(1, sizeof(Request));
+    req->kind = CONN_REQUEST;
+    req->rec = r;
+    req->out_len = build_request(r, &req->out);
+    req->start_ns = now_ns();
+    req->fd = open_socket();
+    if (r->session_id > 0) session_at(r->session_id)->busy = 1;
+    in_flight++;
+    if (req->fd < 0) {
+        finish_request(req, 0);
+        return;
+    }
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = req };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, req->fd, &ev);
+}
+
+/* ============================================================================
+ *                           SCHEDULER
+ * ============================================================================ */
+
+/**
+ * Record có gửi được chưa: đúng lượt của session, session đã subscribe lại,
+ * phòng được join đã được tạo lại
+ */
+static int ready(const Record *r) {
+    if (r->session_id > 0) {
+        SessionState *s = &sessions[r->session_id];
+        if (s->busy || s->head != (int)(r - records) || !s->new_id) return 0;
+    }
+    const char *rid = r->body_len ? memmem(r->body, r->body_len, "\"room_id\":", 10) : NULL;
+    if (rid) {
+        int old = atoi(rid + 10);
+        if (old > 0 && old < room_cap && rooms[old].created_in_log && !rooms[old].new_id) return 0;
+    }
+    return 1;
+}
+
+static uint64_t due_ns(const Record *r, uint64_t start) {
+    if (cfg.speed <= 0) return start;
+    return start + (uint64_t)((double)r->t_us * 1000.0 / cfg.speed);
+}
+
+static int run(void) {
+    struct epoll_event events[EPOLL_BATCH];
+    waiting = malloc(sizeof(int) * (size_t)(record_count + 1));
+
+    // Session có request nhưng không có /subscribe trong log: subscribe trước
+    int orphans = 0;
+    for (int id = 1; id < session_cap; id++) {
+        if (sessions[id].head >= 0 && !sessions[id].has_subscribe) {
+            open_stream(NULL, id);
+            orphans++;
+        }
+    }
+    if (orphans) printf("replay: %d session(s) without /subscribe in the log, subscribed up front\n", orphans);
+
+    uint64_t start = now_ns();
+    uint64_t last_progress = start;
+    int cursor = 0;
+    for (;;) {
+        uint64_t now = now_ns();
+
+        // Record tới giờ -> hàng chờ
+        while (cursor < record_count && due_ns(&records[cursor], start) <= now) {
+            records[cursor].released = 1;
+            waiting[waiting_count++] = cursor++;
+        }
+
+        // Gửi mọi record sẵn sàng (giữ thứ tự thời gian), giới hạn in-flight
+        int kept = 0;
+        for (int i = 0; i < waiting_count; i++) {
+            Record *r = &records[waiting[i]];
+            if (in_flight < cfg.concurrency && ready(r)) {
+                if (cfg.speed > 0) samples_add(&lag, now - due_ns(r, start));
+                issue(r);
+                last_progress = now;
+            } else {
+                waiting[kept++] = waiting[i];
+            }
+        }
+        waiting_count = kept;
+
+        if (cursor == record_count && waiting_count == 0 && in_flight == 0) break;
+        if (now - last_progress > (uint64_t)cfg.timeout_s * 1000000000ULL && cursor == record_count) {
+            fprintf(stderr, "replay: no progress for %d s, %d record(s) stuck (missing session/room?)\n",
+                    cfg.timeout_s, waiting_count + in_flight);
+            failed += waiting_count;
+            break;
+        }
+
+        int timeout_ms = 50;
+        if (cursor < record_count) {
+            uint64_t due = due_ns(&records[cursor], start);
+            uint64_t wait = due > now ? (due - now + 999999) / 1000000 : 0;
+            if (wait < (uint64_t)timeout_ms) timeout_ms = (int)wait;
+        }
+        int n = epoll_wait(epfd, events, EPOLL_BATCH, timeout_ms);
+        for (int i = 0; i < n; i++) {
+            if (*(ConnKind *)events[i].data.ptr == CONN_SSE) {
+                on_stream(events[i].data.ptr, events[i].events);
+            } else {
+                on_request(events[i].data.ptr, events[i].events);
+            }
+            last_progress = now_ns();
+        }
+    }
+    return 0;
+}
+
+/* ============================================================================
+ *                           REPORT / COMPARE
+ * ============================================================================ */
+
+static void report(double elapsed, uint64_t recorded_us) {
+    Samples all = { 0 };
+    FILE *save = cfg.save ? fopen(cfg.save, "w") : NULL;
+    if (cfg.save && !save) perror(cfg.save);
+
+    printf("\nreplayed %d record(s) in %.2f s (recorded span %.2f s), %d failed\n",
+           record_count, elapsed, recorded_us / 1e6, failed);
+    if (lag.count) {
+        qsort(lag.ns, lag.count, sizeof(uint64_t), cmp_u64);
+        printf("schedule lag p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+               percentile_ms(&lag, 0.5), percentile_ms(&lag, 0.99), percentile_ms(&lag, 1.0));
+    }
+    printf("\n%-28s %8s %10s %10s %10s %10s %10s\n", "route (ms)", "count", "p50", "p90", "p99", "p999", "max");
+
+    for (int i = 0; i <= route_count; i++) {
+        Samples *s = &all;
+        const char *name = "ALL";
+        if (i < route_count) {
+            s = &routes[i].latency;
+            name = routes[i].name;
+            for (size_t k = 0; k < s->count; k++) samples_add(&all, s->ns[k]);
+        }
+        qsort(s->ns, s->count, sizeof(uint64_t), cmp_u64);
+        printf("%-28s %8zu %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, s->count, percentile_ms(s, 0.5),
+               percentile_ms(s, 0.9), percentile_ms(s, 0.99), percentile_ms(s, 0.999), percentile_ms(s, 1.0));
+        if (save) {
+            fprintf(save, "{\"route\":\"%s\",\"count\":%zu,\"p50_ms\":%.3f,\"p90_ms\":%.3f,"
+                    "\"p99_ms\":%.3f,\"p999_ms\":%.3f,\"max_ms\":%.3f}\n",
+                    name, s->count, percentile_ms(s, 0.5), percentile_ms(s, 0.9),
+                    percentile_ms(s, 0.99), percentile_ms(s, 0.999), percentile_ms(s, 1.0));
+        }
+    }
+    if (save) {
+        fclose(save);
+        printf("\nsaved to %s (replay --compare %s <other>)\n", cfg.save, cfg.save);
+    }
+}
+
+typedef struct {
+    char route[96];
+    long count;
+    double p[5];                        // p50, p90, p99, p999, max
+} SavedRoute;
+
+static int load_saved(const char *path, SavedRoute *out, int max) {
+    static const char *keys[5] = { "\"p50_ms\":", "\"p90_ms\":", "\"p99_ms\":", "\"p999_ms\":", "\"max_ms\":" };
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    char line[512];
+    int n = 0;
+    while (n < max && fgets(line, sizeof(line), file)) {
+        const char *route = strstr(line, "\"route\":\"");
+        const char *count = strstr(line, "\"count\":");
+        if (!route || !count || sscanf(route + 9, "%95[^\"]", out[n].route) != 1) continue;
+        out[n].count = atol(count + 8);
+        for (int k = 0; k < 5; k++) {
+            const char *v = strstr(line, keys[k]);
+            out[n].p[k] = v ? atof(v + strlen(keys[k])) : 0;
+        }
+        n++;
+    }
+    fclose(file);
+    return n;
+}
+
+static int compare(const char *path_a, const char *path_b) {
+    static SavedRoute a[MAX_ROUTES + 1], b[MAX_ROUTES + 1];
+    int na = load_saved(path_a, a, MAX_ROUTES + 1);
+    int nb = load_saved(path_b, b, MAX_ROUTES + 1);
+    if (na < 0 || nb < 0) return 1;
+
+    static const char *labels[5] = { "p50", "p90", "p99", "p999", "max" };
+    printf("A = %s\nB = %s\n\n", path_a, path_b);
+    printf("%-28s %13s", "route", "count A/B");
+    for (int k = 0; k < 5; k++) printf(" %20s", labels[k]);
+    printf("\n");
+
+    for (int i = 0; i < na; i++) {
+        const SavedRoute *y = NULL;
+        for (int j = 0; j < nb; j++) {
+            if (strcmp(a[i].route, b[j].route) == 0) y = &b[j];
+        }
+        if (!y) {
+            printf("%-28s %6ld/%-6s (only in A)\n", a[i].route, a[i].count, "-");
+            continue;
+        }
+        printf("%-28s %6ld/%-6ld", a[i].route, a[i].count, y->count);
+        for (int k = 0; k < 5; k++) {
+            char cell[32];
+            double change = a[i].p[k] > 0 ? (y->p[k] - a[i].p[k]) * 100.0 / a[i].p[k] : 0;
+            snprintf(cell, sizeof(cell), "%.2f->%.2f %+.0f%%", a[i].p[k], y->p[k], change);
+            printf(" %20s", cell);
+        }
+        printf("\n");
+    }
+    for (int j = 0; j < nb; j++) {
+        int found = 0;
+        for (int i = 0; i < na; i++) found |= strcmp(a[i].route, b[j].route) == 0;
+        if (!found) printf("%-28s %6s/%-6ld (only in B)\n", b[j].route, "-", b[j].count);
+    }
+    return 0;
+}
+
+/* ============================================================================
+ *                           MAIN
+ * ============================================================================ */
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options] traffic.rec\n"
+        "       %s --compare a.jsonl b.jsonl\n"
+        "  --port N          Server port on 127.0.0.1 (default 8080)\n"
+        "  --speed X|max     1 = recorded pace, N = N times faster, max = no delays (default 1)\n"
+        "  --concurrency N   Max requests in flight (default 256)\n"
+        "  --timeout S       Give up after S seconds without progress (default 30)\n"
+        "  --save FILE       Write per-route latency percentiles as JSON lines\n",
+        prog, prog);
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--compare") == 0 && i + 2 < argc) {
+            return compare(argv[i + 1], argv[i + 2]);
+        } else if (strcmp(arg, "--port") == 0 && value) {
+            cfg.port = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--speed") == 0 && value) {
+            cfg.speed = strcmp(value, "max") == 0 ? 0 : atof(value);
+            i++;
+        } else if (strcmp(arg, "--concurrency") == 0 && value) {
+            cfg.concurrency = atoi(value) > 0 ? atoi(value) : 1;
+            i++;
+        } else if (strcmp(arg, "--timeout") == 0 && value) {
+            cfg.timeout_s = atoi(value) > 0 ? atoi(value) : 1;
+            i++;
+        } else if (strcmp(arg, "--save") == 0 && value) {
+            cfg.save = value;
+            i++;
+        } else if (arg[0] != '-' && !path) {
+            path = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!path || cfg.speed < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    uint64_t recorded_at_ms;
+    if (load_recording(path, &recorded_at_ms) != 0) return 1;
+
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons((uint16_t)cfg.port);
+    server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    epfd = epoll_create1(0);
+
+    time_t recorded_at = (time_t)(recorded_at_ms / 1000);
+    char when[32];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&recorded_at));
+    uint64_t span_us = record_count ? records[record_count - 1].t_us : 0;
+    char speed[32];
+    if (cfg.speed > 0) snprintf(speed, sizeof(speed), "%.2fx", cfg.speed);
+    else snprintf(speed, sizeof(speed), "max");
+    printf("replay: %d record(s) recorded %s, span %.2f s, speed %s\n", record_count, when,
+           span_us / 1e6, speed);
+
+    uint64_t start = now_ns();
+    run();
+    report((now_ns() - start) / 1e9, span_us);
+    return failed ? 2 : 0;
+}